@@ -0,0 +1,449 @@
+// Aho-Corasick multi-pattern search
+// https://cr.yp.to/bib/1975/aho.pdf
+//
+// 1. build: trie(first-child/next-sibling), then BFS compile to a full DFA(no failure link at search time)
+// 2. bytes which don't appear in any pattern share one class, DFA row = class count
+// 3. DFA entry: (next state * class count) << 1 | has output, search loop is one load per byte
+// 4. in start state, skip bytes which can't begin a pattern: compare with up to 4 first bytes at 16 positions(SSE2/NEON),
+//    more first bytes: plain DFA loop, byte-by-byte filter is slower than the DFA(branch miss)
+// 5. stream: DFA state is carried by the caller, compiled automaton is read-only and can be shared by threads
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include "algorithm.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define AHO_CORASICK_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define AHO_CORASICK_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#define AHO_CORASICK_FILTER 4
+
+struct aho_corasick_node_t
+{
+	int child; // first child
+	int sibling; // next sibling
+	int fail;
+	int out; // pattern index, -1 if none
+	int dict; // nearest state with output in failure chain, -1 if none
+	uint8_t c;
+};
+
+struct aho_corasick_pattern_t
+{
+	int id;
+	int next; // next pattern with the same state(duplicate pattern)
+};
+
+struct aho_corasick_t
+{
+	struct aho_corasick_node_t* nodes;
+	int count;
+	int capacity;
+
+	struct aho_corasick_pattern_t* patterns;
+	int npatterns;
+	int pcapacity;
+
+	int32_t* dfa; // [state * nclass + class]
+	int nclass;
+	uint16_t classes[256];
+
+	uint8_t first[AHO_CORASICK_FILTER]; // start bytes
+	int nfirst; // >AHO_CORASICK_FILTER-don't filter
+};
+
+struct aho_corasick_t* aho_corasick_create(void)
+{
+	struct aho_corasick_t* ac;
+	ac = (struct aho_corasick_t*)calloc(1, sizeof(*ac));
+	if (!ac)
+		return NULL;
+
+	ac->nodes = (struct aho_corasick_node_t*)malloc(sizeof(ac->nodes[0]) * 64);
+	if (!ac->nodes)
+	{
+		free(ac);
+		return NULL;
+	}
+
+	// root
+	memset(ac->nodes, 0, sizeof(ac->nodes[0]));
+	ac->nodes[0].child = ac->nodes[0].sibling = -1;
+	ac->nodes[0].out = ac->nodes[0].dict = -1;
+	ac->capacity = 64;
+	ac->count = 1;
+	return ac;
+}
+
+void aho_corasick_destroy(struct aho_corasick_t* ac)
+{
+	if (!ac)
+		return;
+	if (ac->dfa)
+		free(ac->dfa);
+	if (ac->patterns)
+		free(ac->patterns);
+	if (ac->nodes)
+		free(ac->nodes);
+	free(ac);
+}
+
+static int aho_corasick_node(struct aho_corasick_t* ac, int parent, uint8_t c)
+{
+	int i;
+	void* p;
+
+	for (i = ac->nodes[parent].child; -1 != i; i = ac->nodes[i].sibling)
+	{
+		if (ac->nodes[i].c == c)
+			return i;
+	}
+
+	if (ac->count >= ac->capacity)
+	{
+		p = realloc(ac->nodes, sizeof(ac->nodes[0]) * ac->capacity * 2);
+		if (!p)
+			return -1;
+		ac->nodes = (struct aho_corasick_node_t*)p;
+		ac->capacity *= 2;
+	}
+
+	i = ac->count++;
+	ac->nodes[i].c = c;
+	ac->nodes[i].child = -1;
+	ac->nodes[i].sibling = ac->nodes[parent].child;
+	ac->nodes[i].fail = 0;
+	ac->nodes[i].out = -1;
+	ac->nodes[i].dict = -1;
+	ac->nodes[parent].child = i;
+	return i;
+}
+
+int aho_corasick_add(struct aho_corasick_t* ac, const void* pattern, size_t bytes, int id)
+{
+	size_t i;
+	int state;
+	void* p;
+	const uint8_t* ptr;
+
+	if (0 == bytes || ac->dfa)
+		return -EINVAL;
+
+	if (ac->npatterns >= ac->pcapacity)
+	{
+		p = realloc(ac->patterns, sizeof(ac->patterns[0]) * (ac->pcapacity + 64));
+		if (!p)
+			return -ENOMEM;
+		ac->patterns = (struct aho_corasick_pattern_t*)p;
+		ac->pcapacity += 64;
+	}
+
+	ptr = (const uint8_t*)pattern;
+	for (state = 0, i = 0; i < bytes; i++)
+	{
+		state = aho_corasick_node(ac, state, ptr[i]);
+		if (state < 0)
+			return -ENOMEM; // keep the trie prefix, it's harmless
+	}
+
+	ac->patterns[ac->npatterns].id = id;
+	ac->patterns[ac->npatterns].next = ac->nodes[state].out;
+	ac->nodes[state].out = ac->npatterns++;
+	return 0;
+}
+
+static int32_t aho_corasick_entry(const struct aho_corasick_t* ac, int state)
+{
+	const struct aho_corasick_node_t* node;
+	node = &ac->nodes[state];
+	return (int32_t)((state * ac->nclass) << 1) | ((-1 != node->out || -1 != node->dict) ? 1 : 0);
+}
+
+int aho_corasick_compile(struct aho_corasick_t* ac)
+{
+	int i, u, v, head, tail;
+	int32_t* row;
+	int* queue;
+
+	if (ac->dfa)
+		return 0;
+
+	// byte class: byte in any pattern has its own class, other bytes share class 0
+	memset(ac->classes, 0, sizeof(ac->classes));
+	for (ac->nclass = 1, i = 1; i < ac->count; i++)
+	{
+		if (0 == ac->classes[ac->nodes[i].c])
+			ac->classes[ac->nodes[i].c] = (uint16_t)ac->nclass++;
+	}
+
+	if ((int64_t)ac->count * ac->nclass >= (1 << 30))
+		return -E2BIG;
+
+	ac->dfa = (int32_t*)malloc(sizeof(int32_t) * ac->count * ac->nclass);
+	queue = (int*)malloc(sizeof(int) * ac->count);
+	if (!ac->dfa || !queue)
+	{
+		free(queue);
+		free(ac->dfa);
+		ac->dfa = NULL;
+		return -ENOMEM;
+	}
+
+	// BFS: fail state is shallower, its row is complete
+	head = tail = 0;
+	queue[tail++] = 0;
+	while (head < tail)
+	{
+		u = queue[head++];
+		row = ac->dfa + u * ac->nclass;
+		if (0 == u)
+			memset(row, 0, sizeof(int32_t) * ac->nclass);
+		else
+			memcpy(row, ac->dfa + ac->nodes[u].fail * ac->nclass, sizeof(int32_t) * ac->nclass);
+
+		for (v = ac->nodes[u].child; -1 != v; v = ac->nodes[v].sibling)
+		{
+			if (0 != u)
+			{
+				// fail row isn't overwrite by children yet
+				ac->nodes[v].fail = (ac->dfa[ac->nodes[u].fail * ac->nclass + ac->classes[ac->nodes[v].c]] >> 1) / ac->nclass;
+				i = ac->nodes[v].fail;
+				ac->nodes[v].dict = -1 != ac->nodes[i].out ? i : ac->nodes[i].dict;
+			}
+			queue[tail++] = v;
+		}
+
+		for (v = ac->nodes[u].child; -1 != v; v = ac->nodes[v].sibling)
+			row[ac->classes[ac->nodes[v].c]] = aho_corasick_entry(ac, v);
+	}
+	free(queue);
+
+	// start state filter
+	for (ac->nfirst = 0, v = ac->nodes[0].child; -1 != v; v = ac->nodes[v].sibling)
+	{
+		if (ac->nfirst < AHO_CORASICK_FILTER)
+			ac->first[ac->nfirst] = ac->nodes[v].c;
+		ac->nfirst++;
+	}
+	return 0;
+}
+
+#if defined(AHO_CORASICK_SSE2) || defined(AHO_CORASICK_NEON)
+static inline int aho_corasick_ctz(uint64_t v)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return (int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if (_BitScanForward(&i, (uint32_t)v))
+		return (int)i;
+	_BitScanForward(&i, (uint32_t)(v >> 32));
+	return (int)i + 32;
+#else
+	return __builtin_ctzll(v);
+#endif
+}
+#endif
+
+/// @return the first byte can begin a pattern, end if not found
+static const uint8_t* aho_corasick_skip(const struct aho_corasick_t* ac, const uint8_t* p, const uint8_t* end)
+{
+#if defined(AHO_CORASICK_SSE2)
+	int i;
+	uint32_t m;
+	__m128i v, x, first[AHO_CORASICK_FILTER];
+	for (i = 0; i < AHO_CORASICK_FILTER; i++)
+		first[i] = _mm_set1_epi8((char)ac->first[i < ac->nfirst ? i : 0]);
+
+	for (; p + 16 <= end; p += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)p);
+		x = _mm_or_si128(_mm_cmpeq_epi8(v, first[0]), _mm_cmpeq_epi8(v, first[1]));
+		x = _mm_or_si128(x, _mm_or_si128(_mm_cmpeq_epi8(v, first[2]), _mm_cmpeq_epi8(v, first[3])));
+		m = (uint32_t)_mm_movemask_epi8(x);
+		if (m)
+			return p + aho_corasick_ctz(m);
+	}
+#elif defined(AHO_CORASICK_NEON)
+	int i;
+	uint64_t m;
+	uint8x16_t v, x, first[AHO_CORASICK_FILTER];
+	for (i = 0; i < AHO_CORASICK_FILTER; i++)
+		first[i] = vdupq_n_u8(ac->first[i < ac->nfirst ? i : 0]);
+
+	for (; p + 16 <= end; p += 16)
+	{
+		v = vld1q_u8(p);
+		x = vorrq_u8(vceqq_u8(v, first[0]), vceqq_u8(v, first[1]));
+		x = vorrq_u8(x, vorrq_u8(vceqq_u8(v, first[2]), vceqq_u8(v, first[3])));
+		m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(x), 4)), 0); // 4-bits per byte
+		if (m)
+			return p + aho_corasick_ctz(m) / 4;
+	}
+#endif
+
+	for (; p < end && 0 == ac->dfa[ac->classes[*p]]; p++)
+	{
+	}
+	return p;
+}
+
+/// report all patterns end at the state
+static int aho_corasick_report(const struct aho_corasick_t* ac, int state, size_t end, int (*onmatch)(void* param, int id, size_t end), void* param)
+{
+	int r, i;
+	for (; -1 != state; state = ac->nodes[state].dict)
+	{
+		for (i = ac->nodes[state].out; -1 != i; i = ac->patterns[i].next)
+		{
+			r = onmatch(param, ac->patterns[i].id, end);
+			if (0 != r)
+				return r;
+		}
+	}
+	return 0;
+}
+
+int aho_corasick_search(const struct aho_corasick_t* ac, int* state, const void* ptr, size_t bytes, int (*onmatch)(void* param, int id, size_t end), void* param)
+{
+	int r;
+	int32_t s;
+	const uint8_t *p, *end;
+
+	assert(ac->dfa);
+	if (!ac->dfa)
+		return -EINVAL;
+
+	r = 0;
+	s = *state;
+	p = (const uint8_t*)ptr;
+	end = p + bytes;
+	while (p < end)
+	{
+		if (0 == s && ac->nfirst <= AHO_CORASICK_FILTER)
+		{
+			p = aho_corasick_skip(ac, p, end);
+			if (p == end)
+				break;
+		}
+
+		s = ac->dfa[(s >> 1) + ac->classes[*p++]];
+		if (s & 1)
+		{
+			r = aho_corasick_report(ac, (s >> 1) / ac->nclass, (size_t)(p - (const uint8_t*)ptr), onmatch, param);
+			if (0 != r)
+				break;
+		}
+	}
+
+	*state = s;
+	return r;
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+struct aho_corasick_test_t
+{
+	int matches[1024]; // (end << 8) | id
+	int n;
+};
+
+static int aho_corasick_test_onmatch(void* param, int id, size_t end)
+{
+	struct aho_corasick_test_t* t;
+	t = (struct aho_corasick_test_t*)param;
+	assert(t->n < (int)(sizeof(t->matches) / sizeof(t->matches[0])));
+	t->matches[t->n++] = (int)(end << 8) | id;
+	return 0;
+}
+
+static int aho_corasick_test_cmp(const void* a, const void* b)
+{
+	return *(const int*)a - *(const int*)b;
+}
+
+void aho_corasick_test(void)
+{
+	int i, j, k, n, state, npatterns;
+	size_t chunk, len[8];
+	uint8_t text[256], patterns[8][8];
+	struct aho_corasick_t* ac;
+	struct aho_corasick_test_t t, t2;
+	static const char* s_words[] = { "he", "she", "his", "hers" };
+
+	ac = aho_corasick_create();
+	for (i = 0; i < 4; i++)
+		assert(0 == aho_corasick_add(ac, s_words[i], strlen(s_words[i]), i));
+	assert(0 == aho_corasick_compile(ac));
+	assert(-EINVAL == aho_corasick_add(ac, "x", 1, 5));
+
+	// stream: "us" | "hers"
+	memset(&t, 0, sizeof(t));
+	state = 0;
+	assert(0 == aho_corasick_search(ac, &state, "ush", 3, aho_corasick_test_onmatch, &t));
+	assert(0 == aho_corasick_search(ac, &state, "ers", 3, aho_corasick_test_onmatch, &t));
+	qsort(t.matches, t.n, sizeof(int), aho_corasick_test_cmp);
+	assert(3 == t.n && t.matches[0] == ((1 << 8) | 0) && t.matches[1] == ((1 << 8) | 1) && t.matches[2] == ((3 << 8) | 3)); // he, she, hers
+	aho_corasick_destroy(ac);
+
+	// differential test with naive search
+	srand(0x5a5a5a5a);
+	for (i = 0; i < 5000; i++)
+	{
+		k = 2 + rand() % 6;
+		n = rand() % (int)sizeof(text);
+		npatterns = 1 + rand() % 8;
+		for (j = 0; j < n; j++)
+			text[j] = (uint8_t)(rand() % 2 ? 'a' + rand() % k : rand() % 256);
+
+		ac = aho_corasick_create();
+		for (j = 0; j < npatterns; j++)
+		{
+			len[j] = 1 + rand() % (int)sizeof(patterns[j]);
+			for (chunk = 0; chunk < len[j]; chunk++)
+				patterns[j][chunk] = (uint8_t)('a' + rand() % k);
+			assert(0 == aho_corasick_add(ac, patterns[j], len[j], j));
+		}
+		assert(0 == aho_corasick_compile(ac));
+
+		memset(&t, 0, sizeof(t));
+		for (j = 0; j < npatterns; j++)
+		{
+			for (k = 0; k + (int)len[j] <= n; k++)
+			{
+				if (0 == memcmp(text + k, patterns[j], len[j]))
+					aho_corasick_test_onmatch(&t, j, k + len[j]);
+			}
+		}
+
+		memset(&t2, 0, sizeof(t2));
+		for (state = 0, j = 0; j < n; j += (int)chunk)
+		{
+			chunk = 1 + rand() % 64;
+			chunk = chunk < (size_t)(n - j) ? chunk : (size_t)(n - j);
+			k = t2.n;
+			assert(0 == aho_corasick_search(ac, &state, text + j, chunk, aho_corasick_test_onmatch, &t2));
+			for (; k < t2.n; k++)
+				t2.matches[k] += j << 8; // chunk offset -> text offset
+		}
+
+		qsort(t.matches, t.n, sizeof(int), aho_corasick_test_cmp);
+		qsort(t2.matches, t2.n, sizeof(int), aho_corasick_test_cmp);
+		assert(t.n == t2.n && 0 == memcmp(t.matches, t2.matches, sizeof(int) * t.n));
+		aho_corasick_destroy(ac);
+	}
+}
+#endif
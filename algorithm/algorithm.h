@@ -1,6 +1,9 @@
 #ifndef _alogrithm_h_
 #define _alogrithm_h_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -27,6 +30,50 @@ int strsubstring(const char* s1, const char* s2, char* sub, int len);
 ///@return 0-can't find substring, other-substring pointer
 const char* kmp(const char* s, const char* pattern);
 
+///binary search, Two-Way/Horspool(SIMD filter for short pattern)
+///@param[in] ptr buffer
+///@param[in] bytes buffer size(bytes)
+///@param[in] pattern pattern, can contain '\0'
+///@param[in] len pattern length(bytes)
+///@return NULL-can't find pattern, other-pattern pointer
+const void* memsearch(const void* ptr, size_t bytes, const void* pattern, size_t len);
+
+///compiled pattern, find the same pattern in many buffers or in a stream
+///@param[in] len pattern length(bytes), >0
+///@return NULL-error, other-searcher
+struct memsearch_t* memsearch_create(const void* pattern, size_t len);
+void memsearch_destroy(struct memsearch_t* s);
+
+///@return NULL-can't find pattern, other-pattern pointer
+const void* memsearch_find(const struct memsearch_t* s, const void* ptr, size_t bytes);
+
+///stream search, pattern across the chunks is found too
+///@param[in] onmatch pattern offset in stream(from the first chunk after create/reset), return 0-continue, other-stop
+///@return 0-ok, other-onmatch return value(the rest of the chunk is skipped)
+int memsearch_stream(struct memsearch_t* s, const void* ptr, size_t bytes, int (*onmatch)(void* param, int64_t offset), void* param);
+///clear stream state
+void memsearch_reset(struct memsearch_t* s);
+
+///Aho-Corasick multi-pattern search(DFA)
+///usage: create -> add patterns -> compile -> search(can be called by many threads)
+struct aho_corasick_t* aho_corasick_create(void);
+void aho_corasick_destroy(struct aho_corasick_t* ac);
+
+///@param[in] pattern pattern, can contain '\0'
+///@param[in] bytes pattern length(bytes), >0
+///@param[in] id pattern id, report by search
+///@return 0-ok, -EINVAL-empty pattern or compiled, -ENOMEM-out of memory
+int aho_corasick_add(struct aho_corasick_t* ac, const void* pattern, size_t bytes, int id);
+
+///build automaton, can't add pattern any more
+///@return 0-ok, -ENOMEM-out of memory, -E2BIG-too many states
+int aho_corasick_compile(struct aho_corasick_t* ac);
+
+///@param[in,out] state stream state, 0-start, pass the same value for the next chunk
+///@param[in] onmatch pattern id and match end offset in this chunk(exclusive), return 0-continue, other-stop
+///@return 0-ok, other-onmatch return value
+int aho_corasick_search(const struct aho_corasick_t* ac, int* state, const void* ptr, size_t bytes, int (*onmatch)(void* param, int id, size_t end), void* param);
+
 #ifdef  __cplusplus
 }
 #endif
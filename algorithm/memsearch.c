@@ -0,0 +1,486 @@
+// Binary single-pattern search
+// 1. SIMD filter: compare the first and last pattern byte at 16 positions at once(SSE2/NEON),
+//    then verify candidates, http://0x80.pl/articles/simd-strfind.html
+// 2. Two-Way(Crochemore-Perrin) with Horspool last-byte shift table, linear worst case, O(1) space
+//    http://www-igm.univ-mlv.fr/~lecroq/string/node26.html
+//    used without SIMD, or long pattern(> 16-bytes) when too many candidates fail verification
+// 3. stream: keep the last (pattern length - 1) bytes, match across chunks is found too
+//
+// memsearch("banananobano", 12, "nano", 4) => "nanobano"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include "algorithm.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MEMSEARCH_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define MEMSEARCH_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#define MEMSEARCH_SHORT 16 // verification cost is bounded
+#define MEMSEARCH_BUDGET 4096
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+struct memsearch_t
+{
+	const uint8_t* pattern;
+	size_t len;
+
+	// Two-Way critical factorization
+	size_t ms; // left half: [0, ms], right half: [ms+1, len)
+	size_t period;
+	size_t mem0; // periodic pattern: len - period, other: 0
+	size_t shift[256]; // Horspool: distance from the last occurrence to the pattern end
+
+	// stream
+	uint8_t* carry; // last len-1 bytes + next chunk len-1 bytes
+	size_t ncarry;
+	int64_t offset; // stream bytes before the current chunk
+};
+
+#if defined(MEMSEARCH_SSE2) || defined(MEMSEARCH_NEON)
+static inline int memsearch_ctz(uint64_t v)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return (int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if (_BitScanForward(&i, (uint32_t)v))
+		return (int)i;
+	_BitScanForward(&i, (uint32_t)(v >> 32));
+	return (int)i + 32;
+#else
+	return __builtin_ctzll(v);
+#endif
+}
+
+/// @param[out] pos first position not scanned(no match before it)
+/// @return match pointer, NULL if not found before pos
+static const uint8_t* memsearch_simd(const uint8_t* s, size_t n, const uint8_t* pattern, size_t len, size_t* pos)
+{
+	int k;
+	size_t i, cost;
+	uint64_t m;
+#if defined(MEMSEARCH_SSE2)
+	__m128i first, last;
+	first = _mm_set1_epi8((char)pattern[0]);
+	last = _mm_set1_epi8((char)pattern[len - 1]);
+#else
+	uint8x16_t first, last;
+	first = vdupq_n_u8(pattern[0]);
+	last = vdupq_n_u8(pattern[len - 1]);
+#endif
+
+	assert(len >= 2);
+	for (cost = i = 0; i + len - 1 + 16 <= n; i += 16)
+	{
+#if defined(MEMSEARCH_SSE2)
+		m = (uint64_t)_mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)(s + i))),
+			_mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i*)(s + i + len - 1)))));
+#else
+		m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vandq_u8(
+			vceqq_u8(first, vld1q_u8(s + i)),
+			vceqq_u8(last, vld1q_u8(s + i + len - 1))))), 4)), 0) & 0x8888888888888888ULL; // 4-bits per byte
+#endif
+		for (; m; m &= m - 1)
+		{
+#if defined(MEMSEARCH_SSE2)
+			k = memsearch_ctz(m);
+#else
+			k = memsearch_ctz(m) / 4;
+#endif
+			if (0 == memcmp(s + i + k + 1, pattern + 1, len - 2))
+				return s + i + k;
+			cost += len;
+		}
+
+		// periodic text, let Two-Way do the work
+		if (len > MEMSEARCH_SHORT && cost > i + MEMSEARCH_BUDGET)
+		{
+			*pos = i + 16;
+			return NULL;
+		}
+	}
+
+	*pos = i;
+	return NULL;
+}
+
+static const uint8_t* memsearch_short(const uint8_t* s, size_t n, const uint8_t* pattern, size_t len)
+{
+	size_t i;
+	const uint8_t* p;
+
+	p = memsearch_simd(s, n, pattern, len, &i);
+	if (p)
+		return p;
+
+	for (; i + len <= n; i++)
+	{
+		if (s[i] == pattern[0] && s[i + len - 1] == pattern[len - 1] && 0 == memcmp(s + i + 1, pattern + 1, len - 2))
+			return s + i;
+	}
+	return NULL;
+}
+#endif
+
+/// maximal suffix of the pattern
+/// @param[in] reverse 0-normal byte order, 1-reverse order
+/// @param[out] period period of the suffix
+/// @return suffix start - 1, (size_t)-1 if the whole pattern
+static size_t memsearch_suffix(const uint8_t* pattern, size_t len, int reverse, size_t* period)
+{
+	size_t i, j, k, p;
+	i = (size_t)-1;
+	j = 0;
+	k = p = 1;
+	while (j + k < len)
+	{
+		if (pattern[i + k] == pattern[j + k])
+		{
+			if (k == p)
+			{
+				j += p;
+				k = 1;
+			}
+			else
+			{
+				k++;
+			}
+		}
+		else if ((pattern[i + k] > pattern[j + k]) ^ reverse)
+		{
+			j += k;
+			k = 1;
+			p = j - i;
+		}
+		else
+		{
+			i = j++;
+			k = p = 1;
+		}
+	}
+
+	*period = p;
+	return i;
+}
+
+static void memsearch_compile(struct memsearch_t* s, const uint8_t* pattern, size_t len)
+{
+	size_t i, ms, ms2, p, p2;
+
+	s->pattern = pattern;
+	s->len = len;
+
+	for (i = 0; i < 256; i++)
+		s->shift[i] = len;
+	for (i = 0; i < len; i++)
+		s->shift[pattern[i]] = len - i - 1;
+
+	// critical factorization: the longer of the two maximal suffixes
+	ms = memsearch_suffix(pattern, len, 0, &p);
+	ms2 = memsearch_suffix(pattern, len, 1, &p2);
+	if (ms2 + 1 > ms + 1)
+	{
+		ms = ms2;
+		p = p2;
+	}
+
+	if (ms + 1 + p <= len && 0 == memcmp(pattern, pattern + p, ms + 1))
+	{
+		s->period = p;
+		s->mem0 = len - p;
+	}
+	else
+	{
+		s->period = MAX(ms + 1, len - ms - 1) + 1;
+		s->mem0 = 0;
+	}
+	s->ms = ms;
+}
+
+static const uint8_t* memsearch_twoway(const struct memsearch_t* s, const uint8_t* h, size_t n)
+{
+	size_t k, mem;
+	const uint8_t* end;
+	const uint8_t* pattern;
+
+	mem = 0;
+	end = h + n;
+	pattern = s->pattern;
+	while ((size_t)(end - h) >= s->len)
+	{
+		// check the last byte first
+		k = s->shift[h[s->len - 1]];
+		if (k)
+		{
+			h += k < mem ? mem : k;
+			mem = 0;
+			continue;
+		}
+
+		// right half
+		for (k = MAX(s->ms + 1, mem); k < s->len && pattern[k] == h[k]; k++)
+		{
+		}
+
+		if (k < s->len)
+		{
+			h += k - s->ms;
+			mem = 0;
+			continue;
+		}
+
+		// left half
+		for (k = s->ms + 1; k > mem && pattern[k - 1] == h[k - 1]; k--)
+		{
+		}
+
+		if (k <= mem)
+			return h;
+
+		h += s->period;
+		mem = s->mem0;
+	}
+
+	return NULL;
+}
+
+static const uint8_t* memsearch_find_(const struct memsearch_t* s, const uint8_t* p, size_t n)
+{
+#if defined(MEMSEARCH_SSE2) || defined(MEMSEARCH_NEON)
+	size_t i;
+	const uint8_t* r;
+#endif
+
+	if (n < s->len)
+		return NULL;
+	if (1 == s->len)
+		return (const uint8_t*)memchr(p, s->pattern[0], n);
+#if defined(MEMSEARCH_SSE2) || defined(MEMSEARCH_NEON)
+	if (s->len <= MEMSEARCH_SHORT)
+		return memsearch_short(p, n, s->pattern, s->len);
+
+	r = memsearch_simd(p, n, s->pattern, s->len, &i);
+	if (r)
+		return r;
+	p += i;
+	n -= i;
+#endif
+	return memsearch_twoway(s, p, n);
+}
+
+const void* memsearch(const void* ptr, size_t bytes, const void* pattern, size_t len)
+{
+	struct memsearch_t s;
+#if defined(MEMSEARCH_SSE2) || defined(MEMSEARCH_NEON)
+	size_t i;
+	const uint8_t* r;
+#endif
+
+	if (0 == len)
+		return ptr;
+	if (bytes < len)
+		return NULL;
+	if (1 == len)
+		return memchr(ptr, *(const uint8_t*)pattern, bytes);
+#if defined(MEMSEARCH_SSE2) || defined(MEMSEARCH_NEON)
+	if (len <= MEMSEARCH_SHORT)
+		return memsearch_short((const uint8_t*)ptr, bytes, (const uint8_t*)pattern, len);
+
+	// compile Two-Way only if needed
+	r = memsearch_simd((const uint8_t*)ptr, bytes, (const uint8_t*)pattern, len, &i);
+	if (r)
+		return r;
+	ptr = (const uint8_t*)ptr + i;
+	bytes -= i;
+#endif
+
+	memsearch_compile(&s, (const uint8_t*)pattern, len);
+	return memsearch_twoway(&s, (const uint8_t*)ptr, bytes);
+}
+
+struct memsearch_t* memsearch_create(const void* pattern, size_t len)
+{
+	uint8_t* p;
+	struct memsearch_t* s;
+
+	if (0 == len)
+		return NULL;
+
+	s = (struct memsearch_t*)malloc(sizeof(*s) + len * 3);
+	if (!s)
+		return NULL;
+
+	p = (uint8_t*)(s + 1);
+	memcpy(p, pattern, len);
+	memsearch_compile(s, p, len);
+	s->carry = p + len;
+	memsearch_reset(s);
+	return s;
+}
+
+void memsearch_destroy(struct memsearch_t* s)
+{
+	if (s)
+		free(s);
+}
+
+const void* memsearch_find(const struct memsearch_t* s, const void* ptr, size_t bytes)
+{
+	return memsearch_find_(s, (const uint8_t*)ptr, bytes);
+}
+
+void memsearch_reset(struct memsearch_t* s)
+{
+	s->ncarry = 0;
+	s->offset = 0;
+}
+
+/// @return 0-ok, other-onmatch return value
+static int memsearch_foreach(const struct memsearch_t* s, const uint8_t* p, size_t n, size_t limit, int64_t offset, int (*onmatch)(void* param, int64_t offset), void* param)
+{
+	int r;
+	const uint8_t* ptr;
+	for (ptr = p; ptr < p + n; ptr++)
+	{
+		ptr = memsearch_find_(s, ptr, p + n - ptr);
+		if (!ptr || (size_t)(ptr - p) >= limit)
+			break;
+
+		r = onmatch(param, offset + (ptr - p));
+		if (0 != r)
+			return r;
+	}
+	return 0;
+}
+
+int memsearch_stream(struct memsearch_t* s, const void* ptr, size_t bytes, int (*onmatch)(void* param, int64_t offset), void* param)
+{
+	int r;
+	size_t n, keep;
+	const uint8_t* p;
+
+	r = 0;
+	p = (const uint8_t*)ptr;
+
+	// match across the previous chunk and this chunk: start in the carry bytes
+	n = bytes < s->len - 1 ? bytes : s->len - 1;
+	memcpy(s->carry + s->ncarry, p, n);
+	if (s->ncarry > 0)
+		r = memsearch_foreach(s, s->carry, s->ncarry + n, s->ncarry, s->offset - (int64_t)s->ncarry, onmatch, param);
+
+	if (0 == r)
+		r = memsearch_foreach(s, p, bytes, bytes, s->offset, onmatch, param);
+
+	// keep the last len-1 bytes
+	keep = s->len - 1;
+	if (bytes >= keep)
+	{
+		memcpy(s->carry, p + bytes - keep, keep);
+	}
+	else
+	{
+		keep = s->ncarry + bytes < keep ? s->ncarry + bytes : keep;
+		memmove(s->carry, s->carry + s->ncarry + bytes - keep, keep);
+	}
+	s->ncarry = keep;
+	s->offset += (int64_t)bytes;
+	return r;
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+static const uint8_t* memsearch_naive(const uint8_t* s, size_t n, const uint8_t* pattern, size_t len)
+{
+	size_t i;
+	for (i = 0; i + len <= n; i++)
+	{
+		if (0 == memcmp(s + i, pattern, len))
+			return s + i;
+	}
+	return NULL;
+}
+
+struct memsearch_test_t
+{
+	int64_t offsets[512];
+	int n;
+};
+
+static int memsearch_test_onmatch(void* param, int64_t offset)
+{
+	struct memsearch_test_t* t;
+	t = (struct memsearch_test_t*)param;
+	assert(t->n < (int)(sizeof(t->offsets) / sizeof(t->offsets[0])));
+	t->offsets[t->n++] = offset;
+	return 0;
+}
+
+void memsearch_test(void)
+{
+	int i, j, k;
+	size_t n, len, chunk;
+	uint8_t text[300], pattern[40];
+	const uint8_t *p1, *p2;
+	struct memsearch_t* s;
+	struct memsearch_test_t t;
+
+	assert(0 == memcmp("nanobano", memsearch("banananobano", 12, "nano", 4), 8));
+	assert(NULL == memsearch("banananobano", 12, "nanoo", 5));
+	p1 = (const uint8_t*)"banan\0nobano";
+	assert(p1 + 4 == memsearch(p1, 12, "n\0no", 4));
+	p1 = (const uint8_t*)"--boundary\r\n\0\0\xff--boundary--";
+	assert(p1 + 14 == memsearch(p1, 27, "\xff--boundary--", 13));
+
+	// differential test, small alphabet to make periodic patterns
+	srand(0x12345678);
+	for (i = 0; i < 20000; i++)
+	{
+		n = (size_t)(rand() % (int)sizeof(text));
+		len = 1 + (size_t)(rand() % (int)sizeof(pattern));
+		k = 2 + rand() % 3;
+		for (j = 0; j < (int)n; j++)
+			text[j] = (uint8_t)('a' + rand() % k);
+		for (j = 0; j < (int)len; j++)
+			pattern[j] = (uint8_t)('a' + rand() % k);
+		if (n > len && rand() % 2)
+			memcpy(text + rand() % (int)(n - len), pattern, len);
+
+		p1 = memsearch_naive(text, n, pattern, len);
+		p2 = (const uint8_t*)memsearch(text, n, pattern, len);
+		assert(p1 == p2);
+
+		s = memsearch_create(pattern, len);
+		p2 = (const uint8_t*)memsearch_find(s, text, n);
+		assert(p1 == p2);
+
+		// stream
+		memset(&t, 0, sizeof(t));
+		for (j = 0; j < (int)n; j += (int)chunk)
+		{
+			chunk = 1 + (size_t)(rand() % 48);
+			chunk = chunk < n - j ? chunk : n - j;
+			assert(0 == memsearch_stream(s, text + j, chunk, memsearch_test_onmatch, &t));
+		}
+		for (k = 0, p1 = memsearch_naive(text, n, pattern, len); p1; p1 = memsearch_naive(p1 + 1, text + n - p1 - 1, pattern, len))
+			assert(k < t.n && t.offsets[k++] == p1 - text);
+		assert(k == t.n);
+		memsearch_destroy(s);
+	}
+}
+#endif
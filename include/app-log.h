@@ -38,6 +38,22 @@ void app_log_setcolor(int enable);
 typedef void (*app_log_provider)(void* param, const char* prefix, const char* log, int n);
 void app_log_setprovider(app_log_provider provider, void* param);
 
+/// async mode: app_log only copy the format pointer and arguments(binary) into a lock-free ring,
+/// a background thread format and write the logs in batch(stdout/provider/syslog).
+/// 1. format MUST be a string literal(or live until the log is written), %s arguments are copied
+/// 2. provider is called by the background thread
+/// 3. log is dropped if the ring is full or exceed the rate limit, see app_log_async_dropped
+/// @param[in] bytes ring buffer size, 0-default(1MB)
+/// @param[in] rate max logs per second, 0-unlimited
+/// @return 0-ok, other-error
+int app_log_async_start(unsigned int bytes, int rate);
+
+/// write all pending logs and stop the background thread, back to sync mode
+void app_log_async_stop(void);
+
+/// @return dropped log count(ring full or rate limit)
+unsigned int app_log_async_dropped(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,40 @@ size_t base64_encode_url(char* target, const void *source, size_t bytes);
 /// @return target bytes
 size_t base64_decode(void* target, const char *source, size_t bytes);
 
+/// base64 streaming encoder/decoder, for large payload
+struct base64_encoder_t
+{
+	int url; // 1-"-_", 0-"+/"
+	int n; // tail bytes
+	unsigned char tail[3];
+};
+
+struct base64_decoder_t
+{
+	int n; // tail chars
+	int done; // 1-padding '=' found
+	unsigned char tail[4];
+};
+
+/// @param[in] url 1-same as base64_encode_url, 0-same as base64_encode
+void base64_encoder_init(struct base64_encoder_t* enc, int url);
+/// @param[out] target output string buffer, target size >= (bytes + 2) / 3 * 4
+/// @return target bytes
+size_t base64_encoder_update(struct base64_encoder_t* enc, char* target, const void *source, size_t bytes);
+/// flush the last group with padding
+/// @param[out] target output string buffer, target size >= 4
+/// @return target bytes
+size_t base64_encoder_finish(struct base64_encoder_t* enc, char* target);
+
+void base64_decoder_init(struct base64_decoder_t* dec);
+/// @param[out] target output binary buffer, target size >= (bytes + 3) / 4 * 3
+/// @return target bytes
+size_t base64_decoder_update(struct base64_decoder_t* dec, void* target, const char *source, size_t bytes);
+/// flush the last group(without padding)
+/// @param[out] target output binary buffer, target size >= 3
+/// @return target bytes
+size_t base64_decoder_finish(struct base64_decoder_t* dec, void* target);
+
 /// Base16(HEX) Encoding
 /// @return target bytes
 size_t base16_encode(char* target, const void *source, size_t bytes);
@@ -25,9 +25,45 @@ size_t bitmap_find_first_zero(const uint8_t* bitmap, size_t nbits);
 size_t bitmap_find_next_zero(const uint8_t* bitmap, size_t nbits, size_t start);
 size_t bitmap_weight(const uint8_t* bitmap, size_t nbits);
 
+/// @param[in] start first bit to check
+/// @return next set(1) bit index(>= start), nbits if not found
+size_t bitmap_next_set(const uint8_t* bitmap, size_t nbits, size_t start);
+/// @return next zero bit index(>= start), nbits if not found
+size_t bitmap_next_zero(const uint8_t* bitmap, size_t nbits, size_t start);
+
+/// for(bit in set bits), e.g. size_t bit; bitmap_for_each_set(bit, bitmap, nbits) { ... }
+#define bitmap_for_each_set(bit, bitmap, nbits) \
+	for ((bit) = bitmap_next_set(bitmap, nbits, 0); (bit) < (nbits); (bit) = bitmap_next_set(bitmap, nbits, (bit) + 1))
+#define bitmap_for_each_zero(bit, bitmap, nbits) \
+	for ((bit) = bitmap_next_zero(bitmap, nbits, 0); (bit) < (nbits); (bit) = bitmap_next_zero(bitmap, nbits, (bit) + 1))
+
 /// @return 0-not set, other-set to 1
 int bitmap_test_bit(const uint8_t* bitmap, size_t bits);
 
+/// hierarchical bitmap(64-ary summary tree) for id/slot allocation,
+/// find a zero bit in O(log64(n)) instead of scanning the whole bitmap. NOT thread-safe.
+struct hbitmap_t;
+
+/// @param[in] nbits bit count, all bits are zero
+/// @return NULL-out of memory or nbits is 0
+struct hbitmap_t* hbitmap_create(size_t nbits);
+void hbitmap_destroy(struct hbitmap_t* hb);
+
+size_t hbitmap_size(const struct hbitmap_t* hb);
+void hbitmap_set(struct hbitmap_t* hb, size_t bit);
+void hbitmap_clear(struct hbitmap_t* hb, size_t bit);
+/// @return 0-not set, 1-set
+int hbitmap_test_bit(const struct hbitmap_t* hb, size_t bit);
+
+/// @return zero bit index, nbits if all bits are set
+size_t hbitmap_find_first_zero(const struct hbitmap_t* hb);
+/// @return zero bit index(>= start), nbits if not found
+size_t hbitmap_find_next_zero(const struct hbitmap_t* hb, size_t start);
+
+/// find a zero bit from start(wrap around) and set it
+/// @return bit index, nbits if all bits are set
+size_t hbitmap_acquire(struct hbitmap_t* hb, size_t start);
+
 #if defined(__cplusplus)
 }
 #endif
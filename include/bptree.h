@@ -0,0 +1,70 @@
+#ifndef _bptree_h_
+#define _bptree_h_
+
+// In-memory B+tree ordered map(uint64_t key -> void* value)
+// 1. node is 256 bytes(4 cache lines), keys are packed together so a node search touch 1~2 lines,
+//    10M keys tree height is 6~7(vs ~24 levels pointer chasing of rbtree)
+// 2. values are stored in leaves only, leaves are linked for range scan and iteration
+// 3. binary keys(e.g. session id) can map to uint64_t(prefix/hash) with a collision list in the value
+// 4. NOT thread-safe, iterators are invalidated by insert/delete
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+struct bptree_t;
+
+struct bptree_iter_t
+{
+	void* leaf;
+	int pos;
+};
+
+/// @return NULL-out of memory
+struct bptree_t* bptree_create(void);
+void bptree_destroy(struct bptree_t* tree);
+
+size_t bptree_size(const struct bptree_t* tree);
+
+/// @return 0-ok, -EEXIST-key exist, -ENOMEM-out of memory
+int bptree_insert(struct bptree_t* tree, uint64_t key, void* value);
+
+/// @return 0-ok, -ENOENT-key not found
+/// @param[out] value key value, NULL if don't care
+int bptree_find(const struct bptree_t* tree, uint64_t key, void** value);
+
+/// @param[out] value deleted key value, NULL if don't care
+/// @return 0-ok, -ENOENT-key not found
+int bptree_delete(struct bptree_t* tree, uint64_t key, void** value);
+
+/// build tree from sorted keys, O(n) and leaves are full
+/// @param[in] keys strictly increasing keys
+/// @param[in] values key values, NULL-all values are NULL
+/// @return 0-ok, -EINVAL-tree is not empty or keys are unsorted, -ENOMEM-out of memory
+int bptree_bulk_load(struct bptree_t* tree, const uint64_t* keys, void* const* values, size_t n);
+
+/// scan keys in [from, to)
+/// @param[in] onscan return 0-continue, other-stop scan
+/// @return 0-ok, other-onscan return value
+typedef int (*bptree_onscan)(void* param, uint64_t key, void* value);
+int bptree_range(const struct bptree_t* tree, uint64_t from, uint64_t to, bptree_onscan onscan, void* param);
+
+/// iterator
+/// @return 0-ok, -ENOENT-no more key(iterator is invalid)
+int bptree_first(const struct bptree_t* tree, struct bptree_iter_t* it);
+int bptree_last(const struct bptree_t* tree, struct bptree_iter_t* it);
+/// first key >= key
+int bptree_lower_bound(const struct bptree_t* tree, uint64_t key, struct bptree_iter_t* it);
+int bptree_next(struct bptree_iter_t* it);
+int bptree_prev(struct bptree_iter_t* it);
+
+uint64_t bptree_iter_key(const struct bptree_iter_t* it);
+void* bptree_iter_value(const struct bptree_iter_t* it);
+
+#if defined(__cplusplus)
+}
+#endif
+#endif /* !_bptree_h_ */
@@ -1,27 +1,48 @@
 #ifndef _channel_h_
 #define _channel_h_
 
+// Bounded MPMC channel
+// 1. lock-free array queue(Dmitry Vyukov), per-slot sequence number, power-of-two capacity
+// 2. blocking operations spin first, then sleep on the channel waiter list(eventcount)
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
 struct channel_t;
 
+/// @param[in] capacity round up to power of 2
 struct channel_t* channel_create(int capacity, int elementsize);
 void channel_destroy(struct channel_t** pc);
 
 //void channel_clear(struct channel_t* c);
+/// @return element count(snapshot)
 int channel_count(struct channel_t* c);
 
 // block push/pop
 int channel_push(struct channel_t* c, const void* e);
 int channel_pop(struct channel_t* c, void* e);
 
-/// @param[in] timeout MS
+/// @param[in] timeout MS, 0-don't wait, <0-infinite
 /// @return 0-success, WAIT_TIMEOUT-timeout, other-error
 int channel_push_timeout(struct channel_t* c, const void* e, int timeout);
 int channel_pop_timeout(struct channel_t* c, void* e, int timeout);
 
+/// push/pop continuous elements, wait until at least one element is done
+/// @param[in] e element array
+/// @param[in] n max element count
+/// @param[in] timeout MS, 0-don't wait, <0-infinite
+/// @return >0-element count, 0-timeout, <0-error
+int channel_push_batch(struct channel_t* c, const void* e, int n, int timeout);
+int channel_pop_batch(struct channel_t* c, void* e, int n, int timeout);
+
+/// pop one element from the first ready channel, all channels MUST have the same element size
+/// @param[in] c channel array, max 64 channels
+/// @param[in] n channel count
+/// @param[in] timeout MS, 0-don't wait, <0-infinite
+/// @return >=0-channel index, -WAIT_TIMEOUT-timeout, other-error
+int channel_select(struct channel_t* c[], int n, void* e, int timeout);
+
 #if defined(__cplusplus)
 }
 #endif
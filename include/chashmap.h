@@ -0,0 +1,65 @@
+#ifndef _chashmap_h_
+#define _chashmap_h_
+
+// Concurrent hash map
+// 1. lock-striped shards(rwlock), shard selected by hash high bits
+// 2. per-shard open addressing table, SoA layout: control bytes + slots,
+//    probe 16 control bytes(7-bits hash tag) at once(SSE2/NEON), power-of-two masking
+// 3. variable-length key by user hash/equal callback,
+//    map only keep key/value pointer, key memory MUST be valid until removed(e.g. key is a member of value)
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct chashmap_t chashmap_t;
+
+struct chashmap_ops_t
+{
+	/// @return key hash value
+	uint32_t (*hash)(void* param, const void* key);
+
+	/// @return 1-equal, 0-not equal
+	int (*equal)(void* param, const void* key1, const void* key2);
+
+	/// optional, call with shard lock held when chashmap_get hit, use to hold value reference
+	void (*addref)(void* param, void* value);
+};
+
+/// @param[in] shards lock stripes, round up to power of 2, <=0-default(cpu count x 4)
+/// @param[in] ops user key hash/equal callback
+/// @return NULL if failed
+chashmap_t* chashmap_create(int shards, const struct chashmap_ops_t* ops, void* param);
+void chashmap_destroy(chashmap_t* map);
+
+/// @return value, NULL if not found
+void* chashmap_get(chashmap_t* map, const void* key);
+
+/// insert if key don't exist
+/// @return 0-ok, -EEXIST-key exist, -ENOMEM-out of memory
+int chashmap_insert(chashmap_t* map, const void* key, void* value);
+
+/// insert or replace
+/// @param[out] prev replaced value, NULL if key don't exist
+/// @return 0-ok, -ENOMEM-out of memory
+int chashmap_set(chashmap_t* map, const void* key, void* value, void** prev);
+
+/// @param[out] value removed value
+/// @return 0-ok, -ENOENT-not found
+int chashmap_remove(chashmap_t* map, const void* key, void** value);
+
+/// @return item count(snapshot)
+size_t chashmap_size(chashmap_t* map);
+
+/// iterate all items, shard by shard(hold shard read lock, don't modify map in callback)
+/// @param[in] fn return 0-continue, other-stop
+/// @return fn last return value
+int chashmap_foreach(chashmap_t* map, int (*fn)(void* param, const void* key, void* value), void* param);
+
+#if defined(__cplusplus)
+}
+#endif
+#endif /* !_chashmap_h_ */
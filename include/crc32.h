@@ -1,6 +1,38 @@
 #ifndef _crc32_h_
 #define _crc32_h_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// CRC-32/MPEG-2, result is byte-swapped
 unsigned int crc32(unsigned int crc, const unsigned char *buffer, unsigned int size);
 
+/// CRC-32/MPEG-2(MSB first), MUST call crc32_msb_init once before crc32_msb
+void crc32_msb_init(void);
+unsigned int crc32_msb(unsigned int crc, const unsigned char *buffer, unsigned int size);
+
+/// CRC-32(LSB first, same as zlib/PNG/STUN FINGERPRINT)
+/// @param[in] crc 0xFFFFFFFF for new message
+/// @return crc ^ 0xFFFFFFFF
+unsigned int crc32_lsb(unsigned int crc, const unsigned char *buffer, unsigned int size);
+void crc32_lsb_init(void); ///< deprecated, tables are generated at compile time
+
+/// CRC-32(LSB first) streaming, e.g. crc = crc32_lsb_update(0, buf1, n1); crc = crc32_lsb_update(crc, buf2, n2);
+/// @param[in] crc 0 for new message, or previous crc32_lsb_update return value
+/// @return CRC-32 of all data
+unsigned int crc32_lsb_update(unsigned int crc, const void* data, size_t bytes);
+
+/// crc32_lsb_update(crc32_lsb_update(0, A), B) = crc32_lsb_combine(crc32_lsb_update(0, A), crc32_lsb_update(0, B), len(B))
+/// @param[in] crc1 CRC-32 of the first part
+/// @param[in] crc2 CRC-32 of the second part
+/// @param[in] bytes2 second part length
+unsigned int crc32_lsb_combine(unsigned int crc1, unsigned int crc2, uint64_t bytes2);
+
+#ifdef __cplusplus
+}
+#endif
 #endif /* !_crc32_h_ */
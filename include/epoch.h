@@ -0,0 +1,58 @@
+#ifndef _epoch_h_
+#define _epoch_h_
+
+// Epoch-based memory reclamation for read-mostly shared data
+// 1. writer unlink node from the shared structure, then epoch_retire it,
+//    node destroy callback is called after all readers which might see it have gone
+// 2. EBR: reader wrap traversal with epoch_read_lock/epoch_read_unlock(nestable, a store and a fence)
+// 3. QSBR: thread call epoch_online once, then epoch_quiescent at the points without any shared reference(e.g. event loop),
+//    reader don't need read lock at all. aio_worker threads are online and report quiescent state every loop,
+//    aio_socket_process goes offline while blocked in the poll(epoll_wait/kevent/GetQueuedCompletionStatus).
+// 4. one process-wide epoch domain, thread register on first use and unregister on thread exit(pthread key/FLS destructor),
+//    epoch_thread_unregister release it early(e.g. flush retired nodes). RTOS has no exit hook, MUST call epoch_thread_unregister.
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+struct epoch_node_t
+{
+	struct epoch_node_t* next;
+	void (*destroy)(struct epoch_node_t* node);
+};
+
+/// register current thread, optional(register on first use)
+/// @return 0-ok, -ENOMEM-out of memory
+int epoch_thread_register(void);
+/// leave QSBR online state, wait and destroy all nodes retired by current thread.
+/// optional, called on thread exit automatically(except RTOS)
+void epoch_thread_unregister(void);
+
+/// enter/leave read-side critical section
+/// @return 0-ok, -ENOMEM-register thread failed(don't touch shared data)
+int epoch_read_lock(void);
+void epoch_read_unlock(void);
+
+/// QSBR: current thread is a reader until epoch_offline, don't block long time(hold back reclamation)
+/// @return 0-ok, -ENOMEM-register thread failed
+int epoch_online(void);
+/// QSBR: leave online state, e.g. before a blocking wait, the thread MUST NOT hold any shared reference
+/// @return 1-was online(call epoch_online after the wait), 0-not online
+int epoch_offline(void);
+
+/// QSBR: current thread don't hold any shared reference, and try to reclaim retired nodes
+void epoch_quiescent(void);
+
+/// deferred free, node MUST be unlinked(unreachable for new readers)
+/// @param[in] node embed in the retired object, see list_entry
+/// @param[in] destroy free callback, called by current thread(retire/quiescent/read_unlock/synchronize)
+void epoch_retire(struct epoch_node_t* node, void (*destroy)(struct epoch_node_t* node));
+
+/// wait for all pre-existing readers, then destroy nodes retired by current thread.
+/// MUST NOT be called in read-side critical section
+void epoch_synchronize(void);
+
+#if defined(__cplusplus)
+}
+#endif
+#endif /* !_epoch_h_ */
@@ -1,6 +1,8 @@
 #ifndef _heap_h_
 #define _heap_h_
 
+#include <stdint.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -29,6 +31,115 @@ void* heap_top(heap_t* heap);
 
 void* heap_get(heap_t* heap, int index);
 
+
+/// 4-ary min-heap of (key, ptr) pairs, keys are stored inline and compared directly,
+/// the 4 children of a node share one cache line.
+/// optional index tracking: the heap write the element position into an int field of ptr
+/// (e.g. struct timer_t { ...; int heap_index; }), so heap4_update/heap4_remove is O(log n)
+/// e.g. timer/scheduler queue: push on start, remove on cancel, pop on expire
+typedef struct heap4_t heap4_t;
+
+#define HEAP4_NO_INDEX (-1)
+
+/// @param[in] offset offset of int index field in ptr, e.g. offsetof(struct timer_t, heap_index), HEAP4_NO_INDEX-no index tracking
+heap4_t* heap4_create(int offset);
+void heap4_destroy(heap4_t* heap);
+
+/// @return 0-ok, other-error
+int heap4_reserve(heap4_t* heap, int size);
+int heap4_size(heap4_t* heap);
+int heap4_empty(heap4_t* heap);
+
+/// @return 0-ok, other-error
+int heap4_push(heap4_t* heap, int64_t key, void* ptr);
+/// @param[out] key min key, NULL if don't care
+/// @return ptr with min key, NULL if heap is empty
+void* heap4_top(heap4_t* heap, int64_t* key);
+/// remove the min key element, index field is set to HEAP4_NO_INDEX
+/// @return ptr, NULL if heap is empty
+void* heap4_pop(heap4_t* heap, int64_t* key);
+
+/// change the element key(increase or decrease)
+/// @param[in] index element position(from the index field)
+/// @return 0-ok, other-error
+int heap4_update(heap4_t* heap, int index, int64_t key);
+/// remove element, index field is set to HEAP4_NO_INDEX
+/// @param[in] index element position(from the index field)
+/// @return ptr, NULL if index is invalid
+void* heap4_remove(heap4_t* heap, int index);
+
+/// compile-time specialised 4-ary heap on a caller array(no function pointer compare)
+/// @param name function prefix: name##_push/name##_remove/name##_update/name##_up/name##_down
+/// @param type array element type
+/// @param less less(param, a, b) a, b: const type*, 1 if *a < *b
+/// @param setindex setindex(param, e, i) element e(type*) moved to position i, use HEAP4_SETINDEX_NONE if no index tracking
+/// usage:
+///   #define TIMER_LESS(param, a, b) ((*(a))->expire < (*(b))->expire)
+///   #define TIMER_INDEX(param, e, i) ((*(e))->index = (i))
+///   HEAP4_DEFINE(timer_heap, struct timer_t*, TIMER_LESS, TIMER_INDEX)
+///   n = timer_heap_push(timers, n, &timer, NULL); // timers[n] MUST be writable
+///   n = timer_heap_remove(timers, n, timer->index, NULL);
+#define HEAP4_SETINDEX_NONE(param, e, i) ((void)(param))
+
+#define HEAP4_DEFINE(name, type, less, setindex) \
+static inline void name##_up(type* h, int n, void* param) \
+{ \
+	int p; \
+	type v = h[n]; \
+	for (; n > 0; n = p) \
+	{ \
+		p = (n - 1) / 4; \
+		if (!less(param, &v, &h[p])) \
+			break; \
+		h[n] = h[p]; \
+		setindex(param, &h[n], n); \
+	} \
+	h[n] = v; \
+	setindex(param, &h[n], n); \
+} \
+static inline void name##_down(type* h, int size, int n, void* param) \
+{ \
+	int c, i, m; \
+	type v = h[n]; \
+	for (c = n * 4 + 1; c < size; c = n * 4 + 1) \
+	{ \
+		for (m = c, i = c + 1; i < c + 4 && i < size; i++) \
+		{ \
+			if (less(param, &h[i], &h[m])) \
+				m = i; \
+		} \
+		if (!less(param, &h[m], &v)) \
+			break; \
+		h[n] = h[m]; \
+		setindex(param, &h[n], n); \
+		n = m; \
+	} \
+	h[n] = v; \
+	setindex(param, &h[n], n); \
+} \
+static inline void name##_update(type* h, int size, int n, void* param) \
+{ \
+	if (n > 0 && less(param, &h[n], &h[(n - 1) / 4])) \
+		name##_up(h, n, param); \
+	else \
+		name##_down(h, size, n, param); \
+} \
+static inline int name##_push(type* h, int size, const type* v, void* param) \
+{ \
+	h[size] = *v; \
+	name##_up(h, size, param); \
+	return size + 1; \
+} \
+static inline int name##_remove(type* h, int size, int n, void* param) \
+{ \
+	if (n != --size) \
+	{ \
+		h[n] = h[size]; \
+		name##_update(h, size, n, param); \
+	} \
+	return size; \
+}
+
 #if defined(__cplusplus)
 }
 #endif
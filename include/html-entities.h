@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 /// Get HTML entities count
+/// Note: the table is the full HTML 4 entity set, 253 entries(was 12 before the perfect-hash lookup).
+/// The first 12 entries are unchanged, they are the entities html_entities_encode emits.
 /// @return html entities count
 int html_entities_count(void);
 
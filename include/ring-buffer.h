@@ -33,6 +33,83 @@ size_t ring_buffer_space(struct ring_buffer_t* rb);
 /// @return 0-ok, other-error
 int ring_buffer_resize(struct ring_buffer_t* rb, size_t capacity);
 
+
+/// single-producer/single-consumer lock-free byte ring
+/// producer: reserve -> write -> commit, consumer: peek -> read -> consume(zero-copy)
+struct ring_spsc_t
+{
+	uint8_t* ptr;
+	uint32_t capacity; // power of 2
+	int mirror; // 1-buffer mapped twice back-to-back
+
+	char padding0[64]; // avoid false sharing
+	volatile int32_t head; // write position, producer only
+	uint32_t tail_cache; // producer copy of tail
+
+	char padding1[64];
+	volatile int32_t tail; // read position, consumer only
+	uint32_t head_cache; // consumer copy of head
+	char padding2[64];
+};
+
+/// @param[in] capacity round up to power of 2(mirror: at least one page/allocation granularity), max 1G
+/// @param[in] mirror 1-map memory twice back-to-back, data across the buffer end is contiguous, 0-normal memory
+/// @return 0-ok, other-error
+int ring_spsc_alloc(struct ring_spsc_t* rb, size_t capacity, int mirror);
+int ring_spsc_free(struct ring_spsc_t* rb);
+
+/// producer: get contiguous free space
+/// @param[in,out] bytes in-minimum bytes(0-any), out-contiguous writable bytes(mirror: all free space)
+/// @return write pointer, NULL if contiguous free space less than minimum bytes
+void* ring_spsc_reserve(struct ring_spsc_t* rb, size_t* bytes);
+/// producer: publish written data
+/// @param[in] bytes written bytes, MUST <= reserved bytes
+void ring_spsc_commit(struct ring_spsc_t* rb, size_t bytes);
+
+/// consumer: get contiguous readable data
+/// @param[in,out] bytes in-minimum bytes(0-any), out-contiguous readable bytes(mirror: all data)
+/// @return read pointer, NULL if contiguous data less than minimum bytes
+const void* ring_spsc_peek(struct ring_spsc_t* rb, size_t* bytes);
+/// consumer: release read data
+/// @param[in] bytes read bytes, MUST <= peek bytes
+void ring_spsc_consume(struct ring_spsc_t* rb, size_t bytes);
+
+/// multi-producer/single-consumer lock-free record ring
+/// producers reserve records by CAS, commit in any order, consumer receive records in reserve order
+struct ring_mpsc_t
+{
+	uint8_t* ptr;
+	uint32_t capacity; // power of 2
+	int mirror;
+
+	char padding0[64];
+	volatile int32_t head; // reserve position, all producers
+
+	char padding1[64];
+	volatile int32_t tail; // read position, consumer only
+	char padding2[64];
+};
+
+/// @param[in] capacity round up to power of 2(mirror: at least one page/allocation granularity), max 1G
+/// @param[in] mirror 1-map memory twice back-to-back, record never split(no padding at buffer end)
+/// @return 0-ok, other-error
+int ring_mpsc_alloc(struct ring_mpsc_t* rb, size_t capacity, int mirror);
+int ring_mpsc_free(struct ring_mpsc_t* rb);
+
+/// producer: reserve a record(8-bytes header + payload, 8-bytes aligned)
+/// @return record payload pointer, NULL if ring is full
+void* ring_mpsc_reserve(struct ring_mpsc_t* rb, size_t bytes);
+/// producer: publish record
+/// @param[in] ptr ring_mpsc_reserve return value
+void ring_mpsc_commit(struct ring_mpsc_t* rb, void* ptr);
+
+/// consumer: get next record
+/// @param[out] bytes record payload bytes
+/// @return record payload pointer, NULL if ring is empty or the next record isn't committed
+const void* ring_mpsc_peek(struct ring_mpsc_t* rb, size_t* bytes);
+/// consumer: release the record returned by ring_mpsc_peek
+void ring_mpsc_consume(struct ring_mpsc_t* rb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -233,6 +233,13 @@ extern int SHA256Input(SHA256Context *, const uint8_t *bytes, unsigned int bytec
 extern int SHA256FinalBits(SHA256Context *, uint8_t bits, unsigned int bit_count);
 extern int SHA256Result(SHA256Context *, uint8_t Message_Digest[SHA256HashSize]);
 
+/*
+* Multi-buffer: hash n independent messages at once
+* (SHA-NI/ARMv8 one by one, AVX2 8 messages in parallel)
+*/
+extern int SHA1MultiBuffer(const uint8_t *messages[], const unsigned int lengths[], int n, uint8_t digests[][SHA1HashSize]);
+extern int SHA256MultiBuffer(const uint8_t *messages[], const unsigned int lengths[], int n, uint8_t digests[][SHA256HashSize]);
+
 /* SHA-384 */
 extern int SHA384Reset(SHA384Context *);
 extern int SHA384Input(SHA384Context *, const uint8_t *bytes, unsigned int bytecount);
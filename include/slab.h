@@ -0,0 +1,49 @@
+#ifndef _slab_h_
+#define _slab_h_
+
+// Fixed-size object cache(magazine allocator, J. Bonwick, "Magazines and Vmem", USENIX 2001)
+// 1. every thread has a home shard(two magazines of cached objects), alloc/free take only the shard lock.
+//    shards are assigned round-robin on first use and never recycled, threads may share a shard
+// 2. full/empty magazines are exchanged with the depot in batch, so objects freed by other threads
+//    flow back through the depot instead of a per-object cross-thread list
+// 3. objects are carved from 64KB chunks, memory is returned to the system by slab_destroy only
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+struct slab_t;
+
+struct slab_stats_t
+{
+	size_t size; // object size(aligned)
+	size_t chunks; // memory chunk count
+	size_t total; // objects carved from chunks
+	size_t inuse; // allocated objects
+	size_t cached; // objects in magazines/depot
+	uint64_t allocs;
+	uint64_t frees;
+};
+
+/// @param[in] size object size
+/// @return NULL-out of memory
+struct slab_t* slab_create(size_t size);
+/// all objects MUST be freed
+void slab_destroy(struct slab_t* slab);
+
+/// @return object(uninitialized), NULL-out of memory
+void* slab_alloc(struct slab_t* slab);
+/// @return zero-filled object, NULL-out of memory
+void* slab_calloc(struct slab_t* slab);
+/// free object to the cache of current thread, ptr can be NULL
+void slab_free(struct slab_t* slab, void* ptr);
+
+void slab_stats(struct slab_t* slab, struct slab_stats_t* stats);
+
+#if defined(__cplusplus)
+}
+#endif
+#endif /* !_slab_h_ */
@@ -556,4 +556,104 @@ static inline int atomic_cas_ptr(void* volatile *value, void *oldvalue, void *ne
 
 #endif /* OS_WINDOWS */
 
+//-------------------------------------------------------------------------------------
+// memory order(lock-free producer/consumer index publish)
+// int32_t atomic_load_acquire32(volatile int32_t *value)
+// void atomic_store_release32(volatile int32_t *value, int32_t newvalue)
+// void* atomic_load_acquire_ptr(void* volatile *value)
+// void atomic_store_release_ptr(void* volatile *value, void *newvalue)
+//-------------------------------------------------------------------------------------
+#if defined(_MSC_VER)
+#if defined(_M_IX86) || defined(_M_X64)
+	// x86/x64 TSO: plain load is acquire, plain store is release, only compiler barrier required
+	#define ATOMIC_BARRIER_ACQ_REL() _ReadWriteBarrier()
+#else
+	#define ATOMIC_BARRIER_ACQ_REL() MemoryBarrier()
+#endif
+
+static inline int32_t atomic_load_acquire32(volatile int32_t *value)
+{
+	int32_t v;
+	assert((intptr_t)value % 4 == 0);
+	v = *value;
+	ATOMIC_BARRIER_ACQ_REL();
+	return v;
+}
+
+static inline void atomic_store_release32(volatile int32_t *value, int32_t newvalue)
+{
+	assert((intptr_t)value % 4 == 0);
+	ATOMIC_BARRIER_ACQ_REL();
+	*value = newvalue;
+}
+
+static inline void* atomic_load_acquire_ptr(void* volatile *value)
+{
+	void* v;
+	v = *value;
+	ATOMIC_BARRIER_ACQ_REL();
+	return v;
+}
+
+static inline void atomic_store_release_ptr(void* volatile *value, void *newvalue)
+{
+	ATOMIC_BARRIER_ACQ_REL();
+	*value = newvalue;
+}
+
+#elif defined(__ATOMIC_ACQUIRE)
+static inline int32_t atomic_load_acquire32(volatile int32_t *value)
+{
+	assert((intptr_t)value % 4 == 0);
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_store_release32(volatile int32_t *value, int32_t newvalue)
+{
+	assert((intptr_t)value % 4 == 0);
+	__atomic_store_n(value, newvalue, __ATOMIC_RELEASE);
+}
+
+static inline void* atomic_load_acquire_ptr(void* volatile *value)
+{
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_store_release_ptr(void* volatile *value, void *newvalue)
+{
+	__atomic_store_n(value, newvalue, __ATOMIC_RELEASE);
+}
+
+#else
+static inline int32_t atomic_load_acquire32(volatile int32_t *value)
+{
+	int32_t v;
+	assert((intptr_t)value % 4 == 0);
+	v = *value;
+	__sync_synchronize();
+	return v;
+}
+
+static inline void atomic_store_release32(volatile int32_t *value, int32_t newvalue)
+{
+	assert((intptr_t)value % 4 == 0);
+	__sync_synchronize();
+	*value = newvalue;
+}
+
+static inline void* atomic_load_acquire_ptr(void* volatile *value)
+{
+	void* v;
+	v = *value;
+	__sync_synchronize();
+	return v;
+}
+
+static inline void atomic_store_release_ptr(void* volatile *value, void *newvalue)
+{
+	__sync_synchronize();
+	*value = newvalue;
+}
+#endif
+
 #endif /* !_platform_atomic_h_ */
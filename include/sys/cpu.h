@@ -0,0 +1,111 @@
+#ifndef _platform_cpu_h_
+#define _platform_cpu_h_
+
+// CPU feature detection for runtime SIMD dispatch
+// x86/x64: cpuid + xgetbv(OS saved YMM state)
+// ARM64: getauxval(AT_HWCAP)/IsProcessorFeaturePresent, NEON is mandatory
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define CPU_X86 1
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define CPU_ARM64 1
+	#if defined(_MSC_VER)
+		#include <Windows.h>
+	#elif defined(__linux__) || defined(__ANDROID__)
+		#include <sys/auxv.h>
+	#endif
+#endif
+
+enum
+{
+	// x86/x64
+	CPU_FEATURE_SSSE3	= 0x0001,
+	CPU_FEATURE_SSE41	= 0x0002,
+	CPU_FEATURE_PCLMUL	= 0x0004,
+	CPU_FEATURE_AVX2	= 0x0008,
+	CPU_FEATURE_SHA		= 0x0010, // SHA-1/SHA-256
+
+	// ARM64
+	CPU_FEATURE_NEON	= 0x0100,
+	CPU_FEATURE_PMULL	= 0x0200,
+	CPU_FEATURE_SHA1	= 0x0400,
+	CPU_FEATURE_SHA2	= 0x0800,
+
+	CPU_FEATURE_INIT	= 0x40000000,
+};
+
+static inline int cpu_features_detect(void)
+{
+	int flags = CPU_FEATURE_INIT;
+
+#if defined(CPU_X86)
+	unsigned int ecx1 = 0, ebx7 = 0, xcr0 = 0;
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuid(r, 0);
+	if (r[0] >= 1)
+	{
+		__cpuid(r, 1);
+		ecx1 = (unsigned int)r[2];
+	}
+	if (r[0] >= 7)
+	{
+		__cpuidex(r, 7, 0);
+		ebx7 = (unsigned int)r[1];
+	}
+	if (ecx1 & (1 << 27)) // OSXSAVE
+		xcr0 = (unsigned int)_xgetbv(0);
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0, max;
+	max = __get_cpuid_max(0, 0);
+	if (max >= 1 && __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		ecx1 = ecx;
+	if (max >= 7)
+	{
+		__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+		ebx7 = ebx;
+	}
+	if (ecx1 & (1 << 27)) // OSXSAVE
+		__asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+#endif
+	if (ecx1 & (1 << 9)) flags |= CPU_FEATURE_SSSE3;
+	if (ecx1 & (1 << 19)) flags |= CPU_FEATURE_SSE41;
+	if (ecx1 & (1 << 1)) flags |= CPU_FEATURE_PCLMUL;
+	if (ebx7 & (1 << 29)) flags |= CPU_FEATURE_SHA;
+	if ((ebx7 & (1 << 5)) && 0x6 == (xcr0 & 0x6)) flags |= CPU_FEATURE_AVX2; // YMM state enabled by OS
+
+#elif defined(CPU_ARM64)
+	flags |= CPU_FEATURE_NEON;
+	#if defined(__APPLE__)
+	flags |= CPU_FEATURE_PMULL | CPU_FEATURE_SHA1 | CPU_FEATURE_SHA2;
+	#elif defined(_MSC_VER)
+	if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE))
+		flags |= CPU_FEATURE_PMULL | CPU_FEATURE_SHA1 | CPU_FEATURE_SHA2;
+	#elif defined(__linux__) || defined(__ANDROID__)
+	{
+		unsigned long hwcap = getauxval(AT_HWCAP);
+		if (hwcap & (1 << 4)) flags |= CPU_FEATURE_PMULL; // HWCAP_PMULL
+		if (hwcap & (1 << 5)) flags |= CPU_FEATURE_SHA1; // HWCAP_SHA1
+		if (hwcap & (1 << 6)) flags |= CPU_FEATURE_SHA2; // HWCAP_SHA2
+	}
+	#endif
+#endif
+
+	return flags;
+}
+
+/// @return CPU_FEATURE_XXX flags
+static inline int cpu_features(void)
+{
+	static volatile int s_features = 0; // benign race, same value
+	if (0 == s_features)
+		s_features = cpu_features_detect();
+	return s_features;
+}
+
+#endif /* !_platform_cpu_h_ */
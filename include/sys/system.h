@@ -53,7 +53,9 @@ typedef void (*funcptr_t)(void);
 // void system_sleep(useconds_t millisecond);
 // uint64_t system_time(void);
 // uint32_t system_clock(void);
+// uint32_t system_clock_coarse(void);
 // int64_t system_getcyclecount(void);
+// int64_t system_getcyclefrequency(void);
 // size_t system_getcpucount(void);
 //
 // int system_version(int* major, int* minor);
@@ -132,18 +134,6 @@ static inline size_t system_getcpucount(void)
 #endif
 }
 
-static inline int64_t system_getcyclecount(void)
-{
-#if defined(OS_WINDOWS)
-	LARGE_INTEGER freq;
-	LARGE_INTEGER count;
-	QueryPerformanceCounter(&count);
-	QueryPerformanceFrequency(&freq);
-#else
-#endif
-	return 0;
-}
-
 /// milliseconds since the Epoch(1970-01-01 00:00:00 +0000 (UTC))
 static inline uint64_t system_time(void)
 {
@@ -209,6 +199,86 @@ static inline uint32_t system_clock(void)
 #endif
 }
 
+///@return milliseconds(relative time, same base as system_clock), cheap but low resolution(1~16ms), for timeout/expire
+static inline uint32_t system_clock_coarse(void)
+{
+#if defined(OS_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+	// vDSO, read the last tick time without the clock source
+	struct timespec tp;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &tp);
+	return (uint32_t)((uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000);
+#else
+	return system_clock();
+#endif
+}
+
+/// high-resolution counter(TSC/CNTVCT/QPC) for profiling, see system_getcyclefrequency
+static inline int64_t system_getcyclecount(void)
+{
+#if defined(OS_WINDOWS)
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+	return (int64_t)count.QuadPart;
+#elif defined(OS_MAC)
+	return (int64_t)mach_absolute_time();
+#elif defined(OS_RTOS)
+	return (int64_t)system_clock();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	uint32_t lo, hi;
+	__asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+	return (int64_t)(((uint64_t)hi << 32) | lo);
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+	uint64_t v;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+	return (int64_t)v;
+#else
+	struct timespec tp;
+	clock_gettime(CLOCK_MONOTONIC, &tp);
+	return (int64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+#endif
+}
+
+/// @return system_getcyclecount counts per second
+static inline int64_t system_getcyclefrequency(void)
+{
+#if defined(OS_WINDOWS)
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return (int64_t)freq.QuadPart;
+#elif defined(OS_MAC)
+	mach_timebase_info_data_t timebase;
+	mach_timebase_info(&timebase);
+	return (int64_t)(1000000000ULL * timebase.denom / timebase.numer);
+#elif defined(OS_RTOS)
+	return 1000;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	// invariant TSC, calibrate with the monotonic clock(10ms) once
+	static int64_t s_frequency;
+	int64_t t0, t1, c0, c1;
+	struct timespec tp;
+	if (0 == s_frequency)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &tp);
+		t0 = (int64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+		c0 = system_getcyclecount();
+		do
+		{
+			clock_gettime(CLOCK_MONOTONIC, &tp);
+			t1 = (int64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+		} while (t1 - t0 < 10000000);
+		c1 = system_getcyclecount();
+		s_frequency = (c1 - c0) * 1000000000 / (t1 - t0);
+	}
+	return s_frequency;
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+	uint64_t v;
+	__asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(v));
+	return (int64_t)v;
+#else
+	return 1000000000;
+#endif
+}
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable: 4996) // GetVersionEx
@@ -2,6 +2,8 @@
 #define _unicode_h_
 
 #include <wchar.h>
+#include <stdint.h>
+#include <stddef.h>
 
 #ifndef IN
 #define IN 
@@ -31,6 +33,39 @@ int unicode_to_utf8(IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, IN s
 /// @return תַ
 int unicode_from_utf8(IN const char* src, IN size_t srcLen, OUT wchar_t* tgt, IN size_t tgtBytes);
 
+/// UTF-8 validation(rfc3629: no overlong form, surrogate or code point > U+10FFFF)
+/// @return 0-valid, -1-invalid or incomplete sequence at end
+int utf8_validate(IN const char* src, IN size_t bytes);
+
+/// Incremental UTF-8 validator, sequence can be split by chunk boundary
+struct utf8_validator_t
+{
+	uint8_t tail[4]; // incomplete sequence of last chunk
+	int n;
+	int error;
+};
+
+void utf8_validator_init(struct utf8_validator_t* v);
+/// @return 0-valid so far, -1-invalid
+int utf8_validator_update(struct utf8_validator_t* v, IN const void* data, IN size_t bytes);
+/// @return 0-valid, -1-invalid or incomplete sequence at end
+int utf8_validator_finish(struct utf8_validator_t* v);
+
+/// UTF-8 -> UTF-16/UTF-32, no allocation, stop at incomplete sequence(source end) or target full
+/// @param[in] src utf-8 string, don't need '\0'
+/// @param[out] tgt target buffer, count in code units
+/// @param[out] consumed source bytes converted, caller keep remain bytes for next chunk, can be NULL
+/// @return target code units, -1-invalid source
+int utf8_to_utf16(IN const char* src, IN size_t bytes, OUT uint16_t* tgt, IN size_t count, OUT size_t* consumed);
+int utf8_to_utf32(IN const char* src, IN size_t bytes, OUT uint32_t* tgt, IN size_t count, OUT size_t* consumed);
+
+/// UTF-16/UTF-32 -> UTF-8, no allocation, stop at incomplete surrogate pair(source end) or target full
+/// @param[in] count source code units
+/// @param[out] consumed source code units converted, can be NULL
+/// @return target bytes, -1-invalid source(lone surrogate, code point > U+10FFFF)
+int utf16_to_utf8(IN const uint16_t* src, IN size_t count, OUT char* tgt, IN size_t bytes, OUT size_t* consumed);
+int utf32_to_utf8(IN const uint32_t* src, IN size_t count, OUT char* tgt, IN size_t bytes, OUT size_t* consumed);
+
 /// Unicodeַתɶַֽ(Windowsƽ̨Unicode UTF-16)
 /// @param[in] src Unicodeַ
 /// @param[in] srcLen ַ, nΪ0ʱתַ(ʱsrcַ'0'β)
@@ -65,6 +100,19 @@ int unicode_from_mbcs(IN const char* src, IN size_t srcLen, OUT wchar_t* tgt, IN
 /// @return
 //int unicode_decode(IN const char* charset, IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, IN size_t tgtBytes);
 
+/// GB18030 -> UTF-32/UTF-8, full GB18030-2005(1/2/4-bytes), no allocation,
+/// stop at incomplete sequence(source end) or target full
+/// @param[out] consumed source bytes converted, caller keep remain bytes for next chunk, can be NULL
+/// @return target code units, -1-invalid source
+int gb18030_to_utf32(IN const char* src, IN size_t bytes, OUT uint32_t* tgt, IN size_t count, OUT size_t* consumed);
+int gb18030_to_utf8(IN const char* src, IN size_t bytes, OUT char* tgt, IN size_t count, OUT size_t* consumed);
+
+/// UTF-32/UTF-8 -> GB18030, stop at incomplete sequence(source end) or target full
+/// @param[out] consumed source code units converted, can be NULL
+/// @return target bytes, -1-invalid source(surrogate, code point > U+10FFFF)
+int utf32_to_gb18030(IN const uint32_t* src, IN size_t count, OUT char* tgt, IN size_t bytes, OUT size_t* consumed);
+int utf8_to_gb18030(IN const char* src, IN size_t bytes, OUT char* tgt, IN size_t count, OUT size_t* consumed);
+
 #define unicode_to_gb2312 unicode_to_gb18030
 #define unicode_from_gb2312 unicode_from_gb18030
 #define unicode_to_gbk unicode_to_gb18030
@@ -30,6 +30,26 @@ struct uri_t* uri_parse(const char* uri, int len);
 /// @param[in] uri return by uri_parse
 void uri_free(struct uri_t* uri);
 
+/// URI components offset in the source uri string(no copy, no allocation), offset -1 if not present
+struct uri_view_t
+{
+	int scheme, n_scheme;
+	int userinfo, n_userinfo;
+	int host, n_host; // IPv6 address without "[]"
+	int port; // 0 if not present
+	int path, n_path; // -1 if no path(default "/")
+	int query, n_query; // without "?"
+	int fragment, n_fragment; // without "#"
+};
+
+/// URI tokenizer, same rules as uri_parse
+/// e.g. path: view.path < 0 ? "/" : std::string(uri + view.path, view.n_path)
+/// @param[in] uri Uniform Resource Identifier
+/// @param[in] len uri length
+/// @param[out] view components offset
+/// @return 0-ok, -1-invalid uri
+int uri_parse_view(const char* uri, int len, struct uri_view_t* view);
+
 /// uri path with query + fragment
 /// e.g. http://host:port/path?query#fragment --> path?query#fragment
 /// @return uri path length
@@ -46,10 +66,20 @@ struct uri_query_t
 	int n_value;
 };
 
+/// parse query string "k1=v1&k2&k3=v3"
+/// @param[out] items name/value pointer to query string, free by uri_query_free
+/// @return item count, -1-invalid(no-name), -ENOMEM-out of memory
 int uri_query(const char* query, const char* end, struct uri_query_t** items);
 
 void uri_query_free(struct uri_query_t** items);
 
+/// query string tokenizer, no allocation
+/// usage: for (p = query; 1 == (r = uri_query_next(&p, end, &item)); ) { ... }
+/// @param[in,out] query in-current position, out-next item position
+/// @param[out] item name/value pointer to query string, value NULL if no-value(e.g. "k1&k2")
+/// @return 1-item, 0-end, -1-invalid(no-name)
+int uri_query_next(const char** query, const char* end, struct uri_query_t* item);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,10 +22,11 @@ public:
 		n = unicode_from_mbcs(mbcs, n, wbuf, sizeof(wchar_t)*n);
 		if(n > 0)
 		{
-			m_p = new char[(n + 1) * 4];
+			m_p = Alloc((n + 1) * 4);
 			memset(m_p, 0, (n + 1) * 4);
 			unicode_to_utf8(wbuf, n, m_p, (n + 1) * 4);
 		}
+		delete[] wbuf;
 	}
 
 	// from unicode
@@ -34,7 +35,7 @@ public:
 		assert(unicode);
 		m_null[0] = 0;
 		int n = wcslen(unicode) + 1;
-		m_p = new char[n * 4];
+		m_p = Alloc(n * 4);
 		memset(m_p, 0, n * 4);
 		unicode_to_utf8(unicode, n, m_p, n * 4);
 	}
@@ -46,8 +47,8 @@ public:
 		if(0==strcasecmp("utf-8", encoding) || 0==strcasecmp("utf8", encoding))
 		{
 			int n = strlen(text) + 1;
-			m_p = new char[n];
-			strcpy(m_p, text);
+			m_p = Alloc(n);
+			memcpy(m_p, text, n);
 		}
 		else if(0==strcasecmp("gbk", encoding) || 0==strcasecmp("gb2312", encoding) || 0==strcasecmp("gb18030", encoding))
 		{
@@ -56,7 +57,7 @@ public:
 			n = unicode_from_gb18030(text, n, wbuf, sizeof(wchar_t)*n);
 			if(n > 0)
 			{
-				m_p = new char[(n + 1) * 4];
+				m_p = Alloc((n + 1) * 4);
 				memset(m_p, 0, (n + 1) * 4);
 				unicode_to_utf8(wbuf, n, m_p, (n + 1) * 4);
 			}
@@ -70,7 +71,7 @@ public:
 
 	~UTF8Encode()
 	{
-		if(m_p)
+		if(m_p && m_p != m_buf)
 			delete[] m_p;
 	}
 
@@ -79,9 +80,17 @@ public:
 		return m_p ? m_p : m_null;
 	}
 
+private:
+	// short string use inline buffer, don't hit heap
+	char* Alloc(size_t n)
+	{
+		return n <= sizeof(m_buf) ? m_buf : new char[n];
+	}
+
 private:
 	char* m_p;
 	char   m_null[1];
+	char   m_buf[256];
 };
 
 class UTF8Decode
@@ -91,7 +100,7 @@ public:
 	{
 		assert(utf8);
 		size_t n = strlen(utf8) + 1;
-		m_pw = new wchar_t[n];
+		m_pw = n <= sizeof(m_wbuf) / sizeof(m_wbuf[0]) ? m_wbuf : new wchar_t[n];
 		memset(m_pw, 0, sizeof(wchar_t) * n);
 		unicode_from_utf8(utf8, n, m_pw, sizeof(wchar_t) * n);
 	}
@@ -100,7 +109,7 @@ public:
 	{
 		if(m_pc)
 			delete[] m_pc;
-		if(m_pw)
+		if(m_pw && m_pw != m_wbuf)
 			delete[] m_pw;
 	}
 
@@ -143,6 +152,7 @@ public:
 private:
 	char* m_pc;
 	wchar_t* m_pw;
+	wchar_t m_wbuf[64];
 };
 
 #endif /* !_utf8_h_ */
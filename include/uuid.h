@@ -26,22 +26,12 @@ static inline void uuid_generate(char s[37])
 
 #else
 
+/// random(version 4) uuid from per-thread CSPRNG(read_random)
 void uuid_generate_simple(char s[37]);
 
 static inline void uuid_generate(char s[37])
 {
-	FILE* fp;
-	fp = fopen("/proc/sys/kernel/random/uuid", "r");
-	if (fp)
-	{
-		s[36] = '\0';
-		fread(s, 1, 36, fp);
-		fclose(fp);
-	}
-	else
-	{
-		uuid_generate_simple(s);
-	}
+	uuid_generate_simple(s);
 }
 #endif
 
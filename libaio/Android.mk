@@ -12,6 +12,8 @@ LOCAL_SRC_FILES += $(wildcard src/*.c)
 LOCAL_SRC_FILES += $(wildcard src/*.cpp)
 LOCAL_SRC_FILES += ../source/port/aio-socket-epoll.c
 LOCAL_SRC_FILES += ../source/twtimer.c
+LOCAL_SRC_FILES += ../source/epoch.c
+LOCAL_SRC_FILES += ../source/slab.c
 
 LOCAL_MODULE := aio
 include $(BUILD_SHARED_LIBRARY)
@@ -11,7 +11,7 @@ static onetime_t s_init = ONETIME_INIT;
 
 static void aio_timeout_init(void)
 {
-	s_timer = time_wheel_create(system_clock());
+	s_timer = time_wheel_create(system_clock_coarse());
 }
 
 static void aio_timeout_clean(void)
@@ -28,7 +28,7 @@ void aio_timeout_process(void)
 {
 	onetime_exec(&s_init, aio_timeout_init);
 
-	twtimer_process(s_timer, system_clock());
+	twtimer_process(s_timer, system_clock_coarse());
 }
 
 int aio_timeout_start(struct aio_timeout_t* timeout, int timeoutMS, void (*notify)(void* param), void* param)
@@ -41,7 +41,7 @@ int aio_timeout_start(struct aio_timeout_t* timeout, int timeoutMS, void (*notif
 
 	timer->param = param;
 	timer->ontimeout = notify;
-	timer->expire = system_clock() + (uint32_t)timeoutMS;
+	timer->expire = system_clock_coarse() + (uint32_t)timeoutMS;
 	return twtimer_start(s_timer, timer);
 }
 
@@ -1,6 +1,7 @@
 #include "aio-worker.h"
 #include "aio-socket.h"
 #include "aio-timeout.h"
+#include "epoch.h"
 #include "sys/thread.h"
 #include <stdio.h>
 #include <errno.h>
@@ -14,6 +15,10 @@ static int STDCALL aio_worker(void* param)
 {
 	int i = 0, r = 0;
 	int idx = (int)(intptr_t)param;
+
+	// QSBR: callbacks can traverse epoch protected data without read lock,
+	// aio_socket_process goes offline while blocked in the poll, so an idle worker doesn't hold back the grace period
+	epoch_online();
 	while (s_running && (r >= 0 || EINTR == errno || EAGAIN == errno)) // ignore epoll EINTR
 	{
 		r = aio_socket_process(idx ? 2000 : 64);
@@ -22,8 +27,12 @@ static int STDCALL aio_worker(void* param)
 			i = 0;
 			aio_timeout_process();
 		}
+
+		epoch_quiescent();
 	}
 
+	epoch_thread_unregister();
+
 	printf("%s[%d] exit => %d.\n", __FUNCTION__, idx, errno);
 	return 0;
 }
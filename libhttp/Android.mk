@@ -7,10 +7,13 @@ LOCAL_LDLIBS +=
 LOCAL_C_INCLUDES := $(LOCAL_PATH)
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/include
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../algorithm
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../libaio/include
 
 LOCAL_SRC_FILES += $(wildcard source/*.c)
 LOCAL_SRC_FILES += $(wildcard source/*.cpp)
+LOCAL_SRC_FILES += ../algorithm/memsearch.c
+LOCAL_SRC_FILES += ../algorithm/aho-corasick.c
 
 LOCAL_MODULE := http
 include $(BUILD_STATIC_LIBRARY)
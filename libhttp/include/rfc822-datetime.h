@@ -11,6 +11,9 @@ typedef char rfc822_datetime_t[30];
 
 const char* rfc822_datetime_format(time_t time, rfc822_datetime_t datetime);
 
+/// current time, formatted once per second(per thread), e.g. HTTP Date header
+const char* rfc822_datetime_now(rfc822_datetime_t datetime);
+
 #ifdef __cplusplus
 }
 #endif
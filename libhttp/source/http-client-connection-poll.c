@@ -82,7 +82,7 @@ static int http_poll_transport_dosend(struct http_poll_transport_t* tcp)
 #endif
         r = socket_send_v(tcp->socket, tcp->send.vec, tcp->send.count, 0);
 
-    now = system_clock();
+    now = system_clock_coarse();
     if (r <= 0)
     {
         tcp->send.onsend(tcp->send.param, r <= 0 ? r : -ETIMEDOUT);
@@ -134,7 +134,7 @@ static int http_poll_transport_dorecv(struct http_poll_transport_t* tcp)
 #endif
         r = socket_recv(tcp->socket, tcp->buf, tcp->cap, 0);
 
-    now = system_clock();
+    now = system_clock_coarse();
     if (r >= 0 || now - tcp->recv.clock >= tcp->recv_timeout)
     {
         tcp->recv.onrecv(tcp->recv.param, r >= 0 ? 0 : -ETIMEDOUT, tcp->buf, r);
@@ -169,7 +169,7 @@ static int http_poll_transport_onconnect(void* c, int event)
     struct http_poll_transport_priv_t* priv;
     tcp = (struct http_poll_transport_t*)c;
     
-    now = system_clock();
+    now = system_clock_coarse();
     if (0 == tcp->connected)
     {
         r = socket_select_connect(tcp->socket, 0);
@@ -293,7 +293,7 @@ static int http_poll_transport_connect(struct http_poll_transport_t* tcp)
     struct http_poll_transport_priv_t* priv;
 
     assert(0 == tcp->connected);
-    tcp->send.clock = system_clock();
+    tcp->send.clock = system_clock_coarse();
 
     // check connection
     if (socket_invalid != tcp->socket && 1 == socket_readable(tcp->socket))
@@ -395,7 +395,7 @@ static int http_poll_transport_recv(void* c, void (*onrecv)(void* param, int cod
 {
     struct http_poll_transport_t* tcp;
     tcp = (struct http_poll_transport_t*)c;
-    tcp->recv.clock = system_clock();
+    tcp->recv.clock = system_clock_coarse();
     tcp->recv.onrecv = onrecv;
     tcp->recv.param = param;
     if (0 == tcp->connected)
@@ -415,7 +415,7 @@ static int http_poll_transport_send(void* c, const char* req, int nreq, const vo
     tcp->send.count = bytes > 0 ? 2 : 1;
     tcp->send.onsend = onsend;
     tcp->send.param = param;
-    tcp->send.clock = system_clock();
+    tcp->send.clock = system_clock_coarse();
     return 1 != tcp->connected ? http_poll_transport_connect(tcp) : http_poll_transport_dosend(tcp);
 }
 
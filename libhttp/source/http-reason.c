@@ -7,7 +7,7 @@ const char* http_reason_phrase(int code)
 	static const char *reason1xx[] = 
 	{
 		"Continue", // 100
-		"Switching Protocols" // 101
+		"Switching Protocols", // 101
 		"Processing", // 102-RFC2518 Section 10.1
 		"Early Hints", // 103-RFC8297
 	};
@@ -4,46 +4,77 @@
 #include "http-route.h"
 #include "http-server-internal.h"
 #include "urlcodec.h"
+#include "unicode.h"
+#include "epoch.h"
+#include "sys/atomic.h"
 
-struct http_server_route_t
+// copy-on-write route table: update copy the whole table and publish it,
+// reader traverse the snapshot in epoch read-side critical section
+struct http_server_route_t : public epoch_node_t
 {
 	typedef std::pair<std::string, http_server_handler> http_route_t;
 	std::vector<http_route_t> handlers;
 };
 
-static http_server_route_t& http_server_get_route()
-{
-	static http_server_route_t router;
-	return router;
-}
+static void* volatile s_router; // http_server_route_t*
 
 static bool http_route_cmp(const http_server_route_t::http_route_t& l, const http_server_route_t::http_route_t& r)
 {
 	return l.first.length() < r.first.length();
 }
 
-int http_server_addroute(const char* path, http_server_handler handler)
+static void http_route_destroy(struct epoch_node_t* node)
 {
-	http_server_route_t& router = http_server_get_route();
-	router.handlers.push_back(std::make_pair(path, handler));
-	std::sort(router.handlers.begin(), router.handlers.end(), http_route_cmp);
-	return 0;
+	delete static_cast<http_server_route_t*>(node);
 }
 
-int http_server_delroute(const char* path)
+/// @param[in] handler NULL-delete route
+static int http_server_update_route(const char* path, http_server_handler handler)
 {
-	http_server_route_t& router = http_server_get_route();
+	http_server_route_t *router, *update;
 	std::vector<http_server_route_t::http_route_t>::iterator it;
-	for (it = router.handlers.begin(); it != router.handlers.end(); ++it)
+
+	for (;;)
 	{
-		if (it->first == path)
+		router = (http_server_route_t*)atomic_load_acquire_ptr(&s_router);
+		update = router ? new http_server_route_t(*router) : new http_server_route_t();
+		if (handler)
 		{
-			router.handlers.erase(it);
-			return 0;
+			update->handlers.push_back(std::make_pair(path, handler));
+			std::sort(update->handlers.begin(), update->handlers.end(), http_route_cmp);
 		}
+		else
+		{
+			for (it = update->handlers.begin(); it != update->handlers.end() && it->first != path; ++it)
+			{
+			}
+
+			if (it == update->handlers.end())
+			{
+				delete update;
+				return -1; // not found
+			}
+			update->handlers.erase(it);
+		}
+
+		if (atomic_cas_ptr(&s_router, router, update))
+			break;
+		delete update; // updated by other thread, try again
 	}
 
-	return -1; // not found
+	if (router)
+		epoch_retire(router, http_route_destroy);
+	return 0;
+}
+
+int http_server_addroute(const char* path, http_server_handler handler)
+{
+	return http_server_update_route(path, handler);
+}
+
+int http_server_delroute(const char* path)
+{
+	return http_server_update_route(path, NULL);
 }
 
 int http_server_route(void* http, http_session_t* session, const char* method, const char* path)
@@ -53,21 +84,35 @@ int http_server_route(void* http, http_session_t* session, const char* method, c
 	url_decode(path, -1, reqpath, sizeof(reqpath));
 	//uri_free(uri);
 
-	//UTF8Decode utf8(reqpath);
+	// percent-decoded path MUST be valid UTF-8(rfc3986 3.3), reject overlong '/' or '.' such as %C0%AF
+	if (0 != utf8_validate(reqpath, strlen(reqpath)))
+	{
+		http_server_set_status_code(session, 400, NULL);
+		return http_server_send(session, "", 0, NULL, NULL);
+	}
+
 	// TODO: path resolve to fix /rootpath/../pathtosystem -> /pathtosystem
 	//path_resolve(buffer, sizeof(buffer), utf8, CWD, strlen(CWD));
 	//path_realpath(buffer, live->path);
 
-	http_server_route_t& router = http_server_get_route();
-	std::vector<http_server_route_t::http_route_t>::iterator it;
-	for (it = router.handlers.begin(); it != router.handlers.end(); ++it)
+	if (0 != epoch_read_lock())
 	{
-		if (0 == strncmp(it->first.c_str(), reqpath, it->first.length()))
-		{
-			return it->second(http, session, method, reqpath);
-		}
+		http_server_set_status_code(session, 500, NULL);
+		return http_server_send(session, "", 0, NULL, NULL);
 	}
 
+	http_server_handler handler = NULL;
+	http_server_route_t* router = (http_server_route_t*)atomic_load_acquire_ptr(&s_router);
+	for (size_t i = 0; router && i < router->handlers.size() && !handler; i++)
+	{
+		if (0 == strncmp(router->handlers[i].first.c_str(), reqpath, router->handlers[i].first.length()))
+			handler = router->handlers[i].second;
+	}
+	epoch_read_unlock();
+
+	if (handler)
+		return handler(http, session, method, reqpath);
+
 	http_server_set_status_code(session, 404, NULL);
 	return http_server_send(session, "", 0, NULL, NULL);
 }
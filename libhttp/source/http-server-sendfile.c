@@ -204,7 +204,7 @@ static int http_session_range(struct http_sendfile_t* sendfile)
 
 		// add Date header
 		rfc822_datetime_t datetime;
-		rfc822_datetime_format(time(NULL), datetime);
+		rfc822_datetime_now(datetime);
 		http_server_set_header(sendfile->session, "Date", datetime);
 
 		// TODO: add cache control here
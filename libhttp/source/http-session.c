@@ -171,6 +171,11 @@ static void http_session_onrecv(void* param, int code, size_t bytes)
 				session->server->wshandler.ondata(session->wsupgrade, code > 0 ? -code : code, NULL, 0, 0);
 			}
 		}
+		else if (-EILSEQ == code)
+		{
+			// rfc6455 8.1. fail the connection(close code 1007)
+			session->server->wshandler.ondata(session->wsupgrade, code, NULL, 0, 0);
+		}
 
 		return;
 	}
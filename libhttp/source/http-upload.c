@@ -1,4 +1,5 @@
 #include "http-upload.h"
+#include "algorithm.h"
 #include <string.h>
 #include <assert.h>
 
@@ -127,34 +128,25 @@ static int http_upload_header_parse(const char* header, char* field, char* file)
 	return 0;
 }
 
-static const char* memstr(const char* s, const char* substring, size_t n)
-{
-	const char* pe = s + n;
-	const char* p = strstr(s, substring);
-	while(!p)
-	{
-		size_t l = strlen(s);
-		s += l + 1;
-		if(s >= pe)
-			return NULL;
-		p = strstr(s, substring);
-	}
-	return p;
-}
-
 int http_get_upload_data(const void* data, unsigned int size, const char* boundary, on_http_upload_data ondata, void* cbparam)
 {
 	// Returning Values from Forms:  multipart/form-data
 	// http://www.faqs.org/rfcs/rfc2388.html
 
-	const char *p, *pbody;
+	size_t n;
+	const char *p, *pbody, *end;
 	char field[128], file[256];
 
-	p = memstr((const char*)data, boundary, size);
+	n = strlen(boundary);
+	end = (const char*)data + size;
+	p = (const char*)memsearch(data, size, boundary, n);
 	while(p)
 	{
-		p += strlen(boundary) + 2; // skip \r\n
-		pbody = strstr(p, "\r\n\r\n");
+		p += n + 2; // skip \r\n
+		if(p >= end)
+			break;
+
+		pbody = (const char*)memsearch(p, end - p, "\r\n\r\n", 4);
 		if(!pbody)
 			break;
 
@@ -165,7 +157,7 @@ int http_get_upload_data(const void* data, unsigned int size, const char* bounda
 			return -1;
 
 		pbody += 4;
-		p = memstr(pbody, boundary, (const char*)data+size-pbody);
+		p = (const char*)memsearch(pbody, end - pbody, boundary, n);
 		if(p)
 		{
 			assert(p-pbody > 4);
@@ -2,6 +2,7 @@
 #define _http_websocket_internal_h_
 
 #include "http-websocket.h"
+#include "unicode.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -36,11 +37,14 @@ struct websocket_parser_t
 	uint64_t len;
 	uint64_t capacity;
 	uint64_t max_capacity;
+
+	struct utf8_validator_t utf8; // rfc6455 8.1. text message MUST be valid UTF-8
 };
 
 typedef int (*websocket_parser_handler)(void* param, int opcode, const void* data, size_t bytes, int flags);
 
 /// @param[in] data raw data, don't with const, maybe use as unmasking
+/// @return 0-ok, -EILSEQ-invalid UTF-8 text message, other-handler return value
 int websocket_parser_input(struct websocket_parser_t* parser, uint8_t* data, size_t bytes, websocket_parser_handler handler, void* param);
 
 int websocket_parser_destroy(struct websocket_parser_t* parser);
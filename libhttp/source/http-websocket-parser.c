@@ -134,6 +134,8 @@ int websocket_parser_input(struct websocket_parser_t* parser, uint8_t* data, siz
 
 				if (parser->len == parser->header.len)
 				{
+					if (WEBSOCKET_OPCODE_TEXT == parser->header.opcode && 0 != utf8_validate((const char*)parser->ptr, (size_t)parser->header.len))
+						return -EILSEQ;
 					r = handler(param, parser->header.opcode, parser->ptr, parser->header.len, WEBSOCKET_FLAGS_START | WEBSOCKET_FLAGS_FIN);
 					websocket_parser_reset(parser);
 				}
@@ -152,6 +154,14 @@ int websocket_parser_input(struct websocket_parser_t* parser, uint8_t* data, siz
 
 				flags = parser->header.opcode > 0 && 0 == parser->len ? WEBSOCKET_FLAGS_START : 0;
 				flags |= parser->header.fin && (parser->len + len >= parser->header.len) ? WEBSOCKET_FLAGS_FIN : 0;
+				if (WEBSOCKET_OPCODE_TEXT == parser->header_opcode && parser->header.opcode < WEBSOCKET_OPCODE_CLOSE)
+				{
+					// fragmented text message, UTF-8 sequence maybe split by frame/chunk
+					if (flags & WEBSOCKET_FLAGS_START)
+						utf8_validator_init(&parser->utf8);
+					if (0 != utf8_validator_update(&parser->utf8, data + off, (size_t)len) || ((flags & WEBSOCKET_FLAGS_FIN) && 0 != utf8_validator_finish(&parser->utf8)))
+						return -EILSEQ;
+				}
 				r = handler(param, parser->header_opcode /*frame type*/, data + off, len, flags);
 				parser->len += len;
 				off += len;
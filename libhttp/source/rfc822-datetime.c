@@ -1,8 +1,17 @@
 #include "rfc822-datetime.h"
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <time.h>
 
+#if defined(_WIN32) || defined(_WIN64) || defined(OS_WINDOWS)
+#define THREAD_LOCAL static __declspec(thread)
+#elif defined(OS_LINUX) || defined(OS_MAC)
+#define THREAD_LOCAL static __thread
+#else
+#define THREAD_LOCAL static
+#endif
+
 // Tue, 15 Nov 1994 08:12:31 GMT
 // 23 Jan 1997 15:35:06 GMT
 /*
@@ -56,7 +65,15 @@ static const char* s_zone[] = {
 const char* rfc822_datetime_format(time_t time, rfc822_datetime_t datetime)
 {
 	int r;
-	struct tm *tm = gmtime(&time);
+	struct tm *tm, t;
+#if defined(_WIN32) || defined(_WIN64) || defined(OS_WINDOWS)
+	tm = 0 == gmtime_s(&t, &time) ? &t : NULL;
+#else
+	tm = gmtime_r(&time, &t);
+#endif
+	if (!tm)
+		return NULL;
+
 	assert(0 <= tm->tm_wday && tm->tm_wday < 7);
 	assert(0 <= tm->tm_mon && tm->tm_mon < 12);
 	assert(sizeof(rfc822_datetime_t) >= 30);
@@ -71,6 +88,24 @@ const char* rfc822_datetime_format(time_t time, rfc822_datetime_t datetime)
 	return r > 0 && r < sizeof(rfc822_datetime_t) ? datetime : NULL;
 }
 
+const char* rfc822_datetime_now(rfc822_datetime_t datetime)
+{
+	time_t now;
+	THREAD_LOCAL time_t s_time = -1;
+	THREAD_LOCAL rfc822_datetime_t s_datetime;
+
+	now = time(NULL);
+	if (now != s_time)
+	{
+		if (!rfc822_datetime_format(now, s_datetime))
+			return NULL;
+		s_time = now;
+	}
+
+	memcpy(datetime, s_datetime, sizeof(rfc822_datetime_t));
+	return datetime;
+}
+
 //time_t datetime_parse(const char* datetime)
 //{
 //	return 0;
@@ -47,6 +47,15 @@ const stun_message_t* stun_request_getmessage(const stun_request_t* req);
 /// @param[in] timeout ms
 void stun_request_settimeout(stun_request_t* req, int timeout);
 
+struct stun_packet_t
+{
+	int protocol; // STUN_PROTOCOL_UDP/STUN_PROTOCOL_TCP/STUN_PROTOCOL_XXX
+	const struct sockaddr* local;
+	const struct sockaddr* remote;
+	const void* data;
+	int bytes;
+};
+
 struct stun_agent_handler_t
 {
 	/// UDP/TURN data callback
@@ -78,6 +87,11 @@ struct stun_agent_handler_t
 	int (*onrefresh)(void* param, stun_response_t* resp, const stun_request_t* req, int lifetime);
 	int (*onpermission)(void* param, stun_response_t* resp, const stun_request_t* req, const struct sockaddr* peer);
 	int (*onchannel)(void* param, stun_response_t* resp, const stun_request_t* req, const struct sockaddr* peer, uint16_t channel);
+
+	/// OPTIONAL, TURN server relay data batch send(e.g. sendmmsg), NULL-use send one by one
+	/// @param[in] pkts packets data/address valid only in callback
+	/// @return 0-ok, other-error
+	int (*sendmmsg)(void* param, const struct stun_packet_t* pkts, int n);
 };
 
 stun_agent_t* stun_agent_create(int rfc, struct stun_agent_handler_t* handler, void* param);
@@ -89,6 +103,11 @@ int stun_agent_destroy(stun_agent_t** stun);
 /// @return 0-ok, other-error
 int stun_agent_input(stun_agent_t* stun, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes);
 
+/// batch input(e.g. recvmmsg), TURN server relay data(ChannelData/SEND indication/peer data)
+/// forward by handler.sendmmsg without STUN message parse
+/// @return 0-ok, other-error
+int stun_agent_input_batch(stun_agent_t* stun, const struct stun_packet_t* pkts, int n);
+
 /// STUN Bind
 /// @return 0-ok, other-error
 int stun_agent_bind(stun_request_t* req);
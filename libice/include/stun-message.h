@@ -72,6 +72,11 @@ int stun_transaction_id(uint8_t* id, int bytes);
 
 int stun_credential_setauth(struct stun_credential_t* auth, int credential, const char* usr, const char* pwd, const char* realm, const char* nonce);
 
+/// Drop cached HMAC keys of the user(all realms), e.g. user deleted.
+/// Password change don't need invalidate, it's detected by key cache lookup.
+/// @param[in] usr username, NULL-all users
+void stun_credential_cache_invalidate(const char* usr);
+
 #if defined(__cplusplus)
 }
 #endif
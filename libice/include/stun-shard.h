@@ -0,0 +1,40 @@
+#ifndef _stun_shard_h_
+#define _stun_shard_h_
+
+#include "stun-agent.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Sharded STUN/TURN server: N stun agents, one per worker thread.
+/// Each shard owns its own requests, allocation tables and relay sockets,
+/// packets of one client 5-tuple always go to the same shard.
+typedef struct stun_shards_t stun_shards_t;
+
+/// @param[in] n shard(worker thread) count, 0-cpu count
+/// @param[in] handler agent handler, callback in shard worker thread
+/// @param[in] params per-shard handler parameter, params[i] for shard i, NULL-all NULL
+stun_shards_t* stun_shards_create(int rfc, int n, struct stun_agent_handler_t* handler, void* params[]);
+int stun_shards_destroy(stun_shards_t** shards);
+
+/// @return shard count
+int stun_shards_count(stun_shards_t* shards);
+
+/// @return shard stun agent, MUST only be used in the shard callback(worker thread)
+stun_agent_t* stun_shards_agent(stun_shards_t* shards, int index);
+
+/// Select shard by client 5-tuple(protocol + local + remote)
+/// @return shard index
+int stun_shards_select(stun_shards_t* shards, int protocol, const struct sockaddr* local, const struct sockaddr* remote);
+
+/// Dispatch packet to shard worker, data is copied
+/// @param[in] index shard index, -1-select by client 5-tuple.
+///		Peer data received on relay socket MUST use the shard index which allocated the relayed address.
+/// @return 0-ok, other-error(shard queue full, packet dropped)
+int stun_shards_input(stun_shards_t* shards, int index, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !_stun_shard_h_ */
@@ -4,21 +4,41 @@
 #include "byte-order.h"
 #include "sockutil.h"
 #include "list.h"
+#include "sys/system.h"
 #include <stdlib.h>
 #include <assert.h>
 
+#define STUN_AGENT_TICK 20 // ms, retransmission timer resolution
+
+static void stun_agent_release(struct stun_agent_t* stun)
+{
+	if (0 != atomic_decrement32(&stun->ref))
+		return;
+
+	assert(0 == stun->transactions.count);
+	stun_hash_destroy(&stun->transactions);
+	if (stun->rto)
+		time_wheel_destroy(stun->rto);
+	locker_destroy(&stun->locker);
+	free(stun);
+}
+
 struct stun_agent_t* stun_agent_create(int rfc, struct stun_agent_handler_t* handler, void* param)
 {
 	struct stun_agent_t* stun;
 	stun = (struct stun_agent_t*)calloc(1, sizeof(*stun));
 	if (stun)
 	{
+		stun->ref = 1;
+		stun->running = 1;
 		stun->rfc = rfc;
 		stun->auth_term = 0; // disable bind request auth check
 		LIST_INIT_HEAD(&stun->requests);
-		LIST_INIT_HEAD(&stun->turnclients);
-		LIST_INIT_HEAD(&stun->turnservers);
-        LIST_INIT_HEAD(&stun->turnreserved);
+		stun->rto = time_wheel_create(system_clock());
+		stun->timer = time_wheel_create(system_clock_coarse()); // turn allocation expiry, see turn_agent_allocation_cleanup
+		turn_agent_allocations_init(&stun->turnclients, stun->timer);
+		turn_agent_allocations_init(&stun->turnservers, stun->timer);
+		turn_agent_allocations_init(&stun->turnreserved, stun->timer);
 		locker_create(&stun->locker);
 		memcpy(&stun->handler, handler, sizeof(stun->handler));
 		stun->param = param;
@@ -30,7 +50,6 @@ int stun_agent_destroy(stun_agent_t** pp)
 {
 	stun_agent_t* stun;
 	struct stun_request_t* req;
-	struct turn_allocation_t* allocate;
 	struct list_head* pos, *next;
 
 	if (!pp || !*pp)
@@ -38,6 +57,13 @@ int stun_agent_destroy(stun_agent_t** pp)
 
 	stun = *pp;
 	locker_lock(&stun->locker);
+	stun->running = 0;
+	if (stun->ticker && 0 == stun_timer_stop(stun->ticker))
+	{
+		stun->ticker = NULL;
+		atomic_decrement32(&stun->ref); // destroy still hold a reference
+	}
+
 	list_for_each_safe(pos, next, &stun->requests)
 	{
 		req = list_entry(pos, struct stun_request_t, link);
@@ -47,26 +73,16 @@ int stun_agent_destroy(stun_agent_t** pp)
 	}
 	locker_unlock(&stun->locker);
 
-	list_for_each_safe(pos, next, &stun->turnclients)
-	{
-		allocate = list_entry(pos, struct turn_allocation_t, link);
-		turn_allocation_destroy(&allocate);
-	}
+	turn_agent_allocations_destroy(&stun->turnclients);
+	turn_agent_allocations_destroy(&stun->turnservers);
+	turn_agent_allocations_destroy(&stun->turnreserved);
+	if (stun->timer)
+		time_wheel_destroy(stun->timer);
+	stun->timer = NULL;
+	turn_agent_relay_destroy(stun);
 
-	list_for_each_safe(pos, next, &stun->turnservers)
-	{
-		allocate = list_entry(pos, struct turn_allocation_t, link);
-		turn_allocation_destroy(&allocate);
-	}
-    
-    list_for_each_safe(pos, next, &stun->turnreserved)
-    {
-        allocate = list_entry(pos, struct turn_allocation_t, link);
-        turn_allocation_destroy(&allocate);
-    }
-
-	locker_destroy(&stun->locker);
-	free(stun);
+	// ticker callback may be running, free by the last reference
+	stun_agent_release(stun);
 	*pp = NULL;
 	return 0;
 }
@@ -97,21 +113,82 @@ int stun_agent_remove(struct stun_agent_t* stun, stun_request_t* req)
 		return -1;
 	}
 	list_remove(&req->link);
+	stun_hash_remove(&stun->transactions, &req->transaction);
 	locker_unlock(&stun->locker);
 	stun_request_release(req);
 	return 0;
 }
 
+static void stun_agent_ontick(void* param);
+
+/// one ticker for all running requests, stop when no running request
+/// stun->locker locked
+static void stun_agent_tick(struct stun_agent_t* stun)
+{
+	if (stun->ticker || !stun->running || stun->transactions.count < 1)
+		return;
+
+	atomic_increment32(&stun->ref);
+	stun->ticker = stun_timer_start(STUN_AGENT_TICK, stun_agent_ontick, stun);
+	if (!stun->ticker)
+		atomic_decrement32(&stun->ref); // caller hold a reference
+}
+
+static void stun_agent_ontick(void* param)
+{
+	struct stun_agent_t* stun;
+	stun = (struct stun_agent_t*)param;
+
+	locker_lock(&stun->locker);
+	stun->ticker = NULL;
+	locker_unlock(&stun->locker);
+
+	twtimer_process(stun->rto, system_clock());
+
+	locker_lock(&stun->locker);
+	stun_agent_tick(stun);
+	locker_unlock(&stun->locker);
+	stun_agent_release(stun);
+}
+
+int stun_agent_index(struct stun_agent_t* stun, struct stun_request_t* req)
+{
+	int r;
+	locker_lock(&stun->locker);
+	stun_hash_remove(&stun->transactions, &req->transaction);
+	r = stun_hash_insert(&stun->transactions, &req->transaction, jhash(req->msg.header.tid, sizeof(req->msg.header.tid), 0));
+	locker_unlock(&stun->locker);
+	return r;
+}
+
+int stun_agent_timer_start(struct stun_agent_t* stun, struct stun_request_t* req)
+{
+	int r;
+	locker_lock(&stun->locker);
+	r = twtimer_start(stun->rto, &req->timer);
+	if (0 == r)
+		stun_agent_tick(stun);
+	locker_unlock(&stun->locker);
+	return r;
+}
+
+int stun_agent_timer_stop(struct stun_agent_t* stun, struct stun_request_t* req)
+{
+	return twtimer_stop(stun->rto, &req->timer);
+}
+
 static struct stun_request_t* stun_agent_fetch(struct stun_agent_t* stun, const struct stun_message_t* msg)
 {
-	struct list_head *ptr, *next;
+	uint32_t hash;
+	struct hash_node_t *pos;
 	struct stun_request_t* entry;
 
+	hash = jhash(msg->header.tid, sizeof(msg->header.tid), 0);
 	locker_lock(&stun->locker);
-	list_for_each_safe(ptr, next, &stun->requests)
+	stun_hash_for_each(pos, &stun->transactions, hash)
 	{
-		entry = list_entry(ptr, struct stun_request_t, link);
-		if (0 == memcmp(entry->msg.header.tid, msg->header.tid, sizeof(msg->header.tid)))
+		entry = stun_hash_entry(pos, struct stun_request_t, transaction);
+		if (entry->transaction.hash == hash && 0 == memcmp(entry->msg.header.tid, msg->header.tid, sizeof(msg->header.tid)))
 		{
 			stun_request_addref(entry);
 			locker_unlock(&stun->locker);
@@ -393,26 +470,15 @@ static int stun_agent_onresponse(stun_agent_t* stun, int protocol, const struct
 	return r;
 }
 
-int stun_agent_input(stun_agent_t* stun, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
-{
-	return stun_agent_input2(stun, protocol, local, remote, NULL, data, bytes);
-}
-
 int stun_agent_input2(stun_agent_t* stun, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const struct sockaddr* relayed, const void* data, int bytes)
 {
 	int r;
 	struct stun_request_t req;
 	struct turn_allocation_t* allocate;
 
-	if (local)
-	{
-		// 1. turn server receive relay data ?
-		allocate = turn_agent_allocation_find_by_relay(&stun->turnservers, local);
-		if (allocate)
-			return turn_server_relay(stun, allocate, remote, data, bytes);
-	}
-    
-	// 2. turn server/client receive channel data ? (channel range: 0x4000 ~ 0x7FFF)
+	// 1. turn server relay data(peer data/ChannelData/SEND indication) handled by turn-relay.c
+
+	// 2. turn client receive channel data ? (channel range: 0x4000 ~ 0x7FFF)
 	//    RFC5766 11. Channels (p37), 0b00-STUN-formatted message, 0b01-ChannelData
 	if (bytes > 0 && 0x40 == (0xC0 & ((const uint8_t*)data)[0]) && local && remote)
 	{
@@ -422,12 +488,6 @@ int stun_agent_input2(stun_agent_t* stun, int protocol, const struct sockaddr* l
 			assert(allocate->addr.protocol == protocol);
 			return turn_client_onchannel_data(stun, allocate, (const uint8_t*)data, bytes);
 		}
-		else
-		{
-			allocate = turn_agent_allocation_find_by_address(&stun->turnservers, local, remote);
-			if (allocate)
-				return turn_server_onchannel_data(stun, allocate, (const uint8_t*)data, bytes);
-		}
 
 		assert(0); // allocation expired ?
 		return 0;
@@ -0,0 +1,159 @@
+// STUN credential key cache
+// rfc5389 15.4. MESSAGE-INTEGRITY
+// derived key and HMAC pad states only depend on (usr, realm, pwd),
+// cache them so Allocate/Refresh/CreatePermission/Send don't redo MD5 + 2 SHA1 blocks.
+// direct-mapped slots, shared by all agents/threads(stun shards), per-slot spin lock.
+
+#include "stun-credential.h"
+#include "stun-proto.h"
+#include "sys/atomic.h"
+#include "md5.h"
+#include "jhash.h"
+#include <string.h>
+
+#define STUN_CREDENTIAL_CACHE 128 // power of 2
+
+struct stun_credential_key_t
+{
+	volatile int32_t locker; // 0-free, 1-locked
+	int credential; // 0-empty slot
+	char usr[STUN_LIMIT_USERNAME_MAX];
+	char pwd[STUN_LIMIT_USERNAME_MAX];
+	char realm[128];
+	struct stun_hmac_t hmac;
+};
+
+static struct stun_credential_key_t s_keys[STUN_CREDENTIAL_CACHE];
+
+static inline void stun_credential_key_lock(struct stun_credential_key_t* key)
+{
+	while (!atomic_cas32(&key->locker, 0, 1))
+		;
+}
+
+static inline void stun_credential_key_unlock(struct stun_credential_key_t* key)
+{
+	atomic_cas32(&key->locker, 1, 0);
+}
+
+static struct stun_credential_key_t* stun_credential_key_slot(int credential, const char* usr, const char* realm)
+{
+	uint32_t hash;
+	hash = jhash(usr, (uint32_t)strlen(usr), (uint32_t)credential);
+	hash = STUN_CREDENTIAL_LONG_TERM == credential ? jhash(realm, (uint32_t)strlen(realm), hash) : hash;
+	return &s_keys[hash & (STUN_CREDENTIAL_CACHE - 1)];
+}
+
+static void long_term_key(uint8_t md5[16], const char* username, const char* password, const char* realm)
+{
+	MD5_CTX ctx;
+	MD5Init(&ctx);
+	MD5Update(&ctx, (unsigned char*)username, (unsigned int)strlen(username));
+	MD5Update(&ctx, (unsigned char*)":", 1);
+	MD5Update(&ctx, (unsigned char*)realm, (unsigned int)strlen(realm));
+	MD5Update(&ctx, (unsigned char*)":", 1);
+	MD5Update(&ctx, (unsigned char*)password, (unsigned int)strlen(password));
+	MD5Final(md5, &ctx);
+}
+
+// HMAC(K, text) = SHA1(K XOR opad, SHA1(K XOR ipad, text)), see hmacReset
+static void stun_hmac_reset(struct stun_hmac_t* hmac, const uint8_t* key, int nkey)
+{
+	int i;
+	uint8_t ipad[SHA1_Message_Block_Size];
+	uint8_t opad[SHA1_Message_Block_Size];
+	uint8_t tempkey[SHA1HashSize];
+
+	if (nkey > SHA1_Message_Block_Size)
+	{
+		SHA1Reset(&hmac->inner);
+		SHA1Input(&hmac->inner, key, (unsigned int)nkey);
+		SHA1Result(&hmac->inner, tempkey);
+		key = tempkey;
+		nkey = sizeof(tempkey);
+	}
+
+	for (i = 0; i < nkey; i++)
+	{
+		ipad[i] = key[i] ^ 0x36;
+		opad[i] = key[i] ^ 0x5c;
+	}
+	for (; i < SHA1_Message_Block_Size; i++)
+	{
+		ipad[i] = 0x36;
+		opad[i] = 0x5c;
+	}
+
+	SHA1Reset(&hmac->inner);
+	SHA1Input(&hmac->inner, ipad, sizeof(ipad));
+	SHA1Reset(&hmac->outer);
+	SHA1Input(&hmac->outer, opad, sizeof(opad));
+}
+
+int stun_hmac_init(struct stun_hmac_t* hmac, const struct stun_credential_t* auth)
+{
+	int credential;
+	size_t nusr, npwd, nrealm;
+	uint8_t md5[16];
+	const char* realm;
+	struct stun_credential_key_t* key;
+
+	// default short-term credential
+	credential = STUN_CREDENTIAL_LONG_TERM == auth->credential ? STUN_CREDENTIAL_LONG_TERM : STUN_CREDENTIAL_SHORT_TERM;
+	realm = STUN_CREDENTIAL_LONG_TERM == credential ? auth->realm : "";
+	key = stun_credential_key_slot(credential, auth->usr, realm);
+
+	stun_credential_key_lock(key);
+	if (key->credential == credential && 0 == strcmp(key->usr, auth->usr) && 0 == strcmp(key->realm, realm) && 0 == strcmp(key->pwd, auth->pwd))
+	{
+		memcpy(hmac, &key->hmac, sizeof(*hmac));
+		stun_credential_key_unlock(key);
+		return 0;
+	}
+	stun_credential_key_unlock(key);
+
+	// cache miss or password changed
+	if (STUN_CREDENTIAL_LONG_TERM == credential)
+	{
+		long_term_key(md5, auth->usr, auth->pwd, realm);
+		stun_hmac_reset(hmac, md5, sizeof(md5));
+	}
+	else
+	{
+		stun_hmac_reset(hmac, (const uint8_t*)auth->pwd, (int)strlen(auth->pwd));
+	}
+
+	nusr = strlen(auth->usr);
+	npwd = strlen(auth->pwd);
+	nrealm = strlen(realm);
+	if (nusr >= sizeof(key->usr) || npwd >= sizeof(key->pwd) || nrealm >= sizeof(key->realm))
+		return 0; // don't cache
+
+	stun_credential_key_lock(key);
+	key->credential = credential;
+	memcpy(key->usr, auth->usr, nusr + 1);
+	memcpy(key->pwd, auth->pwd, npwd + 1);
+	memcpy(key->realm, realm, nrealm + 1);
+	memcpy(&key->hmac, hmac, sizeof(*hmac));
+	stun_credential_key_unlock(key);
+	return 0;
+}
+
+void stun_credential_cache_invalidate(const char* usr)
+{
+	int i;
+	struct stun_credential_key_t* key;
+
+	for (i = 0; i < STUN_CREDENTIAL_CACHE; i++)
+	{
+		key = &s_keys[i];
+		stun_credential_key_lock(key);
+		if (key->credential && (!usr || 0 == strcmp(usr, key->usr)))
+		{
+			key->credential = 0;
+			memset(key->pwd, 0, sizeof(key->pwd));
+			memset(&key->hmac, 0, sizeof(key->hmac));
+		}
+		stun_credential_key_unlock(key);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef _stun_credential_h_
+#define _stun_credential_h_
+
+#include "stun-message.h"
+#include "sha.h"
+
+// HMAC-SHA1(MESSAGE-INTEGRITY) with precomputed inner/outer pad states
+struct stun_hmac_t
+{
+	SHA1Context inner; // SHA1 state after (K XOR ipad)
+	SHA1Context outer; // SHA1 state after (K XOR opad)
+};
+
+/// Load HMAC key states from credential key cache, derive key on cache miss
+/// long-term key: MD5(username ":" realm ":" SASLprep(password))
+/// short-term key: SASLprep(password)
+/// @return 0-ok, other-error
+int stun_hmac_init(struct stun_hmac_t* hmac, const struct stun_credential_t* auth);
+
+static inline void stun_hmac_input(struct stun_hmac_t* hmac, const uint8_t* data, int bytes)
+{
+	SHA1Input(&hmac->inner, data, (unsigned int)bytes);
+}
+
+static inline void stun_hmac_result(struct stun_hmac_t* hmac, uint8_t sha1[SHA1HashSize])
+{
+	uint8_t digest[SHA1HashSize];
+	SHA1Result(&hmac->inner, digest);
+	SHA1Input(&hmac->outer, digest, sizeof(digest));
+	SHA1Result(&hmac->outer, sha1);
+}
+
+#endif /* !_stun_credential_h_ */
@@ -0,0 +1,122 @@
+#ifndef _stun_hash_h_
+#define _stun_hash_h_
+
+#include "sys/sock.h"
+#include "hash-list.h"
+#include "jhash.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// intrusive chained hash table node, keep hash value for rehash and fast compare
+struct stun_hash_node_t
+{
+	struct hash_node_t node;
+	uint32_t hash;
+};
+
+// power-of-two buckets, grow x2 when load factor > 1
+// zero-initialized table is valid(empty), buckets allocated on first insert
+struct stun_hash_t
+{
+	struct hash_head_t* buckets;
+	uint32_t mask; // bucket count - 1
+	uint32_t count;
+};
+
+#define STUN_HASH_BUCKETS_MIN 8
+
+#define stun_hash_entry(ptr, type, member) hash_list_entry(ptr, type, member.node)
+
+/// iterate all nodes which has same bucket with hash(MUST compare hash value and key)
+#define stun_hash_for_each(pos, h, hashval) \
+	for(pos = (h)->buckets ? (h)->buckets[(hashval) & (h)->mask].first : NULL; pos; pos = pos->next)
+
+/// iterate all nodes, safe against removal of pos
+#define stun_hash_for_each_safe(i, pos, n, h) \
+	for(i = 0; (h)->buckets && i <= (h)->mask; i++) \
+		hash_list_for_each_safe(pos, n, &(h)->buckets[i])
+
+static inline void stun_hash_destroy(struct stun_hash_t* h)
+{
+	if (h->buckets)
+		free(h->buckets);
+	memset(h, 0, sizeof(*h));
+}
+
+static inline int stun_hash_rehash(struct stun_hash_t* h, uint32_t n)
+{
+	uint32_t i;
+	struct hash_head_t* buckets;
+	struct hash_node_t* pos, *next;
+	struct stun_hash_node_t* entry;
+
+	buckets = (struct hash_head_t*)calloc(n, sizeof(struct hash_head_t));
+	if (!buckets)
+		return -1; // -ENOMEM
+
+	for (i = 0; h->buckets && i <= h->mask; i++)
+	{
+		hash_list_for_each_safe(pos, next, &h->buckets[i])
+		{
+			entry = hash_list_entry(pos, struct stun_hash_node_t, node);
+			hash_list_link(&buckets[entry->hash & (n - 1)], pos);
+		}
+	}
+
+	if (h->buckets)
+		free(h->buckets);
+	h->buckets = buckets;
+	h->mask = n - 1;
+	return 0;
+}
+
+static inline int stun_hash_insert(struct stun_hash_t* h, struct stun_hash_node_t* node, uint32_t hash)
+{
+	if (!h->buckets && 0 != stun_hash_rehash(h, STUN_HASH_BUCKETS_MIN))
+		return -1;
+
+	// grow failed is not fatal, just longer chain
+	if (h->count > h->mask)
+		stun_hash_rehash(h, (h->mask + 1) * 2);
+
+	node->hash = hash;
+	hash_list_link(&h->buckets[hash & h->mask], &node->node);
+	h->count++;
+	return 0;
+}
+
+static inline int stun_hash_remove(struct stun_hash_t* h, struct stun_hash_node_t* node)
+{
+	if (!node->node.pnext)
+		return -1; // not linked
+
+	hash_list_unlink(&node->node);
+	node->node.next = NULL;
+	node->node.pnext = NULL;
+	h->count--;
+	return 0;
+}
+
+/// @param[in] port 0-ignore port(compare address only), other-with port
+static inline uint32_t stun_hash_addr(const struct sockaddr* addr, int port, uint32_t initval)
+{
+	const struct sockaddr_in* in;
+	const struct sockaddr_in6* in6;
+
+	switch (addr->sa_family)
+	{
+	case AF_INET:
+		in = (const struct sockaddr_in*)addr;
+		return jhash_2words((uint32_t)in->sin_addr.s_addr, port ? (uint32_t)in->sin_port : 0, initval);
+
+	case AF_INET6:
+		in6 = (const struct sockaddr_in6*)addr;
+		return jhash(&in6->sin6_addr, sizeof(in6->sin6_addr), initval + (port ? (uint32_t)in6->sin6_port : 0));
+
+	default:
+		return initval;
+	}
+}
+
+#endif /* !_stun_hash_h_ */
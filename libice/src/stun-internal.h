@@ -9,6 +9,8 @@
 #include "sys/atomic.h"
 #include "sys/locker.h"
 #include "list.h"
+#include "stun-hash.h"
+#include "twtimer.h"
 #include <stdint.h>
 #include <assert.h>
 
@@ -24,6 +26,7 @@ struct stun_address_t
 struct stun_request_t
 {
 	struct list_head link; // 
+	struct stun_hash_node_t transaction; // pending request index by transaction id
 	struct stun_message_t msg;
 
 	int ref;
@@ -33,7 +36,7 @@ struct stun_request_t
 	int elapsed;
 	int interval;
 	int authtimes; // avoid too many auth failed
-	void* timer;
+	struct twtimer_t timer; // retransmission timer
 	locker_t locker;
 	stun_agent_t* stun;
 
@@ -56,13 +59,30 @@ struct stun_response_t
 	struct stun_credential_t auth;
 };
 
+// allocation table: 5-tuple/relayed address/reservation token hash index
+struct turn_allocations_t
+{
+	struct list_head root;
+	struct stun_hash_t addresses;
+	struct stun_hash_t relays;
+	struct stun_hash_t tokens;
+	time_wheel_t* timer; // expire timer, shared by agent
+};
+
 struct stun_agent_t
 {
 	locker_t locker;
+	int ref;
+	int running;
 	struct list_head requests; // stun/turn requests
-	struct list_head turnclients; // client allocations
-	struct list_head turnservers; // server allocations
-    struct list_head turnreserved; // reserved allocations
+	struct stun_hash_t transactions; // running requests by transaction id
+	time_wheel_t* rto; // request retransmission timer
+	void* ticker; // stun_timer_start, drive rto timer wheel
+	struct turn_allocations_t turnclients; // client allocations
+	struct turn_allocations_t turnservers; // server allocations
+	struct turn_allocations_t turnreserved; // reserved allocations
+	time_wheel_t* timer; // allocation/permission/channel expire
+	struct turn_relay_batch_t* relay; // stun_agent_input_batch send buffer
 
 	int rfc; // rfc version
 	int auth_term; // STUN_CREDENTIAL_SHORT_TERM/STUN_CREDENTIAL_LONG_TERM
@@ -78,6 +98,14 @@ int stun_agent_input2(stun_agent_t* stun, int protocol, const struct sockaddr* l
 
 int stun_agent_insert(struct stun_agent_t* stun, struct stun_request_t* req);
 int stun_agent_remove(struct stun_agent_t* stun, struct stun_request_t* req);
+/// index running request by transaction id, MUST be called before send request
+/// @return 0-ok, other-error
+int stun_agent_index(struct stun_agent_t* stun, struct stun_request_t* req);
+/// start request retransmission timer(req->timer.expire)
+/// @return 0-ok, other-error
+int stun_agent_timer_start(struct stun_agent_t* stun, struct stun_request_t* req);
+/// @return 0-ok, other-timer can't be stop(timer have triggered or will be triggered)
+int stun_agent_timer_stop(struct stun_agent_t* stun, struct stun_request_t* req);
 int stun_agent_request_auth_check(stun_agent_t* stun, struct stun_request_t* req, const void* data, int bytes);
 int stun_agent_response_auth_check(stun_agent_t* stun, const struct stun_message_t* resp, struct stun_request_t* req, const void* data, int bytes);
 
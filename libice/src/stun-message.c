@@ -2,16 +2,12 @@
 // rfc5839 6. STUN Message Structure(p10)
 
 #include "stun-message.h"
+#include "stun-credential.h"
 #include "stun-proto.h"
 #include "byte-order.h"
-#include "sha.h"
-#include "md5.h"
 #include "crc32.h"
 #include <string.h>
 
-void crc32_lsb_init(void);
-unsigned int crc32_lsb(unsigned int crc, const unsigned char *buffer, unsigned int size);
-
 int stun_header_read(const uint8_t* data, int bytes, struct stun_header_t* header)
 {
 	if (!data || bytes < 20)
@@ -198,24 +194,11 @@ static int stun_message_attr_detete(struct stun_message_t* msg, uint16_t attr)
     return -1; //  not found
 }
 
-static void long_term_key(uint8_t md5[16], const char* username, const char* password, const char* realm)
-{
-	MD5_CTX ctx;
-	MD5Init(&ctx);
-	MD5Update(&ctx, (unsigned char*)username, (unsigned int)strlen(username));
-	MD5Update(&ctx, (unsigned char*)":", 1);
-	MD5Update(&ctx, (unsigned char*)realm, (unsigned int)strlen(realm));
-	MD5Update(&ctx, (unsigned char*)":", 1);
-	MD5Update(&ctx, (unsigned char*)password, (unsigned int)strlen(password));
-	MD5Final(md5, &ctx);
-}
-
 int stun_message_add_credentials(struct stun_message_t* msg, const struct stun_credential_t* auth)
 {
-	int r, nkey;
-	uint8_t md5[16];
-	const uint8_t *key;
+	int r;
 	uint8_t data[1600];
+	struct stun_hmac_t hmac;
 
 	if (!*auth->usr|| !*auth->pwd)
 		return -1; // invalid username/password
@@ -239,15 +222,6 @@ int stun_message_add_credentials(struct stun_message_t* msg, const struct stun_c
 	{
 		stun_message_add_string(msg, STUN_ATTR_REALM, auth->realm);
 		stun_message_add_string(msg, STUN_ATTR_NONCE, auth->nonce);
-
-		long_term_key(md5, auth->usr, auth->pwd, auth->realm);
-		key = md5;
-		nkey = sizeof(md5);
-	}
-	else
-	{
-		key = (const uint8_t *)auth->pwd;
-		nkey = (int)strlen(auth->pwd);
 	}
 
 	// The length MUST then be set to point to the length of the message up to, and including,
@@ -260,7 +234,10 @@ int stun_message_add_credentials(struct stun_message_t* msg, const struct stun_c
 	if (r < 0)
 		return r;
 
-	hmac(SHA1, data, msg->header.length + STUN_HEADER_SIZE - sizeof(msg->attrs[msg->nattrs].v.sha1) - 4, key, nkey, msg->attrs[msg->nattrs].v.sha1);
+	if (0 != stun_hmac_init(&hmac, auth))
+		return -1;
+	stun_hmac_input(&hmac, data, msg->header.length + STUN_HEADER_SIZE - sizeof(msg->attrs[msg->nattrs].v.sha1) - 4);
+	stun_hmac_result(&hmac, msg->attrs[msg->nattrs].v.sha1);
     msg->nattrs += 1;
 
 	return 0;
@@ -287,8 +264,7 @@ int stun_message_add_fingerprint(struct stun_message_t* msg)
 	if (r < 0)
 		return r;
 
-    crc32_lsb_init();
-	v = crc32_lsb(0xFFFFFFFF, data, msg->header.length + STUN_HEADER_SIZE - 8);
+	v = crc32_lsb_update(0, data, msg->header.length + STUN_HEADER_SIZE - 8);
     msg->attrs[msg->nattrs].v.u32 = v ^ STUN_FINGERPRINT_XOR;
     msg->nattrs += 1;
 	return 0;
@@ -298,23 +274,13 @@ int stun_message_check_integrity(const uint8_t* data, int bytes, const struct st
 {
 	int nattrs;
 	uint16_t len;
-	uint8_t md5[16];
+	uint8_t length[2];
 	uint8_t sha1[20];
-	HMACContext context;
+	struct stun_hmac_t hmac;
 
 	if (msg->header.length + STUN_HEADER_SIZE != bytes || msg->header.length < 24)
 		return -1;
 
-	if (STUN_CREDENTIAL_LONG_TERM == auth->credential)
-	{
-		long_term_key(md5, auth->usr, auth->pwd, auth->realm);
-		hmacReset(&context, SHA1, md5, sizeof(md5));
-	}
-	else
-	{
-		hmacReset(&context, SHA1, (const uint8_t *)auth->pwd, (int)strlen(auth->pwd));
-	}
-
 	len = msg->header.length;
 	nattrs = msg->nattrs;
 	if (nattrs > 0 && STUN_ATTR_FINGERPRINT == msg->attrs[nattrs - 1].type && msg->header.length > 8)
@@ -325,12 +291,15 @@ int stun_message_check_integrity(const uint8_t* data, int bytes, const struct st
 	if (nattrs < 1 || STUN_ATTR_MESSAGE_INTEGRITY != msg->attrs[nattrs - 1].type || msg->header.length < 24)
 		return -1;
 
-	md5[0] = (uint8_t)(len >> 8);
-	md5[1] = (uint8_t)(len & 0xFF);
-	hmacInput(&context, data, 2); // stun header message type
-	hmacInput(&context, md5, 2); // stun header message length (filter fingerprint)
-	hmacInput(&context, data + 4, 16 /*stun remain header*/ + len /* payload except fingerprint */ - (sizeof(sha1) + 4) /* sha1 */);
-	hmacResult(&context, sha1);
+	if (0 != stun_hmac_init(&hmac, auth))
+		return -1;
+
+	length[0] = (uint8_t)(len >> 8);
+	length[1] = (uint8_t)(len & 0xFF);
+	stun_hmac_input(&hmac, data, 2); // stun header message type
+	stun_hmac_input(&hmac, length, 2); // stun header message length (filter fingerprint)
+	stun_hmac_input(&hmac, data + 4, 16 /*stun remain header*/ + len /* payload except fingerprint */ - (sizeof(sha1) + 4) /* sha1 */);
+	stun_hmac_result(&hmac, sha1);
 	return memcmp(msg->attrs[nattrs - 1].v.sha1, sha1, sizeof(sha1));
 }
 
@@ -348,8 +317,7 @@ int stun_message_check_fingerprint(const uint8_t* data, int bytes, const struct
 	if (nattrs < 1 || STUN_ATTR_FINGERPRINT != msg->attrs[nattrs - 1].type)
 		return -1;
 
-	crc32_lsb_init();
-	v = crc32_lsb(0xFFFFFFFF, data, msg->header.length + STUN_HEADER_SIZE - 8);
+	v = crc32_lsb_update(0, data, msg->header.length + STUN_HEADER_SIZE - 8);
 	v = v ^ STUN_FINGERPRINT_XOR;
 
 	return msg->attrs[nattrs-1].v.u32 - v;
@@ -444,6 +412,13 @@ void stun_message_test(void)
 	assert(0 == stun_message_check_integrity(data, msg.header.length + STUN_HEADER_SIZE, &msg, &auth));
 	assert(0 == stun_message_check_fingerprint(data, msg.header.length + STUN_HEADER_SIZE, &msg));
 
+	// cached key MUST be dropped when password changed
+	snprintf(auth.pwd, sizeof(auth.pwd), "%s", "VOkJxbRl1RmTxUk/WvJxBT");
+	assert(0 != stun_message_check_integrity(data, msg.header.length + STUN_HEADER_SIZE, &msg, &auth));
+	snprintf(auth.pwd, sizeof(auth.pwd), "%s", "VOkJxbRl1RmTxUk/WvJxBt");
+	assert(0 == stun_message_check_integrity(data, msg.header.length + STUN_HEADER_SIZE, &msg, &auth));
+	stun_credential_cache_invalidate(NULL);
+
 	memset(&resp, 0, sizeof(resp));
 	assert(0 == stun_message_read(&resp, result2, sizeof(result2)));
 	assert(0 == memcmp(resp.header.tid, transaction, sizeof(transaction)));
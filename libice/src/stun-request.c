@@ -1,15 +1,29 @@
 #include "stun-internal.h"
+#include "sys/system.h"
+#include "sys/onetime.h"
+#include "slab.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
 enum { STUN_REQUEST_INIT = 0, STUN_REQUEST_RUNNING, STUN_REQUEST_DONE };
 
+static void stun_request_ontimer(void* param);
+
+static struct slab_t* s_slab;
+static onetime_t s_slab_init = ONETIME_INIT;
+
+static void stun_request_slab_init(void)
+{
+	s_slab = slab_create(sizeof(stun_request_t));
+}
+
 stun_request_t* stun_request_create(stun_agent_t* stun, int rfc, stun_request_handler handler, void* param)
 {
 	stun_request_t* req;
 	struct stun_message_t* msg;
-	req = (stun_request_t*)calloc(1, sizeof(stun_request_t));
+	onetime_exec(&s_slab_init, stun_request_slab_init);
+	req = s_slab ? (stun_request_t*)slab_calloc(s_slab) : NULL;
 	if (!req) return NULL;
 
 	req->ref = 0;
@@ -20,6 +34,8 @@ stun_request_t* stun_request_create(stun_agent_t* stun, int rfc, stun_request_ha
 	req->state = STUN_REQUEST_INIT;
 	req->param = param;
 	req->handler = handler;
+	req->timer.ontimeout = stun_request_ontimer;
+	req->timer.param = req;
 	//LIST_INIT_HEAD(&req->link);
 	locker_create(&req->locker);
 
@@ -49,7 +65,7 @@ int stun_request_prepare(struct stun_request_t* req)
 	assert(req->ref >= 2);
 	req->state = STUN_REQUEST_DONE; // cancel
 	stun_agent_remove(req->stun, req); // delete link
-	if (req->timer && 0 == stun_timer_stop(req->timer))
+	if (0 == stun_agent_timer_stop(req->stun, req))
 	{
 		assert(req->ref == 2);
 		stun_request_release(req); // for timer
@@ -71,7 +87,7 @@ int stun_request_release(struct stun_request_t* req)
 		assert(STUN_REQUEST_DONE == req->state);
 		assert(req->link.next == NULL);
 		locker_destroy(&req->locker);
-		free(req);
+		slab_free(s_slab, req);
 	}
 	return 0;
 }
@@ -142,8 +158,15 @@ static void stun_request_ontimer(void* param)
 			if (req->elapsed > req->timeout)
 				req->interval = req->timeout + req->interval - req->elapsed;
 			// 11000 = STUN_TIMEOUT - (500 + 1500 + 3500 + 7500 + 15500)
-			req->timer = stun_timer_start(req->interval, stun_request_ontimer, req);
-			if (req->timer)
+			req->timer.expire = system_clock() + req->interval;
+			if (STUN_REQUEST_DONE == req->state)
+			{
+				// response received in send callback, timer can't be stopped by stun_request_prepare
+				locker_unlock(&req->locker);
+				stun_request_release(req); // for timer
+				return;
+			}
+			else if (0 == stun_agent_timer_start(req->stun, req))
 			{
 				locker_unlock(&req->locker);
 				return;
@@ -172,7 +195,8 @@ int stun_request_send(struct stun_agent_t* stun, struct stun_request_t* req)
 	assert(1 == req->ref);
 	stun_request_addref(req);
 
-	r = stun_message_send(stun, &req->msg, req->addr.protocol, &req->addr.host, &req->addr.peer, &req->addr.relay);
+	r = stun_agent_index(stun, req);
+	r = 0 == r ? stun_message_send(stun, &req->msg, req->addr.protocol, &req->addr.host, &req->addr.peer, &req->addr.relay) : r;
 	if (0 == r)
 	{
 		locker_lock(&req->locker);
@@ -182,7 +206,9 @@ int stun_request_send(struct stun_agent_t* stun, struct stun_request_t* req)
 			stun_request_addref(req);
 			req->elapsed = 0;
 			req->interval = STUN_RETRANSMISSION_INTERVAL_MIN;
-			req->timer = stun_timer_start(STUN_RETRANSMISSION_INTERVAL_MIN, stun_request_ontimer, req);
+			req->timer.expire = system_clock() + STUN_RETRANSMISSION_INTERVAL_MIN;
+			if (0 != stun_agent_timer_start(stun, req))
+				stun_request_release(req); // for timer
 		}
 		locker_unlock(&req->locker);
 	}
@@ -0,0 +1,219 @@
+// Sharded STUN/TURN server
+// one stun agent per worker thread, inbound packets steered by client 5-tuple hash.
+// shards share nothing, the dispatcher only copy packet into the shard queue.
+
+#include "stun-internal.h"
+#include "stun-shard.h"
+#include "turn-internal.h"
+#include "sockutil.h"
+#include "sys/thread.h"
+#include "sys/event.h"
+#include "sys/system.h"
+#include <stdlib.h>
+
+#define STUN_SHARD_MTU		1600
+#define STUN_SHARD_QUEUE	1024 // packets per shard
+#define STUN_SHARD_BATCH	64
+#define STUN_SHARD_IDLE		100 // ms, expire allocations when idle
+
+struct stun_shard_packet_t
+{
+	int protocol;
+	int bytes;
+	struct sockaddr_storage local; // ss_family 0-NULL
+	struct sockaddr_storage remote;
+	uint8_t data[STUN_SHARD_MTU];
+};
+
+struct stun_shard_t
+{
+	stun_agent_t* stun;
+	pthread_t thread;
+	event_t event;
+	locker_t locker;
+	int running;
+
+	// ring queue, [offset, offset + count) is owned by worker
+	struct stun_shard_packet_t* queue;
+	int offset;
+	int count;
+};
+
+struct stun_shards_t
+{
+	int n;
+	uint32_t seed;
+	struct stun_shard_t shards[1];
+};
+
+static int STDCALL stun_shard_worker(void* param)
+{
+	int i, n, offset;
+	struct stun_shard_t* shard;
+	struct stun_shard_packet_t* pkt;
+	struct stun_packet_t pkts[STUN_SHARD_BATCH];
+
+	shard = (struct stun_shard_t*)param;
+	while (shard->running)
+	{
+		locker_lock(&shard->locker);
+		offset = shard->offset;
+		n = shard->count < STUN_SHARD_BATCH ? shard->count : STUN_SHARD_BATCH;
+		locker_unlock(&shard->locker);
+
+		if (n < 1)
+		{
+			event_timewait(&shard->event, STUN_SHARD_IDLE);
+			turn_agent_allocation_cleanup(shard->stun);
+			continue;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			pkt = &shard->queue[(offset + i) % STUN_SHARD_QUEUE];
+			pkts[i].protocol = pkt->protocol;
+			pkts[i].local = pkt->local.ss_family ? (const struct sockaddr*)&pkt->local : NULL;
+			pkts[i].remote = (const struct sockaddr*)&pkt->remote;
+			pkts[i].data = pkt->data;
+			pkts[i].bytes = pkt->bytes;
+		}
+
+		stun_agent_input_batch(shard->stun, pkts, n);
+
+		locker_lock(&shard->locker);
+		shard->offset = (shard->offset + n) % STUN_SHARD_QUEUE;
+		shard->count -= n;
+		locker_unlock(&shard->locker);
+	}
+	return 0;
+}
+
+stun_shards_t* stun_shards_create(int rfc, int n, struct stun_agent_handler_t* handler, void* params[])
+{
+	int i;
+	struct stun_shard_t* shard;
+	struct stun_shards_t* shards;
+
+	n = n > 0 ? n : (int)system_getcpucount();
+	n = n > 0 ? n : 1;
+	shards = (struct stun_shards_t*)calloc(1, sizeof(*shards) + sizeof(struct stun_shard_t) * (n - 1));
+	if (!shards)
+		return NULL;
+
+	shards->seed = (uint32_t)system_clock();
+	for (i = 0; i < n; i++)
+	{
+		shard = &shards->shards[i];
+		shard->queue = (struct stun_shard_packet_t*)malloc(sizeof(struct stun_shard_packet_t) * STUN_SHARD_QUEUE);
+		shard->stun = stun_agent_create(rfc, handler, params ? params[i] : NULL);
+		if (!shard->queue || !shard->stun)
+		{
+			if (shard->queue)
+				free(shard->queue);
+			stun_agent_destroy(&shard->stun);
+			break;
+		}
+
+		locker_create(&shard->locker);
+		event_create(&shard->event);
+		shard->running = 1;
+		if (0 != thread_create(&shard->thread, stun_shard_worker, shard))
+		{
+			event_destroy(&shard->event);
+			locker_destroy(&shard->locker);
+			stun_agent_destroy(&shard->stun);
+			free(shard->queue);
+			break;
+		}
+
+		shards->n++;
+	}
+
+	if (shards->n < n)
+	{
+		stun_shards_destroy(&shards);
+		return NULL;
+	}
+	return shards;
+}
+
+int stun_shards_destroy(stun_shards_t** pp)
+{
+	int i;
+	struct stun_shard_t* shard;
+	struct stun_shards_t* shards;
+
+	if (!pp || !*pp)
+		return 0;
+
+	shards = *pp;
+	*pp = NULL;
+	for (i = 0; i < shards->n; i++)
+	{
+		shard = &shards->shards[i];
+		shard->running = 0;
+		event_signal(&shard->event);
+		thread_destroy(shard->thread);
+
+		stun_agent_destroy(&shard->stun);
+		event_destroy(&shard->event);
+		locker_destroy(&shard->locker);
+		free(shard->queue);
+	}
+
+	free(shards);
+	return 0;
+}
+
+int stun_shards_count(stun_shards_t* shards)
+{
+	return shards->n;
+}
+
+stun_agent_t* stun_shards_agent(stun_shards_t* shards, int index)
+{
+	return index >= 0 && index < shards->n ? shards->shards[index].stun : NULL;
+}
+
+int stun_shards_select(stun_shards_t* shards, int protocol, const struct sockaddr* local, const struct sockaddr* remote)
+{
+	uint32_t hash;
+	hash = stun_hash_addr(remote, 1, shards->seed + (uint32_t)protocol);
+	hash = local ? stun_hash_addr(local, 1, hash) : hash;
+	return (int)(((uint64_t)hash * (uint32_t)shards->n) >> 32);
+}
+
+int stun_shards_input(stun_shards_t* shards, int index, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
+{
+	int wakeup;
+	struct stun_shard_t* shard;
+	struct stun_shard_packet_t* pkt;
+
+	if (bytes < 0 || bytes > STUN_SHARD_MTU || !remote || index >= shards->n)
+		return -1;
+
+	index = index >= 0 ? index : stun_shards_select(shards, protocol, local, remote);
+	shard = &shards->shards[index];
+
+	locker_lock(&shard->locker);
+	if (shard->count >= STUN_SHARD_QUEUE)
+	{
+		locker_unlock(&shard->locker);
+		return -1; // queue full, drop
+	}
+
+	pkt = &shard->queue[(shard->offset + shard->count) % STUN_SHARD_QUEUE];
+	pkt->protocol = protocol;
+	pkt->bytes = bytes;
+	pkt->local.ss_family = 0;
+	if (local)
+		memcpy(&pkt->local, local, socket_addr_len(local));
+	memcpy(&pkt->remote, remote, socket_addr_len(remote));
+	memcpy(pkt->data, data, bytes);
+	wakeup = 0 == shard->count++;
+	locker_unlock(&shard->locker);
+
+	if (wakeup)
+		event_signal(&shard->event);
+	return 0;
+}
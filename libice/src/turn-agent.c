@@ -1,57 +1,146 @@
 #include "stun-internal.h"
 #include "turn-internal.h"
 #include "sys/system.h"
+#include "hash.h"
 
-// for RESERVATION-TOKEN
-struct turn_allocation_t* turn_agent_allocation_find_by_token(struct list_head* root, const void* token)
+static inline uint32_t turn_agent_allocation_hash(const struct sockaddr* host, const struct sockaddr* peer)
+{
+	return stun_hash_addr(peer, 1, stun_hash_addr(host, 1, 0));
+}
+
+void turn_agent_allocations_init(struct turn_allocations_t* allocations, time_wheel_t* timer)
+{
+	memset(allocations, 0, sizeof(*allocations));
+	LIST_INIT_HEAD(&allocations->root);
+	allocations->timer = timer;
+}
+
+void turn_agent_allocations_destroy(struct turn_allocations_t* allocations)
 {
-	struct list_head* pos;
+	struct list_head* pos, *next;
 	struct turn_allocation_t* allocate;
-	list_for_each(pos, root)
+
+	list_for_each_safe(pos, next, &allocations->root)
 	{
 		allocate = list_entry(pos, struct turn_allocation_t, link);
+		turn_agent_allocation_remove(allocations, allocate);
+		turn_allocation_destroy(&allocate);
+	}
+
+	stun_hash_destroy(&allocations->addresses);
+	stun_hash_destroy(&allocations->relays);
+	stun_hash_destroy(&allocations->tokens);
+}
+
+// for RESERVATION-TOKEN
+struct turn_allocation_t* turn_agent_allocation_find_by_token(struct turn_allocations_t* allocations, const void* token)
+{
+	uint32_t hash;
+	struct hash_node_t* pos;
+	struct turn_allocation_t* allocate;
+
+	// token is untrusted pointer value, compare only, don't dereference
+	hash = (uint32_t)hash_ptr(token, 32);
+	stun_hash_for_each(pos, &allocations->tokens, hash)
+	{
+		allocate = stun_hash_entry(pos, struct turn_allocation_t, reserved);
 		if (allocate == token)
 			return allocate;
 	}
 	return NULL;
 }
 
-struct turn_allocation_t* turn_agent_allocation_find_by_relay(struct list_head* root, const struct sockaddr* relayed)
+struct turn_allocation_t* turn_agent_allocation_find_by_relay(struct turn_allocations_t* allocations, const struct sockaddr* relayed)
 {
-	struct list_head* pos;
+	uint32_t hash;
+	struct hash_node_t* pos;
 	struct turn_allocation_t* allocate;
-	list_for_each(pos, root)
+
+	hash = stun_hash_addr(relayed, 1, 0);
+	stun_hash_for_each(pos, &allocations->relays, hash)
 	{
-		allocate = list_entry(pos, struct turn_allocation_t, link);
-		if (0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.relay, relayed))
+		allocate = stun_hash_entry(pos, struct turn_allocation_t, relayed);
+		if (allocate->relayed.hash == hash && 0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.relay, relayed))
 			return allocate;
 	}
 	return NULL;
 }
 
-struct turn_allocation_t* turn_agent_allocation_find_by_address(struct list_head* root, const struct sockaddr* host, const struct sockaddr* peer)
+struct turn_allocation_t* turn_agent_allocation_find_by_address(struct turn_allocations_t* allocations, const struct sockaddr* host, const struct sockaddr* peer)
 {
-	struct list_head* pos;
+	uint32_t hash;
+	struct hash_node_t* pos;
 	struct turn_allocation_t* allocate;
-	list_for_each(pos, root)
+
+	hash = turn_agent_allocation_hash(host, peer);
+	stun_hash_for_each(pos, &allocations->addresses, hash)
 	{
-		allocate = list_entry(pos, struct turn_allocation_t, link);
-		if (0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.host, host) && 0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.peer, peer))
+		allocate = stun_hash_entry(pos, struct turn_allocation_t, address);
+		if (allocate->address.hash == hash && 0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.host, host) && 0 == socket_addr_compare((const struct sockaddr*)&allocate->addr.peer, peer))
 			return allocate;
 	}
 	return NULL;
 }
 
-int turn_agent_allocation_insert(struct list_head* root, struct turn_allocation_t* allocate)
+static void turn_agent_allocation_ontimeout(void* param)
+{
+	struct turn_allocation_t* allocate;
+	allocate = (struct turn_allocation_t*)param;
+	assert(allocate->owner);
+
+	// refreshed, restart with new expire clock
+	allocate->timer.expire = allocate->expire;
+	if ((int)(allocate->expire - system_clock_coarse()) > 0 && 0 == twtimer_start(allocate->owner->timer, &allocate->timer))
+		return;
+
+	turn_agent_allocation_remove(allocate->owner, allocate);
+	turn_allocation_destroy(&allocate);
+}
+
+int turn_agent_allocation_insert(struct turn_allocations_t* allocations, struct turn_allocation_t* allocate)
 {
-	assert(NULL == turn_agent_allocation_find_by_address(root, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer));
-	list_insert_after(&allocate->link, root->prev);
+	assert(NULL == turn_agent_allocation_find_by_address(allocations, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer));
+	if (0 != stun_hash_insert(&allocations->addresses, &allocate->address, turn_agent_allocation_hash((const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer)))
+		return -1;
+	if (0 != stun_hash_insert(&allocations->relays, &allocate->relayed, stun_hash_addr((const struct sockaddr*)&allocate->addr.relay, 1, 0)))
+	{
+		stun_hash_remove(&allocations->addresses, &allocate->address);
+		return -1;
+	}
+	if (0 != stun_hash_insert(&allocations->tokens, &allocate->reserved, (uint32_t)hash_ptr(allocate, 32)))
+	{
+		stun_hash_remove(&allocations->addresses, &allocate->address);
+		stun_hash_remove(&allocations->relays, &allocate->relayed);
+		return -1;
+	}
+
+	list_insert_after(&allocate->link, allocations->root.prev);
+	allocate->owner = allocations;
+
+	if (allocations->timer)
+	{
+		allocate->timer.param = allocate;
+		allocate->timer.expire = allocate->expire;
+		allocate->timer.ontimeout = turn_agent_allocation_ontimeout;
+		twtimer_start(allocations->timer, &allocate->timer);
+		turn_allocation_timer_start(allocate);
+	}
 	return 0;
 }
 
-int turn_agent_allocation_remove(struct list_head* root, struct turn_allocation_t* allocate)
+int turn_agent_allocation_remove(struct turn_allocations_t* allocations, struct turn_allocation_t* allocate)
 {
-    (void)root;
+	assert(allocate->owner == allocations);
+	if (allocations->timer)
+	{
+		twtimer_stop(allocations->timer, &allocate->timer);
+		turn_allocation_timer_stop(allocate);
+	}
+	allocate->owner = NULL;
+
+	stun_hash_remove(&allocations->addresses, &allocate->address);
+	stun_hash_remove(&allocations->relays, &allocate->relayed);
+	stun_hash_remove(&allocations->tokens, &allocate->reserved);
 	list_remove(&allocate->link);
 	return 0;
 }
@@ -83,47 +172,5 @@ struct turn_allocation_t* turn_agent_allocation_reservation_token(struct stun_ag
 
 int turn_agent_allocation_cleanup(struct stun_agent_t* turn)
 {
-	uint32_t now;
-    struct turn_allocation_t* allocate;
-    struct list_head* pos, *next;
-    
-    now = system_clock();
-    
-    list_for_each_safe(pos, next, &turn->turnclients)
-    {
-        allocate = list_entry(pos, struct turn_allocation_t, link);
-        // TODO: check permission/channel expire
-
-        if((int)(allocate->expire - now) < 0)
-            continue;
-        
-        list_remove(pos);
-        turn_allocation_destroy(&allocate);
-    }
-    
-    list_for_each_safe(pos, next, &turn->turnservers)
-    {
-        allocate = list_entry(pos, struct turn_allocation_t, link);
-        // TODO: check permission/channel expire
-        
-		if ((int)(allocate->expire - now) < 0)
-            continue;
-        
-        list_remove(pos);
-        turn_allocation_destroy(&allocate);
-    }
-    
-    list_for_each_safe(pos, next, &turn->turnreserved)
-    {
-        allocate = list_entry(pos, struct turn_allocation_t, link);
-        // TODO: check permission/channel expire
-        
-		if ((int)(allocate->expire - now) < 0)
-            continue;
-        
-        list_remove(pos);
-        turn_allocation_destroy(&allocate);
-    }
-
-    return 0;
+	return turn->timer ? twtimer_process(turn->timer, system_clock_coarse()) : 0;
 }
@@ -1,12 +1,27 @@
 #include "stun-internal.h"
 #include "turn-internal.h"
 #include "sys/system.h"
+#include "sys/onetime.h"
+#include "slab.h"
 #include <stdlib.h>
 
+static struct slab_t* s_allocations;
+static struct slab_t* s_permissions;
+static struct slab_t* s_channels;
+static onetime_t s_slab_init = ONETIME_INIT;
+
+static void turn_allocation_slab_init(void)
+{
+	s_allocations = slab_create(sizeof(struct turn_allocation_t));
+	s_permissions = slab_create(sizeof(struct turn_permission_t));
+	s_channels = slab_create(sizeof(struct turn_channel_t));
+}
+
 struct turn_allocation_t* turn_allocation_create(void)
 {
 	struct turn_allocation_t* allocate;
-	allocate = (struct turn_allocation_t*)calloc(1, sizeof(*allocate));
+	onetime_exec(&s_slab_init, turn_allocation_slab_init);
+	allocate = s_allocations ? (struct turn_allocation_t*)slab_calloc(s_allocations) : NULL;
 	if (allocate)
 	{
 		LIST_INIT_HEAD(&allocate->link);
@@ -16,25 +31,115 @@ struct turn_allocation_t* turn_allocation_create(void)
 
 int turn_allocation_destroy(struct turn_allocation_t** pp)
 {
+	uint32_t i;
+	struct hash_node_t* pos, *next;
 	struct turn_allocation_t* allocate;
 
 	if (!pp || !*pp)
 		return -1;
 
 	allocate = *pp;
-	free(allocate);
+	assert(NULL == allocate->owner); // remove from allocation table first
+	stun_hash_for_each_safe(i, pos, next, &allocate->permissions)
+		slab_free(s_permissions, stun_hash_entry(pos, struct turn_permission_t, link));
+	stun_hash_for_each_safe(i, pos, next, &allocate->channels)
+		slab_free(s_channels, stun_hash_entry(pos, struct turn_channel_t, link));
+	stun_hash_destroy(&allocate->permissions);
+	stun_hash_destroy(&allocate->channels);
+	stun_hash_destroy(&allocate->peers);
+	slab_free(s_allocations, allocate);
 	*pp = NULL;
 	return 0;
 }
 
+static void turn_permission_ontimeout(void* param)
+{
+	struct turn_permission_t* p;
+	struct turn_allocation_t* allocate;
+
+	p = (struct turn_permission_t*)param;
+	allocate = p->allocate;
+	assert(allocate->owner);
+
+	// refreshed by CreatePermission/ChannelBind, restart with new expire clock
+	p->timer.expire = p->expired;
+	if ((int)(p->expired - system_clock_coarse()) > 0 && 0 == twtimer_start(allocate->owner->timer, &p->timer))
+		return;
+
+	stun_hash_remove(&allocate->permissions, &p->link);
+	slab_free(s_permissions, p);
+}
+
+static void turn_channel_ontimeout(void* param)
+{
+	struct turn_channel_t* c;
+	struct turn_allocation_t* allocate;
+
+	c = (struct turn_channel_t*)param;
+	allocate = c->allocate;
+	assert(allocate->owner);
+
+	c->timer.expire = c->expired;
+	if ((int)(c->expired - system_clock_coarse()) > 0 && 0 == twtimer_start(allocate->owner->timer, &c->timer))
+		return;
+
+	stun_hash_remove(&allocate->channels, &c->link);
+	stun_hash_remove(&allocate->peers, &c->peer);
+	slab_free(s_channels, c);
+}
+
+int turn_allocation_timer_start(struct turn_allocation_t* allocate)
+{
+	uint32_t i;
+	struct hash_node_t* pos, *next;
+	struct turn_channel_t* c;
+	struct turn_permission_t* p;
+
+	if (!allocate->owner || !allocate->owner->timer)
+		return -1;
+
+	stun_hash_for_each_safe(i, pos, next, &allocate->permissions)
+	{
+		p = stun_hash_entry(pos, struct turn_permission_t, link);
+		p->timer.expire = p->expired;
+		twtimer_start(allocate->owner->timer, &p->timer);
+	}
+
+	stun_hash_for_each_safe(i, pos, next, &allocate->channels)
+	{
+		c = stun_hash_entry(pos, struct turn_channel_t, link);
+		c->timer.expire = c->expired;
+		twtimer_start(allocate->owner->timer, &c->timer);
+	}
+	return 0;
+}
+
+int turn_allocation_timer_stop(struct turn_allocation_t* allocate)
+{
+	uint32_t i;
+	struct hash_node_t* pos, *next;
+
+	if (!allocate->owner || !allocate->owner->timer)
+		return -1;
+
+	stun_hash_for_each_safe(i, pos, next, &allocate->permissions)
+		twtimer_stop(allocate->owner->timer, &stun_hash_entry(pos, struct turn_permission_t, link)->timer);
+	stun_hash_for_each_safe(i, pos, next, &allocate->channels)
+		twtimer_stop(allocate->owner->timer, &stun_hash_entry(pos, struct turn_channel_t, link)->timer);
+	return 0;
+}
+
 const struct turn_permission_t* turn_allocation_find_permission(const struct turn_allocation_t* allocate, const struct sockaddr* addr)
 {
-	int i;
+	uint32_t hash;
+	struct hash_node_t* pos;
 	const struct turn_permission_t* p;
-	for (i = 0; i < allocate->npermission; i++)
+
+	hash = stun_hash_addr(addr, 0, 0);
+	stun_hash_for_each(pos, &allocate->permissions, hash)
 	{
-		p = &allocate->permissions[i];
-		if (0 == turn_sockaddr_cmp((const struct sockaddr*)&p->addr, addr))
+		p = stun_hash_entry(pos, struct turn_permission_t, link);
+		if (p->link.hash == hash && 0 == turn_sockaddr_cmp((const struct sockaddr*)&p->addr, addr))
 			return p;
 	}
 	return NULL;
@@ -42,34 +147,43 @@ const struct turn_permission_t* turn_allocation_find_permission(const struct tur
 
 int turn_allocation_add_permission(struct turn_allocation_t* allocate, const struct sockaddr* addr)
 {
-	struct turn_permission_t permission, *p;
+	struct turn_permission_t *p;
 	p = (struct turn_permission_t*)turn_allocation_find_permission(allocate, addr);
 	if (p)
 	{
-		p->expired = system_clock() + allocate->lifetime * 1000;
+		// lazy update, timer will restart on timeout
+		p->expired = system_clock_coarse() + TURN_PERMISSION_LIFETIME * 1000;
 		return 0;
 	}
-	
-	if (allocate->npermission + 1 > sizeof(allocate->permissions) / sizeof(allocate->permissions[0]))
+
+	p = s_permissions ? (struct turn_permission_t*)slab_calloc(s_permissions) : NULL;
+	if (!p)
+		return -1; // -ENOMEM
+
+	memcpy(&p->addr, addr, socket_addr_len(addr));
+	p->expired = system_clock_coarse() + TURN_PERMISSION_LIFETIME * 1000;
+	p->allocate = allocate;
+	p->timer.param = p;
+	p->timer.expire = p->expired;
+	p->timer.ontimeout = turn_permission_ontimeout;
+	if (0 != stun_hash_insert(&allocate->permissions, &p->link, stun_hash_addr(addr, 0, 0)))
 	{
-		assert(0);
+		slab_free(s_permissions, p);
 		return -1;
 	}
 
-	memset(&permission, 0, sizeof(struct turn_permission_t));
-	memcpy(&permission.addr, addr, socket_addr_len(addr));
-	permission.expired = system_clock() + allocate->lifetime * 1000;
-	memcpy(&allocate->permissions[allocate->npermission++], &permission, sizeof(struct turn_permission_t));
+	if (allocate->owner && allocate->owner->timer)
+		twtimer_start(allocate->owner->timer, &p->timer);
 	return 0;
 }
 
 const struct turn_channel_t* turn_allocation_find_channel(const struct turn_allocation_t* allocate, uint16_t channel)
 {
-	int i;
+	struct hash_node_t* pos;
 	const struct turn_channel_t* p;
-	for (i = 0; i < allocate->nchannel; i++)
+	stun_hash_for_each(pos, &allocate->channels, channel)
 	{
-		p = &allocate->channels[i];
+		p = stun_hash_entry(pos, struct turn_channel_t, link);
 		if (p->channel == channel)
 			return p;
 	}
@@ -78,46 +192,94 @@ const struct turn_channel_t* turn_allocation_find_channel(const struct turn_allo
 
 const struct turn_channel_t* turn_allocation_find_channel_by_peer(const struct turn_allocation_t* allocate, const struct sockaddr* addr)
 {
-	int i;
+	uint32_t hash;
+	struct hash_node_t* pos;
 	const struct turn_channel_t* p;
-	for (i = 0; i < allocate->nchannel; i++)
+
+	hash = stun_hash_addr(addr, 1, 0);
+	stun_hash_for_each(pos, &allocate->peers, hash)
 	{
-		p = &allocate->channels[i];
-		if (0 == socket_addr_compare((const struct sockaddr*)&p->addr, addr))
+		p = stun_hash_entry(pos, struct turn_channel_t, peer);
+		if (p->peer.hash == hash && 0 == socket_addr_compare((const struct sockaddr*)&p->addr, addr))
 			return p;
 	}
 	return NULL;
 }
 
+const struct turn_channel_t* turn_channel_data_read(const struct turn_allocation_t* allocate, const uint8_t* data, int bytes, const uint8_t** payload, int* length)
+{
+	uint16_t number;
+	const struct turn_channel_t* channel;
+
+	// rfc5766 11.4. The ChannelData Message (p45)
+	if (bytes < 4)
+		return NULL;
+
+	number = ((uint16_t)data[0] << 8) | (uint16_t)data[1];
+	*length = ((int)data[2] << 8) | (int)data[3];
+	channel = turn_allocation_find_channel(allocate, number);
+	if (!channel || *length + 4 > bytes || (int)(channel->expired - system_clock_coarse()) < 0)
+		return NULL;
+
+	*payload = data + 4;
+	return channel;
+}
+
+int turn_channel_data_write(const struct turn_channel_t* channel, const void* data, int bytes, uint8_t* ptr, int size)
+{
+	if (bytes < 0 || bytes > 0xFFFF || bytes + 4 > size)
+		return -1; // MTU too long
+
+	ptr[0] = (uint8_t)(channel->channel >> 8);
+	ptr[1] = (uint8_t)(channel->channel);
+	ptr[2] = (uint8_t)(bytes >> 8);
+	ptr[3] = (uint8_t)(bytes);
+	memcpy(ptr + 4, data, bytes);
+	return bytes + 4;
+}
+
 int turn_allocation_add_channel(struct turn_allocation_t* allocate, const struct sockaddr* addr, uint16_t channel)
 {
-    int r;
-	struct turn_channel_t c, *p;
-	const struct turn_channel_t *p2;
+	struct turn_channel_t *p;
 	p = (struct turn_channel_t*)turn_allocation_find_channel(allocate, channel);
 	if (p)
 	{
 		// 1. The channel number is not currently bound to a different transport address
 		// 2. The transport address is not currently bound to a different channel number
-        r =turn_sockaddr_cmp((const struct sockaddr*)&p->addr, addr);
-        p2 =turn_allocation_find_channel_by_peer(allocate, addr);
 		if (0 != socket_addr_compare((const struct sockaddr*)&p->addr, addr) || p != turn_allocation_find_channel_by_peer(allocate, addr))
 			return -1; // channel in-use
 
-		p->expired = system_clock() + allocate->lifetime * 1000;
+		p->expired = system_clock_coarse() + TURN_CHANNEL_LIFETIME * 1000;
 		return 0;
 	}
 
-	if (allocate->nchannel + 1 > sizeof(allocate->channels) / sizeof(allocate->channels[0]))
+	if (turn_allocation_find_channel_by_peer(allocate, addr))
+		return -1; // peer bound to another channel
+
+	p = s_channels ? (struct turn_channel_t*)slab_calloc(s_channels) : NULL;
+	if (!p)
+		return -1; // -ENOMEM
+
+	memcpy(&p->addr, addr, socket_addr_len(addr));
+	p->expired = system_clock_coarse() + TURN_CHANNEL_LIFETIME * 1000;
+	p->channel = channel;
+	p->allocate = allocate;
+	p->timer.param = p;
+	p->timer.expire = p->expired;
+	p->timer.ontimeout = turn_channel_ontimeout;
+	if (0 != stun_hash_insert(&allocate->channels, &p->link, channel))
+	{
+		slab_free(s_channels, p);
+		return -1;
+	}
+	if (0 != stun_hash_insert(&allocate->peers, &p->peer, stun_hash_addr(addr, 1, 0)))
 	{
-		assert(0);
+		stun_hash_remove(&allocate->channels, &p->link);
+		slab_free(s_channels, p);
 		return -1;
 	}
 
-	memset(&c, 0, sizeof(struct turn_channel_t));
-	memcpy(&c.addr, addr, socket_addr_len(addr));
-	c.expired = system_clock() + allocate->lifetime * 1000;
-    c.channel = channel;
-	memcpy(&allocate->channels[allocate->nchannel++], &c, sizeof(struct turn_channel_t));
+	if (allocate->owner && allocate->owner->timer)
+		twtimer_start(allocate->owner->timer, &p->timer);
 	return 0;
 }
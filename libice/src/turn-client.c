@@ -38,7 +38,11 @@ int turn_client_allocate_onresponse(struct stun_agent_t* stun, struct stun_reque
 	{
 		allocate = turn_allocation_create();
 		if (!allocate) return -1;
-		turn_agent_allocation_insert(&stun->turnclients, allocate);
+	}
+	else
+	{
+		// relayed address maybe changed, re-insert to update hash index
+		turn_agent_allocation_remove(&stun->turnclients, allocate);
 	}
 
 	memcpy(&allocate->auth, &req->auth, sizeof(struct stun_credential_t));
@@ -59,11 +63,13 @@ int turn_client_allocate_onresponse(struct stun_agent_t* stun, struct stun_reque
 
 	attr = stun_message_attr_find(resp, STUN_ATTR_LIFETIME);
 	allocate->lifetime = attr ? attr->v.u32 : TURN_LIFETIME;
-	allocate->expire = system_clock() + allocate->lifetime * 1000;
+	allocate->expire = system_clock_coarse() + allocate->lifetime * 1000;
 
+	if (0 != turn_agent_allocation_insert(&stun->turnclients, allocate))
+		goto FAILED;
 	return 0;
+
 FAILED:
-	turn_agent_allocation_remove(&stun->turnclients, allocate);
 	turn_allocation_destroy(&allocate);
 	return -1;
 }
@@ -99,7 +105,7 @@ int turn_client_refresh_onresponse(struct stun_agent_t* stun, struct stun_reques
 		return 0;
 	}
 
-	allocate->expire = system_clock() + (attr ? attr->v.u32 : TURN_LIFETIME) * 1000;
+	allocate->expire = system_clock_coarse() + (attr ? attr->v.u32 : TURN_LIFETIME) * 1000;
 	return 0;
 }
 
@@ -181,19 +187,14 @@ static int turn_client_send_channel_data(struct stun_agent_t* turn, const struct
 {
     uint8_t ptr[1600];
     
-    if ((int)(system_clock() - channel->expired) > 0)
+    if ((int)(system_clock_coarse() - channel->expired) > 0)
         return 0; // expired
     
-    if (bytes + 4 > sizeof(ptr))
-        return -1; // MTU too long
-    
-    ptr[0] = (uint8_t)(channel->channel >> 8);
-    ptr[1] = (uint8_t)(channel->channel);
-    ptr[2] = (uint8_t)(bytes >> 8);
-    ptr[3] = (uint8_t)(bytes);
-    memcpy(ptr + 4, data, bytes);
+    bytes = turn_channel_data_write(channel, data, bytes, ptr, sizeof(ptr));
+    if (bytes < 0)
+        return bytes; // MTU too long
     
-    return turn->handler.send(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer, ptr, bytes+4);
+    return turn->handler.send(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer, ptr, bytes);
 }
 
 int turn_agent_send(stun_agent_t* stun, const struct sockaddr* relay, const struct sockaddr* peer, const void* data, int bytes)
@@ -253,19 +254,17 @@ int turn_client_ondata(struct stun_agent_t* turn, const struct stun_request_t* r
 // ChannelData from server
 int turn_client_onchannel_data(struct stun_agent_t* turn, struct turn_allocation_t* allocate, const uint8_t* data, int bytes)
 {
-	uint16_t number;
-	uint16_t length;
+	int length;
+	const uint8_t* payload;
 	const struct turn_channel_t* channel;
 
 	// TODO: TURN data
 	// check permission
-	number = ((uint16_t)data[0] << 8) | (uint16_t)data[1];
-	length = ((uint16_t)data[2] << 8) | (uint16_t)data[3];
-	channel = turn_allocation_find_channel(allocate, number);
-	if (channel && length + 4 <= bytes)
+	channel = turn_channel_data_read(allocate, data, bytes, &payload, &length);
+	if (channel)
 	{
-		//turn->handler.ondata(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&channel->addr, (const uint8_t*)data + 4, length);
-		return stun_agent_input2(turn, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&channel->addr, (const struct sockaddr*)&allocate->addr.relay, (const uint8_t*)data + 4, length);
+		//turn->handler.ondata(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&channel->addr, payload, length);
+		return stun_agent_input2(turn, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&channel->addr, (const struct sockaddr*)&allocate->addr.relay, payload, length);
 	}
 	
 	return 0;
@@ -3,6 +3,7 @@
 
 #include "list.h"
 #include "sockutil.h"
+#include "stun-hash.h"
 #include "stun-internal.h"
 #include <stdint.h>
 
@@ -10,21 +11,35 @@ struct stun_address_t;
 
 struct turn_permission_t
 {
+	struct stun_hash_node_t link; // hash by address(without port)
 	struct sockaddr_storage addr; // Note that only addresses are compared and port numbers are not considered.
 	uint32_t expired; // expired clock
+
+	struct twtimer_t timer;
+	struct turn_allocation_t* allocate;
 };
 
 struct turn_channel_t
 {
+	struct stun_hash_node_t link; // hash by channel number
+	struct stun_hash_node_t peer; // hash by peer address
 	struct sockaddr_storage addr;
 	uint16_t channel;
 	uint32_t expired; // expired clock
+
+	struct twtimer_t timer;
+	struct turn_allocation_t* allocate;
 };
 
 // rfc 5766 5. Allocations (p22)
 struct turn_allocation_t
 {
 	struct list_head link;
+	struct stun_hash_node_t address; // 5-tuple index
+	struct stun_hash_node_t relayed; // relayed transport address index
+	struct stun_hash_node_t reserved; // RESERVATION-TOKEN index
+	struct turn_allocations_t* owner; // NULL if not in any allocation table
+	struct twtimer_t timer; // expire timer
 //	uint16_t id[16];
 
 	int peertransport;
@@ -42,11 +57,9 @@ struct turn_allocation_t
 	// authentication;
 	struct stun_credential_t auth;
 	
-	int npermission;
-	struct turn_permission_t permissions[8];
-
-	int nchannel;
-	struct turn_channel_t channels[8];
+	struct stun_hash_t permissions; // turn_permission_t
+	struct stun_hash_t channels; // turn_channel_t by channel number
+	struct stun_hash_t peers; // turn_channel_t by peer address
 };
 
 
@@ -74,8 +87,6 @@ int turn_client_channel_bind_onresponse(struct stun_agent_t* stun, struct stun_r
 int turn_server_relay(struct stun_agent_t* turn, const struct turn_allocation_t* allocate, const struct sockaddr* peer, const void* data, int bytes);
 /// SEND indication: from client to turn server
 int turn_server_onsend(struct stun_agent_t* turn, const struct stun_request_t* req);
-/// ChannelData: from client to turn server
-int turn_server_onchannel_data(struct stun_agent_t* turn, struct turn_allocation_t* allocate, const uint8_t* data, int bytes);
 /// DATA indication: from turn server to client
 int turn_client_ondata(struct stun_agent_t* turn, const struct stun_request_t* req);
 /// ChannelData: from turn server to client
@@ -83,19 +94,37 @@ int turn_client_onchannel_data(struct stun_agent_t* turn, struct turn_allocation
 
 struct turn_allocation_t* turn_allocation_create(void);
 int turn_allocation_destroy(struct turn_allocation_t** pp);
+/// start/stop permission/channel expire timer with owner allocation table timer
+int turn_allocation_timer_start(struct turn_allocation_t* allocate);
+int turn_allocation_timer_stop(struct turn_allocation_t* allocate);
 const struct turn_permission_t* turn_allocation_find_permission(const struct turn_allocation_t* allocate, const struct sockaddr* addr);
 int turn_allocation_add_permission(struct turn_allocation_t* allocate, const struct sockaddr* addr);
 const struct turn_channel_t* turn_allocation_find_channel(const struct turn_allocation_t* allocate, uint16_t channel);
 const struct turn_channel_t* turn_allocation_find_channel_by_peer(const struct turn_allocation_t* allocate, const struct sockaddr* addr);
 int turn_allocation_add_channel(struct turn_allocation_t* allocate, const struct sockaddr* addr, uint16_t channel);
-
-struct turn_allocation_t* turn_agent_allocation_find_by_token(struct list_head* root, const void* token);
-struct turn_allocation_t* turn_agent_allocation_find_by_relay(struct list_head* root, const struct sockaddr* relayed);
-struct turn_allocation_t* turn_agent_allocation_find_by_address(struct list_head* root, const struct sockaddr* host, const struct sockaddr* peer);
-int turn_agent_allocation_insert(struct list_head* root, struct turn_allocation_t* allocate);
-int turn_agent_allocation_remove(struct list_head* root, struct turn_allocation_t* allocate);
+/// parse ChannelData, find the bound channel and check lifetime
+/// @param[out] payload/length application data
+/// @return NULL-invalid message, unknown or expired channel(discard)
+const struct turn_channel_t* turn_channel_data_read(const struct turn_allocation_t* allocate, const uint8_t* data, int bytes, const uint8_t** payload, int* length);
+/// write ChannelData(channel number + length + data)
+/// @return ChannelData bytes, <0-data too long
+int turn_channel_data_write(const struct turn_channel_t* channel, const void* data, int bytes, uint8_t* ptr, int size);
+
+void turn_agent_allocations_init(struct turn_allocations_t* allocations, time_wheel_t* timer);
+/// destroy all allocations and free hash buckets
+void turn_agent_allocations_destroy(struct turn_allocations_t* allocations);
+
+struct turn_allocation_t* turn_agent_allocation_find_by_token(struct turn_allocations_t* allocations, const void* token);
+struct turn_allocation_t* turn_agent_allocation_find_by_relay(struct turn_allocations_t* allocations, const struct sockaddr* relayed);
+struct turn_allocation_t* turn_agent_allocation_find_by_address(struct turn_allocations_t* allocations, const struct sockaddr* host, const struct sockaddr* peer);
+/// Note: address(host/peer/relay) MUST NOT be changed after insert, remove it first
+int turn_agent_allocation_insert(struct turn_allocations_t* allocations, struct turn_allocation_t* allocate);
+int turn_agent_allocation_remove(struct turn_allocations_t* allocations, struct turn_allocation_t* allocate);
 struct turn_allocation_t* turn_agent_allocation_reservation_token(struct stun_agent_t* turn, struct turn_allocation_t* from);
 
+void turn_agent_relay_destroy(struct stun_agent_t* stun);
+
+/// trigger expired allocation/permission/channel, cost O(expired)
 int turn_agent_allocation_cleanup(struct stun_agent_t* turn);
 
 #endif /* _turn_internal_h_ */
@@ -0,0 +1,272 @@
+// TURN server relay data plane
+// ChannelData / SEND indication / peer data are forwarded without stun_message_read,
+// only the 5-tuple/relayed address hash lookup and a few header checks.
+
+#include "stun-internal.h"
+#include "turn-internal.h"
+#include "byte-order.h"
+#include "sys/system.h"
+#include <stdlib.h>
+
+#define TURN_RELAY_BATCH		64
+#define TURN_CHANNEL_DATA_MTU	1600
+
+struct turn_relay_batch_t
+{
+	int n;
+	struct stun_packet_t pkts[TURN_RELAY_BATCH];
+	uint8_t buffers[TURN_RELAY_BATCH][TURN_CHANNEL_DATA_MTU]; // peer -> client ChannelData
+};
+
+static int turn_relay_flush(struct stun_agent_t* turn, struct turn_relay_batch_t* batch)
+{
+	int i, r;
+	const struct stun_packet_t* pkt;
+
+	if (!batch || batch->n < 1)
+		return 0;
+
+	r = 0;
+	if (turn->handler.sendmmsg)
+	{
+		r = turn->handler.sendmmsg(turn->param, batch->pkts, batch->n);
+	}
+	else
+	{
+		for (i = 0; i < batch->n; i++)
+		{
+			pkt = &batch->pkts[i];
+			r = turn->handler.send(turn->param, pkt->protocol, pkt->local, pkt->remote, pkt->data, pkt->bytes);
+		}
+	}
+
+	batch->n = 0;
+	return r;
+}
+
+static int turn_relay_send(struct stun_agent_t* turn, struct turn_relay_batch_t* batch, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
+{
+	struct stun_packet_t* pkt;
+	if (!batch)
+		return turn->handler.send(turn->param, protocol, local, remote, data, bytes);
+
+	// data/address MUST be valid until flush(input packet or allocation)
+	pkt = &batch->pkts[batch->n++];
+	pkt->protocol = protocol;
+	pkt->local = local;
+	pkt->remote = remote;
+	pkt->data = data;
+	pkt->bytes = bytes;
+	return batch->n < TURN_RELAY_BATCH ? 0 : turn_relay_flush(turn, batch);
+}
+
+/// peer -> server -> client
+static int turn_relay_peer_data(struct stun_agent_t* turn, struct turn_relay_batch_t* batch, struct turn_allocation_t* allocate, const struct sockaddr* peer, const uint8_t* data, int bytes)
+{
+	uint8_t stack[TURN_CHANNEL_DATA_MTU];
+	uint8_t* ptr;
+	const struct turn_channel_t* channel;
+	const struct turn_permission_t* permission;
+
+	permission = turn_allocation_find_permission(allocate, peer);
+	if (!permission || (int)(permission->expired - system_clock_coarse()) < 0)
+		return 0; // expired
+
+	channel = turn_allocation_find_channel_by_peer(allocate, peer);
+	if (!channel || (int)(channel->expired - system_clock_coarse()) < 0)
+	{
+		// DATA indication, keep order with batched ChannelData
+		turn_relay_flush(turn, batch);
+		return turn_server_relay(turn, allocate, peer, data, bytes);
+	}
+
+	ptr = batch ? batch->buffers[batch->n] : stack;
+	bytes = turn_channel_data_write(channel, data, bytes, ptr, TURN_CHANNEL_DATA_MTU);
+	if (bytes < 0)
+		return bytes;
+	return turn_relay_send(turn, batch, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer, ptr, bytes);
+}
+
+/// ChannelData: client -> server -> peer
+static int turn_relay_channel_data(struct stun_agent_t* turn, struct turn_relay_batch_t* batch, struct turn_allocation_t* allocate, const uint8_t* data, int bytes)
+{
+	int length;
+	const uint8_t* payload;
+	const struct turn_channel_t* channel;
+
+	channel = turn_channel_data_read(allocate, data, bytes, &payload, &length);
+	if (!channel)
+		return 0; // discard
+
+	return turn_relay_send(turn, batch, allocate->peertransport, (const struct sockaddr*)&allocate->addr.relay, (const struct sockaddr*)&channel->addr, payload, length);
+}
+
+static int turn_relay_xor_peer_address(const uint8_t* data, int bytes, const uint8_t* tid, struct sockaddr_storage* addr)
+{
+	int i;
+	struct sockaddr_in* in;
+	struct sockaddr_in6* in6;
+
+	memset(addr, 0, sizeof(*addr));
+	if (8 == bytes && 1 == data[1])
+	{
+		in = (struct sockaddr_in*)addr;
+		in->sin_family = AF_INET;
+		memcpy(&in->sin_port, data + 2, 2);
+		memcpy(&in->sin_addr, data + 4, 4);
+		in->sin_port ^= htons((uint16_t)(STUN_MAGIC_COOKIE >> 16));
+		in->sin_addr.s_addr ^= htonl(STUN_MAGIC_COOKIE);
+		return 0;
+	}
+	else if (20 == bytes && 2 == data[1])
+	{
+		in6 = (struct sockaddr_in6*)addr;
+		in6->sin6_family = AF_INET6;
+		memcpy(&in6->sin6_port, data + 2, 2);
+		in6->sin6_port ^= htons((uint16_t)(STUN_MAGIC_COOKIE >> 16));
+		in6->sin6_addr.s6_addr[0] = data[4] ^ (uint8_t)(STUN_MAGIC_COOKIE >> 24);
+		in6->sin6_addr.s6_addr[1] = data[5] ^ (uint8_t)(STUN_MAGIC_COOKIE >> 16);
+		in6->sin6_addr.s6_addr[2] = data[6] ^ (uint8_t)(STUN_MAGIC_COOKIE >> 8);
+		in6->sin6_addr.s6_addr[3] = data[7] ^ (uint8_t)(STUN_MAGIC_COOKIE >> 0);
+		for (i = 0; i < 12; i++)
+			in6->sin6_addr.s6_addr[4 + i] = data[8 + i] ^ tid[i];
+		return 0;
+	}
+	return -1;
+}
+
+/// SEND indication: client -> server -> peer
+/// @return 0-relayed/discard, 1-not a simple SEND indication
+static int turn_relay_send_indication(struct stun_agent_t* turn, struct turn_relay_batch_t* batch, struct turn_allocation_t* allocate, const uint8_t* data, int bytes)
+{
+	uint16_t type, length, attrlen;
+	const uint8_t* p, *end;
+	const uint8_t* payload;
+	int payloadlen, peerlen;
+	struct sockaddr_storage peer;
+	const struct turn_permission_t* permission;
+
+	be_read_uint16(data + 2, &length);
+	if (length + STUN_HEADER_SIZE > bytes || 0 != length % 4)
+		return 0; // invalid message, discard
+
+	payload = NULL;
+	payloadlen = peerlen = -1;
+	end = data + STUN_HEADER_SIZE + length;
+	for (p = data + STUN_HEADER_SIZE; p + 4 <= end; p += 4 + ALGIN_4BYTES(attrlen))
+	{
+		be_read_uint16(p, &type);
+		be_read_uint16(p + 2, &attrlen);
+		if (p + 4 + attrlen > end)
+			return 0; // discard
+
+		if (STUN_ATTR_XOR_PEER_ADDRESS == type && -1 == peerlen)
+		{
+			// only one peer address in SEND indication
+			peerlen = attrlen;
+			if (0 != turn_relay_xor_peer_address(p + 4, attrlen, data + 8, &peer))
+				return 0; // discard
+		}
+		else if (STUN_ATTR_DATA == type)
+		{
+			payload = p + 4;
+			payloadlen = attrlen;
+		}
+	}
+
+	if (!payload || -1 == peerlen)
+		return 0; // discard
+
+	// rfc5766 10.2. Receiving a Send Indication (p35)
+	// If there is no permission, the server silently discards the Send indication.
+	permission = turn_allocation_find_permission(allocate, (const struct sockaddr*)&peer);
+	if (!permission || (int)(permission->expired - system_clock_coarse()) < 0)
+		return 0;
+
+	// peer is stack address, can't be batched
+	turn_relay_flush(turn, batch);
+	return turn->handler.send(turn->param, allocate->peertransport, (const struct sockaddr*)&allocate->addr.relay, (const struct sockaddr*)&peer, payload, payloadlen);
+}
+
+/// @return 0-relayed/discard, 1-not relay data plane packet(need stun_agent_input2)
+static int turn_relay_input(struct stun_agent_t* turn, struct turn_relay_batch_t* batch, const struct stun_packet_t* pkt)
+{
+	uint16_t msgtype;
+	uint32_t cookie;
+	const uint8_t* data;
+	struct turn_allocation_t* allocate;
+
+	data = (const uint8_t*)pkt->data;
+	if (pkt->bytes < 1 || !pkt->local || !pkt->remote || turn->turnservers.addresses.count < 1)
+		return 1;
+
+	// 1. peer data to relayed transport address
+	allocate = turn_agent_allocation_find_by_relay(&turn->turnservers, pkt->local);
+	if (allocate)
+		return turn_relay_peer_data(turn, batch, allocate, pkt->remote, data, pkt->bytes);
+
+	// 2. ChannelData (first two bits 0b01)
+	if (0x40 == (0xC0 & data[0]))
+	{
+		allocate = turn_agent_allocation_find_by_address(&turn->turnservers, pkt->local, pkt->remote);
+		return allocate ? turn_relay_channel_data(turn, batch, allocate, data, pkt->bytes) : 1;
+	}
+
+	// 3. SEND indication
+	if (pkt->bytes < STUN_HEADER_SIZE)
+		return 1;
+	be_read_uint16(data, &msgtype);
+	be_read_uint32(data + 4, &cookie);
+	if (STUN_MESSAGE_TYPE(STUN_METHOD_CLASS_INDICATION, STUN_METHOD_SEND) != msgtype || STUN_MAGIC_COOKIE != cookie)
+		return 1;
+
+	allocate = turn_agent_allocation_find_by_address(&turn->turnservers, pkt->local, pkt->remote);
+	return allocate ? turn_relay_send_indication(turn, batch, allocate, data, pkt->bytes) : 1;
+}
+
+int stun_agent_input(stun_agent_t* stun, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
+{
+	struct stun_packet_t pkt;
+
+	// expire allocations before lookup
+	turn_agent_allocation_cleanup(stun);
+
+	pkt.protocol = protocol;
+	pkt.local = local;
+	pkt.remote = remote;
+	pkt.data = data;
+	pkt.bytes = bytes;
+	if (0 == turn_relay_input(stun, NULL, &pkt))
+		return 0;
+
+	return stun_agent_input2(stun, protocol, local, remote, NULL, data, bytes);
+}
+
+int stun_agent_input_batch(stun_agent_t* stun, const struct stun_packet_t* pkts, int n)
+{
+	int i;
+
+	turn_agent_allocation_cleanup(stun);
+
+	if (!stun->relay)
+		stun->relay = (struct turn_relay_batch_t*)calloc(1, sizeof(struct turn_relay_batch_t));
+
+	for (i = 0; i < n; i++)
+	{
+		if (0 == turn_relay_input(stun, stun->relay, &pkts[i]))
+			continue;
+
+		// stun/turn request/response, keep order
+		turn_relay_flush(stun, stun->relay);
+		stun_agent_input2(stun, pkts[i].protocol, pkts[i].local, pkts[i].remote, NULL, pkts[i].data, pkts[i].bytes);
+	}
+
+	return turn_relay_flush(stun, stun->relay);
+}
+
+void turn_agent_relay_destroy(struct stun_agent_t* stun)
+{
+	if (stun->relay)
+		free(stun->relay);
+	stun->relay = NULL;
+}
@@ -43,7 +43,7 @@ int turn_server_onallocate(struct stun_agent_t* turn, const struct stun_request_
 	// 2. checks the 5-tuple
 	allocate = turn_agent_allocation_find_by_address(&turn->turnservers, (const struct sockaddr*)&req->addr.host, (const struct sockaddr*)&req->addr.peer);
 	if (NULL != allocate)
-		return (int)(allocate->expire - system_clock()) < 0 ? stun_server_response_failure(resp, 437, "Allocation Mismatch") : turn_server_allocate_doresponse(resp, allocate);
+		return (int)(allocate->expire - system_clock_coarse()) < 0 ? stun_server_response_failure(resp, 437, "Allocation Mismatch") : turn_server_allocate_doresponse(resp, allocate);
 
 	// 3. check REQUESTED-TRANSPORT
 	transport = stun_message_attr_find(&req->msg, STUN_ATTR_REQUESTED_TRANSPORT);
@@ -80,7 +80,7 @@ int turn_server_onallocate(struct stun_agent_t* turn, const struct stun_request_
 			stun_response_destroy(&resp);
 			return 0;
 		}
-		else if ((int)(allocate->expire - system_clock()) < 0)
+		else if ((int)(allocate->expire - system_clock_coarse()) < 0)
 		{
 			return stun_server_response_failure(resp, 508, "Insufficient Capacity");
 		}
@@ -88,7 +88,7 @@ int turn_server_onallocate(struct stun_agent_t* turn, const struct stun_request_
 		allocate->lifetime = lifetime ? lifetime->v.u32 : TURN_LIFETIME;
 		allocate->lifetime = allocate->lifetime > TURN_LIFETIME ? allocate->lifetime : TURN_LIFETIME;
 		allocate->lifetime = allocate->lifetime < 3600 ? allocate->lifetime : 3600; // 1-hour
-		allocate->expire = system_clock() + allocate->lifetime * 1000;
+		allocate->expire = system_clock_coarse() + allocate->lifetime * 1000;
 		allocate->dontfragment = fragment ? fragment->v.u32 : 1;
 		allocate->peertransport = !transport || TURN_TRANSPORT_UDP == (transport->v.u32 >> 24) ? STUN_PROTOCOL_UDP : STUN_PROTOCOL_TCP;
 
@@ -113,7 +113,7 @@ int turn_server_onallocate(struct stun_agent_t* turn, const struct stun_request_
 		allocate->lifetime = lifetime ? lifetime->v.u32 : TURN_LIFETIME;
 		allocate->lifetime = allocate->lifetime > TURN_LIFETIME ? allocate->lifetime : TURN_LIFETIME;
 		allocate->lifetime = allocate->lifetime < 3600 ? allocate->lifetime : 3600; // 1-hour
-		allocate->expire = system_clock() + allocate->lifetime * 1000;
+		allocate->expire = system_clock_coarse() + allocate->lifetime * 1000;
 		allocate->dontfragment = fragment ? fragment->v.u32 : 1;
 		allocate->peertransport = !transport || TURN_TRANSPORT_UDP == (transport->v.u32 >> 24) ? STUN_PROTOCOL_UDP : STUN_PROTOCOL_TCP;
 
@@ -185,7 +185,7 @@ int turn_server_onrefresh(struct stun_agent_t* turn, const struct stun_request_t
 	{
 		lifetime = lifetime > TURN_LIFETIME ? lifetime : TURN_LIFETIME;
 		lifetime = lifetime < 3600 ? lifetime : 3600; // 1-hour
-		allocate->expire = system_clock() + lifetime * 1000;
+		allocate->expire = system_clock_coarse() + lifetime * 1000;
 	}
 
 	// reply
@@ -221,17 +221,23 @@ static int turn_agent_add_permission(void* param, const struct stun_attr_t* attr
 
 int turn_server_oncreate_permission(struct stun_agent_t* turn, const struct stun_request_t* req, struct stun_response_t* resp)
 {
-	int r, n;
+	int r;
+	const struct stun_attr_t* peer;
 	struct turn_allocation_t* allocate;
-	struct turn_permission_t* permission;
 
 	allocate = turn_agent_allocation_find_by_address(&turn->turnservers, (const struct sockaddr*)&req->addr.host, (const struct sockaddr*)&req->addr.peer);
 	if (NULL == allocate)
 		return stun_server_response_failure(resp, 437, "Allocation Mismatch");
 
-	n = allocate->npermission;
 	// The CreatePermission request MUST contain at least one XOR-PEER-ADDRESS 
 	// attribute and MAY contain multiple such attributes
+	peer = stun_message_attr_find(&req->msg, STUN_ATTR_XOR_PEER_ADDRESS);
+	if (!peer)
+		return stun_server_response_failure(resp, 400, "Bad Request");
+
+	if (peer->v.addr.ss_family != allocate->addr.relay.ss_family)
+		return stun_server_response_failure(resp, 443, "Peer Address Family Mismatch");
+
 	r = stun_message_attr_list(&req->msg, STUN_ATTR_XOR_PEER_ADDRESS, turn_agent_add_permission, allocate);
 	if (0 != r)
 	{
@@ -242,15 +248,8 @@ int turn_server_oncreate_permission(struct stun_agent_t* turn, const struct stun
 		return stun_server_response_failure(resp, 508, "Insufficient Capacity)");
 	}
 
-	if(n >= allocate->npermission)
-		return stun_server_response_failure(resp, 400, "Bad Request");
-
 	// reply
-	permission = &allocate->permissions[n];
-    if(permission->addr.ss_family != allocate->addr.relay.ss_family)
-        return stun_server_response_failure(resp, 443, "Peer Address Family Mismatch");
-
-	return turn->handler.onpermission(turn->param, resp, req, (const struct sockaddr*)&permission->addr);
+	return turn->handler.onpermission(turn->param, resp, req, (const struct sockaddr*)&peer->v.addr);
 }
 
 int turn_agent_create_permission_response(struct stun_response_t* resp, int code, const char* pharse)
@@ -350,19 +349,14 @@ static int turn_server_relay_channel_data(struct stun_agent_t* turn, const struc
 {
 	uint8_t ptr[1600];
 
-	if ((int)(channel->expired - system_clock()) < 0)
+	if ((int)(channel->expired - system_clock_coarse()) < 0)
 		return 0; // expired
 
-	if (bytes + 4 > sizeof(ptr))
-		return -1; // MTU too long
-
-	ptr[0] = (uint8_t)(channel->channel >> 8);
-	ptr[1] = (uint8_t)(channel->channel);
-	ptr[2] = (uint8_t)(bytes >> 8);
-	ptr[3] = (uint8_t)(bytes);
-	memcpy(ptr + 4, data, bytes);
+	bytes = turn_channel_data_write(channel, data, bytes, ptr, sizeof(ptr));
+	if (bytes < 0)
+		return bytes; // MTU too long
 
-	return turn->handler.send(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer, ptr, bytes+4);
+	return turn->handler.send(turn->param, allocate->addr.protocol, (const struct sockaddr*)&allocate->addr.host, (const struct sockaddr*)&allocate->addr.peer, ptr, bytes);
 }
 
 // relay peer data to client (peer -> server -> client)
@@ -372,7 +366,7 @@ int turn_server_relay(struct stun_agent_t* turn, const struct turn_allocation_t*
 	const struct turn_permission_t* permission;
 
 	permission = turn_allocation_find_permission(allocate, peer);
-	if (!permission || (int)(permission->expired - system_clock()) < 0)
+	if (!permission || (int)(permission->expired - system_clock_coarse()) < 0)
 		return 0; // expired
 
 	channel = turn_allocation_find_channel_by_peer(allocate, peer);
@@ -388,7 +382,7 @@ int turn_server_onsend(struct stun_agent_t* turn, const struct stun_request_t* r
 	struct turn_allocation_t* allocate;
 	
 	allocate = turn_agent_allocation_find_by_address(&turn->turnservers, (const struct sockaddr*)&req->addr.host, (const struct sockaddr*)&req->addr.peer);
-	if (NULL == allocate || (int)(allocate->expire - system_clock()) < 0)
+	if (NULL == allocate || (int)(allocate->expire - system_clock_coarse()) < 0)
 		return 0; // discard
 
 	attr = stun_message_attr_find(&req->msg, STUN_ATTR_DONT_FRAGMENT);
@@ -403,19 +397,3 @@ int turn_server_onsend(struct stun_agent_t* turn, const struct stun_request_t* r
 
 	return turn->handler.send(turn->param, allocate->peertransport, (const struct sockaddr*)&allocate->addr.relay, (const struct sockaddr*)&peer, attr->v.ptr, attr->length);
 }
-
-// ChannelData from client(client -> server -> peer)
-int turn_server_onchannel_data(struct stun_agent_t* turn, struct turn_allocation_t* allocate, const uint8_t* data, int bytes)
-{
-	uint16_t number;
-	uint16_t length;
-	const struct turn_channel_t* channel;
-
-	number = ((uint16_t)data[0] << 8) | (uint16_t)data[1];
-	length = ((uint16_t)data[2] << 8) | (uint16_t)data[3];
-	channel = turn_allocation_find_channel(allocate, number);
-	if (channel && length + 4 <= bytes)
-		turn->handler.send(turn->param, allocate->peertransport, (const struct sockaddr*)&allocate->addr.relay, (const struct sockaddr*)&channel->addr, (const uint8_t*)data + 4, length);
-	
-	return 0;
-}
@@ -0,0 +1,297 @@
+// TURN server relay data plane loopback benchmark
+// client --(ChannelData)--> turn server --(UDP)--> peer
+// peer --(UDP)--> turn server --(ChannelData)--> client
+// control plane(Allocate/CreatePermission/ChannelBind) in-memory, data plane over 127.0.0.1 UDP sockets
+
+#if defined(OS_LINUX)
+#define _GNU_SOURCE
+#include "sockutil.h"
+#include "stun-agent.h"
+#include "stun-proto.h"
+#include "sys/system.h"
+#include <sys/socket.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define TURN_RELAY_BENCHMARK_BATCH		64
+#define TURN_RELAY_BENCHMARK_PAYLOAD	1200
+#define TURN_RELAY_BENCHMARK_CHANNEL	0x4000
+#define TURN_RELAY_BENCHMARK_DURATION	5000 // ms
+
+struct turn_relay_benchmark_t
+{
+	socket_t client, server, relay, peer;
+	struct sockaddr_storage caddr, saddr, raddr, paddr;
+
+	stun_agent_t* cstun; // turn client
+	stun_agent_t* sstun; // turn server
+	int control; // 1-control plane(in-memory), 0-data plane(socket)
+	int code;
+};
+
+static int turn_relay_benchmark_sendmmsg(void* param, const struct stun_packet_t* pkts, int n)
+{
+	int i;
+	socket_t udp;
+	struct iovec iov[TURN_RELAY_BENCHMARK_BATCH];
+	struct mmsghdr msgs[TURN_RELAY_BENCHMARK_BATCH];
+	struct turn_relay_benchmark_t* ctx;
+	ctx = (struct turn_relay_benchmark_t*)param;
+
+	assert(n <= TURN_RELAY_BENCHMARK_BATCH);
+	udp = 0 == socket_addr_compare(pkts[0].local, (const struct sockaddr*)&ctx->raddr) ? ctx->relay : ctx->server;
+	memset(msgs, 0, sizeof(msgs[0]) * n);
+	for (i = 0; i < n; i++)
+	{
+		assert(udp == (0 == socket_addr_compare(pkts[i].local, (const struct sockaddr*)&ctx->raddr) ? ctx->relay : ctx->server));
+		iov[i].iov_base = (void*)pkts[i].data;
+		iov[i].iov_len = pkts[i].bytes;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = (void*)pkts[i].remote;
+		msgs[i].msg_hdr.msg_namelen = socket_addr_len(pkts[i].remote);
+	}
+
+	return sendmmsg(udp, msgs, n, 0) == n ? 0 : -1;
+}
+
+static int turn_relay_benchmark_server_send(void* param, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
+{
+	struct stun_packet_t pkt;
+	struct turn_relay_benchmark_t* ctx;
+	ctx = (struct turn_relay_benchmark_t*)param;
+
+	if (ctx->control)
+		return stun_agent_input(ctx->cstun, protocol, remote, local, data, bytes);
+
+	pkt.protocol = protocol;
+	pkt.local = local;
+	pkt.remote = remote;
+	pkt.data = data;
+	pkt.bytes = bytes;
+	return turn_relay_benchmark_sendmmsg(param, &pkt, 1);
+}
+
+static int turn_relay_benchmark_client_send(void* param, int protocol, const struct sockaddr* local, const struct sockaddr* remote, const void* data, int bytes)
+{
+	struct turn_relay_benchmark_t* ctx;
+	ctx = (struct turn_relay_benchmark_t*)param;
+	assert(ctx->control);
+	return stun_agent_input(ctx->sstun, protocol, remote, local, data, bytes);
+}
+
+static int turn_relay_benchmark_onallocate(void* param, stun_response_t* resp, const stun_request_t* req, int evenport, int nextport)
+{
+	struct turn_relay_benchmark_t* ctx;
+	ctx = (struct turn_relay_benchmark_t*)param;
+	(void)req, (void)evenport, (void)nextport;
+	return turn_agent_allocate_response(resp, (const struct sockaddr*)&ctx->raddr, 200, "OK");
+}
+
+static int turn_relay_benchmark_onpermission(void* param, stun_response_t* resp, const stun_request_t* req, const struct sockaddr* peer)
+{
+	(void)param, (void)req, (void)peer;
+	return turn_agent_create_permission_response(resp, 200, "OK");
+}
+
+static int turn_relay_benchmark_onchannel(void* param, stun_response_t* resp, const stun_request_t* req, const struct sockaddr* peer, uint16_t channel)
+{
+	(void)param, (void)req, (void)peer, (void)channel;
+	return turn_agent_channel_bind_response(resp, 200, "OK");
+}
+
+static int turn_relay_benchmark_onresponse(void* param, const stun_request_t* req, int code, const char* phrase)
+{
+	struct turn_relay_benchmark_t* ctx;
+	ctx = (struct turn_relay_benchmark_t*)param;
+	(void)req, (void)phrase;
+	ctx->code = code;
+	return 0;
+}
+
+// stun agent retransmission tick, the benchmark drive both agents synchronously
+void* stun_timer_start(int ms, void(*ontimer)(void* param), void* param)
+{
+	(void)ms, (void)ontimer, (void)param;
+	return NULL;
+}
+
+int stun_timer_stop(void* timer)
+{
+	(void)timer;
+	return -1;
+}
+
+static socket_t turn_relay_benchmark_socket(struct sockaddr_storage* addr)
+{
+	int size;
+	socket_t udp;
+	socklen_t addrlen;
+
+	size = 8 * 1024 * 1024;
+	udp = socket_udp_bind_ipv4("127.0.0.1", 0);
+	socket_setrecvbuf(udp, size);
+	socket_setsendbuf(udp, size);
+	addrlen = sizeof(*addr);
+	getsockname(udp, (struct sockaddr*)addr, &addrlen);
+	return udp;
+}
+
+static stun_request_t* turn_relay_benchmark_request(struct turn_relay_benchmark_t* ctx)
+{
+	stun_request_t* req;
+	req = stun_request_create(ctx->cstun, STUN_RFC_5389, turn_relay_benchmark_onresponse, ctx);
+	stun_request_setaddr(req, STUN_PROTOCOL_UDP, (const struct sockaddr*)&ctx->caddr, (const struct sockaddr*)&ctx->saddr, NULL);
+	stun_request_setauth(req, STUN_CREDENTIAL_LONG_TERM, "demo", "demo", "demo.com", "benchmark");
+	ctx->code = -1;
+	return req;
+}
+
+/// @return received bytes
+static int64_t turn_relay_benchmark_recv(socket_t udp, stun_agent_t* stun, const struct sockaddr* local, int batch, int* packets)
+{
+	int i, n;
+	int64_t bytes;
+	static uint8_t buffers[TURN_RELAY_BENCHMARK_BATCH][1600];
+	struct iovec iov[TURN_RELAY_BENCHMARK_BATCH];
+	struct sockaddr_storage addrs[TURN_RELAY_BENCHMARK_BATCH];
+	struct mmsghdr msgs[TURN_RELAY_BENCHMARK_BATCH];
+	struct stun_packet_t pkts[TURN_RELAY_BENCHMARK_BATCH];
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < TURN_RELAY_BENCHMARK_BATCH; i++)
+	{
+		iov[i].iov_base = buffers[i];
+		iov[i].iov_len = sizeof(buffers[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+
+	n = recvmmsg(udp, msgs, TURN_RELAY_BENCHMARK_BATCH, MSG_DONTWAIT, NULL);
+	for (bytes = i = 0; i < n; i++)
+	{
+		bytes += msgs[i].msg_len;
+		pkts[i].protocol = STUN_PROTOCOL_UDP;
+		pkts[i].local = local;
+		pkts[i].remote = (const struct sockaddr*)&addrs[i];
+		pkts[i].data = buffers[i];
+		pkts[i].bytes = (int)msgs[i].msg_len;
+		if (stun && !batch)
+			stun_agent_input(stun, pkts[i].protocol, pkts[i].local, pkts[i].remote, pkts[i].data, pkts[i].bytes);
+	}
+
+	if (stun && batch && n > 0)
+		stun_agent_input_batch(stun, pkts, n);
+
+	*packets += n > 0 ? n : 0;
+	return bytes;
+}
+
+static void turn_relay_benchmark_run(struct turn_relay_benchmark_t* ctx, int batch)
+{
+	int i, n, relayed, packets;
+	int64_t bytes;
+	uint64_t clock, elapsed;
+	uint8_t channel[TURN_RELAY_BENCHMARK_PAYLOAD + 4];
+	uint8_t payload[TURN_RELAY_BENCHMARK_PAYLOAD];
+	struct iovec iov[TURN_RELAY_BENCHMARK_BATCH * 2];
+	struct mmsghdr msgs[TURN_RELAY_BENCHMARK_BATCH * 2];
+
+	channel[0] = (uint8_t)(TURN_RELAY_BENCHMARK_CHANNEL >> 8);
+	channel[1] = (uint8_t)TURN_RELAY_BENCHMARK_CHANNEL;
+	channel[2] = (uint8_t)(TURN_RELAY_BENCHMARK_PAYLOAD >> 8);
+	channel[3] = (uint8_t)TURN_RELAY_BENCHMARK_PAYLOAD;
+	memset(channel + 4, 'C', TURN_RELAY_BENCHMARK_PAYLOAD);
+	memset(payload, 'P', sizeof(payload));
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < TURN_RELAY_BENCHMARK_BATCH * 2; i++)
+	{
+		iov[i].iov_base = i < TURN_RELAY_BENCHMARK_BATCH ? channel : payload;
+		iov[i].iov_len = i < TURN_RELAY_BENCHMARK_BATCH ? sizeof(channel) : sizeof(payload);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &ctx->saddr;
+		msgs[i].msg_hdr.msg_namelen = socket_addr_len((const struct sockaddr*)&ctx->saddr);
+		if (i >= TURN_RELAY_BENCHMARK_BATCH)
+		{
+			msgs[i].msg_hdr.msg_name = &ctx->raddr;
+			msgs[i].msg_hdr.msg_namelen = socket_addr_len((const struct sockaddr*)&ctx->raddr);
+		}
+	}
+
+	bytes = 0;
+	packets = relayed = 0;
+	clock = system_clock();
+	do
+	{
+		// client -> server -> peer
+		n = sendmmsg(ctx->client, msgs, TURN_RELAY_BENCHMARK_BATCH, 0);
+		assert(TURN_RELAY_BENCHMARK_BATCH == n);
+		turn_relay_benchmark_recv(ctx->server, ctx->sstun, (const struct sockaddr*)&ctx->saddr, batch, &relayed);
+		bytes += turn_relay_benchmark_recv(ctx->peer, NULL, NULL, batch, &packets);
+
+		// peer -> server -> client
+		n = sendmmsg(ctx->peer, msgs + TURN_RELAY_BENCHMARK_BATCH, TURN_RELAY_BENCHMARK_BATCH, 0);
+		assert(TURN_RELAY_BENCHMARK_BATCH == n);
+		turn_relay_benchmark_recv(ctx->relay, ctx->sstun, (const struct sockaddr*)&ctx->raddr, batch, &relayed);
+		bytes += turn_relay_benchmark_recv(ctx->client, NULL, NULL, batch, &packets);
+
+		elapsed = system_clock() - clock;
+	} while (elapsed < TURN_RELAY_BENCHMARK_DURATION);
+
+	printf("turn relay %s: %d packets, %.2f Mpps, %.3f Gbps\n", batch ? "stun_agent_input_batch" : "stun_agent_input", packets, packets / 1000.0 / elapsed, bytes * 8.0 / 1000000.0 / elapsed);
+}
+
+void turn_relay_benchmark(void)
+{
+	struct turn_relay_benchmark_t ctx;
+	struct stun_agent_handler_t handler;
+	stun_request_t* req;
+
+	socket_init();
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.client = turn_relay_benchmark_socket(&ctx.caddr);
+	ctx.server = turn_relay_benchmark_socket(&ctx.saddr);
+	ctx.relay = turn_relay_benchmark_socket(&ctx.raddr);
+	ctx.peer = turn_relay_benchmark_socket(&ctx.paddr);
+
+	memset(&handler, 0, sizeof(handler));
+	handler.send = turn_relay_benchmark_server_send;
+	handler.sendmmsg = turn_relay_benchmark_sendmmsg;
+	handler.onallocate = turn_relay_benchmark_onallocate;
+	handler.onpermission = turn_relay_benchmark_onpermission;
+	handler.onchannel = turn_relay_benchmark_onchannel;
+	ctx.sstun = stun_agent_create(STUN_RFC_5389, &handler, &ctx);
+
+	memset(&handler, 0, sizeof(handler));
+	handler.send = turn_relay_benchmark_client_send;
+	ctx.cstun = stun_agent_create(STUN_RFC_5389, &handler, &ctx);
+
+	// control plane
+	ctx.control = 1;
+	req = turn_relay_benchmark_request(&ctx);
+	turn_agent_allocate(req, TURN_TRANSPORT_UDP);
+	assert(0 == ctx.code);
+	req = turn_relay_benchmark_request(&ctx);
+	turn_agent_channel_bind(req, (const struct sockaddr*)&ctx.paddr, TURN_RELAY_BENCHMARK_CHANNEL);
+	assert(0 == ctx.code);
+	ctx.control = 0;
+
+	// data plane
+	turn_relay_benchmark_run(&ctx, 0);
+	turn_relay_benchmark_run(&ctx, 1);
+
+	stun_agent_destroy(&ctx.sstun);
+	stun_agent_destroy(&ctx.cstun);
+	socket_close(ctx.client);
+	socket_close(ctx.server);
+	socket_close(ctx.relay);
+	socket_close(ctx.peer);
+	socket_cleanup();
+}
+#endif
@@ -3,7 +3,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <assert.h>
+#include <errno.h>
+#include <time.h>
 
 #if defined(OS_WINDOWS)
 #include <Windows.h>
@@ -18,6 +21,13 @@
 #endif
 #endif
 
+#if !defined(OS_RTOS)
+#include "ring-buffer.h"
+#include "sys/atomic.h"
+#include "sys/thread.h"
+#include "sys/event.h"
+#endif
+
 #if defined(OS_WINDOWS)
 #define THREAD_LOCAL static __declspec(thread)
 #elif defined(OS_RTOS)
@@ -65,9 +75,17 @@ static int app_log_time(char timestr[], unsigned int bytes)
 #else
 	struct tm t;
 	struct timeval tv;
+	THREAD_LOCAL time_t s_second = -1;
+	THREAD_LOCAL char s_timestr[80]; // localtime and format once per second
+
 	gettimeofday(&tv, NULL);
-	localtime_r(&tv.tv_sec, &t);
-	return snprintf(timestr, bytes, "%04d-%02d-%02dT%02d:%02d:%02d.%03d|", (int)t.tm_year + 1900, (int)t.tm_mon+1, (int)t.tm_mday, (int)t.tm_hour, (int)t.tm_min, (int)t.tm_sec, (int)(tv.tv_usec / 1000) % 1000);
+	if (tv.tv_sec != s_second)
+	{
+		s_second = tv.tv_sec;
+		localtime_r(&tv.tv_sec, &t);
+		snprintf(s_timestr, sizeof(s_timestr), "%04d-%02d-%02dT%02d:%02d:%02d", (int)t.tm_year + 1900, (int)t.tm_mon + 1, (int)t.tm_mday, (int)t.tm_hour, (int)t.tm_min, (int)t.tm_sec);
+	}
+	return snprintf(timestr, bytes, "%.40s.%03d|", s_timestr, (int)(tv.tv_usec / 1000) % 1000);
 #endif
 	//return snprintf(timestr, sizeof(timestr), "%s-%02d %02d:%02d:%02d.%03d|", /*t.year+1900,*/ s_month[t.month % 12], t.day, t.hour, t.minute, t.second, t.millisecond);
 }
@@ -110,6 +128,545 @@ static void app_log_print(int level, const char* format, va_list args)
 	}
 }
 
+#if !defined(OS_RTOS)
+// async mode: caller serialize arguments by the format conversion specifications(8-bytes slot per argument,
+// %s copy the string), the background thread re-format every specification with snprintf.
+// unsupported specifications(%n, %ls, %Lf, ...) are formatted by the caller.
+#define APP_LOG_ASYNC_RING	(1024 * 1024)
+#define APP_LOG_ASYNC_BATCH	(1024 * 64)
+#define APP_LOG_ALIGN(n)	(((n) + 7) & ~7)
+
+enum { APP_LOG_ARG_INT = 1, APP_LOG_ARG_UINT, APP_LOG_ARG_CHAR, APP_LOG_ARG_DOUBLE, APP_LOG_ARG_PTR, APP_LOG_ARG_STR };
+
+// ring record, followed by the arguments(format != NULL) or text
+struct app_log_record_t
+{
+	uint64_t clock; // microseconds since 1970-01-01
+	const char* format; // NULL-preformatted text
+	int level;
+	int bytes;
+};
+
+union app_log_arg_t
+{
+	int64_t i;
+	uint64_t u;
+	double d;
+	const void* p;
+};
+
+struct app_log_spec_t
+{
+	int n; // specification length, include '%'
+	int stars; // '*' width/precision
+	int precision; // -1-none, -2-'*'
+	int length; // length modifier: 'H'-hh, 'h', 'l', 'L'-ll, 'j', 'z', 't', 'D'-long double
+	int type; // APP_LOG_ARG_XXX, 0-unsupported
+};
+
+static struct
+{
+	struct ring_mpsc_t ring;
+	event_t event;
+	pthread_t thread;
+	int rate; // max logs per second
+
+	volatile int32_t running;
+	volatile int32_t sleeping; // background thread is waiting logs
+	volatile int32_t dropped;
+	volatile int32_t window; // rate limit window(second)
+	volatile int32_t count; // logs in the window
+
+	// background thread only
+	int32_t reported; // dropped count reported
+	int64_t second; // cached time
+	char timestr[80]; // e.g. 2024-01-01T00:00:00
+	int n; // batch bytes
+	char batch[APP_LOG_ASYNC_BATCH];
+	char log[N_LOG_BUFFER];
+} s_async;
+
+static uint64_t app_log_clock(void)
+{
+#if defined(OS_WINDOWS)
+	FILETIME ft;
+	GetSystemTimeAsFileTime(&ft);
+	return ((((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime) - 116444736000000000ULL) / 10;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+/// parse printf conversion specification: %[flags][width][.precision][length]conversion
+/// @param[in] p specification, p[0] == '%'
+/// @return argument type, 0-unsupported
+static int app_log_spec_parse(const char* p, struct app_log_spec_t* spec)
+{
+	const char* s;
+	memset(spec, 0, sizeof(*spec));
+	spec->precision = -1;
+	for (s = p++; *p && strchr("-+ #0'", *p); p++)
+	{
+	}
+
+	if ('*' == *p)
+		spec->stars++, p++;
+	while ('0' <= *p && *p <= '9')
+		p++;
+	if ('.' == *p && '*' == *++p)
+	{
+		spec->stars++, p++;
+		spec->precision = -2;
+	}
+	else if ('.' == p[-1])
+	{
+		for (spec->precision = 0; '0' <= *p && *p <= '9' && spec->precision < 0x1000000; p++)
+			spec->precision = spec->precision * 10 + (*p - '0');
+	}
+	while ('0' <= *p && *p <= '9')
+		p++;
+
+	if ('h' == *p || 'l' == *p)
+	{
+		spec->length = *p++;
+		if (spec->length == *p)
+			spec->length = 'h' == *p++ ? 'H' : 'L';
+	}
+	else if (*p && strchr("qjztL", *p))
+	{
+		spec->length = 'q' == *p ? 'L' : ('L' == *p ? 'D' : *p);
+		p++;
+	}
+
+	switch (*p)
+	{
+	case 'd': case 'i':
+		spec->type = 'D' != spec->length ? APP_LOG_ARG_INT : 0;
+		break;
+	case 'u': case 'o': case 'x': case 'X':
+		spec->type = 'D' != spec->length ? APP_LOG_ARG_UINT : 0;
+		break;
+	case 'c':
+		spec->type = 0 == spec->length ? APP_LOG_ARG_CHAR : 0;
+		break;
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		spec->type = (0 == spec->length || 'l' == spec->length) ? APP_LOG_ARG_DOUBLE : 0;
+		break;
+	case 's':
+		spec->type = 0 == spec->length ? APP_LOG_ARG_STR : 0;
+		break;
+	case 'p':
+		spec->type = 0 == spec->length ? APP_LOG_ARG_PTR : 0;
+		break;
+	default:
+		spec->type = 0; // %n, %ls, %lc, %Lf, %I64d, ...
+	}
+
+	spec->n = (int)(p - s) + (*p ? 1 : 0);
+	return spec->n < 32 ? spec->type : 0;
+}
+
+/// rewrite specification for the stored argument type: integer -> long long
+static void app_log_spec_format(const char* p, const struct app_log_spec_t* spec, char fmt[40])
+{
+	int i, n;
+	for (n = i = 0; i < spec->n - 1; i++)
+	{
+		if (!strchr("hlqjztL", p[i]))
+			fmt[n++] = p[i];
+	}
+
+	if (APP_LOG_ARG_INT == spec->type || APP_LOG_ARG_UINT == spec->type)
+	{
+		fmt[n++] = 'l';
+		fmt[n++] = 'l';
+	}
+	fmt[n++] = p[spec->n - 1];
+	fmt[n] = 0;
+}
+
+/// serialize arguments
+/// @return argument bytes, -1-unsupported format or arguments too long
+static int app_log_capture(uint8_t* ptr, int bytes, const char* format, va_list args)
+{
+	int i, n, len;
+	const char* s;
+	union app_log_arg_t v;
+	struct app_log_spec_t spec;
+
+	for (n = 0, format = strchr(format, '%'); format; format = strchr(format, '%'))
+	{
+		if ('%' == format[1])
+		{
+			format += 2;
+			continue;
+		}
+
+		if (0 == app_log_spec_parse(format, &spec) || n + (spec.stars + 1) * (int)sizeof(v) > bytes)
+			return -1;
+		format += spec.n;
+
+		for (i = 0; i < spec.stars; i++)
+		{
+			v.i = va_arg(args, int);
+			memcpy(ptr + n, &v, sizeof(v));
+			n += sizeof(v);
+		}
+
+		switch (spec.type)
+		{
+		case APP_LOG_ARG_INT:
+			switch (spec.length)
+			{
+			case 'H': v.i = (signed char)va_arg(args, int); break;
+			case 'h': v.i = (short)va_arg(args, int); break;
+			case 'l': v.i = va_arg(args, long); break;
+			case 'L': v.i = va_arg(args, long long); break;
+			case 'j': v.i = va_arg(args, intmax_t); break;
+			case 'z': v.i = (ptrdiff_t)va_arg(args, size_t); break;
+			case 't': v.i = va_arg(args, ptrdiff_t); break;
+			default: v.i = va_arg(args, int);
+			}
+			break;
+
+		case APP_LOG_ARG_UINT:
+			switch (spec.length)
+			{
+			case 'H': v.u = (unsigned char)va_arg(args, unsigned int); break;
+			case 'h': v.u = (unsigned short)va_arg(args, unsigned int); break;
+			case 'l': v.u = va_arg(args, unsigned long); break;
+			case 'L': v.u = va_arg(args, unsigned long long); break;
+			case 'j': v.u = va_arg(args, uintmax_t); break;
+			case 'z': v.u = va_arg(args, size_t); break;
+			case 't': v.u = (size_t)va_arg(args, ptrdiff_t); break;
+			default: v.u = va_arg(args, unsigned int);
+			}
+			break;
+
+		case APP_LOG_ARG_CHAR:
+			v.i = va_arg(args, int);
+			break;
+
+		case APP_LOG_ARG_DOUBLE:
+			v.d = va_arg(args, double);
+			break;
+
+		case APP_LOG_ARG_PTR:
+			v.p = va_arg(args, void*);
+			break;
+
+		default:
+			s = va_arg(args, const char*);
+			s = s ? s : "(null)";
+			if (-2 == spec.precision)
+				spec.precision = (int)v.i < 0 ? -1 : (int)v.i; // last '*' argument, negative precision is taken as if omitted
+			// %.Ns may point to an array without NUL-terminator
+			len = spec.precision >= 0 ? (int)strnlen(s, spec.precision) : (int)strlen(s);
+			if (len >= bytes || n + (int)sizeof(v) + APP_LOG_ALIGN(len + 1) > bytes)
+				return -1;
+			v.i = len;
+			memcpy(ptr + n, &v, sizeof(v));
+			memcpy(ptr + n + sizeof(v), s, len);
+			ptr[n + sizeof(v) + len] = 0;
+			n += sizeof(v) + APP_LOG_ALIGN(len + 1);
+			continue;
+		}
+
+		memcpy(ptr + n, &v, sizeof(v));
+		n += sizeof(v);
+	}
+	return n;
+}
+
+static int app_log_snprintf(char* buf, int bytes, const char* fmt, const int* stars, int n, int type, const union app_log_arg_t* v, const char* s)
+{
+#define APP_LOG_SNPRINTF(value) (0 == n ? snprintf(buf, bytes, fmt, value) : (1 == n ? snprintf(buf, bytes, fmt, stars[0], value) : snprintf(buf, bytes, fmt, stars[0], stars[1], value)))
+	switch (type)
+	{
+	case APP_LOG_ARG_INT: return APP_LOG_SNPRINTF((long long)v->i);
+	case APP_LOG_ARG_UINT: return APP_LOG_SNPRINTF((unsigned long long)v->u);
+	case APP_LOG_ARG_CHAR: return APP_LOG_SNPRINTF((int)v->i);
+	case APP_LOG_ARG_DOUBLE: return APP_LOG_SNPRINTF(v->d);
+	case APP_LOG_ARG_PTR: return APP_LOG_SNPRINTF(v->p);
+	default: return APP_LOG_SNPRINTF(s);
+	}
+#undef APP_LOG_SNPRINTF
+}
+
+/// format serialized arguments, see app_log_capture
+/// @return log length
+static int app_log_vformat(char* log, int bytes, const char* format, const uint8_t* ptr)
+{
+	int i, n, r, stars[2];
+	char fmt[40];
+	const char* p;
+	const char* s;
+	union app_log_arg_t v;
+	struct app_log_spec_t spec;
+
+	for (n = 0; *format && n < bytes - 1; )
+	{
+		p = strchr(format, '%');
+		r = p ? (int)(p - format) : (int)strlen(format);
+		r = r < bytes - 1 - n ? r : bytes - 1 - n;
+		memcpy(log + n, format, r);
+		n += r;
+		if (!p || n >= bytes - 1)
+			break;
+
+		if ('%' == p[1])
+		{
+			log[n++] = '%';
+			format = p + 2;
+			continue;
+		}
+
+		app_log_spec_parse(p, &spec);
+		app_log_spec_format(p, &spec, fmt);
+		format = p + spec.n;
+
+		for (i = 0; i < spec.stars; i++)
+		{
+			memcpy(&v, ptr, sizeof(v));
+			ptr += sizeof(v);
+			stars[i] = (int)v.i;
+		}
+
+		memcpy(&v, ptr, sizeof(v));
+		ptr += sizeof(v);
+		s = (const char*)ptr;
+		if (APP_LOG_ARG_STR == spec.type)
+			ptr += APP_LOG_ALIGN((int)v.i + 1);
+
+		r = app_log_snprintf(log + n, bytes - n, fmt, stars, spec.stars, spec.type, &v, s);
+		n += r < 0 ? 0 : (r < bytes - n ? r : bytes - 1 - n);
+	}
+
+	log[n] = 0;
+	return n;
+}
+
+static void app_log_syslog_write(int level, const char* log)
+{
+#if defined(OS_WINDOWS)
+	(void)level;
+	OutputDebugStringA(log);
+#elif defined(OS_ANDROID)
+	static int s_level[] = { ANDROID_LOG_FATAL/*emerg*/, ANDROID_LOG_FATAL/*alert*/, ANDROID_LOG_FATAL/*critical*/, ANDROID_LOG_ERROR/*error*/, ANDROID_LOG_WARN/*warning*/, ANDROID_LOG_INFO/*notice*/, ANDROID_LOG_INFO/*info*/, ANDROID_LOG_DEBUG/*debug*/ };
+	__android_log_write(s_level[level % 8], "android", log);
+#else
+	static pthread_once_t s_onetime = PTHREAD_ONCE_INIT;
+	pthread_once(&s_onetime, app_log_init);
+	syslog(level, "%s", log);
+#endif
+}
+
+static void app_log_async_flush(void)
+{
+	if (s_async.n > 0)
+	{
+		fwrite(s_async.batch, 1, s_async.n, stdout);
+		fflush(stdout);
+		s_async.n = 0;
+	}
+}
+
+static void app_log_async_output(uint64_t clock, int level, const char* log, int n)
+{
+	int r;
+	time_t t;
+	struct tm tm;
+	char prefix[128];
+
+	// localtime once per second
+	if ((int64_t)(clock / 1000000) != s_async.second)
+	{
+		s_async.second = (int64_t)(clock / 1000000);
+		t = (time_t)s_async.second;
+#if defined(OS_WINDOWS)
+		localtime_s(&tm, &t);
+#else
+		localtime_r(&t, &tm);
+#endif
+		snprintf(s_async.timestr, sizeof(s_async.timestr), "%04d-%02d-%02dT%02d:%02d:%02d", (int)tm.tm_year + 1900, (int)tm.tm_mon + 1, (int)tm.tm_mday, (int)tm.tm_hour, (int)tm.tm_min, (int)tm.tm_sec);
+	}
+	snprintf(prefix, sizeof(prefix), "%s.%03d|%s", s_async.timestr, (int)(clock / 1000 % 1000), s_level_tag[LOG_LEVEL(level)]);
+
+	// log length < N_LOG_BUFFER < APP_LOG_ASYNC_BATCH
+	if (s_async.n + n + (int)sizeof(prefix) + 32 > (int)sizeof(s_async.batch))
+		app_log_async_flush();
+	r = snprintf(s_async.batch + s_async.n, sizeof(s_async.batch) - s_async.n, "%s%s|%.*s%s", s_level_color[LOG_LEVEL(level) + 1], prefix, n, log, s_level_color[0]);
+	s_async.n += r < 0 ? 0 : (r < (int)sizeof(s_async.batch) - s_async.n ? r : (int)sizeof(s_async.batch) - s_async.n - 1);
+
+	if (s_provider)
+		s_provider(s_provider_param, prefix, log, n);
+	else
+		app_log_syslog_write(level, log);
+}
+
+static int STDCALL app_log_async_worker(void* param)
+{
+	int n;
+	size_t bytes;
+	int32_t dropped;
+	const struct app_log_record_t* r;
+
+	(void)param;
+	for (;;)
+	{
+		r = (const struct app_log_record_t*)ring_mpsc_peek(&s_async.ring, &bytes);
+		if (r)
+		{
+			if (r->format)
+			{
+				n = app_log_vformat(s_async.log, sizeof(s_async.log), r->format, (const uint8_t*)(r + 1));
+				app_log_async_output(r->clock, r->level, s_async.log, n);
+			}
+			else
+			{
+				app_log_async_output(r->clock, r->level, (const char*)(r + 1), r->bytes);
+			}
+			ring_mpsc_consume(&s_async.ring);
+			continue;
+		}
+
+		dropped = atomic_load_acquire32(&s_async.dropped);
+		if (dropped != s_async.reported)
+		{
+			n = snprintf(s_async.log, sizeof(s_async.log), "app_log: %u logs dropped\n", (unsigned int)(dropped - s_async.reported));
+			s_async.reported = dropped;
+			app_log_async_output(app_log_clock(), LOG_WARNING, s_async.log, n);
+			continue;
+		}
+
+		// ring is empty, write batch
+		app_log_async_flush();
+		if (!atomic_load_acquire32(&s_async.running))
+			break;
+
+		atomic_increment32(&s_async.sleeping); // full barrier: producer commit -> load sleeping
+		if (!ring_mpsc_peek(&s_async.ring, &bytes))
+			event_timewait(&s_async.event, 1000);
+		atomic_decrement32(&s_async.sleeping);
+	}
+	return 0;
+}
+
+static void app_log_async_write(int level, const char* format, va_list args)
+{
+	int n;
+	int32_t second, window;
+	uint64_t clock;
+	va_list copy;
+	struct app_log_record_t* r;
+	THREAD_LOCAL uint8_t ptr[N_LOG_BUFFER];
+
+	clock = app_log_clock();
+	if (s_async.rate > 0)
+	{
+		second = (int32_t)(clock / 1000000);
+		window = atomic_load_acquire32(&s_async.window);
+		if (window != second && atomic_cas32(&s_async.window, window, second))
+			atomic_store_release32(&s_async.count, 0);
+		if (atomic_increment32(&s_async.count) > s_async.rate)
+		{
+			atomic_increment32(&s_async.dropped);
+			return;
+		}
+	}
+
+	va_copy(copy, args);
+	n = app_log_capture(ptr, sizeof(ptr), format, copy);
+	va_end(copy);
+	if (n < 0)
+	{
+		// format by caller
+		n = vsnprintf((char*)ptr, sizeof(ptr), format, args);
+		n = n < 0 ? 0 : (n < (int)sizeof(ptr) ? n : (int)sizeof(ptr) - 1);
+		ptr[n] = 0;
+		format = NULL;
+	}
+
+	r = (struct app_log_record_t*)ring_mpsc_reserve(&s_async.ring, sizeof(*r) + n + (format ? 0 : 1));
+	if (!r)
+	{
+		atomic_increment32(&s_async.dropped);
+		return;
+	}
+
+	r->clock = clock;
+	r->format = format;
+	r->level = level;
+	r->bytes = n;
+	memcpy(r + 1, ptr, n + (format ? 0 : 1));
+	ring_mpsc_commit(&s_async.ring, r);
+
+	if (atomic_load32(&s_async.sleeping)) // full barrier
+		event_signal(&s_async.event);
+}
+
+int app_log_async_start(unsigned int bytes, int rate)
+{
+	int r;
+	if (atomic_load_acquire32(&s_async.running))
+		return -EEXIST;
+
+	// keep the ring after stop, late producers might still write it
+	if (!s_async.ring.ptr)
+	{
+		r = ring_mpsc_alloc(&s_async.ring, bytes ? bytes : APP_LOG_ASYNC_RING, 0);
+		if (0 != r)
+			return r;
+
+		r = event_create(&s_async.event);
+		if (0 != r)
+		{
+			ring_mpsc_free(&s_async.ring);
+			return r;
+		}
+	}
+
+	s_async.rate = rate;
+	s_async.second = -1;
+	atomic_store_release32(&s_async.running, 1);
+	r = thread_create(&s_async.thread, app_log_async_worker, NULL);
+	if (0 != r)
+		atomic_store_release32(&s_async.running, 0);
+	return r;
+}
+
+void app_log_async_stop(void)
+{
+	if (!atomic_cas32(&s_async.running, 1, 0))
+		return;
+
+	event_signal(&s_async.event);
+	thread_destroy(s_async.thread);
+}
+
+unsigned int app_log_async_dropped(void)
+{
+	return (unsigned int)atomic_load32(&s_async.dropped);
+}
+#else
+int app_log_async_start(unsigned int bytes, int rate)
+{
+	(void)bytes, (void)rate;
+	return -ENOSYS;
+}
+
+void app_log_async_stop(void)
+{
+}
+
+unsigned int app_log_async_dropped(void)
+{
+	return 0;
+}
+#endif
+
 static int s_syslog_level = LOG_INFO;
 void app_log_setlevel(int level)
 {
@@ -122,6 +679,16 @@ void app_log(int level, const char* format, ...)
 
 	if (level <= s_syslog_level)
 	{
+#if !defined(OS_RTOS)
+		if (atomic_load_acquire32(&s_async.running))
+		{
+			va_start(args, format);
+			app_log_async_write(level, format, args);
+			va_end(args);
+			return;
+		}
+#endif
+
 		va_start(args, format);
 		app_log_print(level, format, args);
 		va_end(args);
@@ -145,3 +712,59 @@ void app_log_setprovider(app_log_provider provider, void* param)
 	s_provider = provider;
 	s_provider_param = param;
 }
+
+#if (defined(DEBUG) || defined(_DEBUG)) && !defined(OS_RTOS)
+static char s_test_log[1024 * 4];
+static int s_test_bytes;
+
+static void app_log_test_provider(void* param, const char* prefix, const char* log, int n)
+{
+	(void)param;
+	if (0 == strncmp(log, "app_log: ", 9))
+		return; // dropped
+
+	assert(strlen(prefix) > 2 && 0 == strcmp(prefix + strlen(prefix) - 2, "|E"));
+	if (s_test_bytes + n < (int)sizeof(s_test_log))
+	{
+		memcpy(s_test_log + s_test_bytes, log, n);
+		s_test_bytes += n;
+	}
+}
+
+#define APP_LOG_TEST(fmt, ...) do { app_log(LOG_ERROR, fmt, ##__VA_ARGS__); n += snprintf(expected + n, sizeof(expected) - n, fmt, ##__VA_ARGS__); } while (0)
+
+void app_log_test(void)
+{
+	int i, n;
+	char* p;
+	char expected[sizeof(s_test_log)];
+	unsigned int dropped;
+
+	n = 0;
+	s_test_bytes = 0;
+	app_log_setprovider(app_log_test_provider, NULL);
+	assert(0 == app_log_async_start(0, 0));
+	APP_LOG_TEST("int: %d %5i %-3d| %ld %lld %hd %hhd %jd %zd\n", -1, 42, 7, -123456789L, 1234567890123LL, (short)-2, (char)-3, (intmax_t)-4, (size_t)5);
+	APP_LOG_TEST("uint: %u %x %#X %o %zu %08lx %hhu %llu\n", 3000000000u, 255u, 255u, 8u, (size_t)12345, 0xabcdefUL, (unsigned char)200, 18446744073709551615ULL);
+	APP_LOG_TEST("float: %f %.3e %g %*.*f %-*d|\n", 3.14159, 12345.678, 0.0001, 10, 2, 2.71828, 6, 9);
+	APP_LOG_TEST("str: %s [%10s] [%-6.3s] [%.*s] %c %p 100%%\n", "hello", "right", "truncate", 2, "abc", 'x', (void*)&s_test_bytes);
+	APP_LOG_TEST("fallback: %Lf\n", (long double)1.5);
+	p = (char*)malloc(6); // no NUL-terminator
+	memcpy(p, "abcdef", 6);
+	APP_LOG_TEST("precision: [%.4s] [%.*s] [%-8.6s] [%.*s] [%.*s]\n", p, 6, p, p, -1, "neg", 0, p);
+	free(p);
+	APP_LOG_TEST("no argument\n");
+	app_log_async_stop();
+	assert(s_test_bytes == n && 0 == memcmp(s_test_log, expected, n));
+
+	// rate limit
+	dropped = app_log_async_dropped();
+	assert(0 == app_log_async_start(0, 10));
+	for (i = 0; i < 50; i++)
+		app_log(LOG_ERROR, "rate limit %d\n", i);
+	app_log_async_stop();
+	assert(app_log_async_dropped() - dropped >= 30);
+
+	app_log_setprovider(NULL, NULL);
+}
+#endif
@@ -1,6 +1,14 @@
 #include "base64.h"
+#include "sys/cpu.h"
 #include <assert.h>
 #include <stdint.h>
+#include <string.h>
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#elif defined(CPU_ARM64)
+#include <arm_neon.h>
+#endif
 
 static char s_base64_enc[64] = {
 	'A','B','C','D','E','F','G','H','I','J','K','L','M',
@@ -27,12 +35,405 @@ static const uint8_t s_base64_dec[256] = {
 	41,42,43,44,45,46,47,48,49,50,51, 0, 0, 0, 0, 0,
 };
 
+// SIMD kernels, return consumed input bytes, the remaining are processed by scalar code
+// base64: Wojciech Mula, Daniel Lemire, Faster Base64 Encoding and Decoding Using AVX2 Instructions
+#if defined(CPU_X86)
+#if defined(_MSC_VER)
+	#define BASE64_TARGET(x)
+#else
+	#define BASE64_TARGET(x) __attribute__((target(x)))
+#endif
+
+static size_t BASE64_TARGET("ssse3") base64_encode_ssse3(char* target, const uint8_t* source, size_t bytes, const char* table)
+{
+	size_t i;
+	__m128i in, lo, hi, idx, r;
+	const __m128i shuf = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m128i lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, (char)(table[62] - 62), (char)(table[63] - 63), 'A', 0, 0);
+
+	// 12 bytes -> 16 chars, load 16 bytes
+	for (i = 0; i + 16 <= bytes; i += 12, target += 16)
+	{
+		in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + i)), shuf);
+		hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		idx = _mm_or_si128(hi, lo); // 6-bits index per byte
+
+		// 0~25: 13, 26~51: 0, 52~61: 1~10, 62: 11, 63: 12
+		r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+		r = _mm_add_epi8(_mm_shuffle_epi8(lut, r), idx);
+		_mm_storeu_si128((__m128i*)target, r);
+	}
+	return i;
+}
+
+static size_t BASE64_TARGET("avx2") base64_encode_avx2(char* target, const uint8_t* source, size_t bytes, const char* table)
+{
+	size_t i;
+	__m256i in, lo, hi, idx, r;
+	const __m256i shuf = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m256i lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, (char)(table[62] - 62), (char)(table[63] - 63), 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, (char)(table[62] - 62), (char)(table[63] - 63), 'A', 0, 0);
+
+	// 24 bytes -> 32 chars, load 12 bytes per lane
+	for (i = 0; i + 28 <= bytes; i += 24, target += 32)
+	{
+		in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(source + i))), _mm_loadu_si128((const __m128i*)(source + i + 12)), 1);
+		in = _mm256_shuffle_epi8(in, shuf);
+		hi = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+		lo = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+		idx = _mm256_or_si256(hi, lo);
+
+		r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+		r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx), _mm256_set1_epi8(13)));
+		r = _mm256_add_epi8(_mm256_shuffle_epi8(lut, r), idx);
+		_mm256_storeu_si256((__m256i*)target, r);
+	}
+	return i;
+}
+
+#define BASE64_RANGE(c, lo, hi) _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8((lo) - 1)), _mm_cmpgt_epi8(_mm_set1_epi8((hi) + 1), c))
+#define BASE64_RANGE256(c, lo, hi) _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8((lo) - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8((hi) + 1), c))
+
+static size_t BASE64_TARGET("ssse3") base64_decode_ssse3(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	int w;
+	size_t i;
+	__m128i c, up, lw, dg, s62, s63, v;
+	const __m128i shuf = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	// 16 chars -> 12 bytes, stop on '=' or invalid char
+	for (i = 0; i + 16 <= bytes; i += 16, target += 12)
+	{
+		c = _mm_loadu_si128((const __m128i*)(source + i));
+		up = BASE64_RANGE(c, 'A', 'Z');
+		lw = BASE64_RANGE(c, 'a', 'z');
+		dg = BASE64_RANGE(c, '0', '9');
+		s62 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('+')), _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+		s63 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('/')), _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+		if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(up, lw), _mm_or_si128(dg, _mm_or_si128(s62, s63)))))
+			break;
+
+		v = _mm_or_si128(_mm_and_si128(up, _mm_sub_epi8(c, _mm_set1_epi8('A'))), _mm_and_si128(lw, _mm_sub_epi8(c, _mm_set1_epi8('a' - 26))));
+		v = _mm_or_si128(v, _mm_and_si128(dg, _mm_add_epi8(c, _mm_set1_epi8(52 - '0'))));
+		v = _mm_or_si128(v, _mm_or_si128(_mm_and_si128(s62, _mm_set1_epi8(62)), _mm_and_si128(s63, _mm_set1_epi8(63))));
+
+		// pack 4 x 6-bits -> 3 bytes
+		v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+		v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+		v = _mm_shuffle_epi8(v, shuf);
+		_mm_storel_epi64((__m128i*)target, v);
+		w = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+		memcpy(target + 8, &w, 4);
+	}
+	return i;
+}
+
+static size_t BASE64_TARGET("avx2") base64_decode_avx2(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	__m256i c, up, lw, dg, s62, s63, v;
+	const __m256i shuf = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	// 32 chars -> 24 bytes, stop on '=' or invalid char
+	for (i = 0; i + 32 <= bytes; i += 32, target += 24)
+	{
+		c = _mm256_loadu_si256((const __m256i*)(source + i));
+		up = BASE64_RANGE256(c, 'A', 'Z');
+		lw = BASE64_RANGE256(c, 'a', 'z');
+		dg = BASE64_RANGE256(c, '0', '9');
+		s62 = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')));
+		s63 = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('/')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')));
+		if (-1 != _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(up, lw), _mm256_or_si256(dg, _mm256_or_si256(s62, s63)))))
+			break;
+
+		v = _mm256_or_si256(_mm256_and_si256(up, _mm256_sub_epi8(c, _mm256_set1_epi8('A'))), _mm256_and_si256(lw, _mm256_sub_epi8(c, _mm256_set1_epi8('a' - 26))));
+		v = _mm256_or_si256(v, _mm256_and_si256(dg, _mm256_add_epi8(c, _mm256_set1_epi8(52 - '0'))));
+		v = _mm256_or_si256(v, _mm256_or_si256(_mm256_and_si256(s62, _mm256_set1_epi8(62)), _mm256_and_si256(s63, _mm256_set1_epi8(63))));
+
+		v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+		v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+		v = _mm256_shuffle_epi8(v, shuf);
+		v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)); // 12 + 12 bytes
+		_mm_storeu_si128((__m128i*)target, _mm256_castsi256_si128(v));
+		_mm_storel_epi64((__m128i*)(target + 16), _mm256_extracti128_si256(v, 1));
+	}
+	return i;
+}
+
+static size_t BASE64_TARGET("ssse3") base16_encode_ssse3(char* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	__m128i in, hi, lo;
+	const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+
+	for (i = 0; i + 16 <= bytes; i += 16, target += 32)
+	{
+		in = _mm_loadu_si128((const __m128i*)(source + i));
+		hi = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F));
+		lo = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+		_mm_storeu_si128((__m128i*)target, _mm_shuffle_epi8(lut, _mm_unpacklo_epi8(hi, lo)));
+		_mm_storeu_si128((__m128i*)(target + 16), _mm_shuffle_epi8(lut, _mm_unpackhi_epi8(hi, lo)));
+	}
+	return i;
+}
+
+static size_t BASE64_TARGET("avx2") base16_encode_avx2(char* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	__m256i in, hi, lo, a, b;
+	const __m256i lut = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+
+	for (i = 0; i + 32 <= bytes; i += 32, target += 64)
+	{
+		in = _mm256_loadu_si256((const __m256i*)(source + i));
+		hi = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F));
+		lo = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+		a = _mm256_shuffle_epi8(lut, _mm256_unpacklo_epi8(hi, lo));
+		b = _mm256_shuffle_epi8(lut, _mm256_unpackhi_epi8(hi, lo));
+		_mm256_storeu_si256((__m256i*)target, _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i*)(target + 32), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+	return i;
+}
+
+#define BASE16_VALUE(c, valid, v) \
+	do { \
+		__m128i dg, up, lw; \
+		dg = BASE64_RANGE(c, '0', '9'); \
+		up = BASE64_RANGE(c, 'A', 'F'); \
+		lw = BASE64_RANGE(c, 'a', 'f'); \
+		valid = _mm_or_si128(dg, _mm_or_si128(up, lw)); \
+		v = _mm_or_si128(_mm_and_si128(dg, _mm_sub_epi8(c, _mm_set1_epi8('0'))), _mm_and_si128(up, _mm_sub_epi8(c, _mm_set1_epi8('A' - 10)))); \
+		v = _mm_or_si128(v, _mm_and_si128(lw, _mm_sub_epi8(c, _mm_set1_epi8('a' - 10)))); \
+	} while (0)
+
+#define BASE16_VALUE256(c, valid, v) \
+	do { \
+		__m256i dg, up, lw; \
+		dg = BASE64_RANGE256(c, '0', '9'); \
+		up = BASE64_RANGE256(c, 'A', 'F'); \
+		lw = BASE64_RANGE256(c, 'a', 'f'); \
+		valid = _mm256_or_si256(dg, _mm256_or_si256(up, lw)); \
+		v = _mm256_or_si256(_mm256_and_si256(dg, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))), _mm256_and_si256(up, _mm256_sub_epi8(c, _mm256_set1_epi8('A' - 10)))); \
+		v = _mm256_or_si256(v, _mm256_and_si256(lw, _mm256_sub_epi8(c, _mm256_set1_epi8('a' - 10)))); \
+	} while (0)
+
+static size_t BASE64_TARGET("ssse3") base16_decode_ssse3(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	__m128i c0, c1, m0, m1, v0, v1;
+
+	// 32 chars -> 16 bytes
+	for (i = 0; i + 32 <= bytes; i += 32, target += 16)
+	{
+		c0 = _mm_loadu_si128((const __m128i*)(source + i));
+		c1 = _mm_loadu_si128((const __m128i*)(source + i + 16));
+		BASE16_VALUE(c0, m0, v0);
+		BASE16_VALUE(c1, m1, v1);
+		if (0xFFFF != _mm_movemask_epi8(_mm_and_si128(m0, m1)))
+			break;
+
+		// hi * 16 + lo
+		v0 = _mm_maddubs_epi16(v0, _mm_set1_epi16(0x0110));
+		v1 = _mm_maddubs_epi16(v1, _mm_set1_epi16(0x0110));
+		_mm_storeu_si128((__m128i*)target, _mm_packus_epi16(v0, v1));
+	}
+	return i;
+}
+
+static size_t BASE64_TARGET("avx2") base16_decode_avx2(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	__m256i c0, c1, m0, m1, v0, v1;
+
+	// 64 chars -> 32 bytes
+	for (i = 0; i + 64 <= bytes; i += 64, target += 32)
+	{
+		c0 = _mm256_loadu_si256((const __m256i*)(source + i));
+		c1 = _mm256_loadu_si256((const __m256i*)(source + i + 32));
+		BASE16_VALUE256(c0, m0, v0);
+		BASE16_VALUE256(c1, m1, v1);
+		if (-1 != _mm256_movemask_epi8(_mm256_and_si256(m0, m1)))
+			break;
+
+		v0 = _mm256_maddubs_epi16(v0, _mm256_set1_epi16(0x0110));
+		v1 = _mm256_maddubs_epi16(v1, _mm256_set1_epi16(0x0110));
+		_mm256_storeu_si256((__m256i*)target, _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), 0xD8));
+	}
+	return i;
+}
+
+static size_t base64_encode_simd(char* target, const uint8_t* source, size_t bytes, const char* table)
+{
+	size_t i = 0;
+	if (cpu_features() & CPU_FEATURE_AVX2)
+		i = base64_encode_avx2(target, source, bytes, table);
+	if (cpu_features() & CPU_FEATURE_SSSE3)
+		i += base64_encode_ssse3(target + i / 3 * 4, source + i, bytes - i, table);
+	return i;
+}
+
+static size_t base64_decode_simd(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i = 0;
+	if (cpu_features() & CPU_FEATURE_AVX2)
+		i = base64_decode_avx2(target, source, bytes);
+	if (cpu_features() & CPU_FEATURE_SSSE3)
+		i += base64_decode_ssse3(target + i / 4 * 3, source + i, bytes - i);
+	return i;
+}
+
+static size_t base16_encode_simd(char* target, const uint8_t* source, size_t bytes)
+{
+	size_t i = 0;
+	if (cpu_features() & CPU_FEATURE_AVX2)
+		i = base16_encode_avx2(target, source, bytes);
+	if (cpu_features() & CPU_FEATURE_SSSE3)
+		i += base16_encode_ssse3(target + i * 2, source + i, bytes - i);
+	return i;
+}
+
+static size_t base16_decode_simd(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i = 0;
+	if (cpu_features() & CPU_FEATURE_AVX2)
+		i = base16_decode_avx2(target, source, bytes);
+	if (cpu_features() & CPU_FEATURE_SSSE3)
+		i += base16_decode_ssse3(target + i / 2, source + i, bytes - i);
+	return i;
+}
+
+#elif defined(CPU_ARM64)
+
+static size_t base64_encode_simd(char* target, const uint8_t* source, size_t bytes, const char* table)
+{
+	size_t i;
+	uint8x16x3_t in;
+	uint8x16x4_t out, lut;
+	const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+	lut.val[0] = vld1q_u8((const uint8_t*)table);
+	lut.val[1] = vld1q_u8((const uint8_t*)table + 16);
+	lut.val[2] = vld1q_u8((const uint8_t*)table + 32);
+	lut.val[3] = vld1q_u8((const uint8_t*)table + 48);
+
+	// 48 bytes -> 64 chars
+	for (i = 0; i + 48 <= bytes; i += 48, target += 64)
+	{
+		in = vld3q_u8(source + i);
+		out.val[0] = vshrq_n_u8(in.val[0], 2);
+		out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+		out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+		out.val[3] = vandq_u8(in.val[2], mask);
+		out.val[0] = vqtbl4q_u8(lut, out.val[0]);
+		out.val[1] = vqtbl4q_u8(lut, out.val[1]);
+		out.val[2] = vqtbl4q_u8(lut, out.val[2]);
+		out.val[3] = vqtbl4q_u8(lut, out.val[3]);
+		vst4q_u8((uint8_t*)target, out);
+	}
+	return i;
+}
+
+#define BASE64_RANGE(c, lo, hi) vandq_u8(vcgeq_u8(c, vdupq_n_u8(lo)), vcleq_u8(c, vdupq_n_u8(hi)))
+
+/// @return 0-invalid char
+static inline int base64_value_neon(uint8x16_t c, uint8x16_t* v)
+{
+	uint8x16_t up, lw, dg, s62, s63;
+	up = BASE64_RANGE(c, 'A', 'Z');
+	lw = BASE64_RANGE(c, 'a', 'z');
+	dg = BASE64_RANGE(c, '0', '9');
+	s62 = vorrq_u8(vceqq_u8(c, vdupq_n_u8('+')), vceqq_u8(c, vdupq_n_u8('-')));
+	s63 = vorrq_u8(vceqq_u8(c, vdupq_n_u8('/')), vceqq_u8(c, vdupq_n_u8('_')));
+	*v = vorrq_u8(vandq_u8(up, vsubq_u8(c, vdupq_n_u8('A'))), vandq_u8(lw, vsubq_u8(c, vdupq_n_u8('a' - 26))));
+	*v = vorrq_u8(*v, vandq_u8(dg, vaddq_u8(c, vdupq_n_u8(52 - '0'))));
+	*v = vorrq_u8(*v, vorrq_u8(vandq_u8(s62, vdupq_n_u8(62)), vandq_u8(s63, vdupq_n_u8(63))));
+	return 0 != vminvq_u8(vorrq_u8(vorrq_u8(up, lw), vorrq_u8(dg, vorrq_u8(s62, s63))));
+}
+
+static size_t base64_decode_simd(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	uint8x16x4_t in;
+	uint8x16x3_t out;
+
+	// 64 chars -> 48 bytes
+	for (i = 0; i + 64 <= bytes; i += 64, target += 48)
+	{
+		in = vld4q_u8(source + i);
+		if (!base64_value_neon(in.val[0], &in.val[0]) || !base64_value_neon(in.val[1], &in.val[1])
+			|| !base64_value_neon(in.val[2], &in.val[2]) || !base64_value_neon(in.val[3], &in.val[3]))
+			break;
+
+		out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+		vst3q_u8(target, out);
+	}
+	return i;
+}
+
+static size_t base16_encode_simd(char* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	uint8x16_t in;
+	uint8x16x2_t out;
+	static const uint8_t s_hex[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+	const uint8x16_t lut = vld1q_u8(s_hex);
+
+	for (i = 0; i + 16 <= bytes; i += 16, target += 32)
+	{
+		in = vld1q_u8(source + i);
+		out.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(in, 4));
+		out.val[1] = vqtbl1q_u8(lut, vandq_u8(in, vdupq_n_u8(0x0F)));
+		vst2q_u8((uint8_t*)target, out);
+	}
+	return i;
+}
+
+/// @return 0-invalid char
+static inline int base16_value_neon(uint8x16_t c, uint8x16_t* v)
+{
+	uint8x16_t dg, up, lw;
+	dg = BASE64_RANGE(c, '0', '9');
+	up = BASE64_RANGE(c, 'A', 'F');
+	lw = BASE64_RANGE(c, 'a', 'f');
+	*v = vorrq_u8(vandq_u8(dg, vsubq_u8(c, vdupq_n_u8('0'))), vandq_u8(up, vsubq_u8(c, vdupq_n_u8('A' - 10))));
+	*v = vorrq_u8(*v, vandq_u8(lw, vsubq_u8(c, vdupq_n_u8('a' - 10))));
+	return 0 != vminvq_u8(vorrq_u8(dg, vorrq_u8(up, lw)));
+}
+
+static size_t base16_decode_simd(uint8_t* target, const uint8_t* source, size_t bytes)
+{
+	size_t i;
+	uint8x16x2_t in;
+
+	for (i = 0; i + 32 <= bytes; i += 32, target += 16)
+	{
+		in = vld2q_u8(source + i);
+		if (!base16_value_neon(in.val[0], &in.val[0]) || !base16_value_neon(in.val[1], &in.val[1]))
+			break;
+		vst1q_u8(target, vorrq_u8(vshlq_n_u8(in.val[0], 4), in.val[1]));
+	}
+	return i;
+}
+
+#else
+#define base64_encode_simd(target, source, bytes, table) 0
+#define base64_decode_simd(target, source, bytes) 0
+#define base16_encode_simd(target, source, bytes) 0
+#define base16_decode_simd(target, source, bytes) 0
+#endif
+
 static size_t base64_encode_table(char* target, const void *source, size_t bytes, const char* table)
 {
 	size_t i, j;
 	const uint8_t *ptr = (const uint8_t*)source;
 
-	for (j = i = 0; i < bytes / 3 * 3; i += 3)
+	i = base64_encode_simd(target, ptr, bytes, table);
+	for (j = i / 3 * 4; i < bytes / 3 * 3; i += 3)
 	{
 		target[j++] = table[(ptr[i] >> 2) & 0x3F]; /* c1 */
 		target[j++] = table[((ptr[i] & 0x03) << 4) | ((ptr[i + 1] >> 4) & 0x0F)]; /*c2*/
@@ -73,24 +474,131 @@ size_t base64_encode_url(char* target, const void *source, size_t bytes)
 	return base64_encode_table(target, source, bytes, s_base64_url);
 }
 
-size_t base64_decode(void* target, const char *src, size_t bytes)
+static size_t base64_decode_run(uint8_t* p, const uint8_t* source, const uint8_t* end, const uint8_t** stop)
 {
 	size_t i;
-	uint8_t* p = (uint8_t*)target;
-	const uint8_t* source = (const uint8_t*)src;
-	const uint8_t* end;
 
-	//assert(0 == bytes % 4);
+	i = base64_decode_simd(p, source, end - source);
+	source += i;
+	i = i / 4 * 3;
 
-	end = source + bytes;
 #define S(i) ((source+i < end) ? source[i] : '=')
-	for (i = 0; source < end && '=' != *source; source += 4)
+	for (; source < end && '=' != *source; source += 4)
 	{
 		p[i++] = (s_base64_dec[S(0)] << 2) | (s_base64_dec[S(1)] >> 4);
 		if ('=' != S(2)) p[i++] = (s_base64_dec[S(1)] << 4) | (s_base64_dec[S(2)] >> 2);
 		if ('=' != S(3)) p[i++] = (s_base64_dec[S(2)] << 6) | s_base64_dec[S(3)];
 	}
 #undef S
+
+	*stop = source;
+	return i;
+}
+
+size_t base64_decode(void* target, const char *src, size_t bytes)
+{
+	const uint8_t* stop;
+
+	//assert(0 == bytes % 4);
+	return base64_decode_run((uint8_t*)target, (const uint8_t*)src, (const uint8_t*)src + bytes, &stop);
+}
+
+void base64_encoder_init(struct base64_encoder_t* enc, int url)
+{
+	memset(enc, 0, sizeof(*enc));
+	enc->url = url;
+}
+
+size_t base64_encoder_update(struct base64_encoder_t* enc, char* target, const void* source, size_t bytes)
+{
+	size_t j, n;
+	const char* table;
+	const uint8_t* ptr;
+
+	j = 0;
+	ptr = (const uint8_t*)source;
+	table = enc->url ? s_base64_url : s_base64_enc;
+	if (enc->n > 0)
+	{
+		for (; enc->n < 3 && bytes > 0; bytes--)
+			enc->tail[enc->n++] = *ptr++;
+		if (enc->n < 3)
+			return 0;
+
+		j = base64_encode_table(target, enc->tail, 3, table);
+		enc->n = 0;
+	}
+
+	n = bytes / 3 * 3;
+	j += base64_encode_table(target + j, ptr, n, table);
+	memcpy(enc->tail, ptr + n, bytes - n);
+	enc->n = (int)(bytes - n);
+	return j;
+}
+
+size_t base64_encoder_finish(struct base64_encoder_t* enc, char* target)
+{
+	size_t j;
+	j = base64_encode_table(target, enc->tail, enc->n, enc->url ? s_base64_url : s_base64_enc);
+	enc->n = 0;
+	return j;
+}
+
+void base64_decoder_init(struct base64_decoder_t* dec)
+{
+	memset(dec, 0, sizeof(*dec));
+}
+
+size_t base64_decoder_update(struct base64_decoder_t* dec, void* target, const char* source, size_t bytes)
+{
+	size_t i, n;
+	const uint8_t* ptr;
+	const uint8_t* stop;
+
+	if (dec->done)
+		return 0;
+
+	i = 0;
+	ptr = (const uint8_t*)source;
+	if (dec->n > 0)
+	{
+		for (; dec->n < 4 && bytes > 0; bytes--)
+			dec->tail[dec->n++] = *ptr++;
+		if (dec->n < 4)
+			return 0;
+
+		dec->n = 0;
+		i = base64_decode_run((uint8_t*)target, dec->tail, dec->tail + 4, &stop);
+		if (stop < dec->tail + 4)
+		{
+			dec->done = 1; // '='
+			return i;
+		}
+	}
+
+	n = bytes / 4 * 4;
+	i += base64_decode_run((uint8_t*)target + i, ptr, ptr + n, &stop);
+	if (stop < ptr + n)
+	{
+		dec->done = 1; // '='
+		return i;
+	}
+
+	memcpy(dec->tail, ptr + n, bytes - n);
+	dec->n = (int)(bytes - n);
+	return i;
+}
+
+size_t base64_decoder_finish(struct base64_decoder_t* dec, void* target)
+{
+	size_t i;
+	const uint8_t* stop;
+
+	i = 0;
+	if (!dec->done && dec->n > 0)
+		i = base64_decode_run((uint8_t*)target, dec->tail, dec->tail + dec->n, &stop);
+	dec->n = 0;
+	dec->done = 0;
 	return i;
 }
 
@@ -112,7 +620,8 @@ size_t base16_encode(char* target, const void *source, size_t bytes)
 	size_t i;
 	const uint8_t* p;
 	p = (const uint8_t*)source;
-	for (i = 0; i < bytes; i++)
+	i = base16_encode_simd(target, p, bytes);
+	for (p += i; i < bytes; i++)
 	{
 		target[i * 2] = s_base16_enc[(*p >> 4) & 0x0F];
 		target[i * 2 + 1] = s_base16_enc[*p & 0x0F];
@@ -127,7 +636,7 @@ size_t base16_decode(void* target, const char *source, size_t bytes)
 	uint8_t* p;
 	p = (uint8_t*)target;
 	assert(0 == bytes % 2);
-	for (i = 0; i < bytes / 2; i++)
+	for (i = base16_decode_simd(p, (const uint8_t*)source, bytes) / 2; i < bytes / 2; i++)
 	{
 		p[i] = s_base16_dec[(unsigned char)source[i * 2]] << 4;
 		p[i] |= s_base16_dec[(unsigned char)source[i * 2 + 1]];
@@ -236,6 +745,10 @@ void base64_test(void)
 	char source[512];
 	char target[512];
 	const uint8_t p[] = { 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x21, 0xde, 0xad, 0xbe, 0xef };
+	uint8_t big[100];
+	size_t i, n;
+	struct base64_encoder_t enc;
+	struct base64_decoder_t dec;
 
 	assert(8 == base64_encode(source, "4444", 4) && 0 == memcmp(source, "NDQ0NA==", 8));
 	assert(4 == base64_decode(target, "NDQ0NA======", 12) && 0 == memcmp(target, "4444", 4));
@@ -260,6 +773,27 @@ void base64_test(void)
 	assert(8 == base16_encode(source, "4444", 4));
 	assert(4 == base16_decode(target, source, 8) && 0 == memcmp(target, "4444", 4));
 
+	// simd block + scalar tail
+	for (i = 0; i < 100; i++)
+		big[i] = (uint8_t)(i * 37 + 11);
+	n = base64_encode(source, big, 100);
+	assert(136 == n && 100 == base64_decode(target, source, n) && 0 == memcmp(target, big, 100));
+	assert(200 == base16_encode(source, big, 100) && 100 == base16_decode(target, source, 200) && 0 == memcmp(target, big, 100));
+
+	// streaming
+	base64_encoder_init(&enc, 0);
+	n = base64_encoder_update(&enc, source, s, 5);
+	n += base64_encoder_update(&enc, source + n, s + 5, 1);
+	n += base64_encoder_update(&enc, source + n, s + 6, strlen(s) - 6);
+	n += base64_encoder_finish(&enc, source + n);
+	assert(n == strlen(r) && 0 == memcmp(source, r, n));
+	base64_decoder_init(&dec);
+	n = base64_decoder_update(&dec, target, r, 3);
+	n += base64_decoder_update(&dec, target + n, r + 3, 7);
+	n += base64_decoder_update(&dec, target + n, r + 10, strlen(r) - 10);
+	n += base64_decoder_finish(&dec, target + n);
+	assert(n == strlen(s) && 0 == memcmp(target, s, n));
+
 	assert(16 == base32_encode(source, p, 10) && 0 == memcmp(source, "JBSWY3DPEHPK3PXP", 16));
 	assert(10 == base32_decode(target, source, 16) && 0 == memcmp(target, p, sizeof(p)));
 	assert(8 == base32_encode(source, "H", 1) && 0 == memcmp(source, "JA======", 8));
@@ -1,11 +1,129 @@
+// bit order: bit 0 is the MSB of byte 0(big-endian),
+// so a 64-bits word loaded as big-endian keeps the bit order and find-first-set is count-leading-zeros
+
 #include "bitmap.h"
 #include "hweight.h"
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #define BITS_PER_BYTE			(8)
+#define BITS_PER_WORD			(64)
 #define BITS_TO_BYTES(nbits)	(((nbits) + BITS_PER_BYTE - 1) / BITS_PER_BYTE)
 #define BITS_MASK_BYTE(nbits)	((uint8_t)~(((uint8_t)~0) >> nbits))
 
+// Count Leading Zeros, v != 0
+static inline unsigned int clz64(uint64_t v)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long i;
+	_BitScanReverse64(&i, v);
+	return 63 - (unsigned int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if (v >> 32)
+	{
+		_BitScanReverse(&i, (unsigned long)(v >> 32));
+		return 31 - (unsigned int)i;
+	}
+	_BitScanReverse(&i, (unsigned long)v);
+	return 63 - (unsigned int)i;
+#elif defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_clzll(v);
+#else
+	unsigned int num = 0;
+	if (0 == (v >> 32)) { num += 32; v <<= 32; }
+	if (0 == (v >> 48)) { num += 16; v <<= 16; }
+	if (0 == (v >> 56)) { num += 8; v <<= 8; }
+	if (0 == (v >> 60)) { num += 4; v <<= 4; }
+	if (0 == (v >> 62)) { num += 2; v <<= 2; }
+	if (0 == (v >> 63)) { num += 1; }
+	return num;
+#endif
+}
+
+// Count Trailing Zeros, v != 0
+static inline unsigned int ctz64(uint64_t v)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return (unsigned int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if ((uint32_t)v)
+	{
+		_BitScanForward(&i, (unsigned long)v);
+		return (unsigned int)i;
+	}
+	_BitScanForward(&i, (unsigned long)(v >> 32));
+	return 32 + (unsigned int)i;
+#elif defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_ctzll(v);
+#else
+	return 63 - clz64(v & (0 - v));
+#endif
+}
+
+/// load big-endian word(compiler emit a bswap/movbe)
+static inline uint64_t bitmap_load64(const uint8_t* p)
+{
+	return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+		| ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+/// @param[in] i word index
+/// @param[in] bytes bitmap bytes, the last word is zero-padded
+static inline uint64_t bitmap_word(const uint8_t* bitmap, size_t bytes, size_t i)
+{
+	size_t j, n;
+	uint64_t v;
+
+	n = bytes - i * 8;
+	if (n >= 8)
+		return bitmap_load64(bitmap + i * 8);
+
+	for (v = 0, j = 0; j < n; j++)
+		v |= (uint64_t)bitmap[i * 8 + j] << (56 - 8 * j);
+	return v;
+}
+
+/// @param[in] invert 0-find set bit, ~0-find zero bit
+/// @return bit index, nbits if not found
+static size_t bitmap_find(const uint8_t* bitmap, size_t nbits, size_t start, uint64_t invert)
+{
+	size_t i, bytes, words;
+	uint64_t v;
+
+	if (start >= nbits)
+		return nbits;
+
+	bytes = BITS_TO_BYTES(nbits);
+	words = (bytes + 7) / 8;
+	i = start / BITS_PER_WORD;
+	v = (bitmap_word(bitmap, bytes, i) ^ invert) & (~(uint64_t)0 >> (start % BITS_PER_WORD));
+	while (0 == v)
+	{
+		if (++i >= words)
+			return nbits;
+		v = bitmap_word(bitmap, bytes, i) ^ invert;
+	}
+
+	i = i * BITS_PER_WORD + clz64(v);
+	return i < nbits ? i : nbits;
+}
+
 void bitmap_zero(uint8_t* bitmap, size_t nbits)
 {
 	size_t n = BITS_TO_BYTES(nbits);
@@ -28,229 +146,293 @@ void bitmap_set(uint8_t *bitmap, size_t start, size_t len)
 {
 	size_t end = start + len;
 	size_t from = start / BITS_PER_BYTE;
+	size_t to = end / BITS_PER_BYTE;
 	uint8_t mask = ((uint8_t)~0) >> (start % BITS_PER_BYTE);
-	while (from < end / BITS_PER_BYTE)
+
+	if (0 == len)
+		return;
+
+	if (from == to)
 	{
-		bitmap[from++] |= mask;
-		mask = (uint8_t)~0;
+		bitmap[from] |= mask & BITS_MASK_BYTE(end % BITS_PER_BYTE);
+		return;
 	}
 
+	bitmap[from] |= mask;
+	memset(bitmap + from + 1, 0xFF, to - from - 1);
 	if (end % BITS_PER_BYTE)
-	{
-		mask &= BITS_MASK_BYTE(end % BITS_PER_BYTE);
-		bitmap[from] |= mask;
-	}
+		bitmap[to] |= BITS_MASK_BYTE(end % BITS_PER_BYTE);
 }
 
 void bitmap_clear(uint8_t *bitmap, size_t start, size_t len)
 {
 	size_t end = start + len;
 	size_t from = start / BITS_PER_BYTE;
-	uint8_t mask = BITS_MASK_BYTE(start % BITS_PER_BYTE);
-	while (from < end / BITS_PER_BYTE)
+	size_t to = end / BITS_PER_BYTE;
+	uint8_t mask = ((uint8_t)~0) >> (start % BITS_PER_BYTE);
+
+	if (0 == len)
+		return;
+
+	if (from == to)
 	{
-		bitmap[from++] &= mask;
-		mask = 0UL;
+		bitmap[from] &= (uint8_t)~(mask & BITS_MASK_BYTE(end % BITS_PER_BYTE));
+		return;
 	}
 
+	bitmap[from] &= (uint8_t)~mask;
+	memset(bitmap + from + 1, 0x00, to - from - 1);
 	if (end % BITS_PER_BYTE)
-	{
-		mask |= ((uint8_t)~0) >> (end % BITS_PER_BYTE);
-		bitmap[from] &= mask;
-	}
+		bitmap[to] &= (uint8_t)~BITS_MASK_BYTE(end % BITS_PER_BYTE);
 }
 
+// bulk binary operation: 32/16-bytes vector, 8-bytes word, then tail bytes
+#if defined(__AVX2__)
+#define BITMAP_OP_AVX2(op) for (; i + 32 <= n; i += 32) _mm256_storeu_si256((__m256i*)(result + i), op(_mm256_loadu_si256((const __m256i*)(src1 + i)), _mm256_loadu_si256((const __m256i*)(src2 + i))))
+#else
+#define BITMAP_OP_AVX2(op)
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITMAP_OP_SIMD(sse2, neon) for (; i + 16 <= n; i += 16) _mm_storeu_si128((__m128i*)(result + i), sse2(_mm_loadu_si128((const __m128i*)(src1 + i)), _mm_loadu_si128((const __m128i*)(src2 + i))))
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BITMAP_OP_SIMD(sse2, neon) for (; i + 16 <= n; i += 16) vst1q_u8(result + i, neon(vld1q_u8(src1 + i), vld1q_u8(src2 + i)))
+#else
+#define BITMAP_OP_SIMD(sse2, neon)
+#endif
+
+#define BITMAP_OP_WORD(op) \
+	for (; i + 8 <= n; i += 8) { memcpy(&a, src1 + i, 8); memcpy(&b, src2 + i, 8); a = a op b; memcpy(result + i, &a, 8); } \
+	for (; i < n; i++) result[i] = src1[i] op src2[i]
+
 void bitmap_or(uint8_t* result, const uint8_t* src1, const uint8_t* src2, size_t nbits)
 {
-	size_t i;
-	for (i = 0; i < BITS_TO_BYTES(nbits); i++)
-		result[i] = src1[i] | src2[i];
+	uint64_t a, b;
+	size_t i = 0, n = BITS_TO_BYTES(nbits);
+	BITMAP_OP_AVX2(_mm256_or_si256);
+	BITMAP_OP_SIMD(_mm_or_si128, vorrq_u8);
+	BITMAP_OP_WORD(|);
 }
 
 void bitmap_and(uint8_t* result, const uint8_t* src1, const uint8_t* src2, size_t nbits)
 {
-	size_t i;
-	for (i = 0; i < BITS_TO_BYTES(nbits); i++)
-		result[i] = src1[i] & src2[i];
+	uint64_t a, b;
+	size_t i = 0, n = BITS_TO_BYTES(nbits);
+	BITMAP_OP_AVX2(_mm256_and_si256);
+	BITMAP_OP_SIMD(_mm_and_si128, vandq_u8);
+	BITMAP_OP_WORD(&);
 }
 
 void bitmap_xor(uint8_t* result, const uint8_t* src1, const uint8_t* src2, size_t nbits)
 {
-	size_t i;
-	for (i = 0; i < BITS_TO_BYTES(nbits); i++)
-		result[i] = src1[i] ^ src2[i];
+	uint64_t a, b;
+	size_t i = 0, n = BITS_TO_BYTES(nbits);
+	BITMAP_OP_AVX2(_mm256_xor_si256);
+	BITMAP_OP_SIMD(_mm_xor_si128, veorq_u8);
+	BITMAP_OP_WORD(^);
 }
 
 size_t bitmap_weight(const uint8_t* bitmap, size_t nbits)
 {
-	size_t w;
-	size_t i;
-	const unsigned long *p;
-	const uint8_t* p8;
-	
-	p = (unsigned long *)bitmap;
-	for (i = w = 0; i < nbits / (BITS_PER_BYTE * sizeof(unsigned long)); i++)
-		w += hweight_long(*(p + i));
-
-	p8 = (const uint8_t*)(p + i);
-	i = (nbits % (BITS_PER_BYTE * sizeof(unsigned long))) / BITS_PER_BYTE;
-	while(i-- > 0)
-		w += hweight8(*p8++);
-	
+	size_t i, w, n;
+	uint64_t v;
+
+	n = nbits / BITS_PER_BYTE;
+	for (i = w = 0; i + 8 <= n; i += 8)
+	{
+		memcpy(&v, bitmap + i, 8);
+		w += hweight64(v);
+	}
+
+	for (; i < n; i++)
+		w += hweight8(bitmap[i]);
+
 	nbits = nbits % BITS_PER_BYTE;
 	if(nbits)
-		w += hweight8(*p8 & BITS_MASK_BYTE(nbits));
+		w += hweight8(bitmap[i] & BITS_MASK_BYTE(nbits));
 	return w;
 }
 
-#if 0
-// https://en.wikipedia.org/wiki/Find_first_set
-static inline unsigned int clz(unsigned long v)
+size_t bitmap_count_leading_zero(const uint8_t* bitmap, size_t nbits)
 {
-#if defined(_MSC_VER)
-#if defined(_WIN64)
-	return __lzcnt64(v);
-#else
-	return __lzcnt(v);
-#endif
-#elif defined(__GNUC__)
-	return __builtin_clzl(v);
-#else
-	unsigned int num = 64;
-	if (8 == sizeof(v))
-	{
-		if (0xFFFFFFFF00000000ul & v)
-		{
-			num -= 32;
-			v >>= 32;
-		}
-	}
-	if (0xFFFF0000 & v)
-	{
-		num -= 16;
-		v >>= 16;
-	}
-	if (0xFF00 & v)
-	{
-		num -= 8;
-		v >>= 8;
-	}
-	if (0xF0 & v)
-	{
-		num -= 4;
-		v >>= 4;
-	}
-	if (0xC & v)
-	{
-		num -= 2;
-		v >>= 2;
-	}
-	if (0x2 & v)
-	{
-		num -= 1;
-		v >>= 1;
-	}
-	if (0x1 & v)
-		num -= 1;
+	return bitmap_find(bitmap, nbits, 0, 0);
+}
 
-	return num;
-#endif
+size_t bitmap_count_next_zero(const uint8_t* bitmap, size_t nbits, size_t start)
+{
+	return start < nbits ? bitmap_find(bitmap, nbits, start, 0) - start : 0;
 }
-#endif
 
-// Count Leading Zeros
-static inline unsigned int clz8(uint8_t v)
+size_t bitmap_find_first_zero(const uint8_t* bitmap, size_t nbits)
 {
-	unsigned int num = BITS_PER_BYTE;
-	if (0xF0 & v)
-	{
-		num -= 4;
-		v >>= 4;
-	}
-	if (0xC & v)
-	{
-		num -= 2;
-		v >>= 2;
-	}
-	if (0x2 & v)
-	{
-		num -= 1;
-		v >>= 1;
-	}
-	if (0x1 & v)
-		num -= 1;
+	return bitmap_find(bitmap, nbits, 0, ~(uint64_t)0);
+}
 
-	return num;
+size_t bitmap_find_next_zero(const uint8_t* bitmap, size_t nbits, size_t start)
+{
+	return start < nbits ? bitmap_find(bitmap, nbits, start, ~(uint64_t)0) - start : 0;
 }
 
-/// Find First Zero
-static inline unsigned int ffz8(uint8_t v)
+size_t bitmap_next_set(const uint8_t* bitmap, size_t nbits, size_t start)
 {
-	return clz8((uint8_t)~v);
+	return bitmap_find(bitmap, nbits, start, 0);
 }
 
-size_t bitmap_count_leading_zero(const uint8_t* bitmap, size_t nbits)
+size_t bitmap_next_zero(const uint8_t* bitmap, size_t nbits, size_t start)
 {
-	size_t i, c = 0;
-	size_t n = BITS_TO_BYTES(nbits);
+	return bitmap_find(bitmap, nbits, start, ~(uint64_t)0);
+}
 
-	for (i = 0; i < n; i++)
-	{
-		c = clz8(bitmap[i]);
-		if (c < BITS_PER_BYTE)
-			break;
-	}
+int bitmap_test_bit(const uint8_t* bitmap, size_t bits)
+{
+	size_t n = bits / BITS_PER_BYTE;
+	return bitmap[n] & (1 << (BITS_PER_BYTE - 1 - (bits % BITS_PER_BYTE)));
+}
+
+// hierarchical bitmap: leaf words(LSB-first), level-1 bit i: leaf word i has a zero bit,
+// level-2 bit i: level-1 word i isn't zero. find a zero bit touch at most one word per level(plus level-2 scan).
+struct hbitmap_t
+{
+	size_t nbits;
+	size_t n0, n1, n2; // words per level
+	uint64_t* l0;
+	uint64_t* l1;
+	uint64_t* l2;
+};
+
+#define WORDS(nbits) (((nbits) + BITS_PER_WORD - 1) / BITS_PER_WORD)
 
-	c += i * BITS_PER_BYTE;
-	return c > nbits ? nbits : c;
+struct hbitmap_t* hbitmap_create(size_t nbits)
+{
+	size_t i;
+	struct hbitmap_t* hb;
+
+	if (0 == nbits)
+		return NULL;
+
+	i = WORDS(nbits) + WORDS(WORDS(nbits)) + WORDS(WORDS(WORDS(nbits)));
+	hb = (struct hbitmap_t*)calloc(1, sizeof(*hb) + i * sizeof(uint64_t));
+	if (!hb)
+		return NULL;
+
+	hb->nbits = nbits;
+	hb->n0 = WORDS(nbits);
+	hb->n1 = WORDS(hb->n0);
+	hb->n2 = WORDS(hb->n1);
+	hb->l0 = (uint64_t*)(hb + 1);
+	hb->l1 = hb->l0 + hb->n0;
+	hb->l2 = hb->l1 + hb->n1;
+
+	// all bits are zero, bits after nbits are set(never found)
+	if (nbits % BITS_PER_WORD)
+		hb->l0[hb->n0 - 1] = ~(uint64_t)0 << (nbits % BITS_PER_WORD);
+	for (i = 0; i < hb->n0; i++)
+		hb->l1[i / BITS_PER_WORD] |= (uint64_t)1 << (i % BITS_PER_WORD);
+	for (i = 0; i < hb->n1; i++)
+		hb->l2[i / BITS_PER_WORD] |= (uint64_t)1 << (i % BITS_PER_WORD);
+	return hb;
 }
 
-size_t bitmap_count_next_zero(const uint8_t* bitmap, size_t nbits, size_t start)
+void hbitmap_destroy(struct hbitmap_t* hb)
 {
-	size_t c, i = start / BITS_PER_BYTE;
-	uint8_t mask = ((uint8_t)~0) >> (start % BITS_PER_BYTE);
+	free(hb);
+}
 
-	c = clz8(bitmap[i] & mask);
-	if (BITS_PER_BYTE == c && i + 1 < BITS_TO_BYTES(nbits))
-		c += bitmap_count_leading_zero(bitmap + i + 1, nbits - (i + 1) * BITS_PER_BYTE);
-	c += i * BITS_PER_BYTE;
-	c = c > nbits ? nbits : c;
-	c -= start;
-	return c;
+size_t hbitmap_size(const struct hbitmap_t* hb)
+{
+	return hb->nbits;
 }
 
-size_t bitmap_find_first_zero(const uint8_t* bitmap, size_t nbits)
+int hbitmap_test_bit(const struct hbitmap_t* hb, size_t bit)
 {
-	size_t i, c = 0;
-	size_t n = BITS_TO_BYTES(nbits);
+	return bit < hb->nbits && (hb->l0[bit / BITS_PER_WORD] & ((uint64_t)1 << (bit % BITS_PER_WORD))) ? 1 : 0;
+}
+
+void hbitmap_set(struct hbitmap_t* hb, size_t bit)
+{
+	size_t i;
+	if (bit >= hb->nbits)
+		return;
+
+	i = bit / BITS_PER_WORD;
+	hb->l0[i] |= (uint64_t)1 << (bit % BITS_PER_WORD);
+	if (~(uint64_t)0 != hb->l0[i])
+		return;
+
+	// leaf word is full
+	hb->l1[i / BITS_PER_WORD] &= ~((uint64_t)1 << (i % BITS_PER_WORD));
+	i /= BITS_PER_WORD;
+	if (0 == hb->l1[i])
+		hb->l2[i / BITS_PER_WORD] &= ~((uint64_t)1 << (i % BITS_PER_WORD));
+}
+
+void hbitmap_clear(struct hbitmap_t* hb, size_t bit)
+{
+	size_t i;
+	if (bit >= hb->nbits)
+		return;
+
+	i = bit / BITS_PER_WORD;
+	hb->l0[i] &= ~((uint64_t)1 << (bit % BITS_PER_WORD));
+	hb->l1[i / BITS_PER_WORD] |= (uint64_t)1 << (i % BITS_PER_WORD);
+	i /= BITS_PER_WORD;
+	hb->l2[i / BITS_PER_WORD] |= (uint64_t)1 << (i % BITS_PER_WORD);
+}
+
+size_t hbitmap_find_next_zero(const struct hbitmap_t* hb, size_t start)
+{
+	size_t i, j, k;
+	uint64_t v;
+
+	if (start >= hb->nbits)
+		return hb->nbits;
 
-	for (i = 0; i < n; i++)
+	// leaf word
+	i = start / BITS_PER_WORD;
+	v = ~hb->l0[i] & (~(uint64_t)0 << (start % BITS_PER_WORD));
+	if (v)
+		return i * BITS_PER_WORD + ctz64(v);
+
+	// level-1: the following leaf words in the same level-1 word
+	i++;
+	j = i / BITS_PER_WORD;
+	v = (i % BITS_PER_WORD && j < hb->n1) ? hb->l1[j] & (~(uint64_t)0 << (i % BITS_PER_WORD)) : 0;
+	if (!v)
 	{
-		c = ffz8(bitmap[i]);
-		if (c < BITS_PER_BYTE)
-			break;
+		// level-2: the following level-1 words
+		j = (i + BITS_PER_WORD - 1) / BITS_PER_WORD;
+		k = j / BITS_PER_WORD;
+		if (k >= hb->n2)
+			return hb->nbits;
+
+		v = hb->l2[k] & (~(uint64_t)0 << (j % BITS_PER_WORD));
+		while (!v)
+		{
+			if (++k >= hb->n2)
+				return hb->nbits;
+			v = hb->l2[k];
+		}
+
+		j = k * BITS_PER_WORD + ctz64(v);
+		v = hb->l1[j];
 	}
 
-	c += i * BITS_PER_BYTE;
-	return c > nbits ? nbits : c;
+	i = j * BITS_PER_WORD + ctz64(v);
+	return i * BITS_PER_WORD + ctz64(~hb->l0[i]);
 }
 
-size_t bitmap_find_next_zero(const uint8_t* bitmap, size_t nbits, size_t start)
+size_t hbitmap_find_first_zero(const struct hbitmap_t* hb)
 {
-	size_t c, i = start / BITS_PER_BYTE;
-	uint8_t mask = BITS_MASK_BYTE(start % BITS_PER_BYTE);
-
-	c = ffz8(bitmap[i] | mask);
-	if (BITS_PER_BYTE == c && i + 1 < BITS_TO_BYTES(nbits))
-		c += bitmap_find_first_zero(bitmap + i + 1, nbits - (i + 1) * BITS_PER_BYTE);
-	c += i * BITS_PER_BYTE;
-	c = c > nbits ? nbits : c;
-	c -= start;
-	return c;
+	return hbitmap_find_next_zero(hb, 0);
 }
 
-int bitmap_test_bit(const uint8_t* bitmap, size_t bits)
+size_t hbitmap_acquire(struct hbitmap_t* hb, size_t start)
 {
-	size_t n = bits / BITS_PER_BYTE;
-	return bitmap[n] & (1 << (BITS_PER_BYTE - 1 - (bits % BITS_PER_BYTE)));
+	size_t bit;
+	bit = hbitmap_find_next_zero(hb, start);
+	if (bit >= hb->nbits && start > 0)
+		bit = hbitmap_find_next_zero(hb, 0); // wrap around
+	if (bit < hb->nbits)
+		hbitmap_set(hb, bit);
+	return bit;
 }
@@ -0,0 +1,697 @@
+// https://en.wikipedia.org/wiki/B%2B_tree
+// 1. inner node: keys[i-1] <= (keys in children[i]) < keys[i]
+// 2. insert/delete walk down once and keep the path, split/merge bottom-up along the path
+// 3. all nodes needed by the splits are allocated before changing the tree(no half-done insert on out of memory)
+// 4. append to the last leaf split it as 14/1 instead of 7/8, so increasing keys(time index) fill leaves
+
+#include "bptree.h"
+#include "slab.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define BPTREE_LEAF			14 // keys per leaf
+#define BPTREE_INNER		15 // keys per inner node
+#define BPTREE_MIN_LEAF		(BPTREE_LEAF / 2)
+#define BPTREE_MIN_INNER	(BPTREE_INNER / 2)
+#define BPTREE_HEIGHT		32 // >= log8(2^64) + 1
+
+// fetch the node keys(2 cache lines) in parallel
+#if defined(__GNUC__) || defined(__clang__)
+#define BPTREE_PREFETCH(node) (__builtin_prefetch(node), __builtin_prefetch((const char*)(node) + 64))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define BPTREE_PREFETCH(node) (_mm_prefetch((const char*)(node), _MM_HINT_T0), _mm_prefetch((const char*)(node) + 64, _MM_HINT_T0))
+#else
+#define BPTREE_PREFETCH(node) ((void)0)
+#endif
+
+struct bptree_node_t
+{
+	uint32_t leaf;
+	uint32_t n; // key count
+};
+
+struct bptree_leaf_t
+{
+	struct bptree_node_t hdr;
+	uint64_t keys[BPTREE_LEAF];
+	void* values[BPTREE_LEAF];
+	struct bptree_leaf_t* prev;
+	struct bptree_leaf_t* next;
+};
+
+struct bptree_inner_t
+{
+	struct bptree_node_t hdr;
+	uint64_t keys[BPTREE_INNER];
+	struct bptree_node_t* children[BPTREE_INNER + 1];
+};
+
+struct bptree_t
+{
+	struct bptree_node_t* root; // NULL if tree is empty
+	struct bptree_leaf_t* head;
+	struct bptree_leaf_t* tail;
+	size_t size;
+	int height;
+
+	struct slab_t* leaves;
+	struct slab_t* inners;
+};
+
+/// @return first i: keys[i] >= key
+static inline int bptree_lower(const uint64_t* keys, int n, uint64_t key)
+{
+	int i, c;
+	for (c = i = 0; i < n; i++)
+		c += keys[i] < key ? 1 : 0; // branchless
+	return c;
+}
+
+/// @return child index: count of keys[i] <= key
+static inline int bptree_upper(const uint64_t* keys, int n, uint64_t key)
+{
+	int i, c;
+	for (c = i = 0; i < n; i++)
+		c += keys[i] <= key ? 1 : 0;
+	return c;
+}
+
+static struct bptree_leaf_t* bptree_leaf(const struct bptree_t* tree, uint64_t key)
+{
+	const struct bptree_node_t* node;
+	const struct bptree_inner_t* inner;
+
+	node = tree->root;
+	while (node && !node->leaf)
+	{
+		inner = (const struct bptree_inner_t*)node;
+		node = inner->children[bptree_upper(inner->keys, (int)inner->hdr.n, key)];
+		BPTREE_PREFETCH(node);
+	}
+	return (struct bptree_leaf_t*)node;
+}
+
+static struct bptree_leaf_t* bptree_leaf_alloc(struct bptree_t* tree)
+{
+	struct bptree_leaf_t* leaf;
+	leaf = (struct bptree_leaf_t*)slab_alloc(tree->leaves);
+	if (leaf)
+	{
+		leaf->hdr.leaf = 1;
+		leaf->hdr.n = 0;
+		leaf->prev = leaf->next = NULL;
+	}
+	return leaf;
+}
+
+static struct bptree_inner_t* bptree_inner_alloc(struct bptree_t* tree)
+{
+	struct bptree_inner_t* inner;
+	inner = (struct bptree_inner_t*)slab_alloc(tree->inners);
+	if (inner)
+	{
+		inner->hdr.leaf = 0;
+		inner->hdr.n = 0;
+	}
+	return inner;
+}
+
+static void bptree_node_free(struct bptree_t* tree, struct bptree_node_t* node)
+{
+	slab_free(node->leaf ? tree->leaves : tree->inners, node);
+}
+
+static void bptree_free_tree(struct bptree_t* tree, struct bptree_node_t* node)
+{
+	uint32_t i;
+	struct bptree_inner_t* inner;
+
+	if (!node->leaf)
+	{
+		inner = (struct bptree_inner_t*)node;
+		for (i = 0; i <= inner->hdr.n; i++)
+			bptree_free_tree(tree, inner->children[i]);
+	}
+	bptree_node_free(tree, node);
+}
+
+struct bptree_t* bptree_create(void)
+{
+	struct bptree_t* tree;
+	tree = (struct bptree_t*)calloc(1, sizeof(*tree));
+	if (!tree)
+		return NULL;
+
+	tree->leaves = slab_create(sizeof(struct bptree_leaf_t));
+	tree->inners = slab_create(sizeof(struct bptree_inner_t));
+	if (!tree->leaves || !tree->inners)
+	{
+		bptree_destroy(tree);
+		return NULL;
+	}
+	return tree;
+}
+
+void bptree_destroy(struct bptree_t* tree)
+{
+	if (tree->root)
+		bptree_free_tree(tree, tree->root);
+	if (tree->leaves)
+		slab_destroy(tree->leaves);
+	if (tree->inners)
+		slab_destroy(tree->inners);
+	free(tree);
+}
+
+size_t bptree_size(const struct bptree_t* tree)
+{
+	return tree->size;
+}
+
+int bptree_find(const struct bptree_t* tree, uint64_t key, void** value)
+{
+	int pos;
+	struct bptree_leaf_t* leaf;
+
+	leaf = bptree_leaf(tree, key);
+	if (!leaf)
+		return -ENOENT;
+
+	pos = bptree_lower(leaf->keys, (int)leaf->hdr.n, key);
+	if (pos >= (int)leaf->hdr.n || leaf->keys[pos] != key)
+		return -ENOENT;
+
+	if (value)
+		*value = leaf->values[pos];
+	return 0;
+}
+
+/// split full leaf and insert key at pos
+/// @return separator(first key of right leaf)
+static uint64_t bptree_leaf_split(struct bptree_t* tree, struct bptree_leaf_t* leaf, struct bptree_leaf_t* right, int pos, uint64_t key, void* value)
+{
+	int m;
+	uint64_t keys[BPTREE_LEAF + 1];
+	void* values[BPTREE_LEAF + 1];
+
+	memcpy(keys, leaf->keys, sizeof(uint64_t) * pos);
+	memcpy(values, leaf->values, sizeof(void*) * pos);
+	keys[pos] = key;
+	values[pos] = value;
+	memcpy(keys + pos + 1, leaf->keys + pos, sizeof(uint64_t) * (BPTREE_LEAF - pos));
+	memcpy(values + pos + 1, leaf->values + pos, sizeof(void*) * (BPTREE_LEAF - pos));
+
+	m = (BPTREE_LEAF == pos && !leaf->next) ? BPTREE_LEAF : (BPTREE_LEAF + 1) / 2;
+	memcpy(leaf->keys, keys, sizeof(uint64_t) * m);
+	memcpy(leaf->values, values, sizeof(void*) * m);
+	memcpy(right->keys, keys + m, sizeof(uint64_t) * (BPTREE_LEAF + 1 - m));
+	memcpy(right->values, values + m, sizeof(void*) * (BPTREE_LEAF + 1 - m));
+	leaf->hdr.n = m;
+	right->hdr.n = BPTREE_LEAF + 1 - m;
+
+	right->prev = leaf;
+	right->next = leaf->next;
+	if (leaf->next)
+		leaf->next->prev = right;
+	else
+		tree->tail = right;
+	leaf->next = right;
+	return right->keys[0];
+}
+
+/// split full inner node and insert (sep, child) at c
+/// @return separator move up to parent
+static uint64_t bptree_inner_split(struct bptree_inner_t* inner, struct bptree_inner_t* right, int c, uint64_t sep, struct bptree_node_t* child)
+{
+	int m;
+	uint64_t keys[BPTREE_INNER + 1];
+	struct bptree_node_t* children[BPTREE_INNER + 2];
+
+	memcpy(keys, inner->keys, sizeof(uint64_t) * c);
+	keys[c] = sep;
+	memcpy(keys + c + 1, inner->keys + c, sizeof(uint64_t) * (BPTREE_INNER - c));
+	memcpy(children, inner->children, sizeof(void*) * (c + 1));
+	children[c + 1] = child;
+	memcpy(children + c + 2, inner->children + c + 1, sizeof(void*) * (BPTREE_INNER - c));
+
+	m = (BPTREE_INNER + 1) / 2;
+	memcpy(inner->keys, keys, sizeof(uint64_t) * m);
+	memcpy(inner->children, children, sizeof(void*) * (m + 1));
+	inner->hdr.n = m;
+	memcpy(right->keys, keys + m + 1, sizeof(uint64_t) * (BPTREE_INNER - m));
+	memcpy(right->children, children + m + 1, sizeof(void*) * (BPTREE_INNER + 1 - m));
+	right->hdr.n = BPTREE_INNER - m;
+	return keys[m];
+}
+
+int bptree_insert(struct bptree_t* tree, uint64_t key, void* value)
+{
+	int i, c, pos, depth, need;
+	uint64_t sep;
+	struct bptree_node_t* node;
+	struct bptree_node_t* sibling;
+	struct bptree_leaf_t* leaf;
+	struct bptree_leaf_t* right;
+	struct bptree_inner_t* inner;
+	struct bptree_inner_t* path[BPTREE_HEIGHT];
+	struct bptree_inner_t* nodes[BPTREE_HEIGHT];
+	int index[BPTREE_HEIGHT];
+
+	if (!tree->root)
+	{
+		leaf = bptree_leaf_alloc(tree);
+		if (!leaf)
+			return -ENOMEM;
+		tree->root = &leaf->hdr;
+		tree->head = tree->tail = leaf;
+		tree->height = 1;
+	}
+
+	for (depth = 0, node = tree->root; !node->leaf; depth++)
+	{
+		inner = (struct bptree_inner_t*)node;
+		c = bptree_upper(inner->keys, (int)inner->hdr.n, key);
+		path[depth] = inner;
+		index[depth] = c;
+		node = inner->children[c];
+		BPTREE_PREFETCH(node);
+	}
+
+	leaf = (struct bptree_leaf_t*)node;
+	pos = bptree_lower(leaf->keys, (int)leaf->hdr.n, key);
+	if (pos < (int)leaf->hdr.n && leaf->keys[pos] == key)
+		return -EEXIST;
+
+	if (leaf->hdr.n < BPTREE_LEAF)
+	{
+		memmove(leaf->keys + pos + 1, leaf->keys + pos, sizeof(uint64_t) * (leaf->hdr.n - pos));
+		memmove(leaf->values + pos + 1, leaf->values + pos, sizeof(void*) * (leaf->hdr.n - pos));
+		leaf->keys[pos] = key;
+		leaf->values[pos] = value;
+		leaf->hdr.n++;
+		tree->size++;
+		return 0;
+	}
+
+	// full inner nodes on the path(bottom-up) split too, plus a new root
+	for (need = 0, i = depth - 1; i >= 0 && BPTREE_INNER == path[i]->hdr.n; i--)
+		need++;
+	if (i < 0)
+		need++;
+
+	right = bptree_leaf_alloc(tree);
+	for (i = 0; i < need && right; i++)
+	{
+		nodes[i] = bptree_inner_alloc(tree);
+		if (!nodes[i])
+			break;
+	}
+	if (!right || i < need)
+	{
+		while (i-- > 0)
+			bptree_node_free(tree, &nodes[i]->hdr);
+		if (right)
+			bptree_node_free(tree, &right->hdr);
+		return -ENOMEM;
+	}
+
+	sep = bptree_leaf_split(tree, leaf, right, pos, key, value);
+	sibling = &right->hdr;
+	for (i = depth - 1; i >= 0 && sibling; i--)
+	{
+		inner = path[i];
+		c = index[i];
+		if (inner->hdr.n < BPTREE_INNER)
+		{
+			memmove(inner->keys + c + 1, inner->keys + c, sizeof(uint64_t) * (inner->hdr.n - c));
+			memmove(inner->children + c + 2, inner->children + c + 1, sizeof(void*) * (inner->hdr.n - c));
+			inner->keys[c] = sep;
+			inner->children[c + 1] = sibling;
+			inner->hdr.n++;
+			sibling = NULL;
+		}
+		else
+		{
+			sep = bptree_inner_split(inner, nodes[--need], c, sep, sibling);
+			sibling = &nodes[need]->hdr;
+		}
+	}
+
+	if (sibling)
+	{
+		// new root
+		assert(1 == need);
+		inner = nodes[0];
+		inner->keys[0] = sep;
+		inner->children[0] = tree->root;
+		inner->children[1] = sibling;
+		inner->hdr.n = 1;
+		tree->root = &inner->hdr;
+		tree->height++;
+	}
+
+	tree->size++;
+	return 0;
+}
+
+static void bptree_inner_remove(struct bptree_inner_t* inner, int k)
+{
+	// remove keys[k] and children[k + 1]
+	memmove(inner->keys + k, inner->keys + k + 1, sizeof(uint64_t) * (inner->hdr.n - k - 1));
+	memmove(inner->children + k + 1, inner->children + k + 2, sizeof(void*) * (inner->hdr.n - k - 1));
+	inner->hdr.n--;
+}
+
+/// children[c] underflow, borrow from or merge with sibling
+static void bptree_rebalance(struct bptree_t* tree, struct bptree_inner_t* parent, int c)
+{
+	int k, n;
+	struct bptree_leaf_t *ll, *lr;
+	struct bptree_inner_t *il, *ir;
+
+	k = c > 0 ? c - 1 : c; // (children[k], children[k + 1]) separated by keys[k]
+	if (parent->children[k]->leaf)
+	{
+		ll = (struct bptree_leaf_t*)parent->children[k];
+		lr = (struct bptree_leaf_t*)parent->children[k + 1];
+		if (c == k && lr->hdr.n > BPTREE_MIN_LEAF)
+		{
+			// move right first to left
+			ll->keys[ll->hdr.n] = lr->keys[0];
+			ll->values[ll->hdr.n++] = lr->values[0];
+			memmove(lr->keys, lr->keys + 1, sizeof(uint64_t) * --lr->hdr.n);
+			memmove(lr->values, lr->values + 1, sizeof(void*) * lr->hdr.n);
+			parent->keys[k] = lr->keys[0];
+		}
+		else if (c != k && ll->hdr.n > BPTREE_MIN_LEAF)
+		{
+			// move left last to right
+			memmove(lr->keys + 1, lr->keys, sizeof(uint64_t) * lr->hdr.n);
+			memmove(lr->values + 1, lr->values, sizeof(void*) * lr->hdr.n);
+			lr->keys[0] = ll->keys[--ll->hdr.n];
+			lr->values[0] = ll->values[ll->hdr.n];
+			lr->hdr.n++;
+			parent->keys[k] = lr->keys[0];
+		}
+		else
+		{
+			// merge right to left
+			assert(ll->hdr.n + lr->hdr.n <= BPTREE_LEAF);
+			memcpy(ll->keys + ll->hdr.n, lr->keys, sizeof(uint64_t) * lr->hdr.n);
+			memcpy(ll->values + ll->hdr.n, lr->values, sizeof(void*) * lr->hdr.n);
+			ll->hdr.n += lr->hdr.n;
+			ll->next = lr->next;
+			if (lr->next)
+				lr->next->prev = ll;
+			else
+				tree->tail = ll;
+			bptree_inner_remove(parent, k);
+			bptree_node_free(tree, &lr->hdr);
+		}
+	}
+	else
+	{
+		il = (struct bptree_inner_t*)parent->children[k];
+		ir = (struct bptree_inner_t*)parent->children[k + 1];
+		if (c == k && ir->hdr.n > BPTREE_MIN_INNER)
+		{
+			// rotate left
+			il->keys[il->hdr.n] = parent->keys[k];
+			il->children[++il->hdr.n] = ir->children[0];
+			parent->keys[k] = ir->keys[0];
+			memmove(ir->keys, ir->keys + 1, sizeof(uint64_t) * (ir->hdr.n - 1));
+			memmove(ir->children, ir->children + 1, sizeof(void*) * ir->hdr.n);
+			ir->hdr.n--;
+		}
+		else if (c != k && il->hdr.n > BPTREE_MIN_INNER)
+		{
+			// rotate right
+			memmove(ir->keys + 1, ir->keys, sizeof(uint64_t) * ir->hdr.n);
+			memmove(ir->children + 1, ir->children, sizeof(void*) * (ir->hdr.n + 1));
+			ir->keys[0] = parent->keys[k];
+			ir->children[0] = il->children[il->hdr.n];
+			ir->hdr.n++;
+			parent->keys[k] = il->keys[--il->hdr.n];
+		}
+		else
+		{
+			// merge right to left with the separator
+			n = (int)il->hdr.n;
+			assert(il->hdr.n + ir->hdr.n + 1 <= BPTREE_INNER);
+			il->keys[n] = parent->keys[k];
+			memcpy(il->keys + n + 1, ir->keys, sizeof(uint64_t) * ir->hdr.n);
+			memcpy(il->children + n + 1, ir->children, sizeof(void*) * (ir->hdr.n + 1));
+			il->hdr.n += ir->hdr.n + 1;
+			bptree_inner_remove(parent, k);
+			bptree_node_free(tree, &ir->hdr);
+		}
+	}
+}
+
+int bptree_delete(struct bptree_t* tree, uint64_t key, void** value)
+{
+	int i, c, pos, depth;
+	struct bptree_node_t* node;
+	struct bptree_leaf_t* leaf;
+	struct bptree_inner_t* inner;
+	struct bptree_inner_t* path[BPTREE_HEIGHT];
+	int index[BPTREE_HEIGHT];
+
+	if (!tree->root)
+		return -ENOENT;
+
+	for (depth = 0, node = tree->root; !node->leaf; depth++)
+	{
+		inner = (struct bptree_inner_t*)node;
+		c = bptree_upper(inner->keys, (int)inner->hdr.n, key);
+		path[depth] = inner;
+		index[depth] = c;
+		node = inner->children[c];
+		BPTREE_PREFETCH(node);
+	}
+
+	leaf = (struct bptree_leaf_t*)node;
+	pos = bptree_lower(leaf->keys, (int)leaf->hdr.n, key);
+	if (pos >= (int)leaf->hdr.n || leaf->keys[pos] != key)
+		return -ENOENT;
+
+	if (value)
+		*value = leaf->values[pos];
+	memmove(leaf->keys + pos, leaf->keys + pos + 1, sizeof(uint64_t) * (leaf->hdr.n - pos - 1));
+	memmove(leaf->values + pos, leaf->values + pos + 1, sizeof(void*) * (leaf->hdr.n - pos - 1));
+	leaf->hdr.n--;
+	tree->size--;
+
+	for (i = depth - 1; i >= 0; i--)
+	{
+		if (node->n >= (uint32_t)(node->leaf ? BPTREE_MIN_LEAF : BPTREE_MIN_INNER))
+			break;
+		bptree_rebalance(tree, path[i], index[i]);
+		node = &path[i]->hdr;
+	}
+
+	node = tree->root;
+	if (!node->leaf && 0 == node->n)
+	{
+		tree->root = ((struct bptree_inner_t*)node)->children[0];
+		tree->height--;
+		bptree_node_free(tree, node);
+	}
+	else if (node->leaf && 0 == node->n)
+	{
+		tree->root = NULL;
+		tree->head = tree->tail = NULL;
+		tree->height = 0;
+		bptree_node_free(tree, node);
+	}
+	return 0;
+}
+
+int bptree_bulk_load(struct bptree_t* tree, const uint64_t* keys, void* const* values, size_t n)
+{
+	size_t i, j, k, m, g, ng, cnt, nleaves, ninners;
+	uint64_t* mins;
+	void** nodes;
+	void** pool;
+	struct bptree_leaf_t* leaf;
+	struct bptree_inner_t* inner;
+
+	if (tree->root)
+		return -EINVAL;
+	for (i = 1; i < n; i++)
+	{
+		if (keys[i - 1] >= keys[i])
+			return -EINVAL;
+	}
+	if (0 == n)
+		return 0;
+
+	nleaves = (n + BPTREE_LEAF - 1) / BPTREE_LEAF;
+	for (ninners = 0, m = nleaves; m > 1; m = ng)
+	{
+		ng = (m + BPTREE_INNER) / (BPTREE_INNER + 1);
+		ninners += ng;
+	}
+
+	// allocate all nodes first
+	pool = (void**)malloc((nleaves + ninners + nleaves) * sizeof(void*) + nleaves * sizeof(uint64_t));
+	if (!pool)
+		return -ENOMEM;
+	nodes = pool + nleaves + ninners;
+	mins = (uint64_t*)(nodes + nleaves);
+	for (i = 0; i < nleaves + ninners; i++)
+	{
+		pool[i] = i < nleaves ? (void*)bptree_leaf_alloc(tree) : (void*)bptree_inner_alloc(tree);
+		if (!pool[i])
+		{
+			while (i-- > 0)
+				bptree_node_free(tree, (struct bptree_node_t*)pool[i]);
+			free(pool);
+			return -ENOMEM;
+		}
+	}
+
+	// leaves: spread keys evenly, every leaf >= BPTREE_MIN_LEAF
+	for (k = i = 0; i < nleaves; i++)
+	{
+		leaf = (struct bptree_leaf_t*)pool[i];
+		cnt = n / nleaves + (i < n % nleaves ? 1 : 0);
+		memcpy(leaf->keys, keys + k, sizeof(uint64_t) * cnt);
+		if (values)
+			memcpy(leaf->values, values + k, sizeof(void*) * cnt);
+		else
+			memset(leaf->values, 0, sizeof(void*) * cnt);
+		leaf->hdr.n = (uint32_t)cnt;
+		leaf->prev = i > 0 ? (struct bptree_leaf_t*)pool[i - 1] : NULL;
+		leaf->next = i + 1 < nleaves ? (struct bptree_leaf_t*)pool[i + 1] : NULL;
+		nodes[i] = leaf;
+		mins[i] = leaf->keys[0];
+		k += cnt;
+	}
+
+	tree->head = (struct bptree_leaf_t*)pool[0];
+	tree->tail = (struct bptree_leaf_t*)pool[nleaves - 1];
+	tree->height = 1;
+
+	// inner levels: group children evenly, nodes/mins are rewritten in place
+	for (k = nleaves, m = nleaves; m > 1; m = ng)
+	{
+		ng = (m + BPTREE_INNER) / (BPTREE_INNER + 1);
+		for (j = g = 0; g < ng; g++)
+		{
+			inner = (struct bptree_inner_t*)pool[k++];
+			cnt = m / ng + (g < m % ng ? 1 : 0);
+			for (i = 0; i < cnt; i++)
+			{
+				inner->children[i] = (struct bptree_node_t*)nodes[j + i];
+				if (i > 0)
+					inner->keys[i - 1] = mins[j + i];
+			}
+			inner->hdr.n = (uint32_t)(cnt - 1);
+			mins[g] = mins[j];
+			nodes[g] = inner;
+			j += cnt;
+		}
+		tree->height++;
+	}
+
+	tree->root = (struct bptree_node_t*)nodes[0];
+	tree->size = n;
+	free(pool);
+	return 0;
+}
+
+int bptree_range(const struct bptree_t* tree, uint64_t from, uint64_t to, bptree_onscan onscan, void* param)
+{
+	int r, pos;
+	const struct bptree_leaf_t* leaf;
+
+	leaf = bptree_leaf(tree, from);
+	if (!leaf)
+		return 0;
+
+	pos = bptree_lower(leaf->keys, (int)leaf->hdr.n, from);
+	for (; leaf; leaf = leaf->next, pos = 0)
+	{
+		for (; pos < (int)leaf->hdr.n; pos++)
+		{
+			if (leaf->keys[pos] >= to)
+				return 0;
+			r = onscan(param, leaf->keys[pos], leaf->values[pos]);
+			if (0 != r)
+				return r;
+		}
+	}
+	return 0;
+}
+
+int bptree_first(const struct bptree_t* tree, struct bptree_iter_t* it)
+{
+	it->leaf = tree->head;
+	it->pos = 0;
+	return it->leaf ? 0 : -ENOENT;
+}
+
+int bptree_last(const struct bptree_t* tree, struct bptree_iter_t* it)
+{
+	it->leaf = tree->tail;
+	it->pos = tree->tail ? (int)tree->tail->hdr.n - 1 : 0;
+	return it->leaf ? 0 : -ENOENT;
+}
+
+int bptree_lower_bound(const struct bptree_t* tree, uint64_t key, struct bptree_iter_t* it)
+{
+	struct bptree_leaf_t* leaf;
+	leaf = bptree_leaf(tree, key);
+	it->leaf = leaf;
+	it->pos = leaf ? bptree_lower(leaf->keys, (int)leaf->hdr.n, key) : 0;
+	if (leaf && it->pos >= (int)leaf->hdr.n)
+	{
+		it->leaf = leaf->next;
+		it->pos = 0;
+	}
+	return it->leaf ? 0 : -ENOENT;
+}
+
+int bptree_next(struct bptree_iter_t* it)
+{
+	struct bptree_leaf_t* leaf;
+	leaf = (struct bptree_leaf_t*)it->leaf;
+	if (!leaf)
+		return -ENOENT;
+
+	if (++it->pos >= (int)leaf->hdr.n)
+	{
+		it->leaf = leaf->next;
+		it->pos = 0;
+	}
+	return it->leaf ? 0 : -ENOENT;
+}
+
+int bptree_prev(struct bptree_iter_t* it)
+{
+	struct bptree_leaf_t* leaf;
+	leaf = (struct bptree_leaf_t*)it->leaf;
+	if (!leaf)
+		return -ENOENT;
+
+	if (--it->pos < 0)
+	{
+		it->leaf = leaf->prev;
+		it->pos = leaf->prev ? (int)leaf->prev->hdr.n - 1 : 0;
+	}
+	return it->leaf ? 0 : -ENOENT;
+}
+
+uint64_t bptree_iter_key(const struct bptree_iter_t* it)
+{
+	return ((const struct bptree_leaf_t*)it->leaf)->keys[it->pos];
+}
+
+void* bptree_iter_value(const struct bptree_iter_t* it)
+{
+	return ((const struct bptree_leaf_t*)it->leaf)->values[it->pos];
+}
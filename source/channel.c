@@ -1,38 +1,84 @@
+// Bounded MPMC queue: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// slot sequence: pos-empty(producer pos can write), pos+1-full(consumer pos can read), consumer release slot to pos+capacity
+// positions are free-running 32-bits counters, compare by signed difference
+//
+// blocking: spin, then register a waiter on every channel waiter list and sleep on the waiter semaphore,
+// push/pop wake one waiter per element. notifier: publish slot -> load waiter count(full barrier),
+// waiter: increase waiter count(full barrier) -> check channel again, so one of them must see the other.
+
 #include "channel.h"
 #include "sys/sema.h"
 #include "sys/atomic.h"
-#include "sys/locker.h"
+#include "sys/spinlock.h"
+#include "sys/system.h"
+#include "sys/thread.h"
+#include "list.h"
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <errno.h>
+
+#define CHANNEL_SPIN		32
+#define CHANNEL_SELECT_MAX	64
 
 struct channel_t
 {
+	uint8_t* ptr; // elements
+	volatile int32_t* seq; // slot sequence
+	uint32_t mask; // capacity - 1
 	int elesize; // element size
-	int capacity; // channel capacity(by element)
-	int count, offset;
-	uint8_t *ptr;
 
-	locker_t locker;
-    sema_t reader;
-    sema_t writer;
+	char padding0[64]; // avoid false sharing
+	volatile int32_t push; // producer position
+	char padding1[64];
+	volatile int32_t pop; // consumer position
+	char padding2[64];
+
+	spinlock_t locker; // waiter lists
+	volatile int32_t nreaders;
+	volatile int32_t nwriters;
+	struct list_head readers; // wait for data
+	struct list_head writers; // wait for space
+};
+
+struct channel_waiter_t
+{
+	sema_t sema;
+	volatile int32_t signaled; // 0-wait, other-(notifier channel index + 1)
+};
+
+struct channel_wait_t
+{
+	struct list_head link;
+	struct channel_waiter_t* waiter;
+	int index; // channel index
 };
 
 struct channel_t* channel_create(int capacity, int elementsize)
 {
+	int i;
+	uint32_t n;
 	struct channel_t* c;
 	assert(capacity > 0 && elementsize > 0);
-	c = (struct channel_t*)malloc(sizeof(*c) + capacity * elementsize);
+
+	for (n = 2; n < (uint32_t)capacity; n *= 2)
+	{
+	}
+
+	c = (struct channel_t*)malloc(sizeof(*c) + n * sizeof(int32_t) + (size_t)n * elementsize);
 	if (c)
 	{
 		memset(c, 0, sizeof(*c));
-		locker_create(&c->locker);
-		sema_create(&c->reader, NULL, 0);
-		sema_create(&c->writer, NULL, capacity);
+		spinlock_create(&c->locker);
+		LIST_INIT_HEAD(&c->readers);
+		LIST_INIT_HEAD(&c->writers);
 		c->elesize = elementsize;
-		c->capacity = capacity;
-		c->ptr = (uint8_t*)(c + 1);
+		c->mask = n - 1;
+		c->seq = (volatile int32_t*)(c + 1);
+		c->ptr = (uint8_t*)(c->seq + n);
+		for (i = 0; i < (int)n; i++)
+			c->seq[i] = i;
 	}
 	return c;
 }
@@ -47,86 +93,275 @@ void channel_destroy(struct channel_t** pc)
 	c = *pc;
 	*pc = NULL;
 
-	sema_destroy(&c->reader);
-	sema_destroy(&c->writer);
-	locker_destroy(&c->locker);
+	assert(list_empty(&c->readers) && list_empty(&c->writers));
+	spinlock_destroy(&c->locker);
 	free(c);
 }
 
-//void channel_clear(struct channel_t* c)
-//{
-//	locker_lock(&c->locker);
-//	c->count = 0;
-//	c->offset = 0;
-//	locker_unlock(&c->locker);
-//}
-
 int channel_count(struct channel_t* c)
 {
-	// TODO: memory alignment
-	return c->count;
+	int32_t n;
+	n = (int32_t)((uint32_t)atomic_load_acquire32(&c->push) - (uint32_t)atomic_load_acquire32(&c->pop));
+	return n < 0 ? 0 : (n > (int32_t)c->mask + 1 ? (int32_t)c->mask + 1 : n);
 }
 
-int channel_push(struct channel_t* c, const void* e)
+/// @return pushed element count, 0-full
+static int channel_trypush(struct channel_t* c, const uint8_t* e, int n)
 {
-	sema_wait(&c->writer);
-	
-	locker_lock(&c->locker);
-	assert(c->count < c->capacity);
-	memcpy(c->ptr + ((c->offset + c->count) % c->capacity) * c->elesize, e, c->elesize);
-	c->count += 1;
-	locker_unlock(&c->locker);
+	int i, k;
+	int32_t diff;
+	uint32_t pos;
 
-	sema_post(&c->reader);
-	return 0;
+	for (;;)
+	{
+		pos = (uint32_t)atomic_load_acquire32(&c->push);
+		for (k = 0; k < n && (int32_t)(pos + k) == atomic_load_acquire32(&c->seq[(pos + k) & c->mask]); k++)
+		{
+		}
+
+		if (0 == k)
+		{
+			diff = (int32_t)((uint32_t)atomic_load_acquire32(&c->seq[pos & c->mask]) - pos);
+			if (diff < 0)
+				return 0; // full: slot isn't released by the consumer of the previous round
+			continue; // other producer took the slot
+		}
+
+		if (atomic_cas32(&c->push, (int32_t)pos, (int32_t)(pos + k)))
+			break;
+	}
+
+	for (i = 0; i < k; i++)
+	{
+		memcpy(c->ptr + ((pos + i) & c->mask) * c->elesize, e + i * c->elesize, c->elesize);
+		atomic_store_release32(&c->seq[(pos + i) & c->mask], (int32_t)(pos + i + 1));
+	}
+	return k;
 }
 
-int channel_pop(struct channel_t* c, void* e)
+/// @return popped element count, 0-empty
+static int channel_trypop(struct channel_t* c, uint8_t* e, int n)
 {
-	sema_wait(&c->reader);
+	int i, k;
+	int32_t diff;
+	uint32_t pos;
 
-	locker_lock(&c->locker);
-	memcpy(e, c->ptr + c->offset * c->elesize, c->elesize);
-	c->count -= 1;
-	c->offset = (c->offset + 1) % c->capacity;
-	assert(c->count >= 0);
-	locker_unlock(&c->locker);
+	for (;;)
+	{
+		pos = (uint32_t)atomic_load_acquire32(&c->pop);
+		for (k = 0; k < n && (int32_t)(pos + k + 1) == atomic_load_acquire32(&c->seq[(pos + k) & c->mask]); k++)
+		{
+		}
 
-	sema_post(&c->writer);
-	return 0;
+		if (0 == k)
+		{
+			diff = (int32_t)((uint32_t)atomic_load_acquire32(&c->seq[pos & c->mask]) - (pos + 1));
+			if (diff < 0)
+				return 0; // empty
+			continue; // other consumer took the slot
+		}
+
+		if (atomic_cas32(&c->pop, (int32_t)pos, (int32_t)(pos + k)))
+			break;
+	}
+
+	for (i = 0; i < k; i++)
+	{
+		memcpy(e + i * c->elesize, c->ptr + ((pos + i) & c->mask) * c->elesize, c->elesize);
+		atomic_store_release32(&c->seq[(pos + i) & c->mask], (int32_t)(pos + i + c->mask + 1));
+	}
+	return k;
 }
 
-int channel_push_timeout(struct channel_t* c, const void* e, int timeout)
+/// wake up to n waiters
+static void channel_notify(struct channel_t* c, int readers, int n)
 {
-	int r;
-	r = sema_timewait(&c->writer, timeout);
-	if (0 != r)
-		return r;
+	struct list_head *pos, *next, *waiters;
+	volatile int32_t* count;
+	struct channel_wait_t* w;
 
-	locker_lock(&c->locker);
-	assert(c->count < c->capacity);
-	memcpy(c->ptr + ((c->offset + c->count) % c->capacity) * c->elesize, e, c->elesize);
-	c->count += 1;
-	locker_unlock(&c->locker);
+	count = readers ? &c->nreaders : &c->nwriters;
+	waiters = readers ? &c->readers : &c->writers;
+	if (0 == atomic_load32(count)) // full barrier
+		return;
+
+	spinlock_lock(&c->locker);
+	list_for_each_safe(pos, next, waiters)
+	{
+		if (n <= 0)
+			break;
 
-	sema_post(&c->reader);
+		w = list_entry(pos, struct channel_wait_t, link);
+		list_remove(pos);
+		atomic_decrement32(count);
+
+		// select waiter may be signaled by other channel
+		if (atomic_cas32(&w->waiter->signaled, 0, w->index + 1))
+		{
+			// post with lock held: waiter lock the channel before destroy the semaphore
+			sema_post(&w->waiter->sema);
+			n--;
+		}
+	}
+	spinlock_unlock(&c->locker);
+}
+
+static int channel_try(struct channel_t* c[], int num, int pop, uint8_t* e, int n, int* index)
+{
+	int i, r;
+	for (i = 0; i < num; i++)
+	{
+		r = pop ? channel_trypop(c[i], e, n) : channel_trypush(c[i], e, n);
+		if (r > 0)
+		{
+			*index = i;
+			return r;
+		}
+	}
 	return 0;
 }
 
+static void channel_wait_register(struct channel_t* c[], int num, int pop, struct channel_wait_t* nodes, struct channel_waiter_t* waiter)
+{
+	int i;
+	for (i = 0; i < num; i++)
+	{
+		nodes[i].waiter = waiter;
+		nodes[i].index = i;
+		spinlock_lock(&c[i]->locker);
+		list_insert_before(&nodes[i].link, pop ? &c[i]->readers : &c[i]->writers);
+		atomic_increment32(pop ? &c[i]->nreaders : &c[i]->nwriters); // full barrier
+		spinlock_unlock(&c[i]->locker);
+	}
+}
+
+static void channel_wait_unregister(struct channel_t* c[], int num, int pop, struct channel_wait_t* nodes)
+{
+	int i;
+	for (i = 0; i < num; i++)
+	{
+		spinlock_lock(&c[i]->locker);
+		if (nodes[i].link.next) // removed by notifier
+		{
+			list_remove(&nodes[i].link);
+			atomic_decrement32(pop ? &c[i]->nreaders : &c[i]->nwriters);
+		}
+		spinlock_unlock(&c[i]->locker);
+	}
+}
+
+/// @param[in] pop 1-pop, 0-push
+/// @param[out] index channel index
+/// @return >0-element count, 0-timeout, <0-error
+static int channel_wait(struct channel_t* c[], int num, int pop, uint8_t* e, int n, int timeout, int* index)
+{
+	int r, spin, remain;
+	uint32_t clock;
+	struct channel_waiter_t waiter;
+	struct channel_wait_t nodes[CHANNEL_SELECT_MAX];
+
+	if (num < 1 || num > CHANNEL_SELECT_MAX || n < 1)
+		return -EINVAL;
+
+	for (spin = 0; spin < CHANNEL_SPIN; spin++)
+	{
+		r = channel_try(c, num, pop, e, n, index);
+		if (r > 0 || 0 == timeout)
+			return r;
+		if (spin >= CHANNEL_SPIN / 2)
+			thread_yield();
+	}
+
+	if (0 != sema_create(&waiter.sema, NULL, 0))
+		return -ENOMEM;
+
+	remain = timeout;
+	clock = system_clock();
+	do
+	{
+		waiter.signaled = 0;
+		channel_wait_register(c, num, pop, nodes, &waiter);
+		r = channel_try(c, num, pop, e, n, index);
+		if (0 == r && timeout < 0)
+			sema_wait(&waiter.sema);
+		else if (0 == r)
+			sema_timewait(&waiter.sema, remain);
+		channel_wait_unregister(c, num, pop, nodes);
+
+		if (0 == r)
+			r = channel_try(c, num, pop, e, n, index);
+		if (timeout > 0)
+			remain = timeout - (int)(system_clock() - clock);
+	} while (0 == r && (timeout < 0 || remain > 0));
+
+	// wake up by a channel but don't take it, pass it to the next waiter
+	if (waiter.signaled && (0 == r || *index != waiter.signaled - 1))
+		channel_notify(c[waiter.signaled - 1], pop, 1);
+
+	sema_destroy(&waiter.sema);
+	return r;
+}
+
+int channel_push_batch(struct channel_t* c, const void* e, int n, int timeout)
+{
+	int r, index;
+	if (n < 1)
+		return -EINVAL;
+
+	r = channel_trypush(c, (const uint8_t*)e, n);
+	if (0 == r && 0 != timeout)
+		r = channel_wait(&c, 1, 0, (uint8_t*)e, n, timeout, &index);
+	if (r > 0)
+		channel_notify(c, 1, r);
+	return r;
+}
+
+int channel_pop_batch(struct channel_t* c, void* e, int n, int timeout)
+{
+	int r, index;
+	if (n < 1)
+		return -EINVAL;
+
+	r = channel_trypop(c, (uint8_t*)e, n);
+	if (0 == r && 0 != timeout)
+		r = channel_wait(&c, 1, 1, (uint8_t*)e, n, timeout, &index);
+	if (r > 0)
+		channel_notify(c, 0, r);
+	return r;
+}
+
+int channel_select(struct channel_t* c[], int n, void* e, int timeout)
+{
+	int r, index;
+	r = channel_wait(c, n, 1, (uint8_t*)e, 1, timeout, &index);
+	if (r > 0)
+	{
+		channel_notify(c[index], 0, r);
+		return index;
+	}
+	return 0 == r ? -WAIT_TIMEOUT : r;
+}
+
+int channel_push(struct channel_t* c, const void* e)
+{
+	return 1 == channel_push_batch(c, e, 1, -1) ? 0 : -1;
+}
+
+int channel_pop(struct channel_t* c, void* e)
+{
+	return 1 == channel_pop_batch(c, e, 1, -1) ? 0 : -1;
+}
+
+int channel_push_timeout(struct channel_t* c, const void* e, int timeout)
+{
+	int r;
+	r = channel_push_batch(c, e, 1, timeout);
+	return 1 == r ? 0 : (0 == r ? WAIT_TIMEOUT : r);
+}
+
 int channel_pop_timeout(struct channel_t* c, void* e, int timeout)
 {
 	int r;
-	r = sema_timewait(&c->reader, timeout);
-	if (0 != r)
-		return r;
-
-	locker_lock(&c->locker);
-	memcpy(e, c->ptr + c->offset * c->elesize, c->elesize);
-	c->count -= 1;
-	c->offset = (c->offset + 1) % c->capacity;
-	assert(c->count >= 0);
-	locker_unlock(&c->locker);
-
-	sema_post(&c->writer);
-	return 0;
+	r = channel_pop_batch(c, e, 1, timeout);
+	return 1 == r ? 0 : (0 == r ? WAIT_TIMEOUT : r);
 }
@@ -0,0 +1,500 @@
+// Concurrent hash map: lock-striped shards of swiss-table style open addressing table
+// control byte: 0x80-empty, 0xFE-deleted, 0x00~0x7F-full(7-bits hash tag)
+// slots are probed by aligned group(16 control bytes), group probe sequence is triangular(visit all groups)
+
+#include "chashmap.h"
+#include "sys/rwlocker.h"
+#include "sys/system.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CHASHMAP_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define CHASHMAP_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#define CHASHMAP_GROUP		16
+#define CHASHMAP_EMPTY		0x80
+#define CHASHMAP_DELETED	0xFE
+#define CHASHMAP_CAPACITY	CHASHMAP_GROUP // shard initial capacity
+
+struct chashmap_slot_t
+{
+	uint32_t hash;
+	const void* key;
+	void* value;
+};
+
+struct chashmap_shard_t
+{
+	rwlocker_t locker;
+	uint8_t* ctrl; // capacity control bytes
+	struct chashmap_slot_t* slots;
+	uint32_t capacity; // power of 2, 0-don't allocated
+	uint32_t size;
+	uint32_t growth; // empty slots can be used before rehash(load factor 7/8)
+	char padding[64]; // avoid false sharing
+};
+
+struct chashmap_t
+{
+	int bits; // shard bits
+	void* param;
+	struct chashmap_ops_t ops;
+	struct chashmap_shard_t shards[1];
+};
+
+static inline uint32_t chashmap_mix(uint32_t h)
+{
+	// murmur3 fmix32, user hash don't need well distributed
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline int chashmap_ctz(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+/// @return bit mask of group control bytes equal to v
+static inline uint32_t chashmap_group_match(const uint8_t* ctrl, uint8_t v)
+{
+#if defined(CHASHMAP_SSE2)
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)ctrl), _mm_set1_epi8((char)v)));
+#elif defined(CHASHMAP_NEON)
+	static const uint8_t s_bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t m;
+	m = vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(v)), vld1q_u8(s_bits));
+	return (uint32_t)vaddv_u8(vget_low_u8(m)) | ((uint32_t)vaddv_u8(vget_high_u8(m)) << 8);
+#else
+	int i;
+	uint32_t mask;
+	for (mask = i = 0; i < CHASHMAP_GROUP; i++)
+		mask |= (ctrl[i] == v ? 1u : 0u) << i;
+	return mask;
+#endif
+}
+
+/// @return bit mask of group empty/deleted control bytes(high bit set)
+static inline uint32_t chashmap_group_free(const uint8_t* ctrl)
+{
+#if defined(CHASHMAP_SSE2)
+	return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#else
+	return chashmap_group_match(ctrl, CHASHMAP_EMPTY) | chashmap_group_match(ctrl, CHASHMAP_DELETED);
+#endif
+}
+
+static inline struct chashmap_shard_t* chashmap_shard(struct chashmap_t* map, uint32_t hash)
+{
+	return &map->shards[map->bits > 0 ? hash >> (32 - map->bits) : 0];
+}
+
+/// @return slot index, -1 if not found
+static int chashmap_shard_find(struct chashmap_t* map, struct chashmap_shard_t* shard, uint32_t hash, const void* key)
+{
+	uint32_t i, g, mask, mgroup, pos;
+	const struct chashmap_slot_t* slot;
+
+	if (0 == shard->capacity)
+		return -1;
+
+	mgroup = shard->capacity / CHASHMAP_GROUP - 1;
+	g = (hash >> 7) & mgroup;
+	for (i = 0; i <= mgroup; i++)
+	{
+		for (mask = chashmap_group_match(shard->ctrl + g * CHASHMAP_GROUP, (uint8_t)(hash & 0x7F)); mask; mask &= mask - 1)
+		{
+			pos = g * CHASHMAP_GROUP + chashmap_ctz(mask);
+			slot = &shard->slots[pos];
+			if (slot->hash == hash && map->ops.equal(map->param, slot->key, key))
+				return (int)pos;
+		}
+
+		if (chashmap_group_match(shard->ctrl + g * CHASHMAP_GROUP, CHASHMAP_EMPTY))
+			return -1;
+
+		g = (g + i + 1) & mgroup; // triangular probing
+	}
+	return -1;
+}
+
+/// @return first empty/deleted slot index in probe sequence
+static uint32_t chashmap_shard_slot(const uint8_t* ctrl, uint32_t capacity, uint32_t hash)
+{
+	uint32_t i, g, mask, mgroup;
+
+	mgroup = capacity / CHASHMAP_GROUP - 1;
+	g = (hash >> 7) & mgroup;
+	for (i = 0; i <= mgroup; i++)
+	{
+		mask = chashmap_group_free(ctrl + g * CHASHMAP_GROUP);
+		if (mask)
+			return g * CHASHMAP_GROUP + chashmap_ctz(mask);
+		g = (g + i + 1) & mgroup;
+	}
+
+	assert(0); // never full
+	return 0;
+}
+
+static void* chashmap_alloc(uint32_t capacity, uint8_t** ctrl, struct chashmap_slot_t** slots)
+{
+	uint8_t* ptr;
+	ptr = (uint8_t*)malloc(capacity * (sizeof(struct chashmap_slot_t) + 1));
+	if (!ptr)
+		return NULL;
+
+	// slots first, then control bytes
+	*slots = (struct chashmap_slot_t*)ptr;
+	*ctrl = ptr + capacity * sizeof(struct chashmap_slot_t);
+	memset(*ctrl, CHASHMAP_EMPTY, capacity);
+	return ptr;
+}
+
+static int chashmap_shard_rehash(struct chashmap_shard_t* shard)
+{
+	uint32_t i, pos, capacity;
+	uint8_t* ctrl;
+	struct chashmap_slot_t* slots;
+
+	// drop tombstones only if half empty
+	capacity = shard->capacity ? shard->capacity : CHASHMAP_CAPACITY;
+	while (shard->size * 2 >= capacity)
+		capacity *= 2;
+
+	if (!chashmap_alloc(capacity, &ctrl, &slots))
+		return -ENOMEM;
+
+	for (i = 0; i < shard->capacity; i++)
+	{
+		if (shard->ctrl[i] & 0x80)
+			continue; // empty/deleted
+
+		pos = chashmap_shard_slot(ctrl, capacity, shard->slots[i].hash);
+		ctrl[pos] = (uint8_t)(shard->slots[i].hash & 0x7F);
+		memcpy(&slots[pos], &shard->slots[i], sizeof(slots[pos]));
+	}
+
+	if (shard->slots)
+		free(shard->slots);
+	shard->slots = slots;
+	shard->ctrl = ctrl;
+	shard->capacity = capacity;
+	shard->growth = capacity - capacity / 8 - shard->size;
+	return 0;
+}
+
+chashmap_t* chashmap_create(int shards, const struct chashmap_ops_t* ops, void* param)
+{
+	int i, bits;
+	struct chashmap_t* map;
+
+	if (!ops || !ops->hash || !ops->equal)
+		return NULL;
+
+	shards = shards > 0 ? shards : (int)system_getcpucount() * 4;
+	for (bits = 0; bits < 16 && (1 << bits) < shards; bits++)
+		;
+	shards = 1 << bits;
+
+	map = (struct chashmap_t*)calloc(1, sizeof(*map) + sizeof(struct chashmap_shard_t) * (shards - 1));
+	if (!map)
+		return NULL;
+
+	map->bits = bits;
+	map->param = param;
+	memcpy(&map->ops, ops, sizeof(map->ops));
+	for (i = 0; i < shards; i++)
+		rwlocker_create(&map->shards[i].locker);
+	return map;
+}
+
+void chashmap_destroy(chashmap_t* map)
+{
+	int i;
+	if (!map)
+		return;
+
+	for (i = 0; i < (1 << map->bits); i++)
+	{
+		rwlocker_destroy(&map->shards[i].locker);
+		if (map->shards[i].slots)
+			free(map->shards[i].slots);
+	}
+	free(map);
+}
+
+void* chashmap_get(chashmap_t* map, const void* key)
+{
+	int pos;
+	uint32_t hash;
+	void* value;
+	struct chashmap_shard_t* shard;
+
+	hash = chashmap_mix(map->ops.hash(map->param, key));
+	shard = chashmap_shard(map, hash);
+
+	rwlocker_rdlock(&shard->locker);
+	pos = chashmap_shard_find(map, shard, hash, key);
+	value = pos >= 0 ? shard->slots[pos].value : NULL;
+	if (value && map->ops.addref)
+		map->ops.addref(map->param, value);
+	rwlocker_rdunlock(&shard->locker);
+	return value;
+}
+
+static int chashmap_insert_internal(chashmap_t* map, const void* key, void* value, int replace, void** prev)
+{
+	int r, pos;
+	uint32_t hash;
+	struct chashmap_shard_t* shard;
+
+	hash = chashmap_mix(map->ops.hash(map->param, key));
+	shard = chashmap_shard(map, hash);
+
+	rwlocker_wrlock(&shard->locker);
+	pos = chashmap_shard_find(map, shard, hash, key);
+	if (pos >= 0)
+	{
+		if (prev)
+			*prev = shard->slots[pos].value;
+		if (replace)
+		{
+			shard->slots[pos].key = key;
+			shard->slots[pos].value = value;
+		}
+		rwlocker_wrunlock(&shard->locker);
+		return replace ? 0 : -EEXIST;
+	}
+
+	pos = shard->capacity ? (int)chashmap_shard_slot(shard->ctrl, shard->capacity, hash) : 0;
+	if (0 == shard->capacity || (0 == shard->growth && CHASHMAP_EMPTY == shard->ctrl[pos]))
+	{
+		r = chashmap_shard_rehash(shard);
+		if (0 != r)
+		{
+			rwlocker_wrunlock(&shard->locker);
+			return r;
+		}
+		pos = (int)chashmap_shard_slot(shard->ctrl, shard->capacity, hash);
+	}
+
+	shard->growth -= CHASHMAP_EMPTY == shard->ctrl[pos] ? 1 : 0; // reuse deleted slot
+	shard->ctrl[pos] = (uint8_t)(hash & 0x7F);
+	shard->slots[pos].hash = hash;
+	shard->slots[pos].key = key;
+	shard->slots[pos].value = value;
+	shard->size++;
+	rwlocker_wrunlock(&shard->locker);
+
+	if (prev)
+		*prev = NULL;
+	return 0;
+}
+
+int chashmap_insert(chashmap_t* map, const void* key, void* value)
+{
+	return chashmap_insert_internal(map, key, value, 0, NULL);
+}
+
+int chashmap_set(chashmap_t* map, const void* key, void* value, void** prev)
+{
+	return chashmap_insert_internal(map, key, value, 1, prev);
+}
+
+int chashmap_remove(chashmap_t* map, const void* key, void** value)
+{
+	int pos;
+	uint32_t hash;
+	struct chashmap_shard_t* shard;
+
+	hash = chashmap_mix(map->ops.hash(map->param, key));
+	shard = chashmap_shard(map, hash);
+
+	rwlocker_wrlock(&shard->locker);
+	pos = chashmap_shard_find(map, shard, hash, key);
+	if (pos < 0)
+	{
+		rwlocker_wrunlock(&shard->locker);
+		return -ENOENT;
+	}
+
+	if (value)
+		*value = shard->slots[pos].value;
+
+	// lookup stop at group which has empty slot, so the slot can be marked as empty
+	// if the group has any empty slot(never be full, no probe sequence pass through it)
+	if (chashmap_group_match(shard->ctrl + (pos & ~(CHASHMAP_GROUP - 1)), CHASHMAP_EMPTY))
+	{
+		shard->ctrl[pos] = CHASHMAP_EMPTY;
+		shard->growth++;
+	}
+	else
+	{
+		shard->ctrl[pos] = CHASHMAP_DELETED;
+	}
+	shard->size--;
+	rwlocker_wrunlock(&shard->locker);
+	return 0;
+}
+
+size_t chashmap_size(chashmap_t* map)
+{
+	int i;
+	size_t n;
+	for (n = i = 0; i < (1 << map->bits); i++)
+		n += map->shards[i].size;
+	return n;
+}
+
+int chashmap_foreach(chashmap_t* map, int (*fn)(void* param, const void* key, void* value), void* param)
+{
+	int i, r;
+	uint32_t j;
+	struct chashmap_shard_t* shard;
+
+	for (r = i = 0; 0 == r && i < (1 << map->bits); i++)
+	{
+		shard = &map->shards[i];
+		rwlocker_rdlock(&shard->locker);
+		for (j = 0; 0 == r && j < shard->capacity; j++)
+		{
+			if (0 == (shard->ctrl[j] & 0x80))
+				r = fn(param, shard->slots[j].key, shard->slots[j].value);
+		}
+		rwlocker_rdunlock(&shard->locker);
+	}
+	return r;
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+#include "sys/thread.h"
+#include <stdio.h>
+
+#define N 100000
+
+static uint32_t chashmap_test_hash(void* param, const void* key)
+{
+	(void)param;
+	return (uint32_t)strlen((const char*)key); // poor hash, many collisions
+}
+
+static int chashmap_test_equal(void* param, const void* key1, const void* key2)
+{
+	(void)param;
+	return 0 == strcmp((const char*)key1, (const char*)key2) ? 1 : 0;
+}
+
+static uint32_t chashmap_test_hash2(void* param, const void* key)
+{
+	(void)param;
+	return (uint32_t)(intptr_t)key;
+}
+
+static int chashmap_test_equal2(void* param, const void* key1, const void* key2)
+{
+	(void)param;
+	return key1 == key2 ? 1 : 0;
+}
+
+struct chashmap_test_thread_t
+{
+	chashmap_t* map;
+	intptr_t base;
+};
+
+static int STDCALL chashmap_test_worker(void* param)
+{
+	intptr_t i, base;
+	void* v;
+	chashmap_t* map;
+
+	map = ((struct chashmap_test_thread_t*)param)->map;
+	base = ((struct chashmap_test_thread_t*)param)->base;
+	for (i = 1; i <= N; i++)
+		assert(0 == chashmap_insert(map, (void*)(base + i), (void*)(base + i)));
+	for (i = 1; i <= N; i++)
+		assert((void*)(base + i) == chashmap_get(map, (void*)(base + i)));
+	for (i = 1; i <= N; i += 2)
+		assert(0 == chashmap_remove(map, (void*)(base + i), &v) && v == (void*)(base + i));
+	return 0;
+}
+
+static int chashmap_test_count(void* param, const void* key, void* value)
+{
+	assert(key == value);
+	(*(int*)param)++;
+	return 0;
+}
+
+void chashmap_test(void)
+{
+	int i, n;
+	char keys[64][65];
+	void* v;
+	pthread_t threads[4];
+	struct chashmap_test_thread_t params[4];
+	chashmap_t* map;
+	struct chashmap_ops_t ops;
+
+	memset(&ops, 0, sizeof(ops));
+	ops.hash = chashmap_test_hash;
+	ops.equal = chashmap_test_equal;
+	map = chashmap_create(2, &ops, NULL);
+	for (i = 0; i < 64; i++)
+	{
+		memset(keys[i], 'a' + i % 26, i + 1);
+		keys[i][i + 1] = 0;
+		assert(0 == chashmap_insert(map, keys[i], keys[i]));
+	}
+	assert(64 == chashmap_size(map));
+	assert(-EEXIST == chashmap_insert(map, keys[3], NULL));
+	assert(0 == chashmap_set(map, keys[3], keys[4], &v) && v == keys[3]);
+	assert(keys[4] == chashmap_get(map, "dddd"));
+	assert(NULL == chashmap_get(map, "ddde"));
+	for (i = 0; i < 64; i += 2)
+		assert(0 == chashmap_remove(map, keys[i], NULL));
+	assert(-ENOENT == chashmap_remove(map, keys[0], NULL));
+	for (i = 1; i < 64; i += 2)
+		assert(keys[i] == chashmap_get(map, keys[i]) || 3 == i);
+	assert(32 == chashmap_size(map));
+	chashmap_destroy(map);
+
+	// multi-thread
+	ops.hash = chashmap_test_hash2;
+	ops.equal = chashmap_test_equal2;
+	map = chashmap_create(0, &ops, NULL);
+	for (i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++)
+	{
+		params[i].map = map;
+		params[i].base = (intptr_t)i * N;
+		thread_create(&threads[i], chashmap_test_worker, &params[i]);
+	}
+	for (i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++)
+		thread_destroy(threads[i]);
+	assert(N / 2 * sizeof(threads) / sizeof(threads[0]) == chashmap_size(map));
+	n = 0;
+	chashmap_foreach(map, chashmap_test_count, &n);
+	assert(n == (int)chashmap_size(map));
+	chashmap_destroy(map);
+}
+#endif
@@ -1,51 +1,771 @@
-static unsigned int crc32table[256] = {
-	0x00000000, 0xB71DC104, 0x6E3B8209, 0xD926430D, 0xDC760413, 0x6B6BC517,
-	0xB24D861A, 0x0550471E, 0xB8ED0826, 0x0FF0C922, 0xD6D68A2F, 0x61CB4B2B,
-	0x649B0C35, 0xD386CD31, 0x0AA08E3C, 0xBDBD4F38, 0x70DB114C, 0xC7C6D048,
-	0x1EE09345, 0xA9FD5241, 0xACAD155F, 0x1BB0D45B, 0xC2969756, 0x758B5652,
-	0xC836196A, 0x7F2BD86E, 0xA60D9B63, 0x11105A67, 0x14401D79, 0xA35DDC7D,
-	0x7A7B9F70, 0xCD665E74, 0xE0B62398, 0x57ABE29C, 0x8E8DA191, 0x39906095,
-	0x3CC0278B, 0x8BDDE68F, 0x52FBA582, 0xE5E66486, 0x585B2BBE, 0xEF46EABA,
-	0x3660A9B7, 0x817D68B3, 0x842D2FAD, 0x3330EEA9, 0xEA16ADA4, 0x5D0B6CA0,
-	0x906D32D4, 0x2770F3D0, 0xFE56B0DD, 0x494B71D9, 0x4C1B36C7, 0xFB06F7C3,
-	0x2220B4CE, 0x953D75CA, 0x28803AF2, 0x9F9DFBF6, 0x46BBB8FB, 0xF1A679FF,
-	0xF4F63EE1, 0x43EBFFE5, 0x9ACDBCE8, 0x2DD07DEC, 0x77708634, 0xC06D4730,
-	0x194B043D, 0xAE56C539, 0xAB068227, 0x1C1B4323, 0xC53D002E, 0x7220C12A,
-	0xCF9D8E12, 0x78804F16, 0xA1A60C1B, 0x16BBCD1F, 0x13EB8A01, 0xA4F64B05,
-	0x7DD00808, 0xCACDC90C, 0x07AB9778, 0xB0B6567C, 0x69901571, 0xDE8DD475,
-	0xDBDD936B, 0x6CC0526F, 0xB5E61162, 0x02FBD066, 0xBF469F5E, 0x085B5E5A,
-	0xD17D1D57, 0x6660DC53, 0x63309B4D, 0xD42D5A49, 0x0D0B1944, 0xBA16D840,
-	0x97C6A5AC, 0x20DB64A8, 0xF9FD27A5, 0x4EE0E6A1, 0x4BB0A1BF, 0xFCAD60BB,
-	0x258B23B6, 0x9296E2B2, 0x2F2BAD8A, 0x98366C8E, 0x41102F83, 0xF60DEE87,
-	0xF35DA999, 0x4440689D, 0x9D662B90, 0x2A7BEA94, 0xE71DB4E0, 0x500075E4,
-	0x892636E9, 0x3E3BF7ED, 0x3B6BB0F3, 0x8C7671F7, 0x555032FA, 0xE24DF3FE,
-	0x5FF0BCC6, 0xE8ED7DC2, 0x31CB3ECF, 0x86D6FFCB, 0x8386B8D5, 0x349B79D1,
-	0xEDBD3ADC, 0x5AA0FBD8, 0xEEE00C69, 0x59FDCD6D, 0x80DB8E60, 0x37C64F64,
-	0x3296087A, 0x858BC97E, 0x5CAD8A73, 0xEBB04B77, 0x560D044F, 0xE110C54B,
-	0x38368646, 0x8F2B4742, 0x8A7B005C, 0x3D66C158, 0xE4408255, 0x535D4351,
-	0x9E3B1D25, 0x2926DC21, 0xF0009F2C, 0x471D5E28, 0x424D1936, 0xF550D832,
-	0x2C769B3F, 0x9B6B5A3B, 0x26D61503, 0x91CBD407, 0x48ED970A, 0xFFF0560E,
-	0xFAA01110, 0x4DBDD014, 0x949B9319, 0x2386521D, 0x0E562FF1, 0xB94BEEF5,
-	0x606DADF8, 0xD7706CFC, 0xD2202BE2, 0x653DEAE6, 0xBC1BA9EB, 0x0B0668EF,
-	0xB6BB27D7, 0x01A6E6D3, 0xD880A5DE, 0x6F9D64DA, 0x6ACD23C4, 0xDDD0E2C0,
-	0x04F6A1CD, 0xB3EB60C9, 0x7E8D3EBD, 0xC990FFB9, 0x10B6BCB4, 0xA7AB7DB0,
-	0xA2FB3AAE, 0x15E6FBAA, 0xCCC0B8A7, 0x7BDD79A3, 0xC660369B, 0x717DF79F,
-	0xA85BB492, 0x1F467596, 0x1A163288, 0xAD0BF38C, 0x742DB081, 0xC3307185,
-	0x99908A5D, 0x2E8D4B59, 0xF7AB0854, 0x40B6C950, 0x45E68E4E, 0xF2FB4F4A,
-	0x2BDD0C47, 0x9CC0CD43, 0x217D827B, 0x9660437F, 0x4F460072, 0xF85BC176,
-	0xFD0B8668, 0x4A16476C, 0x93300461, 0x242DC565, 0xE94B9B11, 0x5E565A15,
-	0x87701918, 0x306DD81C, 0x353D9F02, 0x82205E06, 0x5B061D0B, 0xEC1BDC0F,
-	0x51A69337, 0xE6BB5233, 0x3F9D113E, 0x8880D03A, 0x8DD09724, 0x3ACD5620,
-	0xE3EB152D, 0x54F6D429, 0x7926A9C5, 0xCE3B68C1, 0x171D2BCC, 0xA000EAC8,
-	0xA550ADD6, 0x124D6CD2, 0xCB6B2FDF, 0x7C76EEDB, 0xC1CBA1E3, 0x76D660E7,
-	0xAFF023EA, 0x18EDE2EE, 0x1DBDA5F0, 0xAAA064F4, 0x738627F9, 0xC49BE6FD,
-	0x09FDB889, 0xBEE0798D, 0x67C63A80, 0xD0DBFB84, 0xD58BBC9A, 0x62967D9E,
-	0xBBB03E93, 0x0CADFF97, 0xB110B0AF, 0x060D71AB, 0xDF2B32A6, 0x6836F3A2,
-	0x6D66B4BC, 0xDA7B75B8, 0x035D36B5, 0xB440F7B1
+// CRC-32
+// 1. slicing-by-8 tables(8 bytes per iteration)
+// 2. carry-less multiplication folding(x86 PCLMULQDQ, ARMv8 PMULL), runtime cpu dispatch
+// Intel: Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction
+
+#include "crc32.h"
+#include "sys/cpu.h"
+#include <stdint.h>
+
+#if defined(CPU_X86)
+	#define CRC32_HW_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#define CRC32_HW_TARGET
+	#else
+		#define CRC32_HW_TARGET __attribute__((target("pclmul,sse4.1")))
+	#endif
+#elif defined(CPU_ARM64)
+	#define CRC32_HW_ARM
+	#include <arm_neon.h>
+	#if defined(_MSC_VER)
+		#define CRC32_HW_TARGET
+	#elif defined(__clang__)
+		#define CRC32_HW_TARGET __attribute__((target("crypto")))
+	#else
+		#define CRC32_HW_TARGET __attribute__((target("+crypto")))
+	#endif
+#endif
+
+// CRC-32/MPEG-2 byte-swapped, slicing-by-8: crc32table[k][n] = (crc32table[k-1][n] >> 8) ^ crc32table[0][crc32table[k-1][n] & 0xFF]
+static const unsigned int crc32table[8][256] = {
+	{
+		0x00000000, 0xB71DC104, 0x6E3B8209, 0xD926430D, 0xDC760413, 0x6B6BC517,
+		0xB24D861A, 0x0550471E, 0xB8ED0826, 0x0FF0C922, 0xD6D68A2F, 0x61CB4B2B,
+		0x649B0C35, 0xD386CD31, 0x0AA08E3C, 0xBDBD4F38, 0x70DB114C, 0xC7C6D048,
+		0x1EE09345, 0xA9FD5241, 0xACAD155F, 0x1BB0D45B, 0xC2969756, 0x758B5652,
+		0xC836196A, 0x7F2BD86E, 0xA60D9B63, 0x11105A67, 0x14401D79, 0xA35DDC7D,
+		0x7A7B9F70, 0xCD665E74, 0xE0B62398, 0x57ABE29C, 0x8E8DA191, 0x39906095,
+		0x3CC0278B, 0x8BDDE68F, 0x52FBA582, 0xE5E66486, 0x585B2BBE, 0xEF46EABA,
+		0x3660A9B7, 0x817D68B3, 0x842D2FAD, 0x3330EEA9, 0xEA16ADA4, 0x5D0B6CA0,
+		0x906D32D4, 0x2770F3D0, 0xFE56B0DD, 0x494B71D9, 0x4C1B36C7, 0xFB06F7C3,
+		0x2220B4CE, 0x953D75CA, 0x28803AF2, 0x9F9DFBF6, 0x46BBB8FB, 0xF1A679FF,
+		0xF4F63EE1, 0x43EBFFE5, 0x9ACDBCE8, 0x2DD07DEC, 0x77708634, 0xC06D4730,
+		0x194B043D, 0xAE56C539, 0xAB068227, 0x1C1B4323, 0xC53D002E, 0x7220C12A,
+		0xCF9D8E12, 0x78804F16, 0xA1A60C1B, 0x16BBCD1F, 0x13EB8A01, 0xA4F64B05,
+		0x7DD00808, 0xCACDC90C, 0x07AB9778, 0xB0B6567C, 0x69901571, 0xDE8DD475,
+		0xDBDD936B, 0x6CC0526F, 0xB5E61162, 0x02FBD066, 0xBF469F5E, 0x085B5E5A,
+		0xD17D1D57, 0x6660DC53, 0x63309B4D, 0xD42D5A49, 0x0D0B1944, 0xBA16D840,
+		0x97C6A5AC, 0x20DB64A8, 0xF9FD27A5, 0x4EE0E6A1, 0x4BB0A1BF, 0xFCAD60BB,
+		0x258B23B6, 0x9296E2B2, 0x2F2BAD8A, 0x98366C8E, 0x41102F83, 0xF60DEE87,
+		0xF35DA999, 0x4440689D, 0x9D662B90, 0x2A7BEA94, 0xE71DB4E0, 0x500075E4,
+		0x892636E9, 0x3E3BF7ED, 0x3B6BB0F3, 0x8C7671F7, 0x555032FA, 0xE24DF3FE,
+		0x5FF0BCC6, 0xE8ED7DC2, 0x31CB3ECF, 0x86D6FFCB, 0x8386B8D5, 0x349B79D1,
+		0xEDBD3ADC, 0x5AA0FBD8, 0xEEE00C69, 0x59FDCD6D, 0x80DB8E60, 0x37C64F64,
+		0x3296087A, 0x858BC97E, 0x5CAD8A73, 0xEBB04B77, 0x560D044F, 0xE110C54B,
+		0x38368646, 0x8F2B4742, 0x8A7B005C, 0x3D66C158, 0xE4408255, 0x535D4351,
+		0x9E3B1D25, 0x2926DC21, 0xF0009F2C, 0x471D5E28, 0x424D1936, 0xF550D832,
+		0x2C769B3F, 0x9B6B5A3B, 0x26D61503, 0x91CBD407, 0x48ED970A, 0xFFF0560E,
+		0xFAA01110, 0x4DBDD014, 0x949B9319, 0x2386521D, 0x0E562FF1, 0xB94BEEF5,
+		0x606DADF8, 0xD7706CFC, 0xD2202BE2, 0x653DEAE6, 0xBC1BA9EB, 0x0B0668EF,
+		0xB6BB27D7, 0x01A6E6D3, 0xD880A5DE, 0x6F9D64DA, 0x6ACD23C4, 0xDDD0E2C0,
+		0x04F6A1CD, 0xB3EB60C9, 0x7E8D3EBD, 0xC990FFB9, 0x10B6BCB4, 0xA7AB7DB0,
+		0xA2FB3AAE, 0x15E6FBAA, 0xCCC0B8A7, 0x7BDD79A3, 0xC660369B, 0x717DF79F,
+		0xA85BB492, 0x1F467596, 0x1A163288, 0xAD0BF38C, 0x742DB081, 0xC3307185,
+		0x99908A5D, 0x2E8D4B59, 0xF7AB0854, 0x40B6C950, 0x45E68E4E, 0xF2FB4F4A,
+		0x2BDD0C47, 0x9CC0CD43, 0x217D827B, 0x9660437F, 0x4F460072, 0xF85BC176,
+		0xFD0B8668, 0x4A16476C, 0x93300461, 0x242DC565, 0xE94B9B11, 0x5E565A15,
+		0x87701918, 0x306DD81C, 0x353D9F02, 0x82205E06, 0x5B061D0B, 0xEC1BDC0F,
+		0x51A69337, 0xE6BB5233, 0x3F9D113E, 0x8880D03A, 0x8DD09724, 0x3ACD5620,
+		0xE3EB152D, 0x54F6D429, 0x7926A9C5, 0xCE3B68C1, 0x171D2BCC, 0xA000EAC8,
+		0xA550ADD6, 0x124D6CD2, 0xCB6B2FDF, 0x7C76EEDB, 0xC1CBA1E3, 0x76D660E7,
+		0xAFF023EA, 0x18EDE2EE, 0x1DBDA5F0, 0xAAA064F4, 0x738627F9, 0xC49BE6FD,
+		0x09FDB889, 0xBEE0798D, 0x67C63A80, 0xD0DBFB84, 0xD58BBC9A, 0x62967D9E,
+		0xBBB03E93, 0x0CADFF97, 0xB110B0AF, 0x060D71AB, 0xDF2B32A6, 0x6836F3A2,
+		0x6D66B4BC, 0xDA7B75B8, 0x035D36B5, 0xB440F7B1
+	},
+	{
+		0x00000000, 0xDCC119D2, 0x0F9EF2A0, 0xD35FEB72, 0xA9212445, 0x75E03D97,
+		0xA6BFD6E5, 0x7A7ECF37, 0x5243488A, 0x8E825158, 0x5DDDBA2A, 0x811CA3F8,
+		0xFB626CCF, 0x27A3751D, 0xF4FC9E6F, 0x283D87BD, 0x139B5110, 0xCF5A48C2,
+		0x1C05A3B0, 0xC0C4BA62, 0xBABA7555, 0x667B6C87, 0xB52487F5, 0x69E59E27,
+		0x41D8199A, 0x9D190048, 0x4E46EB3A, 0x9287F2E8, 0xE8F93DDF, 0x3438240D,
+		0xE767CF7F, 0x3BA6D6AD, 0x2636A320, 0xFAF7BAF2, 0x29A85180, 0xF5694852,
+		0x8F178765, 0x53D69EB7, 0x808975C5, 0x5C486C17, 0x7475EBAA, 0xA8B4F278,
+		0x7BEB190A, 0xA72A00D8, 0xDD54CFEF, 0x0195D63D, 0xD2CA3D4F, 0x0E0B249D,
+		0x35ADF230, 0xE96CEBE2, 0x3A330090, 0xE6F21942, 0x9C8CD675, 0x404DCFA7,
+		0x931224D5, 0x4FD33D07, 0x67EEBABA, 0xBB2FA368, 0x6870481A, 0xB4B151C8,
+		0xCECF9EFF, 0x120E872D, 0xC1516C5F, 0x1D90758D, 0x4C6C4641, 0x90AD5F93,
+		0x43F2B4E1, 0x9F33AD33, 0xE54D6204, 0x398C7BD6, 0xEAD390A4, 0x36128976,
+		0x1E2F0ECB, 0xC2EE1719, 0x11B1FC6B, 0xCD70E5B9, 0xB70E2A8E, 0x6BCF335C,
+		0xB890D82E, 0x6451C1FC, 0x5FF71751, 0x83360E83, 0x5069E5F1, 0x8CA8FC23,
+		0xF6D63314, 0x2A172AC6, 0xF948C1B4, 0x2589D866, 0x0DB45FDB, 0xD1754609,
+		0x022AAD7B, 0xDEEBB4A9, 0xA4957B9E, 0x7854624C, 0xAB0B893E, 0x77CA90EC,
+		0x6A5AE561, 0xB69BFCB3, 0x65C417C1, 0xB9050E13, 0xC37BC124, 0x1FBAD8F6,
+		0xCCE53384, 0x10242A56, 0x3819ADEB, 0xE4D8B439, 0x37875F4B, 0xEB464699,
+		0x913889AE, 0x4DF9907C, 0x9EA67B0E, 0x426762DC, 0x79C1B471, 0xA500ADA3,
+		0x765F46D1, 0xAA9E5F03, 0xD0E09034, 0x0C2189E6, 0xDF7E6294, 0x03BF7B46,
+		0x2B82FCFB, 0xF743E529, 0x241C0E5B, 0xF8DD1789, 0x82A3D8BE, 0x5E62C16C,
+		0x8D3D2A1E, 0x51FC33CC, 0x98D88C82, 0x44199550, 0x97467E22, 0x4B8767F0,
+		0x31F9A8C7, 0xED38B115, 0x3E675A67, 0xE2A643B5, 0xCA9BC408, 0x165ADDDA,
+		0xC50536A8, 0x19C42F7A, 0x63BAE04D, 0xBF7BF99F, 0x6C2412ED, 0xB0E50B3F,
+		0x8B43DD92, 0x5782C440, 0x84DD2F32, 0x581C36E0, 0x2262F9D7, 0xFEA3E005,
+		0x2DFC0B77, 0xF13D12A5, 0xD9009518, 0x05C18CCA, 0xD69E67B8, 0x0A5F7E6A,
+		0x7021B15D, 0xACE0A88F, 0x7FBF43FD, 0xA37E5A2F, 0xBEEE2FA2, 0x622F3670,
+		0xB170DD02, 0x6DB1C4D0, 0x17CF0BE7, 0xCB0E1235, 0x1851F947, 0xC490E095,
+		0xECAD6728, 0x306C7EFA, 0xE3339588, 0x3FF28C5A, 0x458C436D, 0x994D5ABF,
+		0x4A12B1CD, 0x96D3A81F, 0xAD757EB2, 0x71B46760, 0xA2EB8C12, 0x7E2A95C0,
+		0x04545AF7, 0xD8954325, 0x0BCAA857, 0xD70BB185, 0xFF363638, 0x23F72FEA,
+		0xF0A8C498, 0x2C69DD4A, 0x5617127D, 0x8AD60BAF, 0x5989E0DD, 0x8548F90F,
+		0xD4B4CAC3, 0x0875D311, 0xDB2A3863, 0x07EB21B1, 0x7D95EE86, 0xA154F754,
+		0x720B1C26, 0xAECA05F4, 0x86F78249, 0x5A369B9B, 0x896970E9, 0x55A8693B,
+		0x2FD6A60C, 0xF317BFDE, 0x204854AC, 0xFC894D7E, 0xC72F9BD3, 0x1BEE8201,
+		0xC8B16973, 0x147070A1, 0x6E0EBF96, 0xB2CFA644, 0x61904D36, 0xBD5154E4,
+		0x956CD359, 0x49ADCA8B, 0x9AF221F9, 0x4633382B, 0x3C4DF71C, 0xE08CEECE,
+		0x33D305BC, 0xEF121C6E, 0xF28269E3, 0x2E437031, 0xFD1C9B43, 0x21DD8291,
+		0x5BA34DA6, 0x87625474, 0x543DBF06, 0x88FCA6D4, 0xA0C12169, 0x7C0038BB,
+		0xAF5FD3C9, 0x739ECA1B, 0x09E0052C, 0xD5211CFE, 0x067EF78C, 0xDABFEE5E,
+		0xE11938F3, 0x3DD82121, 0xEE87CA53, 0x3246D381, 0x48381CB6, 0x94F90564,
+		0x47A6EE16, 0x9B67F7C4, 0xB35A7079, 0x6F9B69AB, 0xBCC482D9, 0x60059B0B,
+		0x1A7B543C, 0xC6BA4DEE, 0x15E5A69C, 0xC924BF4E
+	},
+	{
+		0x00000000, 0x87ACD801, 0x0E59B103, 0x89F56902, 0x1CB26207, 0x9B1EBA06,
+		0x12EBD304, 0x95470B05, 0x3864C50E, 0xBFC81D0F, 0x363D740D, 0xB191AC0C,
+		0x24D6A709, 0xA37A7F08, 0x2A8F160A, 0xAD23CE0B, 0x70C88A1D, 0xF764521C,
+		0x7E913B1E, 0xF93DE31F, 0x6C7AE81A, 0xEBD6301B, 0x62235919, 0xE58F8118,
+		0x48AC4F13, 0xCF009712, 0x46F5FE10, 0xC1592611, 0x541E2D14, 0xD3B2F515,
+		0x5A479C17, 0xDDEB4416, 0xE090153B, 0x673CCD3A, 0xEEC9A438, 0x69657C39,
+		0xFC22773C, 0x7B8EAF3D, 0xF27BC63F, 0x75D71E3E, 0xD8F4D035, 0x5F580834,
+		0xD6AD6136, 0x5101B937, 0xC446B232, 0x43EA6A33, 0xCA1F0331, 0x4DB3DB30,
+		0x90589F26, 0x17F44727, 0x9E012E25, 0x19ADF624, 0x8CEAFD21, 0x0B462520,
+		0x82B34C22, 0x051F9423, 0xA83C5A28, 0x2F908229, 0xA665EB2B, 0x21C9332A,
+		0xB48E382F, 0x3322E02E, 0xBAD7892C, 0x3D7B512D, 0xC0212B76, 0x478DF377,
+		0xCE789A75, 0x49D44274, 0xDC934971, 0x5B3F9170, 0xD2CAF872, 0x55662073,
+		0xF845EE78, 0x7FE93679, 0xF61C5F7B, 0x71B0877A, 0xE4F78C7F, 0x635B547E,
+		0xEAAE3D7C, 0x6D02E57D, 0xB0E9A16B, 0x3745796A, 0xBEB01068, 0x391CC869,
+		0xAC5BC36C, 0x2BF71B6D, 0xA202726F, 0x25AEAA6E, 0x888D6465, 0x0F21BC64,
+		0x86D4D566, 0x01780D67, 0x943F0662, 0x1393DE63, 0x9A66B761, 0x1DCA6F60,
+		0x20B13E4D, 0xA71DE64C, 0x2EE88F4E, 0xA944574F, 0x3C035C4A, 0xBBAF844B,
+		0x325AED49, 0xB5F63548, 0x18D5FB43, 0x9F792342, 0x168C4A40, 0x91209241,
+		0x04679944, 0x83CB4145, 0x0A3E2847, 0x8D92F046, 0x5079B450, 0xD7D56C51,
+		0x5E200553, 0xD98CDD52, 0x4CCBD657, 0xCB670E56, 0x42926754, 0xC53EBF55,
+		0x681D715E, 0xEFB1A95F, 0x6644C05D, 0xE1E8185C, 0x74AF1359, 0xF303CB58,
+		0x7AF6A25A, 0xFD5A7A5B, 0x804356EC, 0x07EF8EED, 0x8E1AE7EF, 0x09B63FEE,
+		0x9CF134EB, 0x1B5DECEA, 0x92A885E8, 0x15045DE9, 0xB82793E2, 0x3F8B4BE3,
+		0xB67E22E1, 0x31D2FAE0, 0xA495F1E5, 0x233929E4, 0xAACC40E6, 0x2D6098E7,
+		0xF08BDCF1, 0x772704F0, 0xFED26DF2, 0x797EB5F3, 0xEC39BEF6, 0x6B9566F7,
+		0xE2600FF5, 0x65CCD7F4, 0xC8EF19FF, 0x4F43C1FE, 0xC6B6A8FC, 0x411A70FD,
+		0xD45D7BF8, 0x53F1A3F9, 0xDA04CAFB, 0x5DA812FA, 0x60D343D7, 0xE77F9BD6,
+		0x6E8AF2D4, 0xE9262AD5, 0x7C6121D0, 0xFBCDF9D1, 0x723890D3, 0xF59448D2,
+		0x58B786D9, 0xDF1B5ED8, 0x56EE37DA, 0xD142EFDB, 0x4405E4DE, 0xC3A93CDF,
+		0x4A5C55DD, 0xCDF08DDC, 0x101BC9CA, 0x97B711CB, 0x1E4278C9, 0x99EEA0C8,
+		0x0CA9ABCD, 0x8B0573CC, 0x02F01ACE, 0x855CC2CF, 0x287F0CC4, 0xAFD3D4C5,
+		0x2626BDC7, 0xA18A65C6, 0x34CD6EC3, 0xB361B6C2, 0x3A94DFC0, 0xBD3807C1,
+		0x40627D9A, 0xC7CEA59B, 0x4E3BCC99, 0xC9971498, 0x5CD01F9D, 0xDB7CC79C,
+		0x5289AE9E, 0xD525769F, 0x7806B894, 0xFFAA6095, 0x765F0997, 0xF1F3D196,
+		0x64B4DA93, 0xE3180292, 0x6AED6B90, 0xED41B391, 0x30AAF787, 0xB7062F86,
+		0x3EF34684, 0xB95F9E85, 0x2C189580, 0xABB44D81, 0x22412483, 0xA5EDFC82,
+		0x08CE3289, 0x8F62EA88, 0x0697838A, 0x813B5B8B, 0x147C508E, 0x93D0888F,
+		0x1A25E18D, 0x9D89398C, 0xA0F268A1, 0x275EB0A0, 0xAEABD9A2, 0x290701A3,
+		0xBC400AA6, 0x3BECD2A7, 0xB219BBA5, 0x35B563A4, 0x9896ADAF, 0x1F3A75AE,
+		0x96CF1CAC, 0x1163C4AD, 0x8424CFA8, 0x038817A9, 0x8A7D7EAB, 0x0DD1A6AA,
+		0xD03AE2BC, 0x57963ABD, 0xDE6353BF, 0x59CF8BBE, 0xCC8880BB, 0x4B2458BA,
+		0xC2D131B8, 0x457DE9B9, 0xE85E27B2, 0x6FF2FFB3, 0xE60796B1, 0x61AB4EB0,
+		0xF4EC45B5, 0x73409DB4, 0xFAB5F4B6, 0x7D192CB7
+	},
+	{
+		0x00000000, 0xB79A6DDC, 0xD9281ABC, 0x6EB27760, 0x054CF57C, 0xB2D698A0,
+		0xDC64EFC0, 0x6BFE821C, 0x0A98EAF9, 0xBD028725, 0xD3B0F045, 0x642A9D99,
+		0x0FD41F85, 0xB84E7259, 0xD6FC0539, 0x616668E5, 0xA32D14F7, 0x14B7792B,
+		0x7A050E4B, 0xCD9F6397, 0xA661E18B, 0x11FB8C57, 0x7F49FB37, 0xC8D396EB,
+		0xA9B5FE0E, 0x1E2F93D2, 0x709DE4B2, 0xC707896E, 0xACF90B72, 0x1B6366AE,
+		0x75D111CE, 0xC24B7C12, 0xF146E9EA, 0x46DC8436, 0x286EF356, 0x9FF49E8A,
+		0xF40A1C96, 0x4390714A, 0x2D22062A, 0x9AB86BF6, 0xFBDE0313, 0x4C446ECF,
+		0x22F619AF, 0x956C7473, 0xFE92F66F, 0x49089BB3, 0x27BAECD3, 0x9020810F,
+		0x526BFD1D, 0xE5F190C1, 0x8B43E7A1, 0x3CD98A7D, 0x57270861, 0xE0BD65BD,
+		0x8E0F12DD, 0x39957F01, 0x58F317E4, 0xEF697A38, 0x81DB0D58, 0x36416084,
+		0x5DBFE298, 0xEA258F44, 0x8497F824, 0x330D95F8, 0x559013D1, 0xE20A7E0D,
+		0x8CB8096D, 0x3B2264B1, 0x50DCE6AD, 0xE7468B71, 0x89F4FC11, 0x3E6E91CD,
+		0x5F08F928, 0xE89294F4, 0x8620E394, 0x31BA8E48, 0x5A440C54, 0xEDDE6188,
+		0x836C16E8, 0x34F67B34, 0xF6BD0726, 0x41276AFA, 0x2F951D9A, 0x980F7046,
+		0xF3F1F25A, 0x446B9F86, 0x2AD9E8E6, 0x9D43853A, 0xFC25EDDF, 0x4BBF8003,
+		0x250DF763, 0x92979ABF, 0xF96918A3, 0x4EF3757F, 0x2041021F, 0x97DB6FC3,
+		0xA4D6FA3B, 0x134C97E7, 0x7DFEE087, 0xCA648D5B, 0xA19A0F47, 0x1600629B,
+		0x78B215FB, 0xCF287827, 0xAE4E10C2, 0x19D47D1E, 0x77660A7E, 0xC0FC67A2,
+		0xAB02E5BE, 0x1C988862, 0x722AFF02, 0xC5B092DE, 0x07FBEECC, 0xB0618310,
+		0xDED3F470, 0x694999AC, 0x02B71BB0, 0xB52D766C, 0xDB9F010C, 0x6C056CD0,
+		0x0D630435, 0xBAF969E9, 0xD44B1E89, 0x63D17355, 0x082FF149, 0xBFB59C95,
+		0xD107EBF5, 0x669D8629, 0x1D3DE6A6, 0xAAA78B7A, 0xC415FC1A, 0x738F91C6,
+		0x187113DA, 0xAFEB7E06, 0xC1590966, 0x76C364BA, 0x17A50C5F, 0xA03F6183,
+		0xCE8D16E3, 0x79177B3F, 0x12E9F923, 0xA57394FF, 0xCBC1E39F, 0x7C5B8E43,
+		0xBE10F251, 0x098A9F8D, 0x6738E8ED, 0xD0A28531, 0xBB5C072D, 0x0CC66AF1,
+		0x62741D91, 0xD5EE704D, 0xB48818A8, 0x03127574, 0x6DA00214, 0xDA3A6FC8,
+		0xB1C4EDD4, 0x065E8008, 0x68ECF768, 0xDF769AB4, 0xEC7B0F4C, 0x5BE16290,
+		0x355315F0, 0x82C9782C, 0xE937FA30, 0x5EAD97EC, 0x301FE08C, 0x87858D50,
+		0xE6E3E5B5, 0x51798869, 0x3FCBFF09, 0x885192D5, 0xE3AF10C9, 0x54357D15,
+		0x3A870A75, 0x8D1D67A9, 0x4F561BBB, 0xF8CC7667, 0x967E0107, 0x21E46CDB,
+		0x4A1AEEC7, 0xFD80831B, 0x9332F47B, 0x24A899A7, 0x45CEF142, 0xF2549C9E,
+		0x9CE6EBFE, 0x2B7C8622, 0x4082043E, 0xF71869E2, 0x99AA1E82, 0x2E30735E,
+		0x48ADF577, 0xFF3798AB, 0x9185EFCB, 0x261F8217, 0x4DE1000B, 0xFA7B6DD7,
+		0x94C91AB7, 0x2353776B, 0x42351F8E, 0xF5AF7252, 0x9B1D0532, 0x2C8768EE,
+		0x4779EAF2, 0xF0E3872E, 0x9E51F04E, 0x29CB9D92, 0xEB80E180, 0x5C1A8C5C,
+		0x32A8FB3C, 0x853296E0, 0xEECC14FC, 0x59567920, 0x37E40E40, 0x807E639C,
+		0xE1180B79, 0x568266A5, 0x383011C5, 0x8FAA7C19, 0xE454FE05, 0x53CE93D9,
+		0x3D7CE4B9, 0x8AE68965, 0xB9EB1C9D, 0x0E717141, 0x60C30621, 0xD7596BFD,
+		0xBCA7E9E1, 0x0B3D843D, 0x658FF35D, 0xD2159E81, 0xB373F664, 0x04E99BB8,
+		0x6A5BECD8, 0xDDC18104, 0xB63F0318, 0x01A56EC4, 0x6F1719A4, 0xD88D7478,
+		0x1AC6086A, 0xAD5C65B6, 0xC3EE12D6, 0x74747F0A, 0x1F8AFD16, 0xA81090CA,
+		0xC6A2E7AA, 0x71388A76, 0x105EE293, 0xA7C48F4F, 0xC976F82F, 0x7EEC95F3,
+		0x151217EF, 0xA2887A33, 0xCC3A0D53, 0x7BA0608F
+	},
+	{
+		0x00000000, 0x8D670D49, 0x1ACF1A92, 0x97A817DB, 0x8383F420, 0x0EE4F969,
+		0x994CEEB2, 0x142BE3FB, 0x0607E941, 0x8B60E408, 0x1CC8F3D3, 0x91AFFE9A,
+		0x85841D61, 0x08E31028, 0x9F4B07F3, 0x122C0ABA, 0x0C0ED283, 0x8169DFCA,
+		0x16C1C811, 0x9BA6C558, 0x8F8D26A3, 0x02EA2BEA, 0x95423C31, 0x18253178,
+		0x0A093BC2, 0x876E368B, 0x10C62150, 0x9DA12C19, 0x898ACFE2, 0x04EDC2AB,
+		0x9345D570, 0x1E22D839, 0xAF016503, 0x2266684A, 0xB5CE7F91, 0x38A972D8,
+		0x2C829123, 0xA1E59C6A, 0x364D8BB1, 0xBB2A86F8, 0xA9068C42, 0x2461810B,
+		0xB3C996D0, 0x3EAE9B99, 0x2A857862, 0xA7E2752B, 0x304A62F0, 0xBD2D6FB9,
+		0xA30FB780, 0x2E68BAC9, 0xB9C0AD12, 0x34A7A05B, 0x208C43A0, 0xADEB4EE9,
+		0x3A435932, 0xB724547B, 0xA5085EC1, 0x286F5388, 0xBFC74453, 0x32A0491A,
+		0x268BAAE1, 0xABECA7A8, 0x3C44B073, 0xB123BD3A, 0x5E03CA06, 0xD364C74F,
+		0x44CCD094, 0xC9ABDDDD, 0xDD803E26, 0x50E7336F, 0xC74F24B4, 0x4A2829FD,
+		0x58042347, 0xD5632E0E, 0x42CB39D5, 0xCFAC349C, 0xDB87D767, 0x56E0DA2E,
+		0xC148CDF5, 0x4C2FC0BC, 0x520D1885, 0xDF6A15CC, 0x48C20217, 0xC5A50F5E,
+		0xD18EECA5, 0x5CE9E1EC, 0xCB41F637, 0x4626FB7E, 0x540AF1C4, 0xD96DFC8D,
+		0x4EC5EB56, 0xC3A2E61F, 0xD78905E4, 0x5AEE08AD, 0xCD461F76, 0x4021123F,
+		0xF102AF05, 0x7C65A24C, 0xEBCDB597, 0x66AAB8DE, 0x72815B25, 0xFFE6566C,
+		0x684E41B7, 0xE5294CFE, 0xF7054644, 0x7A624B0D, 0xEDCA5CD6, 0x60AD519F,
+		0x7486B264, 0xF9E1BF2D, 0x6E49A8F6, 0xE32EA5BF, 0xFD0C7D86, 0x706B70CF,
+		0xE7C36714, 0x6AA46A5D, 0x7E8F89A6, 0xF3E884EF, 0x64409334, 0xE9279E7D,
+		0xFB0B94C7, 0x766C998E, 0xE1C48E55, 0x6CA3831C, 0x788860E7, 0xF5EF6DAE,
+		0x62477A75, 0xEF20773C, 0xBC06940D, 0x31619944, 0xA6C98E9F, 0x2BAE83D6,
+		0x3F85602D, 0xB2E26D64, 0x254A7ABF, 0xA82D77F6, 0xBA017D4C, 0x37667005,
+		0xA0CE67DE, 0x2DA96A97, 0x3982896C, 0xB4E58425, 0x234D93FE, 0xAE2A9EB7,
+		0xB008468E, 0x3D6F4BC7, 0xAAC75C1C, 0x27A05155, 0x338BB2AE, 0xBEECBFE7,
+		0x2944A83C, 0xA423A575, 0xB60FAFCF, 0x3B68A286, 0xACC0B55D, 0x21A7B814,
+		0x358C5BEF, 0xB8EB56A6, 0x2F43417D, 0xA2244C34, 0x1307F10E, 0x9E60FC47,
+		0x09C8EB9C, 0x84AFE6D5, 0x9084052E, 0x1DE30867, 0x8A4B1FBC, 0x072C12F5,
+		0x1500184F, 0x98671506, 0x0FCF02DD, 0x82A80F94, 0x9683EC6F, 0x1BE4E126,
+		0x8C4CF6FD, 0x012BFBB4, 0x1F09238D, 0x926E2EC4, 0x05C6391F, 0x88A13456,
+		0x9C8AD7AD, 0x11EDDAE4, 0x8645CD3F, 0x0B22C076, 0x190ECACC, 0x9469C785,
+		0x03C1D05E, 0x8EA6DD17, 0x9A8D3EEC, 0x17EA33A5, 0x8042247E, 0x0D252937,
+		0xE2055E0B, 0x6F625342, 0xF8CA4499, 0x75AD49D0, 0x6186AA2B, 0xECE1A762,
+		0x7B49B0B9, 0xF62EBDF0, 0xE402B74A, 0x6965BA03, 0xFECDADD8, 0x73AAA091,
+		0x6781436A, 0xEAE64E23, 0x7D4E59F8, 0xF02954B1, 0xEE0B8C88, 0x636C81C1,
+		0xF4C4961A, 0x79A39B53, 0x6D8878A8, 0xE0EF75E1, 0x7747623A, 0xFA206F73,
+		0xE80C65C9, 0x656B6880, 0xF2C37F5B, 0x7FA47212, 0x6B8F91E9, 0xE6E89CA0,
+		0x71408B7B, 0xFC278632, 0x4D043B08, 0xC0633641, 0x57CB219A, 0xDAAC2CD3,
+		0xCE87CF28, 0x43E0C261, 0xD448D5BA, 0x592FD8F3, 0x4B03D249, 0xC664DF00,
+		0x51CCC8DB, 0xDCABC592, 0xC8802669, 0x45E72B20, 0xD24F3CFB, 0x5F2831B2,
+		0x410AE98B, 0xCC6DE4C2, 0x5BC5F319, 0xD6A2FE50, 0xC2891DAB, 0x4FEE10E2,
+		0xD8460739, 0x55210A70, 0x470D00CA, 0xCA6A0D83, 0x5DC21A58, 0xD0A51711,
+		0xC48EF4EA, 0x49E9F9A3, 0xDE41EE78, 0x5326E331
+	},
+	{
+		0x00000000, 0x780D281B, 0xF01A5036, 0x8817782D, 0xE035A06C, 0x98388877,
+		0x102FF05A, 0x6822D841, 0xC06B40D9, 0xB86668C2, 0x307110EF, 0x487C38F4,
+		0x205EE0B5, 0x5853C8AE, 0xD044B083, 0xA8499898, 0x37CA41B6, 0x4FC769AD,
+		0xC7D01180, 0xBFDD399B, 0xD7FFE1DA, 0xAFF2C9C1, 0x27E5B1EC, 0x5FE899F7,
+		0xF7A1016F, 0x8FAC2974, 0x07BB5159, 0x7FB67942, 0x1794A103, 0x6F998918,
+		0xE78EF135, 0x9F83D92E, 0xD9894268, 0xA1846A73, 0x2993125E, 0x519E3A45,
+		0x39BCE204, 0x41B1CA1F, 0xC9A6B232, 0xB1AB9A29, 0x19E202B1, 0x61EF2AAA,
+		0xE9F85287, 0x91F57A9C, 0xF9D7A2DD, 0x81DA8AC6, 0x09CDF2EB, 0x71C0DAF0,
+		0xEE4303DE, 0x964E2BC5, 0x1E5953E8, 0x66547BF3, 0x0E76A3B2, 0x767B8BA9,
+		0xFE6CF384, 0x8661DB9F, 0x2E284307, 0x56256B1C, 0xDE321331, 0xA63F3B2A,
+		0xCE1DE36B, 0xB610CB70, 0x3E07B35D, 0x460A9B46, 0xB21385D0, 0xCA1EADCB,
+		0x4209D5E6, 0x3A04FDFD, 0x522625BC, 0x2A2B0DA7, 0xA23C758A, 0xDA315D91,
+		0x7278C509, 0x0A75ED12, 0x8262953F, 0xFA6FBD24, 0x924D6565, 0xEA404D7E,
+		0x62573553, 0x1A5A1D48, 0x85D9C466, 0xFDD4EC7D, 0x75C39450, 0x0DCEBC4B,
+		0x65EC640A, 0x1DE14C11, 0x95F6343C, 0xEDFB1C27, 0x45B284BF, 0x3DBFACA4,
+		0xB5A8D489, 0xCDA5FC92, 0xA58724D3, 0xDD8A0CC8, 0x559D74E5, 0x2D905CFE,
+		0x6B9AC7B8, 0x1397EFA3, 0x9B80978E, 0xE38DBF95, 0x8BAF67D4, 0xF3A24FCF,
+		0x7BB537E2, 0x03B81FF9, 0xABF18761, 0xD3FCAF7A, 0x5BEBD757, 0x23E6FF4C,
+		0x4BC4270D, 0x33C90F16, 0xBBDE773B, 0xC3D35F20, 0x5C50860E, 0x245DAE15,
+		0xAC4AD638, 0xD447FE23, 0xBC652662, 0xC4680E79, 0x4C7F7654, 0x34725E4F,
+		0x9C3BC6D7, 0xE436EECC, 0x6C2196E1, 0x142CBEFA, 0x7C0E66BB, 0x04034EA0,
+		0x8C14368D, 0xF4191E96, 0xD33ACBA5, 0xAB37E3BE, 0x23209B93, 0x5B2DB388,
+		0x330F6BC9, 0x4B0243D2, 0xC3153BFF, 0xBB1813E4, 0x13518B7C, 0x6B5CA367,
+		0xE34BDB4A, 0x9B46F351, 0xF3642B10, 0x8B69030B, 0x037E7B26, 0x7B73533D,
+		0xE4F08A13, 0x9CFDA208, 0x14EADA25, 0x6CE7F23E, 0x04C52A7F, 0x7CC80264,
+		0xF4DF7A49, 0x8CD25252, 0x249BCACA, 0x5C96E2D1, 0xD4819AFC, 0xAC8CB2E7,
+		0xC4AE6AA6, 0xBCA342BD, 0x34B43A90, 0x4CB9128B, 0x0AB389CD, 0x72BEA1D6,
+		0xFAA9D9FB, 0x82A4F1E0, 0xEA8629A1, 0x928B01BA, 0x1A9C7997, 0x6291518C,
+		0xCAD8C914, 0xB2D5E10F, 0x3AC29922, 0x42CFB139, 0x2AED6978, 0x52E04163,
+		0xDAF7394E, 0xA2FA1155, 0x3D79C87B, 0x4574E060, 0xCD63984D, 0xB56EB056,
+		0xDD4C6817, 0xA541400C, 0x2D563821, 0x555B103A, 0xFD1288A2, 0x851FA0B9,
+		0x0D08D894, 0x7505F08F, 0x1D2728CE, 0x652A00D5, 0xED3D78F8, 0x953050E3,
+		0x61294E75, 0x1924666E, 0x91331E43, 0xE93E3658, 0x811CEE19, 0xF911C602,
+		0x7106BE2F, 0x090B9634, 0xA1420EAC, 0xD94F26B7, 0x51585E9A, 0x29557681,
+		0x4177AEC0, 0x397A86DB, 0xB16DFEF6, 0xC960D6ED, 0x56E30FC3, 0x2EEE27D8,
+		0xA6F95FF5, 0xDEF477EE, 0xB6D6AFAF, 0xCEDB87B4, 0x46CCFF99, 0x3EC1D782,
+		0x96884F1A, 0xEE856701, 0x66921F2C, 0x1E9F3737, 0x76BDEF76, 0x0EB0C76D,
+		0x86A7BF40, 0xFEAA975B, 0xB8A00C1D, 0xC0AD2406, 0x48BA5C2B, 0x30B77430,
+		0x5895AC71, 0x2098846A, 0xA88FFC47, 0xD082D45C, 0x78CB4CC4, 0x00C664DF,
+		0x88D11CF2, 0xF0DC34E9, 0x98FEECA8, 0xE0F3C4B3, 0x68E4BC9E, 0x10E99485,
+		0x8F6A4DAB, 0xF76765B0, 0x7F701D9D, 0x077D3586, 0x6F5FEDC7, 0x1752C5DC,
+		0x9F45BDF1, 0xE74895EA, 0x4F010D72, 0x370C2569, 0xBF1B5D44, 0xC716755F,
+		0xAF34AD1E, 0xD7398505, 0x5F2EFD28, 0x2723D533
+	},
+	{
+		0x00000000, 0x1168574F, 0x22D0AE9E, 0x33B8F9D1, 0xF3BD9C39, 0xE2D5CB76,
+		0xD16D32A7, 0xC00565E8, 0xE67B3973, 0xF7136E3C, 0xC4AB97ED, 0xD5C3C0A2,
+		0x15C6A54A, 0x04AEF205, 0x37160BD4, 0x267E5C9B, 0xCCF772E6, 0xDD9F25A9,
+		0xEE27DC78, 0xFF4F8B37, 0x3F4AEEDF, 0x2E22B990, 0x1D9A4041, 0x0CF2170E,
+		0x2A8C4B95, 0x3BE41CDA, 0x085CE50B, 0x1934B244, 0xD931D7AC, 0xC85980E3,
+		0xFBE17932, 0xEA892E7D, 0x2FF224C8, 0x3E9A7387, 0x0D228A56, 0x1C4ADD19,
+		0xDC4FB8F1, 0xCD27EFBE, 0xFE9F166F, 0xEFF74120, 0xC9891DBB, 0xD8E14AF4,
+		0xEB59B325, 0xFA31E46A, 0x3A348182, 0x2B5CD6CD, 0x18E42F1C, 0x098C7853,
+		0xE305562E, 0xF26D0161, 0xC1D5F8B0, 0xD0BDAFFF, 0x10B8CA17, 0x01D09D58,
+		0x32686489, 0x230033C6, 0x057E6F5D, 0x14163812, 0x27AEC1C3, 0x36C6968C,
+		0xF6C3F364, 0xE7ABA42B, 0xD4135DFA, 0xC57B0AB5, 0xE9F98894, 0xF891DFDB,
+		0xCB29260A, 0xDA417145, 0x1A4414AD, 0x0B2C43E2, 0x3894BA33, 0x29FCED7C,
+		0x0F82B1E7, 0x1EEAE6A8, 0x2D521F79, 0x3C3A4836, 0xFC3F2DDE, 0xED577A91,
+		0xDEEF8340, 0xCF87D40F, 0x250EFA72, 0x3466AD3D, 0x07DE54EC, 0x16B603A3,
+		0xD6B3664B, 0xC7DB3104, 0xF463C8D5, 0xE50B9F9A, 0xC375C301, 0xD21D944E,
+		0xE1A56D9F, 0xF0CD3AD0, 0x30C85F38, 0x21A00877, 0x1218F1A6, 0x0370A6E9,
+		0xC60BAC5C, 0xD763FB13, 0xE4DB02C2, 0xF5B3558D, 0x35B63065, 0x24DE672A,
+		0x17669EFB, 0x060EC9B4, 0x2070952F, 0x3118C260, 0x02A03BB1, 0x13C86CFE,
+		0xD3CD0916, 0xC2A55E59, 0xF11DA788, 0xE075F0C7, 0x0AFCDEBA, 0x1B9489F5,
+		0x282C7024, 0x3944276B, 0xF9414283, 0xE82915CC, 0xDB91EC1D, 0xCAF9BB52,
+		0xEC87E7C9, 0xFDEFB086, 0xCE574957, 0xDF3F1E18, 0x1F3A7BF0, 0x0E522CBF,
+		0x3DEAD56E, 0x2C828221, 0x65EED02D, 0x74868762, 0x473E7EB3, 0x565629FC,
+		0x96534C14, 0x873B1B5B, 0xB483E28A, 0xA5EBB5C5, 0x8395E95E, 0x92FDBE11,
+		0xA14547C0, 0xB02D108F, 0x70287567, 0x61402228, 0x52F8DBF9, 0x43908CB6,
+		0xA919A2CB, 0xB871F584, 0x8BC90C55, 0x9AA15B1A, 0x5AA43EF2, 0x4BCC69BD,
+		0x7874906C, 0x691CC723, 0x4F629BB8, 0x5E0ACCF7, 0x6DB23526, 0x7CDA6269,
+		0xBCDF0781, 0xADB750CE, 0x9E0FA91F, 0x8F67FE50, 0x4A1CF4E5, 0x5B74A3AA,
+		0x68CC5A7B, 0x79A40D34, 0xB9A168DC, 0xA8C93F93, 0x9B71C642, 0x8A19910D,
+		0xAC67CD96, 0xBD0F9AD9, 0x8EB76308, 0x9FDF3447, 0x5FDA51AF, 0x4EB206E0,
+		0x7D0AFF31, 0x6C62A87E, 0x86EB8603, 0x9783D14C, 0xA43B289D, 0xB5537FD2,
+		0x75561A3A, 0x643E4D75, 0x5786B4A4, 0x46EEE3EB, 0x6090BF70, 0x71F8E83F,
+		0x424011EE, 0x532846A1, 0x932D2349, 0x82457406, 0xB1FD8DD7, 0xA095DA98,
+		0x8C1758B9, 0x9D7F0FF6, 0xAEC7F627, 0xBFAFA168, 0x7FAAC480, 0x6EC293CF,
+		0x5D7A6A1E, 0x4C123D51, 0x6A6C61CA, 0x7B043685, 0x48BCCF54, 0x59D4981B,
+		0x99D1FDF3, 0x88B9AABC, 0xBB01536D, 0xAA690422, 0x40E02A5F, 0x51887D10,
+		0x623084C1, 0x7358D38E, 0xB35DB666, 0xA235E129, 0x918D18F8, 0x80E54FB7,
+		0xA69B132C, 0xB7F34463, 0x844BBDB2, 0x9523EAFD, 0x55268F15, 0x444ED85A,
+		0x77F6218B, 0x669E76C4, 0xA3E57C71, 0xB28D2B3E, 0x8135D2EF, 0x905D85A0,
+		0x5058E048, 0x4130B707, 0x72884ED6, 0x63E01999, 0x459E4502, 0x54F6124D,
+		0x674EEB9C, 0x7626BCD3, 0xB623D93B, 0xA74B8E74, 0x94F377A5, 0x859B20EA,
+		0x6F120E97, 0x7E7A59D8, 0x4DC2A009, 0x5CAAF746, 0x9CAF92AE, 0x8DC7C5E1,
+		0xBE7F3C30, 0xAF176B7F, 0x896937E4, 0x980160AB, 0xABB9997A, 0xBAD1CE35,
+		0x7AD4ABDD, 0x6BBCFC92, 0x58040543, 0x496C520C
+	},
+	{
+		0x00000000, 0xCADCA15B, 0x94B943B7, 0x5E65E2EC, 0x9F6E466A, 0x55B2E731,
+		0x0BD705DD, 0xC10BA486, 0x3EDD8CD4, 0xF4012D8F, 0xAA64CF63, 0x60B86E38,
+		0xA1B3CABE, 0x6B6F6BE5, 0x350A8909, 0xFFD62852, 0xCBA7D8AD, 0x017B79F6,
+		0x5F1E9B1A, 0x95C23A41, 0x54C99EC7, 0x9E153F9C, 0xC070DD70, 0x0AAC7C2B,
+		0xF57A5479, 0x3FA6F522, 0x61C317CE, 0xAB1FB695, 0x6A141213, 0xA0C8B348,
+		0xFEAD51A4, 0x3471F0FF, 0x2152705F, 0xEB8ED104, 0xB5EB33E8, 0x7F3792B3,
+		0xBE3C3635, 0x74E0976E, 0x2A857582, 0xE059D4D9, 0x1F8FFC8B, 0xD5535DD0,
+		0x8B36BF3C, 0x41EA1E67, 0x80E1BAE1, 0x4A3D1BBA, 0x1458F956, 0xDE84580D,
+		0xEAF5A8F2, 0x202909A9, 0x7E4CEB45, 0xB4904A1E, 0x759BEE98, 0xBF474FC3,
+		0xE122AD2F, 0x2BFE0C74, 0xD4282426, 0x1EF4857D, 0x40916791, 0x8A4DC6CA,
+		0x4B46624C, 0x819AC317, 0xDFFF21FB, 0x152380A0, 0x42A4E0BE, 0x887841E5,
+		0xD61DA309, 0x1CC10252, 0xDDCAA6D4, 0x1716078F, 0x4973E563, 0x83AF4438,
+		0x7C796C6A, 0xB6A5CD31, 0xE8C02FDD, 0x221C8E86, 0xE3172A00, 0x29CB8B5B,
+		0x77AE69B7, 0xBD72C8EC, 0x89033813, 0x43DF9948, 0x1DBA7BA4, 0xD766DAFF,
+		0x166D7E79, 0xDCB1DF22, 0x82D43DCE, 0x48089C95, 0xB7DEB4C7, 0x7D02159C,
+		0x2367F770, 0xE9BB562B, 0x28B0F2AD, 0xE26C53F6, 0xBC09B11A, 0x76D51041,
+		0x63F690E1, 0xA92A31BA, 0xF74FD356, 0x3D93720D, 0xFC98D68B, 0x364477D0,
+		0x6821953C, 0xA2FD3467, 0x5D2B1C35, 0x97F7BD6E, 0xC9925F82, 0x034EFED9,
+		0xC2455A5F, 0x0899FB04, 0x56FC19E8, 0x9C20B8B3, 0xA851484C, 0x628DE917,
+		0x3CE80BFB, 0xF634AAA0, 0x373F0E26, 0xFDE3AF7D, 0xA3864D91, 0x695AECCA,
+		0x968CC498, 0x5C5065C3, 0x0235872F, 0xC8E92674, 0x09E282F2, 0xC33E23A9,
+		0x9D5BC145, 0x5787601E, 0x33550079, 0xF989A122, 0xA7EC43CE, 0x6D30E295,
+		0xAC3B4613, 0x66E7E748, 0x388205A4, 0xF25EA4FF, 0x0D888CAD, 0xC7542DF6,
+		0x9931CF1A, 0x53ED6E41, 0x92E6CAC7, 0x583A6B9C, 0x065F8970, 0xCC83282B,
+		0xF8F2D8D4, 0x322E798F, 0x6C4B9B63, 0xA6973A38, 0x679C9EBE, 0xAD403FE5,
+		0xF325DD09, 0x39F97C52, 0xC62F5400, 0x0CF3F55B, 0x529617B7, 0x984AB6EC,
+		0x5941126A, 0x939DB331, 0xCDF851DD, 0x0724F086, 0x12077026, 0xD8DBD17D,
+		0x86BE3391, 0x4C6292CA, 0x8D69364C, 0x47B59717, 0x19D075FB, 0xD30CD4A0,
+		0x2CDAFCF2, 0xE6065DA9, 0xB863BF45, 0x72BF1E1E, 0xB3B4BA98, 0x79681BC3,
+		0x270DF92F, 0xEDD15874, 0xD9A0A88B, 0x137C09D0, 0x4D19EB3C, 0x87C54A67,
+		0x46CEEEE1, 0x8C124FBA, 0xD277AD56, 0x18AB0C0D, 0xE77D245F, 0x2DA18504,
+		0x73C467E8, 0xB918C6B3, 0x78136235, 0xB2CFC36E, 0xECAA2182, 0x267680D9,
+		0x71F1E0C7, 0xBB2D419C, 0xE548A370, 0x2F94022B, 0xEE9FA6AD, 0x244307F6,
+		0x7A26E51A, 0xB0FA4441, 0x4F2C6C13, 0x85F0CD48, 0xDB952FA4, 0x11498EFF,
+		0xD0422A79, 0x1A9E8B22, 0x44FB69CE, 0x8E27C895, 0xBA56386A, 0x708A9931,
+		0x2EEF7BDD, 0xE433DA86, 0x25387E00, 0xEFE4DF5B, 0xB1813DB7, 0x7B5D9CEC,
+		0x848BB4BE, 0x4E5715E5, 0x1032F709, 0xDAEE5652, 0x1BE5F2D4, 0xD139538F,
+		0x8F5CB163, 0x45801038, 0x50A39098, 0x9A7F31C3, 0xC41AD32F, 0x0EC67274,
+		0xCFCDD6F2, 0x051177A9, 0x5B749545, 0x91A8341E, 0x6E7E1C4C, 0xA4A2BD17,
+		0xFAC75FFB, 0x301BFEA0, 0xF1105A26, 0x3BCCFB7D, 0x65A91991, 0xAF75B8CA,
+		0x9B044835, 0x51D8E96E, 0x0FBD0B82, 0xC561AAD9, 0x046A0E5F, 0xCEB6AF04,
+		0x90D34DE8, 0x5A0FECB3, 0xA5D9C4E1, 0x6F0565BA, 0x31608756, 0xFBBC260D,
+		0x3AB7828B, 0xF06B23D0, 0xAE0EC13C, 0x64D26067
+	}
+};
+
+// CRC-32(reflected 0xEDB88320), slicing-by-8
+static const unsigned int crc32lsbtable[8][256] = {
+	{
+		0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+		0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+		0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+		0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+		0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+		0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+		0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+		0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+		0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+		0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+		0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+		0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+		0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+		0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+		0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+		0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+		0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+		0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+		0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+		0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+		0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+		0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+		0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+		0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+		0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+		0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+		0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+		0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+		0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+		0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+		0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+		0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+		0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+		0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+		0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+		0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+		0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+		0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+		0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+		0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+		0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+		0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+		0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+	},
+	{
+		0x00000000, 0x191B3141, 0x32366282, 0x2B2D53C3, 0x646CC504, 0x7D77F445,
+		0x565AA786, 0x4F4196C7, 0xC8D98A08, 0xD1C2BB49, 0xFAEFE88A, 0xE3F4D9CB,
+		0xACB54F0C, 0xB5AE7E4D, 0x9E832D8E, 0x87981CCF, 0x4AC21251, 0x53D92310,
+		0x78F470D3, 0x61EF4192, 0x2EAED755, 0x37B5E614, 0x1C98B5D7, 0x05838496,
+		0x821B9859, 0x9B00A918, 0xB02DFADB, 0xA936CB9A, 0xE6775D5D, 0xFF6C6C1C,
+		0xD4413FDF, 0xCD5A0E9E, 0x958424A2, 0x8C9F15E3, 0xA7B24620, 0xBEA97761,
+		0xF1E8E1A6, 0xE8F3D0E7, 0xC3DE8324, 0xDAC5B265, 0x5D5DAEAA, 0x44469FEB,
+		0x6F6BCC28, 0x7670FD69, 0x39316BAE, 0x202A5AEF, 0x0B07092C, 0x121C386D,
+		0xDF4636F3, 0xC65D07B2, 0xED705471, 0xF46B6530, 0xBB2AF3F7, 0xA231C2B6,
+		0x891C9175, 0x9007A034, 0x179FBCFB, 0x0E848DBA, 0x25A9DE79, 0x3CB2EF38,
+		0x73F379FF, 0x6AE848BE, 0x41C51B7D, 0x58DE2A3C, 0xF0794F05, 0xE9627E44,
+		0xC24F2D87, 0xDB541CC6, 0x94158A01, 0x8D0EBB40, 0xA623E883, 0xBF38D9C2,
+		0x38A0C50D, 0x21BBF44C, 0x0A96A78F, 0x138D96CE, 0x5CCC0009, 0x45D73148,
+		0x6EFA628B, 0x77E153CA, 0xBABB5D54, 0xA3A06C15, 0x888D3FD6, 0x91960E97,
+		0xDED79850, 0xC7CCA911, 0xECE1FAD2, 0xF5FACB93, 0x7262D75C, 0x6B79E61D,
+		0x4054B5DE, 0x594F849F, 0x160E1258, 0x0F152319, 0x243870DA, 0x3D23419B,
+		0x65FD6BA7, 0x7CE65AE6, 0x57CB0925, 0x4ED03864, 0x0191AEA3, 0x188A9FE2,
+		0x33A7CC21, 0x2ABCFD60, 0xAD24E1AF, 0xB43FD0EE, 0x9F12832D, 0x8609B26C,
+		0xC94824AB, 0xD05315EA, 0xFB7E4629, 0xE2657768, 0x2F3F79F6, 0x362448B7,
+		0x1D091B74, 0x04122A35, 0x4B53BCF2, 0x52488DB3, 0x7965DE70, 0x607EEF31,
+		0xE7E6F3FE, 0xFEFDC2BF, 0xD5D0917C, 0xCCCBA03D, 0x838A36FA, 0x9A9107BB,
+		0xB1BC5478, 0xA8A76539, 0x3B83984B, 0x2298A90A, 0x09B5FAC9, 0x10AECB88,
+		0x5FEF5D4F, 0x46F46C0E, 0x6DD93FCD, 0x74C20E8C, 0xF35A1243, 0xEA412302,
+		0xC16C70C1, 0xD8774180, 0x9736D747, 0x8E2DE606, 0xA500B5C5, 0xBC1B8484,
+		0x71418A1A, 0x685ABB5B, 0x4377E898, 0x5A6CD9D9, 0x152D4F1E, 0x0C367E5F,
+		0x271B2D9C, 0x3E001CDD, 0xB9980012, 0xA0833153, 0x8BAE6290, 0x92B553D1,
+		0xDDF4C516, 0xC4EFF457, 0xEFC2A794, 0xF6D996D5, 0xAE07BCE9, 0xB71C8DA8,
+		0x9C31DE6B, 0x852AEF2A, 0xCA6B79ED, 0xD37048AC, 0xF85D1B6F, 0xE1462A2E,
+		0x66DE36E1, 0x7FC507A0, 0x54E85463, 0x4DF36522, 0x02B2F3E5, 0x1BA9C2A4,
+		0x30849167, 0x299FA026, 0xE4C5AEB8, 0xFDDE9FF9, 0xD6F3CC3A, 0xCFE8FD7B,
+		0x80A96BBC, 0x99B25AFD, 0xB29F093E, 0xAB84387F, 0x2C1C24B0, 0x350715F1,
+		0x1E2A4632, 0x07317773, 0x4870E1B4, 0x516BD0F5, 0x7A468336, 0x635DB277,
+		0xCBFAD74E, 0xD2E1E60F, 0xF9CCB5CC, 0xE0D7848D, 0xAF96124A, 0xB68D230B,
+		0x9DA070C8, 0x84BB4189, 0x03235D46, 0x1A386C07, 0x31153FC4, 0x280E0E85,
+		0x674F9842, 0x7E54A903, 0x5579FAC0, 0x4C62CB81, 0x8138C51F, 0x9823F45E,
+		0xB30EA79D, 0xAA1596DC, 0xE554001B, 0xFC4F315A, 0xD7626299, 0xCE7953D8,
+		0x49E14F17, 0x50FA7E56, 0x7BD72D95, 0x62CC1CD4, 0x2D8D8A13, 0x3496BB52,
+		0x1FBBE891, 0x06A0D9D0, 0x5E7EF3EC, 0x4765C2AD, 0x6C48916E, 0x7553A02F,
+		0x3A1236E8, 0x230907A9, 0x0824546A, 0x113F652B, 0x96A779E4, 0x8FBC48A5,
+		0xA4911B66, 0xBD8A2A27, 0xF2CBBCE0, 0xEBD08DA1, 0xC0FDDE62, 0xD9E6EF23,
+		0x14BCE1BD, 0x0DA7D0FC, 0x268A833F, 0x3F91B27E, 0x70D024B9, 0x69CB15F8,
+		0x42E6463B, 0x5BFD777A, 0xDC656BB5, 0xC57E5AF4, 0xEE530937, 0xF7483876,
+		0xB809AEB1, 0xA1129FF0, 0x8A3FCC33, 0x9324FD72
+	},
+	{
+		0x00000000, 0x01C26A37, 0x0384D46E, 0x0246BE59, 0x0709A8DC, 0x06CBC2EB,
+		0x048D7CB2, 0x054F1685, 0x0E1351B8, 0x0FD13B8F, 0x0D9785D6, 0x0C55EFE1,
+		0x091AF964, 0x08D89353, 0x0A9E2D0A, 0x0B5C473D, 0x1C26A370, 0x1DE4C947,
+		0x1FA2771E, 0x1E601D29, 0x1B2F0BAC, 0x1AED619B, 0x18ABDFC2, 0x1969B5F5,
+		0x1235F2C8, 0x13F798FF, 0x11B126A6, 0x10734C91, 0x153C5A14, 0x14FE3023,
+		0x16B88E7A, 0x177AE44D, 0x384D46E0, 0x398F2CD7, 0x3BC9928E, 0x3A0BF8B9,
+		0x3F44EE3C, 0x3E86840B, 0x3CC03A52, 0x3D025065, 0x365E1758, 0x379C7D6F,
+		0x35DAC336, 0x3418A901, 0x3157BF84, 0x3095D5B3, 0x32D36BEA, 0x331101DD,
+		0x246BE590, 0x25A98FA7, 0x27EF31FE, 0x262D5BC9, 0x23624D4C, 0x22A0277B,
+		0x20E69922, 0x2124F315, 0x2A78B428, 0x2BBADE1F, 0x29FC6046, 0x283E0A71,
+		0x2D711CF4, 0x2CB376C3, 0x2EF5C89A, 0x2F37A2AD, 0x709A8DC0, 0x7158E7F7,
+		0x731E59AE, 0x72DC3399, 0x7793251C, 0x76514F2B, 0x7417F172, 0x75D59B45,
+		0x7E89DC78, 0x7F4BB64F, 0x7D0D0816, 0x7CCF6221, 0x798074A4, 0x78421E93,
+		0x7A04A0CA, 0x7BC6CAFD, 0x6CBC2EB0, 0x6D7E4487, 0x6F38FADE, 0x6EFA90E9,
+		0x6BB5866C, 0x6A77EC5B, 0x68315202, 0x69F33835, 0x62AF7F08, 0x636D153F,
+		0x612BAB66, 0x60E9C151, 0x65A6D7D4, 0x6464BDE3, 0x662203BA, 0x67E0698D,
+		0x48D7CB20, 0x4915A117, 0x4B531F4E, 0x4A917579, 0x4FDE63FC, 0x4E1C09CB,
+		0x4C5AB792, 0x4D98DDA5, 0x46C49A98, 0x4706F0AF, 0x45404EF6, 0x448224C1,
+		0x41CD3244, 0x400F5873, 0x4249E62A, 0x438B8C1D, 0x54F16850, 0x55330267,
+		0x5775BC3E, 0x56B7D609, 0x53F8C08C, 0x523AAABB, 0x507C14E2, 0x51BE7ED5,
+		0x5AE239E8, 0x5B2053DF, 0x5966ED86, 0x58A487B1, 0x5DEB9134, 0x5C29FB03,
+		0x5E6F455A, 0x5FAD2F6D, 0xE1351B80, 0xE0F771B7, 0xE2B1CFEE, 0xE373A5D9,
+		0xE63CB35C, 0xE7FED96B, 0xE5B86732, 0xE47A0D05, 0xEF264A38, 0xEEE4200F,
+		0xECA29E56, 0xED60F461, 0xE82FE2E4, 0xE9ED88D3, 0xEBAB368A, 0xEA695CBD,
+		0xFD13B8F0, 0xFCD1D2C7, 0xFE976C9E, 0xFF5506A9, 0xFA1A102C, 0xFBD87A1B,
+		0xF99EC442, 0xF85CAE75, 0xF300E948, 0xF2C2837F, 0xF0843D26, 0xF1465711,
+		0xF4094194, 0xF5CB2BA3, 0xF78D95FA, 0xF64FFFCD, 0xD9785D60, 0xD8BA3757,
+		0xDAFC890E, 0xDB3EE339, 0xDE71F5BC, 0xDFB39F8B, 0xDDF521D2, 0xDC374BE5,
+		0xD76B0CD8, 0xD6A966EF, 0xD4EFD8B6, 0xD52DB281, 0xD062A404, 0xD1A0CE33,
+		0xD3E6706A, 0xD2241A5D, 0xC55EFE10, 0xC49C9427, 0xC6DA2A7E, 0xC7184049,
+		0xC25756CC, 0xC3953CFB, 0xC1D382A2, 0xC011E895, 0xCB4DAFA8, 0xCA8FC59F,
+		0xC8C97BC6, 0xC90B11F1, 0xCC440774, 0xCD866D43, 0xCFC0D31A, 0xCE02B92D,
+		0x91AF9640, 0x906DFC77, 0x922B422E, 0x93E92819, 0x96A63E9C, 0x976454AB,
+		0x9522EAF2, 0x94E080C5, 0x9FBCC7F8, 0x9E7EADCF, 0x9C381396, 0x9DFA79A1,
+		0x98B56F24, 0x99770513, 0x9B31BB4A, 0x9AF3D17D, 0x8D893530, 0x8C4B5F07,
+		0x8E0DE15E, 0x8FCF8B69, 0x8A809DEC, 0x8B42F7DB, 0x89044982, 0x88C623B5,
+		0x839A6488, 0x82580EBF, 0x801EB0E6, 0x81DCDAD1, 0x8493CC54, 0x8551A663,
+		0x8717183A, 0x86D5720D, 0xA9E2D0A0, 0xA820BA97, 0xAA6604CE, 0xABA46EF9,
+		0xAEEB787C, 0xAF29124B, 0xAD6FAC12, 0xACADC625, 0xA7F18118, 0xA633EB2F,
+		0xA4755576, 0xA5B73F41, 0xA0F829C4, 0xA13A43F3, 0xA37CFDAA, 0xA2BE979D,
+		0xB5C473D0, 0xB40619E7, 0xB640A7BE, 0xB782CD89, 0xB2CDDB0C, 0xB30FB13B,
+		0xB1490F62, 0xB08B6555, 0xBBD72268, 0xBA15485F, 0xB853F606, 0xB9919C31,
+		0xBCDE8AB4, 0xBD1CE083, 0xBF5A5EDA, 0xBE9834ED
+	},
+	{
+		0x00000000, 0xB8BC6765, 0xAA09C88B, 0x12B5AFEE, 0x8F629757, 0x37DEF032,
+		0x256B5FDC, 0x9DD738B9, 0xC5B428EF, 0x7D084F8A, 0x6FBDE064, 0xD7018701,
+		0x4AD6BFB8, 0xF26AD8DD, 0xE0DF7733, 0x58631056, 0x5019579F, 0xE8A530FA,
+		0xFA109F14, 0x42ACF871, 0xDF7BC0C8, 0x67C7A7AD, 0x75720843, 0xCDCE6F26,
+		0x95AD7F70, 0x2D111815, 0x3FA4B7FB, 0x8718D09E, 0x1ACFE827, 0xA2738F42,
+		0xB0C620AC, 0x087A47C9, 0xA032AF3E, 0x188EC85B, 0x0A3B67B5, 0xB28700D0,
+		0x2F503869, 0x97EC5F0C, 0x8559F0E2, 0x3DE59787, 0x658687D1, 0xDD3AE0B4,
+		0xCF8F4F5A, 0x7733283F, 0xEAE41086, 0x525877E3, 0x40EDD80D, 0xF851BF68,
+		0xF02BF8A1, 0x48979FC4, 0x5A22302A, 0xE29E574F, 0x7F496FF6, 0xC7F50893,
+		0xD540A77D, 0x6DFCC018, 0x359FD04E, 0x8D23B72B, 0x9F9618C5, 0x272A7FA0,
+		0xBAFD4719, 0x0241207C, 0x10F48F92, 0xA848E8F7, 0x9B14583D, 0x23A83F58,
+		0x311D90B6, 0x89A1F7D3, 0x1476CF6A, 0xACCAA80F, 0xBE7F07E1, 0x06C36084,
+		0x5EA070D2, 0xE61C17B7, 0xF4A9B859, 0x4C15DF3C, 0xD1C2E785, 0x697E80E0,
+		0x7BCB2F0E, 0xC377486B, 0xCB0D0FA2, 0x73B168C7, 0x6104C729, 0xD9B8A04C,
+		0x446F98F5, 0xFCD3FF90, 0xEE66507E, 0x56DA371B, 0x0EB9274D, 0xB6054028,
+		0xA4B0EFC6, 0x1C0C88A3, 0x81DBB01A, 0x3967D77F, 0x2BD27891, 0x936E1FF4,
+		0x3B26F703, 0x839A9066, 0x912F3F88, 0x299358ED, 0xB4446054, 0x0CF80731,
+		0x1E4DA8DF, 0xA6F1CFBA, 0xFE92DFEC, 0x462EB889, 0x549B1767, 0xEC277002,
+		0x71F048BB, 0xC94C2FDE, 0xDBF98030, 0x6345E755, 0x6B3FA09C, 0xD383C7F9,
+		0xC1366817, 0x798A0F72, 0xE45D37CB, 0x5CE150AE, 0x4E54FF40, 0xF6E89825,
+		0xAE8B8873, 0x1637EF16, 0x048240F8, 0xBC3E279D, 0x21E91F24, 0x99557841,
+		0x8BE0D7AF, 0x335CB0CA, 0xED59B63B, 0x55E5D15E, 0x47507EB0, 0xFFEC19D5,
+		0x623B216C, 0xDA874609, 0xC832E9E7, 0x708E8E82, 0x28ED9ED4, 0x9051F9B1,
+		0x82E4565F, 0x3A58313A, 0xA78F0983, 0x1F336EE6, 0x0D86C108, 0xB53AA66D,
+		0xBD40E1A4, 0x05FC86C1, 0x1749292F, 0xAFF54E4A, 0x322276F3, 0x8A9E1196,
+		0x982BBE78, 0x2097D91D, 0x78F4C94B, 0xC048AE2E, 0xD2FD01C0, 0x6A4166A5,
+		0xF7965E1C, 0x4F2A3979, 0x5D9F9697, 0xE523F1F2, 0x4D6B1905, 0xF5D77E60,
+		0xE762D18E, 0x5FDEB6EB, 0xC2098E52, 0x7AB5E937, 0x680046D9, 0xD0BC21BC,
+		0x88DF31EA, 0x3063568F, 0x22D6F961, 0x9A6A9E04, 0x07BDA6BD, 0xBF01C1D8,
+		0xADB46E36, 0x15080953, 0x1D724E9A, 0xA5CE29FF, 0xB77B8611, 0x0FC7E174,
+		0x9210D9CD, 0x2AACBEA8, 0x38191146, 0x80A57623, 0xD8C66675, 0x607A0110,
+		0x72CFAEFE, 0xCA73C99B, 0x57A4F122, 0xEF189647, 0xFDAD39A9, 0x45115ECC,
+		0x764DEE06, 0xCEF18963, 0xDC44268D, 0x64F841E8, 0xF92F7951, 0x41931E34,
+		0x5326B1DA, 0xEB9AD6BF, 0xB3F9C6E9, 0x0B45A18C, 0x19F00E62, 0xA14C6907,
+		0x3C9B51BE, 0x842736DB, 0x96929935, 0x2E2EFE50, 0x2654B999, 0x9EE8DEFC,
+		0x8C5D7112, 0x34E11677, 0xA9362ECE, 0x118A49AB, 0x033FE645, 0xBB838120,
+		0xE3E09176, 0x5B5CF613, 0x49E959FD, 0xF1553E98, 0x6C820621, 0xD43E6144,
+		0xC68BCEAA, 0x7E37A9CF, 0xD67F4138, 0x6EC3265D, 0x7C7689B3, 0xC4CAEED6,
+		0x591DD66F, 0xE1A1B10A, 0xF3141EE4, 0x4BA87981, 0x13CB69D7, 0xAB770EB2,
+		0xB9C2A15C, 0x017EC639, 0x9CA9FE80, 0x241599E5, 0x36A0360B, 0x8E1C516E,
+		0x866616A7, 0x3EDA71C2, 0x2C6FDE2C, 0x94D3B949, 0x090481F0, 0xB1B8E695,
+		0xA30D497B, 0x1BB12E1E, 0x43D23E48, 0xFB6E592D, 0xE9DBF6C3, 0x516791A6,
+		0xCCB0A91F, 0x740CCE7A, 0x66B96194, 0xDE0506F1
+	},
+	{
+		0x00000000, 0x3D6029B0, 0x7AC05360, 0x47A07AD0, 0xF580A6C0, 0xC8E08F70,
+		0x8F40F5A0, 0xB220DC10, 0x30704BC1, 0x0D106271, 0x4AB018A1, 0x77D03111,
+		0xC5F0ED01, 0xF890C4B1, 0xBF30BE61, 0x825097D1, 0x60E09782, 0x5D80BE32,
+		0x1A20C4E2, 0x2740ED52, 0x95603142, 0xA80018F2, 0xEFA06222, 0xD2C04B92,
+		0x5090DC43, 0x6DF0F5F3, 0x2A508F23, 0x1730A693, 0xA5107A83, 0x98705333,
+		0xDFD029E3, 0xE2B00053, 0xC1C12F04, 0xFCA106B4, 0xBB017C64, 0x866155D4,
+		0x344189C4, 0x0921A074, 0x4E81DAA4, 0x73E1F314, 0xF1B164C5, 0xCCD14D75,
+		0x8B7137A5, 0xB6111E15, 0x0431C205, 0x3951EBB5, 0x7EF19165, 0x4391B8D5,
+		0xA121B886, 0x9C419136, 0xDBE1EBE6, 0xE681C256, 0x54A11E46, 0x69C137F6,
+		0x2E614D26, 0x13016496, 0x9151F347, 0xAC31DAF7, 0xEB91A027, 0xD6F18997,
+		0x64D15587, 0x59B17C37, 0x1E1106E7, 0x23712F57, 0x58F35849, 0x659371F9,
+		0x22330B29, 0x1F532299, 0xAD73FE89, 0x9013D739, 0xD7B3ADE9, 0xEAD38459,
+		0x68831388, 0x55E33A38, 0x124340E8, 0x2F236958, 0x9D03B548, 0xA0639CF8,
+		0xE7C3E628, 0xDAA3CF98, 0x3813CFCB, 0x0573E67B, 0x42D39CAB, 0x7FB3B51B,
+		0xCD93690B, 0xF0F340BB, 0xB7533A6B, 0x8A3313DB, 0x0863840A, 0x3503ADBA,
+		0x72A3D76A, 0x4FC3FEDA, 0xFDE322CA, 0xC0830B7A, 0x872371AA, 0xBA43581A,
+		0x9932774D, 0xA4525EFD, 0xE3F2242D, 0xDE920D9D, 0x6CB2D18D, 0x51D2F83D,
+		0x167282ED, 0x2B12AB5D, 0xA9423C8C, 0x9422153C, 0xD3826FEC, 0xEEE2465C,
+		0x5CC29A4C, 0x61A2B3FC, 0x2602C92C, 0x1B62E09C, 0xF9D2E0CF, 0xC4B2C97F,
+		0x8312B3AF, 0xBE729A1F, 0x0C52460F, 0x31326FBF, 0x7692156F, 0x4BF23CDF,
+		0xC9A2AB0E, 0xF4C282BE, 0xB362F86E, 0x8E02D1DE, 0x3C220DCE, 0x0142247E,
+		0x46E25EAE, 0x7B82771E, 0xB1E6B092, 0x8C869922, 0xCB26E3F2, 0xF646CA42,
+		0x44661652, 0x79063FE2, 0x3EA64532, 0x03C66C82, 0x8196FB53, 0xBCF6D2E3,
+		0xFB56A833, 0xC6368183, 0x74165D93, 0x49767423, 0x0ED60EF3, 0x33B62743,
+		0xD1062710, 0xEC660EA0, 0xABC67470, 0x96A65DC0, 0x248681D0, 0x19E6A860,
+		0x5E46D2B0, 0x6326FB00, 0xE1766CD1, 0xDC164561, 0x9BB63FB1, 0xA6D61601,
+		0x14F6CA11, 0x2996E3A1, 0x6E369971, 0x5356B0C1, 0x70279F96, 0x4D47B626,
+		0x0AE7CCF6, 0x3787E546, 0x85A73956, 0xB8C710E6, 0xFF676A36, 0xC2074386,
+		0x4057D457, 0x7D37FDE7, 0x3A978737, 0x07F7AE87, 0xB5D77297, 0x88B75B27,
+		0xCF1721F7, 0xF2770847, 0x10C70814, 0x2DA721A4, 0x6A075B74, 0x576772C4,
+		0xE547AED4, 0xD8278764, 0x9F87FDB4, 0xA2E7D404, 0x20B743D5, 0x1DD76A65,
+		0x5A7710B5, 0x67173905, 0xD537E515, 0xE857CCA5, 0xAFF7B675, 0x92979FC5,
+		0xE915E8DB, 0xD475C16B, 0x93D5BBBB, 0xAEB5920B, 0x1C954E1B, 0x21F567AB,
+		0x66551D7B, 0x5B3534CB, 0xD965A31A, 0xE4058AAA, 0xA3A5F07A, 0x9EC5D9CA,
+		0x2CE505DA, 0x11852C6A, 0x562556BA, 0x6B457F0A, 0x89F57F59, 0xB49556E9,
+		0xF3352C39, 0xCE550589, 0x7C75D999, 0x4115F029, 0x06B58AF9, 0x3BD5A349,
+		0xB9853498, 0x84E51D28, 0xC34567F8, 0xFE254E48, 0x4C059258, 0x7165BBE8,
+		0x36C5C138, 0x0BA5E888, 0x28D4C7DF, 0x15B4EE6F, 0x521494BF, 0x6F74BD0F,
+		0xDD54611F, 0xE03448AF, 0xA794327F, 0x9AF41BCF, 0x18A48C1E, 0x25C4A5AE,
+		0x6264DF7E, 0x5F04F6CE, 0xED242ADE, 0xD044036E, 0x97E479BE, 0xAA84500E,
+		0x4834505D, 0x755479ED, 0x32F4033D, 0x0F942A8D, 0xBDB4F69D, 0x80D4DF2D,
+		0xC774A5FD, 0xFA148C4D, 0x78441B9C, 0x4524322C, 0x028448FC, 0x3FE4614C,
+		0x8DC4BD5C, 0xB0A494EC, 0xF704EE3C, 0xCA64C78C
+	},
+	{
+		0x00000000, 0xCB5CD3A5, 0x4DC8A10B, 0x869472AE, 0x9B914216, 0x50CD91B3,
+		0xD659E31D, 0x1D0530B8, 0xEC53826D, 0x270F51C8, 0xA19B2366, 0x6AC7F0C3,
+		0x77C2C07B, 0xBC9E13DE, 0x3A0A6170, 0xF156B2D5, 0x03D6029B, 0xC88AD13E,
+		0x4E1EA390, 0x85427035, 0x9847408D, 0x531B9328, 0xD58FE186, 0x1ED33223,
+		0xEF8580F6, 0x24D95353, 0xA24D21FD, 0x6911F258, 0x7414C2E0, 0xBF481145,
+		0x39DC63EB, 0xF280B04E, 0x07AC0536, 0xCCF0D693, 0x4A64A43D, 0x81387798,
+		0x9C3D4720, 0x57619485, 0xD1F5E62B, 0x1AA9358E, 0xEBFF875B, 0x20A354FE,
+		0xA6372650, 0x6D6BF5F5, 0x706EC54D, 0xBB3216E8, 0x3DA66446, 0xF6FAB7E3,
+		0x047A07AD, 0xCF26D408, 0x49B2A6A6, 0x82EE7503, 0x9FEB45BB, 0x54B7961E,
+		0xD223E4B0, 0x197F3715, 0xE82985C0, 0x23755665, 0xA5E124CB, 0x6EBDF76E,
+		0x73B8C7D6, 0xB8E41473, 0x3E7066DD, 0xF52CB578, 0x0F580A6C, 0xC404D9C9,
+		0x4290AB67, 0x89CC78C2, 0x94C9487A, 0x5F959BDF, 0xD901E971, 0x125D3AD4,
+		0xE30B8801, 0x28575BA4, 0xAEC3290A, 0x659FFAAF, 0x789ACA17, 0xB3C619B2,
+		0x35526B1C, 0xFE0EB8B9, 0x0C8E08F7, 0xC7D2DB52, 0x4146A9FC, 0x8A1A7A59,
+		0x971F4AE1, 0x5C439944, 0xDAD7EBEA, 0x118B384F, 0xE0DD8A9A, 0x2B81593F,
+		0xAD152B91, 0x6649F834, 0x7B4CC88C, 0xB0101B29, 0x36846987, 0xFDD8BA22,
+		0x08F40F5A, 0xC3A8DCFF, 0x453CAE51, 0x8E607DF4, 0x93654D4C, 0x58399EE9,
+		0xDEADEC47, 0x15F13FE2, 0xE4A78D37, 0x2FFB5E92, 0xA96F2C3C, 0x6233FF99,
+		0x7F36CF21, 0xB46A1C84, 0x32FE6E2A, 0xF9A2BD8F, 0x0B220DC1, 0xC07EDE64,
+		0x46EAACCA, 0x8DB67F6F, 0x90B34FD7, 0x5BEF9C72, 0xDD7BEEDC, 0x16273D79,
+		0xE7718FAC, 0x2C2D5C09, 0xAAB92EA7, 0x61E5FD02, 0x7CE0CDBA, 0xB7BC1E1F,
+		0x31286CB1, 0xFA74BF14, 0x1EB014D8, 0xD5ECC77D, 0x5378B5D3, 0x98246676,
+		0x852156CE, 0x4E7D856B, 0xC8E9F7C5, 0x03B52460, 0xF2E396B5, 0x39BF4510,
+		0xBF2B37BE, 0x7477E41B, 0x6972D4A3, 0xA22E0706, 0x24BA75A8, 0xEFE6A60D,
+		0x1D661643, 0xD63AC5E6, 0x50AEB748, 0x9BF264ED, 0x86F75455, 0x4DAB87F0,
+		0xCB3FF55E, 0x006326FB, 0xF135942E, 0x3A69478B, 0xBCFD3525, 0x77A1E680,
+		0x6AA4D638, 0xA1F8059D, 0x276C7733, 0xEC30A496, 0x191C11EE, 0xD240C24B,
+		0x54D4B0E5, 0x9F886340, 0x828D53F8, 0x49D1805D, 0xCF45F2F3, 0x04192156,
+		0xF54F9383, 0x3E134026, 0xB8873288, 0x73DBE12D, 0x6EDED195, 0xA5820230,
+		0x2316709E, 0xE84AA33B, 0x1ACA1375, 0xD196C0D0, 0x5702B27E, 0x9C5E61DB,
+		0x815B5163, 0x4A0782C6, 0xCC93F068, 0x07CF23CD, 0xF6999118, 0x3DC542BD,
+		0xBB513013, 0x700DE3B6, 0x6D08D30E, 0xA65400AB, 0x20C07205, 0xEB9CA1A0,
+		0x11E81EB4, 0xDAB4CD11, 0x5C20BFBF, 0x977C6C1A, 0x8A795CA2, 0x41258F07,
+		0xC7B1FDA9, 0x0CED2E0C, 0xFDBB9CD9, 0x36E74F7C, 0xB0733DD2, 0x7B2FEE77,
+		0x662ADECF, 0xAD760D6A, 0x2BE27FC4, 0xE0BEAC61, 0x123E1C2F, 0xD962CF8A,
+		0x5FF6BD24, 0x94AA6E81, 0x89AF5E39, 0x42F38D9C, 0xC467FF32, 0x0F3B2C97,
+		0xFE6D9E42, 0x35314DE7, 0xB3A53F49, 0x78F9ECEC, 0x65FCDC54, 0xAEA00FF1,
+		0x28347D5F, 0xE368AEFA, 0x16441B82, 0xDD18C827, 0x5B8CBA89, 0x90D0692C,
+		0x8DD55994, 0x46898A31, 0xC01DF89F, 0x0B412B3A, 0xFA1799EF, 0x314B4A4A,
+		0xB7DF38E4, 0x7C83EB41, 0x6186DBF9, 0xAADA085C, 0x2C4E7AF2, 0xE712A957,
+		0x15921919, 0xDECECABC, 0x585AB812, 0x93066BB7, 0x8E035B0F, 0x455F88AA,
+		0xC3CBFA04, 0x089729A1, 0xF9C19B74, 0x329D48D1, 0xB4093A7F, 0x7F55E9DA,
+		0x6250D962, 0xA90C0AC7, 0x2F987869, 0xE4C4ABCC
+	},
+	{
+		0x00000000, 0xA6770BB4, 0x979F1129, 0x31E81A9D, 0xF44F2413, 0x52382FA7,
+		0x63D0353A, 0xC5A73E8E, 0x33EF4E67, 0x959845D3, 0xA4705F4E, 0x020754FA,
+		0xC7A06A74, 0x61D761C0, 0x503F7B5D, 0xF64870E9, 0x67DE9CCE, 0xC1A9977A,
+		0xF0418DE7, 0x56368653, 0x9391B8DD, 0x35E6B369, 0x040EA9F4, 0xA279A240,
+		0x5431D2A9, 0xF246D91D, 0xC3AEC380, 0x65D9C834, 0xA07EF6BA, 0x0609FD0E,
+		0x37E1E793, 0x9196EC27, 0xCFBD399C, 0x69CA3228, 0x582228B5, 0xFE552301,
+		0x3BF21D8F, 0x9D85163B, 0xAC6D0CA6, 0x0A1A0712, 0xFC5277FB, 0x5A257C4F,
+		0x6BCD66D2, 0xCDBA6D66, 0x081D53E8, 0xAE6A585C, 0x9F8242C1, 0x39F54975,
+		0xA863A552, 0x0E14AEE6, 0x3FFCB47B, 0x998BBFCF, 0x5C2C8141, 0xFA5B8AF5,
+		0xCBB39068, 0x6DC49BDC, 0x9B8CEB35, 0x3DFBE081, 0x0C13FA1C, 0xAA64F1A8,
+		0x6FC3CF26, 0xC9B4C492, 0xF85CDE0F, 0x5E2BD5BB, 0x440B7579, 0xE27C7ECD,
+		0xD3946450, 0x75E36FE4, 0xB044516A, 0x16335ADE, 0x27DB4043, 0x81AC4BF7,
+		0x77E43B1E, 0xD19330AA, 0xE07B2A37, 0x460C2183, 0x83AB1F0D, 0x25DC14B9,
+		0x14340E24, 0xB2430590, 0x23D5E9B7, 0x85A2E203, 0xB44AF89E, 0x123DF32A,
+		0xD79ACDA4, 0x71EDC610, 0x4005DC8D, 0xE672D739, 0x103AA7D0, 0xB64DAC64,
+		0x87A5B6F9, 0x21D2BD4D, 0xE47583C3, 0x42028877, 0x73EA92EA, 0xD59D995E,
+		0x8BB64CE5, 0x2DC14751, 0x1C295DCC, 0xBA5E5678, 0x7FF968F6, 0xD98E6342,
+		0xE86679DF, 0x4E11726B, 0xB8590282, 0x1E2E0936, 0x2FC613AB, 0x89B1181F,
+		0x4C162691, 0xEA612D25, 0xDB8937B8, 0x7DFE3C0C, 0xEC68D02B, 0x4A1FDB9F,
+		0x7BF7C102, 0xDD80CAB6, 0x1827F438, 0xBE50FF8C, 0x8FB8E511, 0x29CFEEA5,
+		0xDF879E4C, 0x79F095F8, 0x48188F65, 0xEE6F84D1, 0x2BC8BA5F, 0x8DBFB1EB,
+		0xBC57AB76, 0x1A20A0C2, 0x8816EAF2, 0x2E61E146, 0x1F89FBDB, 0xB9FEF06F,
+		0x7C59CEE1, 0xDA2EC555, 0xEBC6DFC8, 0x4DB1D47C, 0xBBF9A495, 0x1D8EAF21,
+		0x2C66B5BC, 0x8A11BE08, 0x4FB68086, 0xE9C18B32, 0xD82991AF, 0x7E5E9A1B,
+		0xEFC8763C, 0x49BF7D88, 0x78576715, 0xDE206CA1, 0x1B87522F, 0xBDF0599B,
+		0x8C184306, 0x2A6F48B2, 0xDC27385B, 0x7A5033EF, 0x4BB82972, 0xEDCF22C6,
+		0x28681C48, 0x8E1F17FC, 0xBFF70D61, 0x198006D5, 0x47ABD36E, 0xE1DCD8DA,
+		0xD034C247, 0x7643C9F3, 0xB3E4F77D, 0x1593FCC9, 0x247BE654, 0x820CEDE0,
+		0x74449D09, 0xD23396BD, 0xE3DB8C20, 0x45AC8794, 0x800BB91A, 0x267CB2AE,
+		0x1794A833, 0xB1E3A387, 0x20754FA0, 0x86024414, 0xB7EA5E89, 0x119D553D,
+		0xD43A6BB3, 0x724D6007, 0x43A57A9A, 0xE5D2712E, 0x139A01C7, 0xB5ED0A73,
+		0x840510EE, 0x22721B5A, 0xE7D525D4, 0x41A22E60, 0x704A34FD, 0xD63D3F49,
+		0xCC1D9F8B, 0x6A6A943F, 0x5B828EA2, 0xFDF58516, 0x3852BB98, 0x9E25B02C,
+		0xAFCDAAB1, 0x09BAA105, 0xFFF2D1EC, 0x5985DA58, 0x686DC0C5, 0xCE1ACB71,
+		0x0BBDF5FF, 0xADCAFE4B, 0x9C22E4D6, 0x3A55EF62, 0xABC30345, 0x0DB408F1,
+		0x3C5C126C, 0x9A2B19D8, 0x5F8C2756, 0xF9FB2CE2, 0xC813367F, 0x6E643DCB,
+		0x982C4D22, 0x3E5B4696, 0x0FB35C0B, 0xA9C457BF, 0x6C636931, 0xCA146285,
+		0xFBFC7818, 0x5D8B73AC, 0x03A0A617, 0xA5D7ADA3, 0x943FB73E, 0x3248BC8A,
+		0xF7EF8204, 0x519889B0, 0x6070932D, 0xC6079899, 0x304FE870, 0x9638E3C4,
+		0xA7D0F959, 0x01A7F2ED, 0xC400CC63, 0x6277C7D7, 0x539FDD4A, 0xF5E8D6FE,
+		0x647E3AD9, 0xC209316D, 0xF3E12BF0, 0x55962044, 0x90311ECA, 0x3646157E,
+		0x07AE0FE3, 0xA1D90457, 0x579174BE, 0xF1E67F0A, 0xC00E6597, 0x66796E23,
+		0xA3DE50AD, 0x05A95B19, 0x34414184, 0x92364A30
+	},
+	{
+		0x00000000, 0xCCAA009E, 0x4225077D, 0x8E8F07E3, 0x844A0EFA, 0x48E00E64,
+		0xC66F0987, 0x0AC50919, 0xD3E51BB5, 0x1F4F1B2B, 0x91C01CC8, 0x5D6A1C56,
+		0x57AF154F, 0x9B0515D1, 0x158A1232, 0xD92012AC, 0x7CBB312B, 0xB01131B5,
+		0x3E9E3656, 0xF23436C8, 0xF8F13FD1, 0x345B3F4F, 0xBAD438AC, 0x767E3832,
+		0xAF5E2A9E, 0x63F42A00, 0xED7B2DE3, 0x21D12D7D, 0x2B142464, 0xE7BE24FA,
+		0x69312319, 0xA59B2387, 0xF9766256, 0x35DC62C8, 0xBB53652B, 0x77F965B5,
+		0x7D3C6CAC, 0xB1966C32, 0x3F196BD1, 0xF3B36B4F, 0x2A9379E3, 0xE639797D,
+		0x68B67E9E, 0xA41C7E00, 0xAED97719, 0x62737787, 0xECFC7064, 0x205670FA,
+		0x85CD537D, 0x496753E3, 0xC7E85400, 0x0B42549E, 0x01875D87, 0xCD2D5D19,
+		0x43A25AFA, 0x8F085A64, 0x562848C8, 0x9A824856, 0x140D4FB5, 0xD8A74F2B,
+		0xD2624632, 0x1EC846AC, 0x9047414F, 0x5CED41D1, 0x299DC2ED, 0xE537C273,
+		0x6BB8C590, 0xA712C50E, 0xADD7CC17, 0x617DCC89, 0xEFF2CB6A, 0x2358CBF4,
+		0xFA78D958, 0x36D2D9C6, 0xB85DDE25, 0x74F7DEBB, 0x7E32D7A2, 0xB298D73C,
+		0x3C17D0DF, 0xF0BDD041, 0x5526F3C6, 0x998CF358, 0x1703F4BB, 0xDBA9F425,
+		0xD16CFD3C, 0x1DC6FDA2, 0x9349FA41, 0x5FE3FADF, 0x86C3E873, 0x4A69E8ED,
+		0xC4E6EF0E, 0x084CEF90, 0x0289E689, 0xCE23E617, 0x40ACE1F4, 0x8C06E16A,
+		0xD0EBA0BB, 0x1C41A025, 0x92CEA7C6, 0x5E64A758, 0x54A1AE41, 0x980BAEDF,
+		0x1684A93C, 0xDA2EA9A2, 0x030EBB0E, 0xCFA4BB90, 0x412BBC73, 0x8D81BCED,
+		0x8744B5F4, 0x4BEEB56A, 0xC561B289, 0x09CBB217, 0xAC509190, 0x60FA910E,
+		0xEE7596ED, 0x22DF9673, 0x281A9F6A, 0xE4B09FF4, 0x6A3F9817, 0xA6959889,
+		0x7FB58A25, 0xB31F8ABB, 0x3D908D58, 0xF13A8DC6, 0xFBFF84DF, 0x37558441,
+		0xB9DA83A2, 0x7570833C, 0x533B85DA, 0x9F918544, 0x111E82A7, 0xDDB48239,
+		0xD7718B20, 0x1BDB8BBE, 0x95548C5D, 0x59FE8CC3, 0x80DE9E6F, 0x4C749EF1,
+		0xC2FB9912, 0x0E51998C, 0x04949095, 0xC83E900B, 0x46B197E8, 0x8A1B9776,
+		0x2F80B4F1, 0xE32AB46F, 0x6DA5B38C, 0xA10FB312, 0xABCABA0B, 0x6760BA95,
+		0xE9EFBD76, 0x2545BDE8, 0xFC65AF44, 0x30CFAFDA, 0xBE40A839, 0x72EAA8A7,
+		0x782FA1BE, 0xB485A120, 0x3A0AA6C3, 0xF6A0A65D, 0xAA4DE78C, 0x66E7E712,
+		0xE868E0F1, 0x24C2E06F, 0x2E07E976, 0xE2ADE9E8, 0x6C22EE0B, 0xA088EE95,
+		0x79A8FC39, 0xB502FCA7, 0x3B8DFB44, 0xF727FBDA, 0xFDE2F2C3, 0x3148F25D,
+		0xBFC7F5BE, 0x736DF520, 0xD6F6D6A7, 0x1A5CD639, 0x94D3D1DA, 0x5879D144,
+		0x52BCD85D, 0x9E16D8C3, 0x1099DF20, 0xDC33DFBE, 0x0513CD12, 0xC9B9CD8C,
+		0x4736CA6F, 0x8B9CCAF1, 0x8159C3E8, 0x4DF3C376, 0xC37CC495, 0x0FD6C40B,
+		0x7AA64737, 0xB60C47A9, 0x3883404A, 0xF42940D4, 0xFEEC49CD, 0x32464953,
+		0xBCC94EB0, 0x70634E2E, 0xA9435C82, 0x65E95C1C, 0xEB665BFF, 0x27CC5B61,
+		0x2D095278, 0xE1A352E6, 0x6F2C5505, 0xA386559B, 0x061D761C, 0xCAB77682,
+		0x44387161, 0x889271FF, 0x825778E6, 0x4EFD7878, 0xC0727F9B, 0x0CD87F05,
+		0xD5F86DA9, 0x19526D37, 0x97DD6AD4, 0x5B776A4A, 0x51B26353, 0x9D1863CD,
+		0x1397642E, 0xDF3D64B0, 0x83D02561, 0x4F7A25FF, 0xC1F5221C, 0x0D5F2282,
+		0x079A2B9B, 0xCB302B05, 0x45BF2CE6, 0x89152C78, 0x50353ED4, 0x9C9F3E4A,
+		0x121039A9, 0xDEBA3937, 0xD47F302E, 0x18D530B0, 0x965A3753, 0x5AF037CD,
+		0xFF6B144A, 0x33C114D4, 0xBD4E1337, 0x71E413A9, 0x7B211AB0, 0xB78B1A2E,
+		0x39041DCD, 0xF5AE1D53, 0x2C8E0FFF, 0xE0240F61, 0x6EAB0882, 0xA201081C,
+		0xA8C40105, 0x646E019B, 0xEAE10678, 0x264B06E6
+	}
+};
+
+// x^(2^n) mod P(x), n = 0 ~ 31, CRC-32(reflected)
+static const unsigned int crc32x2ntable[32] = {
+	0x40000000, 0x20000000, 0x08000000, 0x00800000, 0x00008000, 0xEDB88320,
+	0xB1E6B092, 0xA06A2517, 0xED627DAE, 0x88D14467, 0xD7BBFE6A, 0xEC447F11,
+	0x8E7EA170, 0x6427800E, 0x4D47BAE0, 0x09FE548F, 0x83852D0F, 0x30362F1A,
+	0x7B5A9CC3, 0x31FEC169, 0x9FEC022A, 0x6C8DEDC4, 0x15D6874D, 0x5FDE7A4E,
+	0xBAD90E37, 0x2E4E5EEF, 0x4EABA214, 0xA8A472C0, 0x429A969E, 0x148D302A,
+	0xC40BA6D0, 0xC4E22C3C
 };
 
 static unsigned int crc32msbtable[256];
-static unsigned int crc32lsbtable[256];
 
 typedef struct _crc_polynomial_t
 {
@@ -112,40 +832,236 @@ unsigned int crc32_msb(unsigned int crc, const unsigned char *buffer, unsigned i
 // http://www.w3.org/TR/PNG/#D-CRCAppendix
 void crc32_lsb_init(void)
 {
-	int val, i;
-	unsigned int rem;
+	// crc32lsbtable is generated at compile time
+}
 
-	for(val = 0; val < 256; val++)
+#define CRC32_LOAD32(p) ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+
+static uint32_t crc32_slicing8(const unsigned int table[8][256], uint32_t crc, const unsigned char* p, size_t n)
+{
+	uint32_t hi;
+
+	for (; n >= 8; n -= 8, p += 8)
 	{
-		rem = val;
-		for(i = 0; i < 8; i++)
-		{
-			if(rem & 0x00000001)
-				rem = (rem >> 1) ^ 0xEDB88320L;
-			else
-				rem >>= 1;
-		}
+		crc ^= CRC32_LOAD32(p);
+		hi = CRC32_LOAD32(p + 4);
+		crc = table[7][crc & 0xFF] ^ table[6][(crc >> 8) & 0xFF] ^ table[5][(crc >> 16) & 0xFF] ^ table[4][crc >> 24]
+			^ table[3][hi & 0xFF] ^ table[2][(hi >> 8) & 0xFF] ^ table[1][(hi >> 16) & 0xFF] ^ table[0][hi >> 24];
+	}
+
+	for (; n > 0; n--, p++)
+		crc = table[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+#if defined(CRC32_HW_X86) || defined(CRC32_HW_ARM)
+// bit-reflected domain constants: k1 = x^(4*128+32) mod P, k2 = x^(4*128-32) mod P,
+// k3 = x^(128+32) mod P, k4 = x^(128-32) mod P, k5 = x^64 mod P, P, u = x^64 / P
+static const uint64_t s_crc32_k1k2[2] = { 0x0154442bd4, 0x01c6e41596 };
+static const uint64_t s_crc32_k3k4[2] = { 0x01751997d0, 0x00ccaa009e };
+static const uint64_t s_crc32_k5k0[2] = { 0x0163cd6124, 0x0000000000 };
+static const uint64_t s_crc32_poly[2] = { 0x01db710641, 0x01f7011641 };
+#endif
+
+#if defined(CRC32_HW_X86)
+/// @param[in] n bytes, n >= 64 and n % 16 == 0
+static uint32_t CRC32_HW_TARGET crc32_hw_fold(uint32_t crc, const unsigned char* p, size_t n)
+{
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+	x2 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+	x3 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+	x4 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	x0 = _mm_loadu_si128((const __m128i*)s_crc32_k1k2);
+	p += 64;
+	n -= 64;
+
+	// fold 4 x 128-bits in parallel
+	for (; n >= 64; n -= 64, p += 64)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		y5 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+		y6 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+		y7 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+		y8 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+	}
+
+	// fold into 128-bits
+	x0 = _mm_loadu_si128((const __m128i*)s_crc32_k3k4);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
 
-		crc32lsbtable[val] = rem;
+	for (; n >= 16; n -= 16, p += 16)
+	{
+		x2 = _mm_loadu_si128((const __m128i*)p);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
 	}
+
+	// fold 128-bits to 64-bits
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x0 = _mm_loadl_epi64((const __m128i*)s_crc32_k5k0);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32-bits
+	x0 = _mm_loadu_si128((const __m128i*)s_crc32_poly);
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return (uint32_t)_mm_extract_epi32(x1, 1);
 }
 
-unsigned int crc32_lsb(unsigned int crc, const unsigned char *buffer, unsigned int size)  
+#elif defined(CRC32_HW_ARM)
+// _mm_clmulepi64_si128(a, b, imm): a[imm & 1] * b[(imm >> 4) & 1]
+#define CRC32_CLMUL(a, b, i, j) vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, i), (poly64_t)vgetq_lane_u64(b, j)))
+
+/// @param[in] n bytes, n >= 64 and n % 16 == 0
+static uint32_t CRC32_HW_TARGET crc32_hw_fold(uint32_t crc, const unsigned char* p, size_t n)
 {
-	unsigned int i;
+	uint64x2_t x0, x1, x2, x3, x4, y1, y2, y3, y4;
+	const uint64x2_t zero = vdupq_n_u64(0);
 
-	for (i = 0; i < size; i++) {
-		crc = crc32lsbtable[(crc ^ buffer[i]) & 0xff] ^ (crc >> 8);  
-	} 
-	return crc ^ 0xFFFFFFFF;
+	x1 = vld1q_u64((const uint64_t*)(p + 0x00));
+	x2 = vld1q_u64((const uint64_t*)(p + 0x10));
+	x3 = vld1q_u64((const uint64_t*)(p + 0x20));
+	x4 = vld1q_u64((const uint64_t*)(p + 0x30));
+	x1 = veorq_u64(x1, vreinterpretq_u64_u32(vsetq_lane_u32(crc, vdupq_n_u32(0), 0)));
+	x0 = vld1q_u64(s_crc32_k1k2);
+	p += 64;
+	n -= 64;
+
+	// fold 4 x 128-bits in parallel
+	for (; n >= 64; n -= 64, p += 64)
+	{
+		y1 = vld1q_u64((const uint64_t*)(p + 0x00));
+		y2 = vld1q_u64((const uint64_t*)(p + 0x10));
+		y3 = vld1q_u64((const uint64_t*)(p + 0x20));
+		y4 = vld1q_u64((const uint64_t*)(p + 0x30));
+		x1 = veorq_u64(veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), CRC32_CLMUL(x1, x0, 1, 1)), y1);
+		x2 = veorq_u64(veorq_u64(CRC32_CLMUL(x2, x0, 0, 0), CRC32_CLMUL(x2, x0, 1, 1)), y2);
+		x3 = veorq_u64(veorq_u64(CRC32_CLMUL(x3, x0, 0, 0), CRC32_CLMUL(x3, x0, 1, 1)), y3);
+		x4 = veorq_u64(veorq_u64(CRC32_CLMUL(x4, x0, 0, 0), CRC32_CLMUL(x4, x0, 1, 1)), y4);
+	}
+
+	// fold into 128-bits
+	x0 = vld1q_u64(s_crc32_k3k4);
+	x1 = veorq_u64(veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), CRC32_CLMUL(x1, x0, 1, 1)), x2);
+	x1 = veorq_u64(veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), CRC32_CLMUL(x1, x0, 1, 1)), x3);
+	x1 = veorq_u64(veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), CRC32_CLMUL(x1, x0, 1, 1)), x4);
+
+	for (; n >= 16; n -= 16, p += 16)
+		x1 = veorq_u64(veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), CRC32_CLMUL(x1, x0, 1, 1)), vld1q_u64((const uint64_t*)p));
+
+	// fold 128-bits to 64-bits
+	x2 = CRC32_CLMUL(x1, x0, 0, 1);
+	x3 = vreinterpretq_u64_u32(vsetq_lane_u32(~0U, vsetq_lane_u32(~0U, vdupq_n_u32(0), 0), 2));
+	x1 = veorq_u64(vextq_u64(x1, zero, 1), x2);
+	x0 = vld1q_u64(s_crc32_k5k0);
+	x2 = vreinterpretq_u64_u8(vextq_u8(vreinterpretq_u8_u64(x1), vreinterpretq_u8_u64(zero), 4));
+	x1 = vandq_u64(x1, x3);
+	x1 = veorq_u64(CRC32_CLMUL(x1, x0, 0, 0), x2);
+
+	// Barrett reduction to 32-bits
+	x0 = vld1q_u64(s_crc32_poly);
+	x2 = vandq_u64(x1, x3);
+	x2 = CRC32_CLMUL(x2, x0, 0, 1);
+	x2 = vandq_u64(x2, x3);
+	x2 = CRC32_CLMUL(x2, x0, 0, 0);
+	x1 = veorq_u64(x1, x2);
+	return vgetq_lane_u32(vreinterpretq_u32_u64(x1), 1);
 }
+#endif
 
-unsigned int crc32(unsigned int crc, const unsigned char *buffer, unsigned int size)  
-{  
-	unsigned int i;
+static uint32_t crc32_lsb_raw(uint32_t crc, const unsigned char* p, size_t n)
+{
+#if defined(CRC32_HW_X86) || defined(CRC32_HW_ARM)
+	size_t bytes;
+#if defined(CRC32_HW_X86)
+	if (n >= 64 && (CPU_FEATURE_PCLMUL | CPU_FEATURE_SSE41) == (cpu_features() & (CPU_FEATURE_PCLMUL | CPU_FEATURE_SSE41)))
+#else
+	if (n >= 64 && (cpu_features() & CPU_FEATURE_PMULL))
+#endif
+	{
+		bytes = n & ~(size_t)15;
+		crc = crc32_hw_fold(crc, p, bytes);
+		p += bytes;
+		n -= bytes;
+	}
+#endif
+	return crc32_slicing8(crc32lsbtable, crc, p, n);
+}
 
-	for (i = 0; i < size; i++) {
-		crc = crc32table[(crc ^ buffer[i]) & 0xff] ^ (crc >> 8);  
-	}  
-	return crc ;  
+unsigned int crc32_lsb(unsigned int crc, const unsigned char *buffer, unsigned int size)
+{
+	return crc32_lsb_raw(crc, buffer, size) ^ 0xFFFFFFFF;
+}
+
+unsigned int crc32_lsb_update(unsigned int crc, const void* data, size_t bytes)
+{
+	return crc32_lsb_raw(crc ^ 0xFFFFFFFF, (const unsigned char*)data, bytes) ^ 0xFFFFFFFF;
+}
+
+// a * b mod P(x), reflected
+static uint32_t crc32_multmodp(uint32_t a, uint32_t b)
+{
+	uint32_t m, p;
+	for (p = 0, m = (uint32_t)1 << 31; m; m >>= 1)
+	{
+		if (a & m)
+		{
+			p ^= b;
+			if (0 == (a & (m - 1)))
+				break;
+		}
+		b = (b & 1) ? (b >> 1) ^ 0xEDB88320 : b >> 1;
+	}
+	return p;
+}
+
+unsigned int crc32_lsb_combine(unsigned int crc1, unsigned int crc2, uint64_t bytes2)
+{
+	int k;
+	uint32_t p;
+
+	// p = x^(8 * bytes2) mod P(x)
+	p = (uint32_t)1 << 31; // x^0
+	for (k = 3; bytes2; bytes2 >>= 1, k++)
+	{
+		if (bytes2 & 1)
+			p = crc32_multmodp(crc32x2ntable[k & 31], p);
+	}
+	return crc32_multmodp(p, crc1) ^ crc2;
+}
+
+unsigned int crc32(unsigned int crc, const unsigned char *buffer, unsigned int size)
+{
+	return crc32_slicing8(crc32table, crc, buffer, size);
 }
@@ -0,0 +1,501 @@
+// SHA-1/SHA-256 hardware acceleration with runtime cpu dispatch
+// 1. x86/x64: SHA-NI(SHA1RNDS4/SHA256RNDS2), AVX2 8-lanes multi-buffer
+// 2. ARMv8: crypto extension(SHA1C/SHA256H)
+// Intel SHA Extensions: https://www.intel.com/content/dam/develop/external/us/en/documents/intel-sha-extensions-white-paper.pdf
+
+#include "sha.h"
+#include "sha-hw.h"
+#include "sys/cpu.h"
+#include <string.h>
+
+#if defined(CPU_X86)
+	#define SHA_HW_X86
+	#define SHA_HW_NI (CPU_FEATURE_SHA | CPU_FEATURE_SSSE3 | CPU_FEATURE_SSE41)
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#define SHA_HW_TARGET(x)
+	#else
+		#define SHA_HW_TARGET(x) __attribute__((target(x)))
+	#endif
+#elif defined(CPU_ARM64)
+	#define SHA_HW_ARM
+	#include <arm_neon.h>
+	#if defined(_MSC_VER)
+		#define SHA_HW_TARGET(x)
+	#elif defined(__clang__)
+		#define SHA_HW_TARGET(x) __attribute__((target("crypto")))
+	#else
+		#define SHA_HW_TARGET(x) __attribute__((target("+crypto")))
+	#endif
+#endif
+
+
+static const uint32_t SHA1_K[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6 };
+
+static const uint32_t SHA256_K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t sha_hw_be32(const uint8_t* p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+#if defined(SHA_HW_X86)
+
+// message schedule(i: 4-rounds group index, 0~19)
+// msg[i&3] current 4 words, e[i&1] current E
+#define SHA1_NI_ROUNDS4(i) \
+	e[(i) & 1] = (i) ? _mm_sha1nexte_epu32(e[(i) & 1], msg[(i) & 3]) : _mm_add_epi32(e[0], msg[0]); \
+	if ((i) >= 3 && (i) <= 18) msg[((i) + 1) & 3] = _mm_sha1msg2_epu32(msg[((i) + 1) & 3], msg[(i) & 3]); \
+	e[((i) + 1) & 1] = abcd; \
+	abcd = _mm_sha1rnds4_epu32(abcd, e[(i) & 1], (i) / 5); \
+	if ((i) >= 1 && (i) <= 16) msg[((i) + 3) & 3] = _mm_sha1msg1_epu32(msg[((i) + 3) & 3], msg[(i) & 3]); \
+	if ((i) >= 2 && (i) <= 17) msg[((i) + 2) & 3] = _mm_xor_si128(msg[((i) + 2) & 3], msg[(i) & 3])
+
+static void SHA_HW_TARGET("sha,sse4.1,ssse3") sha1_shani(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+	int i;
+	__m128i abcd, abcd0, e0, e[2], msg[4];
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+	e[0] = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+	for (; blocks > 0; blocks--, data += 64)
+	{
+		abcd0 = abcd;
+		e0 = e[0];
+		for (i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16)), mask);
+
+		SHA1_NI_ROUNDS4(0); SHA1_NI_ROUNDS4(1); SHA1_NI_ROUNDS4(2); SHA1_NI_ROUNDS4(3);
+		SHA1_NI_ROUNDS4(4); SHA1_NI_ROUNDS4(5); SHA1_NI_ROUNDS4(6); SHA1_NI_ROUNDS4(7);
+		SHA1_NI_ROUNDS4(8); SHA1_NI_ROUNDS4(9); SHA1_NI_ROUNDS4(10); SHA1_NI_ROUNDS4(11);
+		SHA1_NI_ROUNDS4(12); SHA1_NI_ROUNDS4(13); SHA1_NI_ROUNDS4(14); SHA1_NI_ROUNDS4(15);
+		SHA1_NI_ROUNDS4(16); SHA1_NI_ROUNDS4(17); SHA1_NI_ROUNDS4(18); SHA1_NI_ROUNDS4(19);
+
+		e[0] = _mm_sha1nexte_epu32(e[0], e0);
+		abcd = _mm_add_epi32(abcd, abcd0);
+	}
+
+	_mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = (uint32_t)_mm_extract_epi32(e[0], 3);
+}
+
+// i: 4-rounds group index, 0~15
+#define SHA256_NI_ROUNDS4(i) \
+	m = _mm_add_epi32(msg[(i) & 3], _mm_loadu_si128((const __m128i*)&SHA256_K[(i) * 4])); \
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, m); \
+	if ((i) >= 3 && (i) <= 14) { \
+		t = _mm_alignr_epi8(msg[(i) & 3], msg[((i) + 3) & 3], 4); \
+		msg[((i) + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(msg[((i) + 1) & 3], t), msg[(i) & 3]); \
+	} \
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(m, 0x0E)); \
+	if ((i) >= 1 && (i) <= 12) msg[((i) + 3) & 3] = _mm_sha256msg1_epu32(msg[((i) + 3) & 3], msg[(i) & 3])
+
+static void SHA_HW_TARGET("sha,sse4.1,ssse3") sha256_shani(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+	int i;
+	__m128i abef, cdgh, abef0, cdgh0, m, t, msg[4];
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1); // CDAB
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B); // EFGH
+	abef = _mm_alignr_epi8(t, cdgh, 8); // ABEF
+	cdgh = _mm_blend_epi16(cdgh, t, 0xF0); // CDGH
+
+	for (; blocks > 0; blocks--, data += 64)
+	{
+		abef0 = abef;
+		cdgh0 = cdgh;
+		for (i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16)), mask);
+
+		SHA256_NI_ROUNDS4(0); SHA256_NI_ROUNDS4(1); SHA256_NI_ROUNDS4(2); SHA256_NI_ROUNDS4(3);
+		SHA256_NI_ROUNDS4(4); SHA256_NI_ROUNDS4(5); SHA256_NI_ROUNDS4(6); SHA256_NI_ROUNDS4(7);
+		SHA256_NI_ROUNDS4(8); SHA256_NI_ROUNDS4(9); SHA256_NI_ROUNDS4(10); SHA256_NI_ROUNDS4(11);
+		SHA256_NI_ROUNDS4(12); SHA256_NI_ROUNDS4(13); SHA256_NI_ROUNDS4(14); SHA256_NI_ROUNDS4(15);
+
+		abef = _mm_add_epi32(abef, abef0);
+		cdgh = _mm_add_epi32(cdgh, cdgh0);
+	}
+
+	t = _mm_shuffle_epi32(abef, 0x1B); // FEBA
+	cdgh = _mm_shuffle_epi32(cdgh, 0xB1); // DCHG
+	_mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(t, cdgh, 0xF0)); // DCBA
+	_mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(cdgh, t, 8)); // HGFE
+}
+
+#define SHA_X8_ROTL(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define SHA_X8_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define SHA_X8_LOAD(data, i) _mm256_set_epi32((int)sha_hw_be32(data[7] + (i) * 4), (int)sha_hw_be32(data[6] + (i) * 4), (int)sha_hw_be32(data[5] + (i) * 4), (int)sha_hw_be32(data[4] + (i) * 4), \
+	(int)sha_hw_be32(data[3] + (i) * 4), (int)sha_hw_be32(data[2] + (i) * 4), (int)sha_hw_be32(data[1] + (i) * 4), (int)sha_hw_be32(data[0] + (i) * 4))
+
+/// 8 independent messages, one 64-bytes block per lane
+static void SHA_HW_TARGET("avx2") sha1_avx2_x8(uint32_t state[8][8], const uint8_t* data[8])
+{
+	int t, lane;
+	uint32_t out[8];
+	__m256i W[16], S[5], a, b, c, d, e, f, k, temp;
+
+	for (t = 0; t < 5; t++)
+		S[t] = _mm256_set_epi32((int)state[7][t], (int)state[6][t], (int)state[5][t], (int)state[4][t], (int)state[3][t], (int)state[2][t], (int)state[1][t], (int)state[0][t]);
+	for (t = 0; t < 16; t++)
+		W[t] = SHA_X8_LOAD(data, t);
+
+	a = S[0]; b = S[1]; c = S[2]; d = S[3]; e = S[4];
+	for (t = 0; t < 80; t++)
+	{
+		if (t >= 16)
+		{
+			temp = _mm256_xor_si256(_mm256_xor_si256(W[(t - 3) & 15], W[(t - 8) & 15]), _mm256_xor_si256(W[(t - 14) & 15], W[t & 15]));
+			W[t & 15] = SHA_X8_ROTL(temp, 1);
+		}
+
+		if (t < 20)
+			f = _mm256_xor_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d)); // Ch
+		else if (t < 40 || t >= 60)
+			f = _mm256_xor_si256(_mm256_xor_si256(b, c), d); // Parity
+		else
+			f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c))); // Maj
+
+		k = _mm256_set1_epi32((int)SHA1_K[t / 20]);
+		temp = _mm256_add_epi32(_mm256_add_epi32(SHA_X8_ROTL(a, 5), f), _mm256_add_epi32(_mm256_add_epi32(e, W[t & 15]), k));
+		e = d;
+		d = c;
+		c = SHA_X8_ROTL(b, 30);
+		b = a;
+		a = temp;
+	}
+
+	S[0] = _mm256_add_epi32(S[0], a);
+	S[1] = _mm256_add_epi32(S[1], b);
+	S[2] = _mm256_add_epi32(S[2], c);
+	S[3] = _mm256_add_epi32(S[3], d);
+	S[4] = _mm256_add_epi32(S[4], e);
+	for (t = 0; t < 5; t++)
+	{
+		_mm256_storeu_si256((__m256i*)out, S[t]);
+		for (lane = 0; lane < 8; lane++)
+			state[lane][t] = out[lane];
+	}
+}
+
+/// 8 independent messages, one 64-bytes block per lane
+static void SHA_HW_TARGET("avx2") sha256_avx2_x8(uint32_t state[8][8], const uint8_t* data[8])
+{
+	int t, lane;
+	uint32_t out[8];
+	__m256i W[16], S[8], v[8], s0, s1, t1, t2;
+
+	for (t = 0; t < 8; t++)
+	{
+		S[t] = _mm256_set_epi32((int)state[7][t], (int)state[6][t], (int)state[5][t], (int)state[4][t], (int)state[3][t], (int)state[2][t], (int)state[1][t], (int)state[0][t]);
+		v[t] = S[t];
+	}
+	for (t = 0; t < 16; t++)
+		W[t] = SHA_X8_LOAD(data, t);
+
+	for (t = 0; t < 64; t++)
+	{
+		if (t >= 16)
+		{
+			s0 = W[(t - 15) & 15];
+			s0 = _mm256_xor_si256(_mm256_xor_si256(SHA_X8_ROTR(s0, 7), SHA_X8_ROTR(s0, 18)), _mm256_srli_epi32(s0, 3));
+			s1 = W[(t - 2) & 15];
+			s1 = _mm256_xor_si256(_mm256_xor_si256(SHA_X8_ROTR(s1, 17), SHA_X8_ROTR(s1, 19)), _mm256_srli_epi32(s1, 10));
+			W[t & 15] = _mm256_add_epi32(_mm256_add_epi32(W[t & 15], s0), _mm256_add_epi32(W[(t - 7) & 15], s1));
+		}
+
+		// v: a, b, c, d, e, f, g, h
+		s1 = _mm256_xor_si256(_mm256_xor_si256(SHA_X8_ROTR(v[4], 6), SHA_X8_ROTR(v[4], 11)), SHA_X8_ROTR(v[4], 25));
+		t1 = _mm256_xor_si256(_mm256_and_si256(v[4], v[5]), _mm256_andnot_si256(v[4], v[6])); // Ch
+		t1 = _mm256_add_epi32(_mm256_add_epi32(v[7], s1), _mm256_add_epi32(t1, _mm256_add_epi32(W[t & 15], _mm256_set1_epi32((int)SHA256_K[t]))));
+		s0 = _mm256_xor_si256(_mm256_xor_si256(SHA_X8_ROTR(v[0], 2), SHA_X8_ROTR(v[0], 13)), SHA_X8_ROTR(v[0], 22));
+		t2 = _mm256_or_si256(_mm256_and_si256(v[0], v[1]), _mm256_and_si256(v[2], _mm256_or_si256(v[0], v[1]))); // Maj
+		t2 = _mm256_add_epi32(s0, t2);
+
+		v[7] = v[6];
+		v[6] = v[5];
+		v[5] = v[4];
+		v[4] = _mm256_add_epi32(v[3], t1);
+		v[3] = v[2];
+		v[2] = v[1];
+		v[1] = v[0];
+		v[0] = _mm256_add_epi32(t1, t2);
+	}
+
+	for (t = 0; t < 8; t++)
+	{
+		_mm256_storeu_si256((__m256i*)out, _mm256_add_epi32(S[t], v[t]));
+		for (lane = 0; lane < 8; lane++)
+			state[lane][t] = out[lane];
+	}
+}
+
+#elif defined(SHA_HW_ARM)
+
+#define SHA_ARM_BE(v) vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(v)))
+
+// i: 4-rounds group index, 0~19
+// tmp[i&1] = W + K of the current group, e[i&1] current E
+#define SHA1_ARM_ROUNDS4(i, op) \
+	e[((i) + 1) & 1] = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+	abcd = op(abcd, e[(i) & 1], tmp[(i) & 1]); \
+	if ((i) + 2 <= 19) tmp[(i) & 1] = vaddq_u32(msg[((i) + 2) & 3], vdupq_n_u32(SHA1_K[((i) + 2) / 5])); \
+	if ((i) >= 1 && (i) <= 16) msg[((i) + 3) & 3] = vsha1su1q_u32(msg[((i) + 3) & 3], msg[((i) + 2) & 3]); \
+	if ((i) <= 15) msg[(i) & 3] = vsha1su0q_u32(msg[(i) & 3], msg[((i) + 1) & 3], msg[((i) + 2) & 3])
+
+static void SHA_HW_TARGET("crypto") sha1_armv8(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+	int i;
+	uint32_t e0, e[2];
+	uint32x4_t abcd, abcd0, tmp[2], msg[4];
+
+	abcd = vld1q_u32(state);
+	e[0] = state[4];
+
+	for (; blocks > 0; blocks--, data += 64)
+	{
+		abcd0 = abcd;
+		e0 = e[0];
+		for (i = 0; i < 4; i++)
+			msg[i] = SHA_ARM_BE(vld1q_u32((const uint32_t*)(data + i * 16)));
+		tmp[0] = vaddq_u32(msg[0], vdupq_n_u32(SHA1_K[0]));
+		tmp[1] = vaddq_u32(msg[1], vdupq_n_u32(SHA1_K[0]));
+
+		SHA1_ARM_ROUNDS4(0, vsha1cq_u32); SHA1_ARM_ROUNDS4(1, vsha1cq_u32); SHA1_ARM_ROUNDS4(2, vsha1cq_u32); SHA1_ARM_ROUNDS4(3, vsha1cq_u32); SHA1_ARM_ROUNDS4(4, vsha1cq_u32);
+		SHA1_ARM_ROUNDS4(5, vsha1pq_u32); SHA1_ARM_ROUNDS4(6, vsha1pq_u32); SHA1_ARM_ROUNDS4(7, vsha1pq_u32); SHA1_ARM_ROUNDS4(8, vsha1pq_u32); SHA1_ARM_ROUNDS4(9, vsha1pq_u32);
+		SHA1_ARM_ROUNDS4(10, vsha1mq_u32); SHA1_ARM_ROUNDS4(11, vsha1mq_u32); SHA1_ARM_ROUNDS4(12, vsha1mq_u32); SHA1_ARM_ROUNDS4(13, vsha1mq_u32); SHA1_ARM_ROUNDS4(14, vsha1mq_u32);
+		SHA1_ARM_ROUNDS4(15, vsha1pq_u32); SHA1_ARM_ROUNDS4(16, vsha1pq_u32); SHA1_ARM_ROUNDS4(17, vsha1pq_u32); SHA1_ARM_ROUNDS4(18, vsha1pq_u32); SHA1_ARM_ROUNDS4(19, vsha1pq_u32);
+
+		e[0] += e0;
+		abcd = vaddq_u32(abcd, abcd0);
+	}
+
+	vst1q_u32(state, abcd);
+	state[4] = e[0];
+}
+
+// i: 4-rounds group index, 0~15
+// tmp[i&1] = W + K of the current group
+#define SHA256_ARM_ROUNDS4(i) \
+	if ((i) < 12) msg[(i) & 3] = vsha256su0q_u32(msg[(i) & 3], msg[((i) + 1) & 3]); \
+	t = abcd; \
+	if ((i) < 15) tmp[((i) + 1) & 1] = vaddq_u32(msg[((i) + 1) & 3], vld1q_u32(&SHA256_K[((i) + 1) * 4])); \
+	abcd = vsha256hq_u32(abcd, efgh, tmp[(i) & 1]); \
+	efgh = vsha256h2q_u32(efgh, t, tmp[(i) & 1]); \
+	if ((i) < 12) msg[(i) & 3] = vsha256su1q_u32(msg[(i) & 3], msg[((i) + 2) & 3], msg[((i) + 3) & 3])
+
+static void SHA_HW_TARGET("crypto") sha256_armv8(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+	int i;
+	uint32x4_t abcd, efgh, abcd0, efgh0, t, tmp[2], msg[4];
+
+	abcd = vld1q_u32(&state[0]);
+	efgh = vld1q_u32(&state[4]);
+
+	for (; blocks > 0; blocks--, data += 64)
+	{
+		abcd0 = abcd;
+		efgh0 = efgh;
+		for (i = 0; i < 4; i++)
+			msg[i] = SHA_ARM_BE(vld1q_u32((const uint32_t*)(data + i * 16)));
+		tmp[0] = vaddq_u32(msg[0], vld1q_u32(&SHA256_K[0]));
+
+		SHA256_ARM_ROUNDS4(0); SHA256_ARM_ROUNDS4(1); SHA256_ARM_ROUNDS4(2); SHA256_ARM_ROUNDS4(3);
+		SHA256_ARM_ROUNDS4(4); SHA256_ARM_ROUNDS4(5); SHA256_ARM_ROUNDS4(6); SHA256_ARM_ROUNDS4(7);
+		SHA256_ARM_ROUNDS4(8); SHA256_ARM_ROUNDS4(9); SHA256_ARM_ROUNDS4(10); SHA256_ARM_ROUNDS4(11);
+		SHA256_ARM_ROUNDS4(12); SHA256_ARM_ROUNDS4(13); SHA256_ARM_ROUNDS4(14); SHA256_ARM_ROUNDS4(15);
+
+		abcd = vaddq_u32(abcd, abcd0);
+		efgh = vaddq_u32(efgh, efgh0);
+	}
+
+	vst1q_u32(&state[0], abcd);
+	vst1q_u32(&state[4], efgh);
+}
+
+#endif
+
+sha_hw_blocks sha1_hw(void)
+{
+#if defined(SHA_HW_X86)
+	return SHA_HW_NI == (cpu_features() & SHA_HW_NI) ? sha1_shani : NULL;
+#elif defined(SHA_HW_ARM)
+	return (cpu_features() & CPU_FEATURE_SHA1) ? sha1_armv8 : NULL;
+#else
+	return NULL;
+#endif
+}
+
+sha_hw_blocks sha256_hw(void)
+{
+#if defined(SHA_HW_X86)
+	return SHA_HW_NI == (cpu_features() & SHA_HW_NI) ? sha256_shani : NULL;
+#elif defined(SHA_HW_ARM)
+	return (cpu_features() & CPU_FEATURE_SHA2) ? sha256_armv8 : NULL;
+#else
+	return NULL;
+#endif
+}
+
+#if defined(SHA_HW_X86)
+static const uint32_t SHA256_H0[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const uint32_t SHA1_H0[5] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+typedef void (*sha_hw_blocks_x8)(uint32_t state[8][8], const uint8_t* data[8]);
+
+struct sha_hw_lane_t
+{
+	int index; // message index, -1-idle
+	const uint8_t* msg;
+	size_t blocks; // message full blocks
+	size_t total; // message full blocks + padding blocks
+	size_t block; // current block
+	uint8_t tail[128]; // last partial block + padding
+};
+
+static void sha_hw_lane_init(struct sha_hw_lane_t* lane, int index, const uint8_t* msg, unsigned int bytes)
+{
+	uint64_t bits;
+	size_t n, i;
+
+	n = bytes % 64;
+	bits = (uint64_t)bytes * 8;
+	lane->index = index;
+	lane->msg = msg;
+	lane->blocks = bytes / 64;
+	lane->total = lane->blocks + (n + 9 <= 64 ? 1 : 2);
+	lane->block = 0;
+
+	memset(lane->tail, 0, sizeof(lane->tail));
+	memcpy(lane->tail, msg + lane->blocks * 64, n);
+	lane->tail[n] = 0x80;
+	n = (lane->total - lane->blocks) * 64;
+	for (i = 0; i < 8; i++)
+		lane->tail[n - 1 - i] = (uint8_t)(bits >> (8 * i));
+}
+
+static const uint8_t* sha_hw_lane_block(struct sha_hw_lane_t* lane)
+{
+	return lane->block < lane->blocks ? lane->msg + lane->block * 64 : lane->tail + (lane->block - lane->blocks) * 64;
+}
+
+/// hash messages in 8 lanes, an idle lane is refilled with the next message
+static void sha_hw_multi_buffer(sha_hw_blocks_x8 x8, const uint32_t* H0, int words, const uint8_t* messages[], const unsigned int lengths[], int n, uint8_t* digests, int hashsize)
+{
+	int i, j, next, active;
+	uint32_t state[8][8];
+	const uint8_t* data[8];
+	struct sha_hw_lane_t lanes[8];
+
+	memset(state, 0, sizeof(state));
+	for (next = active = i = 0; i < 8; i++)
+	{
+		lanes[i].index = -1;
+		if (next < n)
+		{
+			sha_hw_lane_init(&lanes[i], next, messages[next], lengths[next]);
+			memcpy(state[i], H0, words * sizeof(uint32_t));
+			next++;
+			active++;
+		}
+	}
+
+	while (active > 0)
+	{
+		for (i = 0; i < 8; i++)
+			data[i] = lanes[i].index >= 0 ? sha_hw_lane_block(&lanes[i]) : lanes[0].tail; // idle lane: dummy block
+		x8(state, data);
+
+		for (i = 0; i < 8; i++)
+		{
+			if (lanes[i].index < 0 || ++lanes[i].block < lanes[i].total)
+				continue;
+
+			for (j = 0; j < hashsize; j++)
+				digests[lanes[i].index * hashsize + j] = (uint8_t)(state[i][j >> 2] >> (8 * (3 - (j & 0x03))));
+
+			lanes[i].index = -1;
+			active--;
+			if (next < n)
+			{
+				sha_hw_lane_init(&lanes[i], next, messages[next], lengths[next]);
+				memcpy(state[i], H0, words * sizeof(uint32_t));
+				next++;
+				active++;
+			}
+		}
+	}
+}
+#endif
+
+int SHA1MultiBuffer(const uint8_t* messages[], const unsigned int lengths[], int n, uint8_t digests[][SHA1HashSize])
+{
+	int i, r;
+	SHA1Context ctx;
+
+	if (!messages || !lengths || !digests || n < 0)
+		return shaNull;
+
+#if defined(SHA_HW_X86)
+	// SHA-NI single buffer is faster than AVX2 8-lanes
+	if (!sha1_hw() && (cpu_features() & CPU_FEATURE_AVX2))
+	{
+		sha_hw_multi_buffer(sha1_avx2_x8, SHA1_H0, 5, messages, lengths, n, &digests[0][0], SHA1HashSize);
+		return shaSuccess;
+	}
+#endif
+
+	for (i = 0; i < n; i++)
+	{
+		r = SHA1Reset(&ctx);
+		r = shaSuccess == r ? SHA1Input(&ctx, messages[i], lengths[i]) : r;
+		r = shaSuccess == r ? SHA1Result(&ctx, digests[i]) : r;
+		if (shaSuccess != r)
+			return r;
+	}
+	return shaSuccess;
+}
+
+int SHA256MultiBuffer(const uint8_t* messages[], const unsigned int lengths[], int n, uint8_t digests[][SHA256HashSize])
+{
+	int i, r;
+	SHA256Context ctx;
+
+	if (!messages || !lengths || !digests || n < 0)
+		return shaNull;
+
+#if defined(SHA_HW_X86)
+	// SHA-NI single buffer is faster than AVX2 8-lanes
+	if (!sha256_hw() && (cpu_features() & CPU_FEATURE_AVX2))
+	{
+		sha_hw_multi_buffer(sha256_avx2_x8, SHA256_H0, 8, messages, lengths, n, &digests[0][0], SHA256HashSize);
+		return shaSuccess;
+	}
+#endif
+
+	for (i = 0; i < n; i++)
+	{
+		r = SHA256Reset(&ctx);
+		r = shaSuccess == r ? SHA256Input(&ctx, messages[i], lengths[i]) : r;
+		r = shaSuccess == r ? SHA256Result(&ctx, digests[i]) : r;
+		if (shaSuccess != r)
+			return r;
+	}
+	return shaSuccess;
+}
@@ -0,0 +1,15 @@
+#ifndef _sha_hw_h_
+#define _sha_hw_h_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// process 64-bytes message blocks
+/// @param[in,out] state SHA-1: 5 words, SHA-256: 8 words(Intermediate_Hash)
+typedef void (*sha_hw_blocks)(uint32_t* state, const uint8_t* data, size_t blocks);
+
+/// @return hardware block function(SHA-NI/ARMv8 crypto extension), NULL if cpu don't support
+sha_hw_blocks sha1_hw(void);
+sha_hw_blocks sha256_hw(void);
+
+#endif /* !_sha_hw_h_ */
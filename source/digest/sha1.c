@@ -34,6 +34,8 @@
 */
 
 #include "sha.h"
+#include "sha-hw.h"
+#include <string.h>
 
 /*
 * These definitions are defined in FIPS 180-3, section 4.1.
@@ -63,14 +65,16 @@
 * Add "length" to the length.
 * Set Corrupted when overflow has occurred.
 */
-static uint32_t addTemp;
-#define SHA1AddLength(context, length) \
-		(addTemp = (context)->Length_Low, \
-		(context)->Corrupted = \
-			(((context)->Length_Low += (length)) < addTemp) && \
-			(++(context)->Length_High == 0) ? shaInputTooLong : (context)->Corrupted )
+static int SHA1AddLength(SHA1Context *context, uint32_t length)
+{
+	uint32_t addTemp = context->Length_Low;
+	if (((context->Length_Low += length) < addTemp) && (++context->Length_High == 0))
+		context->Corrupted = shaInputTooLong;
+	return context->Corrupted;
+}
 
 /* Local Function Prototypes */
+static sha_hw_blocks SHA1Blocks(void);
 static void SHA1ProcessMessageBlock(SHA1Context *context);
 static void SHA1Finalize(SHA1Context *context, uint8_t Pad_Byte);
 static void SHA1PadMessage(SHA1Context *context, uint8_t Pad_Byte);
@@ -128,18 +132,33 @@ int SHA1Reset(SHA1Context *context)
 */
 int SHA1Input(SHA1Context *context, const uint8_t *message_array, unsigned int length)
 {
+	unsigned int n;
 	if (!context) return shaNull;
 	if (!length) return shaSuccess;
 	if (!message_array) return shaNull;
 	if (context->Computed) return context->Corrupted = shaStateError;
 	if (context->Corrupted) return context->Corrupted;
-	while (length--) {
-		context->Message_Block[context->Message_Block_Index++] =
-			*message_array;
-		if ((SHA1AddLength(context, 8) == shaSuccess) &&
-			(context->Message_Block_Index == SHA1_Message_Block_Size))
-			SHA1ProcessMessageBlock(context);
-		message_array++;
+	while (length > 0) {
+		if (0 == context->Message_Block_Index && length >= SHA1_Message_Block_Size) {
+			/* hash whole blocks in place, bit count fits in 32 bits */
+			n = length / SHA1_Message_Block_Size;
+			n = n < 0x7FFFFF ? n : 0x7FFFFF;
+			if (SHA1AddLength(context, n * SHA1_Message_Block_Size * 8) != shaSuccess)
+				break;
+			SHA1Blocks()(context->Intermediate_Hash, message_array, n);
+			n *= SHA1_Message_Block_Size;
+		} else {
+			n = SHA1_Message_Block_Size - context->Message_Block_Index;
+			n = n < length ? n : length;
+			memcpy(context->Message_Block + context->Message_Block_Index, message_array, n);
+			context->Message_Block_Index += n;
+			if (SHA1AddLength(context, n * 8) != shaSuccess)
+				break;
+			if (context->Message_Block_Index == SHA1_Message_Block_Size)
+				SHA1ProcessMessageBlock(context);
+		}
+		message_array += n;
+		length -= n;
 	}
 	return context->Corrupted;
 }
@@ -223,15 +242,19 @@ int SHA1Result(SHA1Context *context, uint8_t Message_Digest[SHA1HashSize])
 }
 
 /*
-* SHA1ProcessMessageBlock
+* SHA1ProcessBlocks
 *
 * Description:
-*	This helper function will process the next 512 bits of the
-*	message stored in the Message_Block array.
+*	This helper function will process the next 512-bit blocks
+*	of the message.
 *
 * Parameters:
-*	context: [in/out]
-*		The SHA context to update.
+*	Intermediate_Hash: [in/out]
+*		The message digest to update.
+*	Message_Block: [in]
+*		The message blocks.
+*	blocks: [in]
+*		The number of 512-bit blocks.
 *
 * Returns:
 *	Nothing.
@@ -241,10 +264,10 @@ int SHA1Result(SHA1Context *context, uint8_t Message_Digest[SHA1HashSize])
 *	single character names, were used because those were the
 *	names used in the Secure Hash Standard.
 */
-static void SHA1ProcessMessageBlock(SHA1Context *context)
+static void SHA1ProcessBlocks(uint32_t *Intermediate_Hash, const uint8_t *Message_Block, size_t blocks)
 {
 	/* Constants defined in FIPS 180-3, section 4.2.1 */
-	const uint32_t K[4] = {
+	static const uint32_t K[4] = {
 		0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6
 	};
 	int t; /* Loop counter */
@@ -252,65 +275,86 @@ static void SHA1ProcessMessageBlock(SHA1Context *context)
 	uint32_t W[80]; /* Word sequence */
 	uint32_t A, B, C, D, E; /* Word buffers */
 
-	/*
-	* Initialize the first 16 words in the array W
-	*/
-	for (t = 0; t < 16; t++) {
-		W[t] = ((uint32_t)context->Message_Block[t * 4]) << 24;
-		W[t] |= ((uint32_t)context->Message_Block[t * 4 + 1]) << 16;
-		W[t] |= ((uint32_t)context->Message_Block[t * 4 + 2]) << 8;
-		W[t] |= ((uint32_t)context->Message_Block[t * 4 + 3]);
-	}
+	for (; blocks > 0; blocks--, Message_Block += SHA1_Message_Block_Size) {
+		/*
+		* Initialize the first 16 words in the array W
+		*/
+		for (t = 0; t < 16; t++) {
+			W[t] = ((uint32_t)Message_Block[t * 4]) << 24;
+			W[t] |= ((uint32_t)Message_Block[t * 4 + 1]) << 16;
+			W[t] |= ((uint32_t)Message_Block[t * 4 + 2]) << 8;
+			W[t] |= ((uint32_t)Message_Block[t * 4 + 3]);
+		}
 
-	for (t = 16; t < 80; t++)
-		W[t] = SHA1_ROTL(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+		for (t = 16; t < 80; t++)
+			W[t] = SHA1_ROTL(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
 
-	A = context->Intermediate_Hash[0];
-	B = context->Intermediate_Hash[1];
-	C = context->Intermediate_Hash[2];
-	D = context->Intermediate_Hash[3];
-	E = context->Intermediate_Hash[4];
+		A = Intermediate_Hash[0];
+		B = Intermediate_Hash[1];
+		C = Intermediate_Hash[2];
+		D = Intermediate_Hash[3];
+		E = Intermediate_Hash[4];
 
-	for (t = 0; t < 20; t++) {
-		temp = SHA1_ROTL(5, A) + SHA_Ch(B, C, D) + E + W[t] + K[0];
-		E = D;
-		D = C;
-		C = SHA1_ROTL(30, B);
-		B = A;
-		A = temp;
-	}
+		for (t = 0; t < 20; t++) {
+			temp = SHA1_ROTL(5, A) + SHA_Ch(B, C, D) + E + W[t] + K[0];
+			E = D;
+			D = C;
+			C = SHA1_ROTL(30, B);
+			B = A;
+			A = temp;
+		}
 
-	for (t = 20; t < 40; t++) {
-		temp = SHA1_ROTL(5, A) + SHA_Parity(B, C, D) + E + W[t] + K[1];
-		E = D;
-		D = C;
-		C = SHA1_ROTL(30, B);
-		B = A;
-		A = temp;
-	}
-	for (t = 40; t < 60; t++) {
-		temp = SHA1_ROTL(5, A) + SHA_Maj(B, C, D) + E + W[t] + K[2];
-		E = D;
-		D = C;
-		C = SHA1_ROTL(30, B);
-		B = A;
-		A = temp;
+		for (t = 20; t < 40; t++) {
+			temp = SHA1_ROTL(5, A) + SHA_Parity(B, C, D) + E + W[t] + K[1];
+			E = D;
+			D = C;
+			C = SHA1_ROTL(30, B);
+			B = A;
+			A = temp;
+		}
+		for (t = 40; t < 60; t++) {
+			temp = SHA1_ROTL(5, A) + SHA_Maj(B, C, D) + E + W[t] + K[2];
+			E = D;
+			D = C;
+			C = SHA1_ROTL(30, B);
+			B = A;
+			A = temp;
+		}
+
+		for (t = 60; t < 80; t++) {
+			temp = SHA1_ROTL(5, A) + SHA_Parity(B, C, D) + E + W[t] + K[3];
+			E = D;
+			D = C;
+			C = SHA1_ROTL(30, B);
+			B = A;
+			A = temp;
+		}
+
+		Intermediate_Hash[0] += A;
+		Intermediate_Hash[1] += B;
+		Intermediate_Hash[2] += C;
+		Intermediate_Hash[3] += D;
+		Intermediate_Hash[4] += E;
 	}
+}
 
-	for (t = 60; t < 80; t++) {
-		temp = SHA1_ROTL(5, A) + SHA_Parity(B, C, D) + E + W[t] + K[3];
-		E = D;
-		D = C;
-		C = SHA1_ROTL(30, B);
-		B = A;
-		A = temp;
+/*
+* Block function dispatch: SHA-NI/ARMv8 if cpu support, otherwise the
+* portable reference code above.
+*/
+static sha_hw_blocks SHA1Blocks(void)
+{
+	static sha_hw_blocks blocks;
+	if (!blocks) {
+		sha_hw_blocks hw = sha1_hw();
+		blocks = hw ? hw : SHA1ProcessBlocks;
 	}
+	return blocks;
+}
 
-	context->Intermediate_Hash[0] += A;
-	context->Intermediate_Hash[1] += B;
-	context->Intermediate_Hash[2] += C;
-	context->Intermediate_Hash[3] += D;
-	context->Intermediate_Hash[4] += E;
+static void SHA1ProcessMessageBlock(SHA1Context *context)
+{
+	SHA1Blocks()(context->Intermediate_Hash, context->Message_Block, 1);
 	context->Message_Block_Index = 0;
 }
 
@@ -38,6 +38,8 @@
 */
 
 #include "sha.h"
+#include "sha-hw.h"
+#include <string.h>
 
 /*
 * These definitions are defined in FIPS 180-3, section 4.1.
@@ -73,14 +75,17 @@
 * Add "length" to the length.
 * Set Corrupted when overflow has occurred.
 */
-static uint32_t addTemp;
-#define SHA224_256AddLength(context, length) \
-	(addTemp = (context)->Length_Low, (context)->Corrupted = \
-	(((context)->Length_Low += (length)) < addTemp) && \
-	(++(context)->Length_High == 0) ? shaInputTooLong : (context)->Corrupted )
+static int SHA224_256AddLength(SHA256Context *context, uint32_t length)
+{
+	uint32_t addTemp = context->Length_Low;
+	if (((context->Length_Low += length) < addTemp) && (++context->Length_High == 0))
+		context->Corrupted = shaInputTooLong;
+	return context->Corrupted;
+}
 
 /* Local Function Prototypes */
 static int SHA224_256Reset(SHA256Context *context, uint32_t *H0);
+static sha_hw_blocks SHA224_256Blocks(void);
 static void SHA224_256ProcessMessageBlock(SHA256Context *context);
 static void SHA224_256Finalize(SHA256Context *context, uint8_t Pad_Byte);
 static void SHA224_256PadMessage(SHA256Context *context, uint8_t Pad_Byte);
@@ -230,18 +235,34 @@ int SHA256Reset(SHA256Context *context)
 */
 int SHA256Input(SHA256Context *context, const uint8_t *message_array, unsigned int length)
 {
+	unsigned int n;
 	if (!context) return shaNull;
 	if (!length) return shaSuccess;
 	if (!message_array) return shaNull;
 	if (context->Computed) return context->Corrupted = shaStateError;
 	if (context->Corrupted) return context->Corrupted;
 
-	while (length--) {
-		context->Message_Block[context->Message_Block_Index++] = *message_array;
-		if ((SHA224_256AddLength(context, 8) == shaSuccess) &&
-			(context->Message_Block_Index == SHA256_Message_Block_Size))
-			SHA224_256ProcessMessageBlock(context);
-		message_array++;
+	while (length > 0) {
+		if (0 == context->Message_Block_Index && length >= SHA256_Message_Block_Size) {
+			/* hash whole blocks in place, bit count fits in 32 bits */
+			n = length / SHA256_Message_Block_Size;
+			n = n < 0x7FFFFF ? n : 0x7FFFFF;
+			if (SHA224_256AddLength(context, n * SHA256_Message_Block_Size * 8) != shaSuccess)
+				break;
+			SHA224_256Blocks()(context->Intermediate_Hash, message_array, n);
+			n *= SHA256_Message_Block_Size;
+		} else {
+			n = SHA256_Message_Block_Size - context->Message_Block_Index;
+			n = n < length ? n : length;
+			memcpy(context->Message_Block + context->Message_Block_Index, message_array, n);
+			context->Message_Block_Index += n;
+			if (SHA224_256AddLength(context, n * 8) != shaSuccess)
+				break;
+			if (context->Message_Block_Index == SHA256_Message_Block_Size)
+				SHA224_256ProcessMessageBlock(context);
+		}
+		message_array += n;
+		length -= n;
 	}
 	return context->Corrupted;
 }
@@ -355,15 +376,19 @@ static int SHA224_256Reset(SHA256Context *context, uint32_t *H0)
 }
 
 /*
-* SHA224_256ProcessMessageBlock
+* SHA224_256ProcessBlocks
 *
 * Description:
-*	This helper function will process the next 512 bits of the
-*	message stored in the Message_Block array.
+*	This helper function will process the next 512-bit blocks
+*	of the message.
 *
 * Parameters:
-*	context: [in/out]
-*		The SHA context to update.
+*	Intermediate_Hash: [in/out]
+*		The message digest to update.
+*	Message_Block: [in]
+*		The message blocks.
+*	blocks: [in]
+*		The number of 512-bit blocks.
 *
 * Returns:
 *	Nothing.
@@ -373,7 +398,7 @@ static int SHA224_256Reset(SHA256Context *context, uint32_t *H0)
 *	single character names, were used because those were the
 *	names used in the Secure Hash Standard.
 */
-static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+static void SHA224_256ProcessBlocks(uint32_t *Intermediate_Hash, const uint8_t *Message_Block, size_t blocks)
 {
 	/* Constants defined in FIPS 180-3, section 4.2.2 */
 	static const uint32_t K[64] = {
@@ -397,49 +422,69 @@ static void SHA224_256ProcessMessageBlock(SHA256Context *context)
 	uint32_t W[64]; /* Word sequence */
 	uint32_t A, B, C, D, E, F, G, H; /* Word buffers */
 
-	/*
-	* Initialize the first 16 words in the array W
-	*/
-	for (t = t4 = 0; t < 16; t++, t4 += 4)
-		W[t] = (((uint32_t)context->Message_Block[t4]) << 24) |
-				(((uint32_t)context->Message_Block[t4 + 1]) << 16) |
-				(((uint32_t)context->Message_Block[t4 + 2]) << 8) |
-				(((uint32_t)context->Message_Block[t4 + 3]));
-
-	for (t = 16; t < 64; t++)
-		W[t] = SHA256_sigma1(W[t - 2]) + W[t - 7] + SHA256_sigma0(W[t - 15]) + W[t - 16];
-
-	A = context->Intermediate_Hash[0];
-	B = context->Intermediate_Hash[1];
-	C = context->Intermediate_Hash[2];
-	D = context->Intermediate_Hash[3];
-	E = context->Intermediate_Hash[4];
-	F = context->Intermediate_Hash[5];
-	G = context->Intermediate_Hash[6];
-	H = context->Intermediate_Hash[7];
-
-	for (t = 0; t < 64; t++) {
-		temp1 = H + SHA256_SIGMA1(E) + SHA_Ch(E, F, G) + K[t] + W[t];
-		temp2 = SHA256_SIGMA0(A) + SHA_Maj(A, B, C);
-		H = G;
-		G = F;
-		F = E;
-		E = D + temp1;
-		D = C;
-		C = B;
-		B = A;
-		A = temp1 + temp2;
+	for (; blocks > 0; blocks--, Message_Block += SHA256_Message_Block_Size) {
+		/*
+		* Initialize the first 16 words in the array W
+		*/
+		for (t = t4 = 0; t < 16; t++, t4 += 4)
+			W[t] = (((uint32_t)Message_Block[t4]) << 24) |
+					(((uint32_t)Message_Block[t4 + 1]) << 16) |
+					(((uint32_t)Message_Block[t4 + 2]) << 8) |
+					(((uint32_t)Message_Block[t4 + 3]));
+
+		for (t = 16; t < 64; t++)
+			W[t] = SHA256_sigma1(W[t - 2]) + W[t - 7] + SHA256_sigma0(W[t - 15]) + W[t - 16];
+
+		A = Intermediate_Hash[0];
+		B = Intermediate_Hash[1];
+		C = Intermediate_Hash[2];
+		D = Intermediate_Hash[3];
+		E = Intermediate_Hash[4];
+		F = Intermediate_Hash[5];
+		G = Intermediate_Hash[6];
+		H = Intermediate_Hash[7];
+
+		for (t = 0; t < 64; t++) {
+			temp1 = H + SHA256_SIGMA1(E) + SHA_Ch(E, F, G) + K[t] + W[t];
+			temp2 = SHA256_SIGMA0(A) + SHA_Maj(A, B, C);
+			H = G;
+			G = F;
+			F = E;
+			E = D + temp1;
+			D = C;
+			C = B;
+			B = A;
+			A = temp1 + temp2;
+		}
+
+		Intermediate_Hash[0] += A;
+		Intermediate_Hash[1] += B;
+		Intermediate_Hash[2] += C;
+		Intermediate_Hash[3] += D;
+		Intermediate_Hash[4] += E;
+		Intermediate_Hash[5] += F;
+		Intermediate_Hash[6] += G;
+		Intermediate_Hash[7] += H;
 	}
+}
 
-	context->Intermediate_Hash[0] += A;
-	context->Intermediate_Hash[1] += B;
-	context->Intermediate_Hash[2] += C;
-	context->Intermediate_Hash[3] += D;
-	context->Intermediate_Hash[4] += E;
-	context->Intermediate_Hash[5] += F;
-	context->Intermediate_Hash[6] += G;
-	context->Intermediate_Hash[7] += H;
+/*
+* Block function dispatch: SHA-NI/ARMv8 if cpu support, otherwise the
+* portable reference code above.
+*/
+static sha_hw_blocks SHA224_256Blocks(void)
+{
+	static sha_hw_blocks blocks;
+	if (!blocks) {
+		sha_hw_blocks hw = sha256_hw();
+		blocks = hw ? hw : SHA224_256ProcessBlocks;
+	}
+	return blocks;
+}
 
+static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+{
+	SHA224_256Blocks()(context->Intermediate_Hash, context->Message_Block, 1);
 	context->Message_Block_Index = 0;
 }
 
@@ -0,0 +1,500 @@
+// Epoch-based reclamation(EBR) / quiescent-state-based reclamation(QSBR)
+// http://www.cl.cam.ac.uk/techreports/UCAM-CL-TR-579.pdf (K. Fraser, Practical lock-freedom, 5.2.3)
+//
+// 1. global epoch E is even(increase by 2), active thread publish the observed epoch: state = E | 1, inactive: 0
+// 2. E -> E+2 only if every active thread has observed E,
+//    so a node retired in epoch e is unreachable for all readers when E >= e + 4(two steps)
+// 3. retired nodes are kept in per-thread limbo lists(3 buckets by epoch), destroyed by the retire thread
+//
+// reader: store state -> full barrier -> load shared pointer
+// writer: unlink node -> full barrier -> load global epoch -> retire
+
+#include "epoch.h"
+#include "list.h"
+#include "sys/atomic.h"
+#include "sys/system.h"
+#include "sys/thread.h"
+#include "sys/onetime.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(OS_WINDOWS) || defined(_WIN32) || defined(_WIN64)
+#define THREAD_LOCAL static __declspec(thread)
+#elif defined(OS_LINUX) || defined(OS_MAC)
+#define THREAD_LOCAL static __thread
+#else
+#define THREAD_LOCAL static
+#endif
+
+#define EPOCH_BUCKETS	3
+#define EPOCH_RECLAIM	64 // try to advance epoch every n retired nodes
+
+struct epoch_thread_t
+{
+	volatile int32_t state; // 0-inactive, other-(observed epoch | 1)
+	char padding[64]; // avoid false sharing
+
+	struct list_head link; // registry
+	int nesting; // read lock nesting
+	int online; // QSBR online
+	int count; // nodes in limbo
+	int32_t epochs[EPOCH_BUCKETS]; // limbo bucket epoch
+	struct epoch_node_t* limbo[EPOCH_BUCKETS];
+};
+
+static volatile int32_t s_epoch = 2;
+static volatile int32_t s_locker; // registry lock
+static struct list_head s_threads = { &s_threads, &s_threads };
+THREAD_LOCAL struct epoch_thread_t* s_self;
+
+// unregister on thread exit, e.g. http worker thread only take read lock
+#if defined(OS_WINDOWS)
+static DWORD s_exit_key = FLS_OUT_OF_INDEXES;
+#elif !defined(OS_RTOS)
+static pthread_key_t s_exit_key;
+static int s_exit_key_valid;
+#endif
+static onetime_t s_exit_key_once = ONETIME_INIT;
+
+#if defined(OS_WINDOWS)
+static void NTAPI epoch_thread_exit(void* param)
+#else
+static void epoch_thread_exit(void* param)
+#endif
+{
+	if (!param)
+		return;
+	s_self = (struct epoch_thread_t*)param;
+	epoch_thread_unregister();
+}
+
+static void epoch_exit_key_create(void)
+{
+#if defined(OS_WINDOWS)
+	s_exit_key = FlsAlloc(epoch_thread_exit);
+#elif !defined(OS_RTOS)
+	s_exit_key_valid = 0 == pthread_key_create(&s_exit_key, epoch_thread_exit) ? 1 : 0;
+#endif
+}
+
+static void epoch_exit_key_set(struct epoch_thread_t* t)
+{
+#if defined(OS_WINDOWS)
+	if (FLS_OUT_OF_INDEXES != s_exit_key)
+		FlsSetValue(s_exit_key, t);
+#elif !defined(OS_RTOS)
+	if (s_exit_key_valid)
+		pthread_setspecific(s_exit_key, t);
+#else
+	(void)t; // no thread exit hook, MUST call epoch_thread_unregister
+#endif
+}
+
+static int epoch_trylock(void)
+{
+	return atomic_cas32(&s_locker, 0, 1);
+}
+
+static void epoch_lock(void)
+{
+	while (!epoch_trylock())
+		thread_yield();
+}
+
+static void epoch_unlock(void)
+{
+	atomic_store_release32(&s_locker, 0);
+}
+
+/// set current thread state, full barrier(store-load order with the following reads)
+static void epoch_publish(struct epoch_thread_t* t, int32_t state)
+{
+	// only owner thread modify the state, cas always success
+	atomic_cas32(&t->state, t->state, state);
+}
+
+static int epoch_advance(void)
+{
+	int32_t epoch, state;
+	struct list_head* pos;
+	struct epoch_thread_t* t;
+
+	// other thread is scanning, let it do the work
+	if (!epoch_trylock())
+		return 0;
+
+	epoch = atomic_load32(&s_epoch);
+	list_for_each(pos, &s_threads)
+	{
+		t = list_entry(pos, struct epoch_thread_t, link);
+		state = atomic_load_acquire32(&t->state);
+		if (0 != state && state != (epoch | 1))
+		{
+			epoch_unlock();
+			return 0;
+		}
+	}
+
+	atomic_cas32(&s_epoch, epoch, (int32_t)((uint32_t)epoch + 2));
+	epoch_unlock();
+	return 1;
+}
+
+static void epoch_free(struct epoch_thread_t* t, int bucket)
+{
+	struct epoch_node_t *node, *next;
+	for (node = t->limbo[bucket]; node; node = next)
+	{
+		next = node->next;
+		node->destroy(node);
+		t->count--;
+	}
+	t->limbo[bucket] = NULL;
+}
+
+static void epoch_reclaim(struct epoch_thread_t* t)
+{
+	int i;
+	int32_t epoch;
+
+	epoch_advance();
+	epoch = atomic_load_acquire32(&s_epoch);
+	for (i = 0; i < EPOCH_BUCKETS; i++)
+	{
+		if (t->limbo[i] && (int32_t)((uint32_t)epoch - (uint32_t)t->epochs[i]) >= 4)
+			epoch_free(t, i);
+	}
+}
+
+int epoch_thread_register(void)
+{
+	struct epoch_thread_t* t;
+	if (s_self)
+		return 0;
+
+	t = (struct epoch_thread_t*)calloc(1, sizeof(*t));
+	if (!t)
+		return -ENOMEM;
+
+	epoch_lock();
+	list_insert_after(&t->link, &s_threads);
+	epoch_unlock();
+	s_self = t;
+
+	onetime_exec(&s_exit_key_once, epoch_exit_key_create);
+	epoch_exit_key_set(t);
+	return 0;
+}
+
+void epoch_thread_unregister(void)
+{
+	struct epoch_thread_t* t;
+	t = s_self;
+	if (!t)
+		return;
+
+	assert(0 == t->nesting);
+	epoch_offline();
+	if (t->count > 0)
+		epoch_synchronize();
+	assert(0 == t->count);
+
+	epoch_lock();
+	list_remove(&t->link);
+	epoch_unlock();
+	s_self = NULL;
+	epoch_exit_key_set(NULL);
+	free(t);
+}
+
+int epoch_read_lock(void)
+{
+	struct epoch_thread_t* t;
+	if (!s_self && 0 != epoch_thread_register())
+		return -ENOMEM;
+
+	t = s_self;
+	if (0 == t->nesting++ && !t->online)
+		epoch_publish(t, atomic_load_acquire32(&s_epoch) | 1);
+	return 0;
+}
+
+void epoch_read_unlock(void)
+{
+	struct epoch_thread_t* t;
+	t = s_self;
+	assert(t && t->nesting > 0);
+	if (0 == --t->nesting && !t->online)
+	{
+		atomic_store_release32(&t->state, 0);
+		if (t->count > 0)
+			epoch_reclaim(t);
+	}
+}
+
+int epoch_online(void)
+{
+	struct epoch_thread_t* t;
+	if (!s_self && 0 != epoch_thread_register())
+		return -ENOMEM;
+
+	t = s_self;
+	t->online = 1;
+	epoch_publish(t, atomic_load_acquire32(&s_epoch) | 1);
+	return 0;
+}
+
+int epoch_offline(void)
+{
+	struct epoch_thread_t* t;
+	t = s_self;
+	if (!t || !t->online)
+		return 0;
+
+	t->online = 0;
+	if (0 == t->nesting)
+		atomic_store_release32(&t->state, 0);
+	return 1;
+}
+
+void epoch_quiescent(void)
+{
+	struct epoch_thread_t* t;
+	t = s_self;
+	if (!t)
+		return;
+
+	if (t->online && 0 == t->nesting)
+		epoch_publish(t, atomic_load_acquire32(&s_epoch) | 1);
+	if (t->count > 0)
+		epoch_reclaim(t);
+}
+
+void epoch_retire(struct epoch_node_t* node, void (*destroy)(struct epoch_node_t* node))
+{
+	int bucket;
+	int32_t epoch;
+	struct epoch_thread_t* t;
+
+	node->destroy = destroy;
+	if (!s_self && 0 != epoch_thread_register())
+	{
+		// no limbo list, wait readers
+		epoch_synchronize();
+		destroy(node);
+		return;
+	}
+
+	t = s_self;
+	epoch = atomic_load32(&s_epoch); // full barrier: node unlink happen before
+	bucket = (int)(((uint32_t)epoch >> 1) % EPOCH_BUCKETS);
+	if (t->limbo[bucket] && t->epochs[bucket] != epoch)
+		epoch_free(t, bucket); // at least 3 epochs ago
+
+	t->epochs[bucket] = epoch;
+	node->next = t->limbo[bucket];
+	t->limbo[bucket] = node;
+	if (++t->count >= EPOCH_RECLAIM)
+		epoch_reclaim(t);
+}
+
+void epoch_synchronize(void)
+{
+	int i, online;
+	int32_t epoch;
+	struct epoch_thread_t* t;
+
+	t = s_self;
+	assert(!t || 0 == t->nesting);
+
+	// don't hold back the epoch by self
+	online = t && t->online;
+	if (online)
+		atomic_store_release32(&t->state, 0);
+
+	epoch = atomic_load32(&s_epoch);
+	for (i = 0; (int32_t)((uint32_t)atomic_load_acquire32(&s_epoch) - (uint32_t)epoch) < 4; i++)
+	{
+		if (epoch_advance())
+			continue;
+		if (i < 100)
+			thread_yield();
+		else
+			system_sleep(1);
+	}
+
+	if (online)
+		epoch_publish(t, atomic_load_acquire32(&s_epoch) | 1);
+
+	if (t)
+	{
+		// all nodes retired before the call are safe now
+		for (i = 0; i < EPOCH_BUCKETS; i++)
+		{
+			if (t->limbo[i] && (int32_t)((uint32_t)epoch - (uint32_t)t->epochs[i]) >= 0)
+				epoch_free(t, i);
+		}
+	}
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+#define EPOCH_TEST_MAGIC 0x45504f43
+
+struct epoch_test_object_t
+{
+	struct epoch_node_t node;
+	volatile int32_t magic;
+	int value;
+};
+
+struct epoch_test_t
+{
+	void* volatile ptr; // shared object
+	volatile int32_t running;
+	volatile int32_t reads;
+	volatile int32_t destroyed;
+	int qsbr;
+};
+
+static struct epoch_test_t s_test;
+
+static void epoch_test_destroy(struct epoch_node_t* node)
+{
+	struct epoch_test_object_t* obj;
+	obj = list_entry(node, struct epoch_test_object_t, node);
+	assert(EPOCH_TEST_MAGIC == obj->magic);
+	obj->magic = 0;
+	atomic_increment32(&s_test.destroyed);
+	free(obj);
+}
+
+static int STDCALL epoch_test_reader(void* param)
+{
+	int i, v;
+	struct epoch_test_object_t* obj;
+
+	(void)param;
+	if (s_test.qsbr)
+		epoch_online();
+
+	for (i = 0; atomic_load_acquire32(&s_test.running); i++)
+	{
+		if (!s_test.qsbr)
+			assert(0 == epoch_read_lock());
+		obj = (struct epoch_test_object_t*)atomic_load_acquire_ptr(&s_test.ptr);
+		v = obj->value;
+		thread_yield(); // hold the reference for a while
+		assert(EPOCH_TEST_MAGIC == obj->magic && v == obj->value);
+		if (!s_test.qsbr)
+			epoch_read_unlock();
+		else if (0 == i % 64)
+		{
+			// offline while blocked, don't hold back the writer
+			assert(1 == epoch_offline() && 0 == epoch_offline());
+			system_sleep(1);
+			assert(0 == epoch_online());
+		}
+		else if (0 == i % 4)
+			epoch_quiescent();
+		atomic_increment32(&s_test.reads);
+	}
+
+	epoch_thread_unregister();
+	return 0;
+}
+
+static void epoch_test_run(int qsbr)
+{
+	int i;
+	pthread_t threads[4];
+	struct epoch_test_object_t* obj;
+	struct epoch_test_object_t* old;
+
+	memset(&s_test, 0, sizeof(s_test));
+	s_test.qsbr = qsbr;
+	s_test.running = 1;
+	obj = (struct epoch_test_object_t*)calloc(1, sizeof(*obj));
+	obj->magic = EPOCH_TEST_MAGIC;
+	s_test.ptr = obj;
+
+	for (i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++)
+		thread_create(&threads[i], epoch_test_reader, NULL);
+	while (0 == atomic_load_acquire32(&s_test.reads))
+		thread_yield(); // wait readers
+
+	for (i = 1; i <= 2000; i++)
+	{
+		obj = (struct epoch_test_object_t*)calloc(1, sizeof(*obj));
+		obj->magic = EPOCH_TEST_MAGIC;
+		obj->value = i;
+		old = (struct epoch_test_object_t*)s_test.ptr;
+		atomic_store_release_ptr(&s_test.ptr, obj);
+		epoch_retire(&old->node, epoch_test_destroy);
+		if (0 == i % 500)
+			epoch_synchronize();
+		else if (0 == i % 50)
+			thread_yield();
+	}
+
+	atomic_store_release32(&s_test.running, 0);
+	for (i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++)
+		thread_destroy(threads[i]);
+
+	epoch_thread_unregister();
+	assert(2000 == s_test.destroyed && s_test.reads > 0);
+	free(s_test.ptr);
+}
+
+#if !defined(OS_RTOS)
+static int epoch_test_threads(void)
+{
+	int n;
+	struct list_head* pos;
+
+	n = 0;
+	epoch_lock();
+	list_for_each(pos, &s_threads)
+		n++;
+	epoch_unlock();
+	return n;
+}
+
+static int STDCALL epoch_test_exit_reader(void* param)
+{
+	// read lock only, without epoch_thread_unregister
+	(void)param;
+	assert(0 == epoch_read_lock());
+	epoch_read_unlock();
+	return 0;
+}
+
+// thread is unregistered on exit
+static void epoch_test_exit(void)
+{
+	int n;
+	pthread_t thread;
+
+	n = epoch_test_threads();
+	thread_create(&thread, epoch_test_exit_reader, NULL);
+	thread_destroy(thread);
+	assert(n == epoch_test_threads());
+}
+#endif
+
+void epoch_test(void)
+{
+	// nested read lock
+	assert(0 == epoch_read_lock() && 0 == epoch_read_lock());
+	epoch_read_unlock();
+	epoch_read_unlock();
+
+	epoch_test_run(0);
+	epoch_test_run(1);
+#if !defined(OS_RTOS)
+	epoch_test_exit();
+#endif
+}
+#endif
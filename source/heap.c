@@ -4,7 +4,9 @@
 
 #include "heap.h"
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 struct heap_t
@@ -163,8 +165,156 @@ static void heap_percolate_down(struct heap_t* heap)
 	}
 }
 
+struct heap4_entry_t
+{
+	int64_t key;
+	void* ptr;
+};
+
+struct heap4_t
+{
+	struct heap4_entry_t* elts; // elts[1] is 64-bytes aligned, children of n: [4n+1, 4n+4]
+	void* ptr; // memory
+	int size;
+	int capacity;
+	int offset; // index field offset
+};
+
+#define HEAP4_LESS(param, a, b) ((a)->key < (b)->key)
+#define HEAP4_SETINDEX(param, e, i) (*(int*)((char*)(e)->ptr + (intptr_t)(param)) = (i))
+
+HEAP4_DEFINE(heap4_plain, struct heap4_entry_t, HEAP4_LESS, HEAP4_SETINDEX_NONE)
+HEAP4_DEFINE(heap4_index, struct heap4_entry_t, HEAP4_LESS, HEAP4_SETINDEX)
+
+struct heap4_t* heap4_create(int offset)
+{
+	struct heap4_t* heap;
+	heap = (struct heap4_t*)calloc(1, sizeof(*heap));
+	if (heap)
+		heap->offset = offset;
+	return heap;
+}
+
+void heap4_destroy(struct heap4_t* heap)
+{
+	if (heap->ptr)
+		free(heap->ptr);
+	free(heap);
+}
+
+int heap4_reserve(struct heap4_t* heap, int size)
+{
+	uintptr_t p;
+	void* ptr;
+
+	if (size <= heap->capacity)
+		return 0;
+	if (size < 0 || (size_t)size > ((size_t)-1 - 64) / sizeof(struct heap4_entry_t))
+		return -ENOMEM;
+
+	ptr = malloc(sizeof(struct heap4_entry_t) * size + 64);
+	if (!ptr)
+		return -ENOMEM;
+
+	// align the first child group(elts[1]) to cache line
+	p = ((uintptr_t)ptr + sizeof(struct heap4_entry_t) + 63) & ~(uintptr_t)63;
+	p -= sizeof(struct heap4_entry_t);
+	if (heap->size > 0)
+		memcpy((void*)p, heap->elts, sizeof(struct heap4_entry_t) * heap->size);
+	if (heap->ptr)
+		free(heap->ptr);
+	heap->ptr = ptr;
+	heap->elts = (struct heap4_entry_t*)p;
+	heap->capacity = size;
+	return 0;
+}
+
+int heap4_size(struct heap4_t* heap)
+{
+	return heap->size;
+}
+
+int heap4_empty(struct heap4_t* heap)
+{
+	return !heap->size;
+}
+
+int heap4_push(struct heap4_t* heap, int64_t key, void* ptr)
+{
+	int r;
+	struct heap4_entry_t e;
+
+	if (heap->size >= heap->capacity)
+	{
+		if (heap->capacity > INT_MAX / 2)
+			return -ENOMEM;
+		r = heap4_reserve(heap, heap->capacity < 64 ? 64 : heap->capacity * 2);
+		if (0 != r)
+			return r;
+	}
+
+	e.key = key;
+	e.ptr = ptr;
+	if (HEAP4_NO_INDEX == heap->offset)
+		heap->size = heap4_plain_push(heap->elts, heap->size, &e, NULL);
+	else
+		heap->size = heap4_index_push(heap->elts, heap->size, &e, (void*)(intptr_t)heap->offset);
+	return 0;
+}
+
+void* heap4_top(struct heap4_t* heap, int64_t* key)
+{
+	if (heap->size < 1)
+		return NULL;
+	if (key)
+		*key = heap->elts[0].key;
+	return heap->elts[0].ptr;
+}
+
+void* heap4_pop(struct heap4_t* heap, int64_t* key)
+{
+	if (heap->size < 1)
+		return NULL;
+	if (key)
+		*key = heap->elts[0].key;
+	return heap4_remove(heap, 0);
+}
+
+int heap4_update(struct heap4_t* heap, int index, int64_t key)
+{
+	if (index < 0 || index >= heap->size)
+		return -EINVAL;
+
+	heap->elts[index].key = key;
+	if (HEAP4_NO_INDEX == heap->offset)
+		heap4_plain_update(heap->elts, heap->size, index, NULL);
+	else
+		heap4_index_update(heap->elts, heap->size, index, (void*)(intptr_t)heap->offset);
+	return 0;
+}
+
+void* heap4_remove(struct heap4_t* heap, int index)
+{
+	void* ptr;
+	if (index < 0 || index >= heap->size)
+		return NULL;
+
+	ptr = heap->elts[index].ptr;
+	if (HEAP4_NO_INDEX == heap->offset)
+	{
+		heap->size = heap4_plain_remove(heap->elts, heap->size, index, NULL);
+	}
+	else
+	{
+		heap->size = heap4_index_remove(heap->elts, heap->size, index, (void*)(intptr_t)heap->offset);
+		*(int*)((char*)ptr + heap->offset) = HEAP4_NO_INDEX;
+	}
+	return ptr;
+}
+
 #if defined(_DEBUG) || defined(DEBUG)
 #include <stdio.h>
+#include <stddef.h>
 #include <time.h>
 #if defined(OS_RTOS)
 #define N 1000
@@ -177,6 +327,78 @@ static int heap_test_compare(void* param, const void* p1, const void* p2)
 	return *(int*)p1 < *(int*)p2;
 }
 
+struct heap4_test_item_t
+{
+	int64_t key;
+	int index;
+};
+
+static void heap4_test(void)
+{
+	int i, j;
+	int64_t key, last;
+	heap4_t* heap;
+	struct heap4_test_item_t* items;
+
+	items = (struct heap4_test_item_t*)malloc(sizeof(*items) * N);
+	heap = heap4_create((int)offsetof(struct heap4_test_item_t, index));
+	for (i = 0; i < N; i++)
+	{
+		items[i].key = rand() % 1000;
+		assert(0 == heap4_push(heap, items[i].key, &items[i]));
+		assert(&items[i] == heap4_remove(heap, items[i].index));
+		assert(HEAP4_NO_INDEX == items[i].index);
+		assert(0 == heap4_push(heap, items[i].key, &items[i]));
+	}
+	assert(heap4_size(heap) == N);
+
+	// cancel 1/4, reschedule 1/4
+	for (i = 0; i < N; i += 4)
+	{
+		assert(&items[i] == heap4_remove(heap, items[i].index));
+		assert(HEAP4_NO_INDEX == items[i].index);
+		j = i + 1 < N ? i + 1 : i;
+		if (j != i)
+		{
+			items[j].key = rand() % 2000 - 500;
+			assert(0 == heap4_update(heap, items[j].index, items[j].key));
+		}
+	}
+	assert(heap4_size(heap) == N - (N + 3) / 4);
+
+	last = INT64_MIN;
+	while (!heap4_empty(heap))
+	{
+		struct heap4_test_item_t* item;
+		item = (struct heap4_test_item_t*)heap4_pop(heap, &key);
+		assert(key == item->key && key >= last && HEAP4_NO_INDEX == item->index);
+		last = key;
+	}
+	assert(NULL == heap4_pop(heap, NULL));
+	heap4_destroy(heap);
+
+	// without index tracking
+	heap = heap4_create(HEAP4_NO_INDEX);
+	for (i = 0; i < N; i++)
+		assert(0 == heap4_push(heap, items[i].key, &items[i]));
+	last = INT64_MIN;
+	for (i = 0; i < N; i++)
+	{
+		assert(NULL != heap4_pop(heap, &key) && key >= last);
+		last = key;
+	}
+	assert(heap4_empty(heap));
+
+	// capacity can't be doubled
+	i = heap->capacity;
+	heap->size = heap->capacity = INT_MAX / 2 + 1;
+	assert(-ENOMEM == heap4_push(heap, 0, NULL));
+	heap->size = 0;
+	heap->capacity = i;
+	heap4_destroy(heap);
+	free(items);
+}
+
 void heap_test(void)
 {
 	int i;
@@ -205,6 +427,8 @@ void heap_test(void)
 	assert(heap_empty(heap));
 	heap_destroy(heap);
 	free(v);
+
+	heap4_test();
 	printf("heap test ok\n");
 }
 #endif
@@ -1,9 +1,22 @@
 #include "html-entities.h"
 #include <stdio.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HTML_ENTITIES_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define HTML_ENTITIES_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
 // HTML Entities
 // Some characters are reserved in HTML.
 // http://www.w3schools.com/tags/ref_entities.asp
@@ -19,6 +32,9 @@ typedef struct _html_entities
 
 #define html_entity(entity, code) { entity, code }
 
+#define HTML_ENTITIES_ENCODE 12 // encode the first 12 entities only
+#define HTML_ENTITIES_NAME_MAX 8 // max entity name length("thetasym")
+
 static html_entities s_entities[] = {
 	// HTML and XHTML processors must support the five special characters listed in the table below:
 	html_entity("quot",	34), // quotation mark(")
@@ -35,8 +51,346 @@ static html_entities s_entities[] = {
 	html_entity("copy",	169), // copyright(©)
 	html_entity("reg",	174), // registered trademark(®)
 	html_entity("euro",	8364), // euro(€)
+
+	// HTML 4.01 character entity references(decode only), order by number
+	// https://www.w3.org/TR/html4/sgml/entities.html
+	html_entity("iexcl",161), // ¡
+	html_entity("cent",	162), // ¢
+	html_entity("curren",164), // ¤
+	html_entity("brvbar",166), // ¦
+	html_entity("uml",	168), // ¨
+	html_entity("ordf",	170), // ª
+	html_entity("laquo",171), // «
+	html_entity("not",	172), // ¬
+	html_entity("shy",	173), // U+00AD
+	html_entity("macr",	175), // ¯
+	html_entity("deg",	176), // °
+	html_entity("plusmn",177), // ±
+	html_entity("sup2",	178), // ²
+	html_entity("sup3",	179), // ³
+	html_entity("acute",180), // ´
+	html_entity("micro",181), // µ
+	html_entity("para",	182), // ¶
+	html_entity("middot",183), // ·
+	html_entity("cedil",184), // ¸
+	html_entity("sup1",	185), // ¹
+	html_entity("ordm",	186), // º
+	html_entity("raquo",187), // »
+	html_entity("frac14",188), // ¼
+	html_entity("frac12",189), // ½
+	html_entity("frac34",190), // ¾
+	html_entity("iquest",191), // ¿
+	html_entity("Agrave",192), // À
+	html_entity("Aacute",193), // Á
+	html_entity("Acirc",194), // Â
+	html_entity("Atilde",195), // Ã
+	html_entity("Auml",	196), // Ä
+	html_entity("Aring",197), // Å
+	html_entity("AElig",198), // Æ
+	html_entity("Ccedil",199), // Ç
+	html_entity("Egrave",200), // È
+	html_entity("Eacute",201), // É
+	html_entity("Ecirc",202), // Ê
+	html_entity("Euml",	203), // Ë
+	html_entity("Igrave",204), // Ì
+	html_entity("Iacute",205), // Í
+	html_entity("Icirc",206), // Î
+	html_entity("Iuml",	207), // Ï
+	html_entity("ETH",	208), // Ð
+	html_entity("Ntilde",209), // Ñ
+	html_entity("Ograve",210), // Ò
+	html_entity("Oacute",211), // Ó
+	html_entity("Ocirc",212), // Ô
+	html_entity("Otilde",213), // Õ
+	html_entity("Ouml",	214), // Ö
+	html_entity("times",215), // ×
+	html_entity("Oslash",216), // Ø
+	html_entity("Ugrave",217), // Ù
+	html_entity("Uacute",218), // Ú
+	html_entity("Ucirc",219), // Û
+	html_entity("Uuml",	220), // Ü
+	html_entity("Yacute",221), // Ý
+	html_entity("THORN",222), // Þ
+	html_entity("szlig",223), // ß
+	html_entity("agrave",224), // à
+	html_entity("aacute",225), // á
+	html_entity("acirc",226), // â
+	html_entity("atilde",227), // ã
+	html_entity("auml",	228), // ä
+	html_entity("aring",229), // å
+	html_entity("aelig",230), // æ
+	html_entity("ccedil",231), // ç
+	html_entity("egrave",232), // è
+	html_entity("eacute",233), // é
+	html_entity("ecirc",234), // ê
+	html_entity("euml",	235), // ë
+	html_entity("igrave",236), // ì
+	html_entity("iacute",237), // í
+	html_entity("icirc",238), // î
+	html_entity("iuml",	239), // ï
+	html_entity("eth",	240), // ð
+	html_entity("ntilde",241), // ñ
+	html_entity("ograve",242), // ò
+	html_entity("oacute",243), // ó
+	html_entity("ocirc",244), // ô
+	html_entity("otilde",245), // õ
+	html_entity("ouml",	246), // ö
+	html_entity("divide",247), // ÷
+	html_entity("oslash",248), // ø
+	html_entity("ugrave",249), // ù
+	html_entity("uacute",250), // ú
+	html_entity("ucirc",251), // û
+	html_entity("uuml",	252), // ü
+	html_entity("yacute",253), // ý
+	html_entity("thorn",254), // þ
+	html_entity("yuml",	255), // ÿ
+	html_entity("OElig",338), // Œ
+	html_entity("oelig",339), // œ
+	html_entity("Scaron",352), // Š
+	html_entity("scaron",353), // š
+	html_entity("Yuml",	376), // Ÿ
+	html_entity("fnof",	402), // ƒ
+	html_entity("circ",	710), // ˆ
+	html_entity("tilde",732), // ˜
+	html_entity("Alpha",913), // Α
+	html_entity("Beta",	914), // Β
+	html_entity("Gamma",915), // Γ
+	html_entity("Delta",916), // Δ
+	html_entity("Epsilon",917), // Ε
+	html_entity("Zeta",	918), // Ζ
+	html_entity("Eta",	919), // Η
+	html_entity("Theta",920), // Θ
+	html_entity("Iota",	921), // Ι
+	html_entity("Kappa",922), // Κ
+	html_entity("Lambda",923), // Λ
+	html_entity("Mu",	924), // Μ
+	html_entity("Nu",	925), // Ν
+	html_entity("Xi",	926), // Ξ
+	html_entity("Omicron",927), // Ο
+	html_entity("Pi",	928), // Π
+	html_entity("Rho",	929), // Ρ
+	html_entity("Sigma",931), // Σ
+	html_entity("Tau",	932), // Τ
+	html_entity("Upsilon",933), // Υ
+	html_entity("Phi",	934), // Φ
+	html_entity("Chi",	935), // Χ
+	html_entity("Psi",	936), // Ψ
+	html_entity("Omega",937), // Ω
+	html_entity("alpha",945), // α
+	html_entity("beta",	946), // β
+	html_entity("gamma",947), // γ
+	html_entity("delta",948), // δ
+	html_entity("epsilon",949), // ε
+	html_entity("zeta",	950), // ζ
+	html_entity("eta",	951), // η
+	html_entity("theta",952), // θ
+	html_entity("iota",	953), // ι
+	html_entity("kappa",954), // κ
+	html_entity("lambda",955), // λ
+	html_entity("mu",	956), // μ
+	html_entity("nu",	957), // ν
+	html_entity("xi",	958), // ξ
+	html_entity("omicron",959), // ο
+	html_entity("pi",	960), // π
+	html_entity("rho",	961), // ρ
+	html_entity("sigmaf",962), // ς
+	html_entity("sigma",963), // σ
+	html_entity("tau",	964), // τ
+	html_entity("upsilon",965), // υ
+	html_entity("phi",	966), // φ
+	html_entity("chi",	967), // χ
+	html_entity("psi",	968), // ψ
+	html_entity("omega",969), // ω
+	html_entity("thetasym",977), // ϑ
+	html_entity("upsih",978), // ϒ
+	html_entity("piv",	982), // ϖ
+	html_entity("ensp",	8194), // U+2002
+	html_entity("emsp",	8195), // U+2003
+	html_entity("thinsp",8201), // U+2009
+	html_entity("zwnj",	8204), // U+200C
+	html_entity("zwj",	8205), // U+200D
+	html_entity("lrm",	8206), // U+200E
+	html_entity("rlm",	8207), // U+200F
+	html_entity("ndash",8211), // –
+	html_entity("mdash",8212), // —
+	html_entity("lsquo",8216), // ‘
+	html_entity("rsquo",8217), // ’
+	html_entity("sbquo",8218), // ‚
+	html_entity("ldquo",8220), // “
+	html_entity("rdquo",8221), // ”
+	html_entity("bdquo",8222), // „
+	html_entity("dagger",8224), // †
+	html_entity("Dagger",8225), // ‡
+	html_entity("bull",	8226), // •
+	html_entity("hellip",8230), // …
+	html_entity("permil",8240), // ‰
+	html_entity("prime",8242), // ′
+	html_entity("Prime",8243), // ″
+	html_entity("lsaquo",8249), // ‹
+	html_entity("rsaquo",8250), // ›
+	html_entity("oline",8254), // ‾
+	html_entity("frasl",8260), // ⁄
+	html_entity("image",8465), // ℑ
+	html_entity("weierp",8472), // ℘
+	html_entity("real",	8476), // ℜ
+	html_entity("trade",8482), // ™
+	html_entity("alefsym",8501), // ℵ
+	html_entity("larr",	8592), // ←
+	html_entity("uarr",	8593), // ↑
+	html_entity("rarr",	8594), // →
+	html_entity("darr",	8595), // ↓
+	html_entity("harr",	8596), // ↔
+	html_entity("crarr",8629), // ↵
+	html_entity("lArr",	8656), // ⇐
+	html_entity("uArr",	8657), // ⇑
+	html_entity("rArr",	8658), // ⇒
+	html_entity("dArr",	8659), // ⇓
+	html_entity("hArr",	8660), // ⇔
+	html_entity("forall",8704), // ∀
+	html_entity("part",	8706), // ∂
+	html_entity("exist",8707), // ∃
+	html_entity("empty",8709), // ∅
+	html_entity("nabla",8711), // ∇
+	html_entity("isin",	8712), // ∈
+	html_entity("notin",8713), // ∉
+	html_entity("ni",	8715), // ∋
+	html_entity("prod",	8719), // ∏
+	html_entity("sum",	8721), // ∑
+	html_entity("minus",8722), // −
+	html_entity("lowast",8727), // ∗
+	html_entity("radic",8730), // √
+	html_entity("prop",	8733), // ∝
+	html_entity("infin",8734), // ∞
+	html_entity("ang",	8736), // ∠
+	html_entity("and",	8743), // ∧
+	html_entity("or",	8744), // ∨
+	html_entity("cap",	8745), // ∩
+	html_entity("cup",	8746), // ∪
+	html_entity("int",	8747), // ∫
+	html_entity("there4",8756), // ∴
+	html_entity("sim",	8764), // ∼
+	html_entity("cong",	8773), // ≅
+	html_entity("asymp",8776), // ≈
+	html_entity("ne",	8800), // ≠
+	html_entity("equiv",8801), // ≡
+	html_entity("le",	8804), // ≤
+	html_entity("ge",	8805), // ≥
+	html_entity("sub",	8834), // ⊂
+	html_entity("sup",	8835), // ⊃
+	html_entity("nsub",	8836), // ⊄
+	html_entity("sube",	8838), // ⊆
+	html_entity("supe",	8839), // ⊇
+	html_entity("oplus",8853), // ⊕
+	html_entity("otimes",8855), // ⊗
+	html_entity("perp",	8869), // ⊥
+	html_entity("sdot",	8901), // ⋅
+	html_entity("lceil",8968), // ⌈
+	html_entity("rceil",8969), // ⌉
+	html_entity("lfloor",8970), // ⌊
+	html_entity("rfloor",8971), // ⌋
+	html_entity("lang",	9001), // 〈
+	html_entity("rang",	9002), // 〉
+	html_entity("loz",	9674), // ◊
+	html_entity("spades",9824), // ♠
+	html_entity("clubs",9827), // ♣
+	html_entity("hearts",9829), // ♥
+	html_entity("diams",9830), // ♦
+};
+
+// minimal perfect hash(hash and displace), generated from s_entities by html_entities_perfect_hash(DEBUG),
+// html_entities_test checks the tables, build with HTML_ENTITIES_GENERATE to print them after s_entities changed
+// slot = disp[hash(0, key) & 0xFF], slot < 0 ? -slot - 1 : hash(slot, key) & 0xFF
+// name: entity name bytes, number: 3-bytes little-endian code point
+static const int16_t s_name_disp[256] = {
+	0, 0, 2, 0, 0, 2, 0, -250, 2, 0, 1, 0, 2, -246, 0, -242,
+	-241, 0, 3, 1, 2, 3, -240, 0, 1, 1, -239, 0, 3, -238, 0, 4,
+	-233, -230, 4, -229, -226, 0, -224, 1, 1, 0, -221, -220, 3, 0, 1, -219,
+	0, 2, 0, -215, -213, 0, 0, 0, 0, 0, -211, 1, 3, 0, 0, 0,
+	0, 0, 7, -209, 2, 0, -208, 3, -207, 0, 0, 1, 3, 0, 0, 0,
+	-204, -203, -202, -201, 0, -196, 1, -195, 0, 8, 0, 0, 0, -192, -185, -184,
+	0, 0, 0, -183, -182, 3, 0, -181, -179, -174, -171, 0, 0, 0, 0, 0,
+	-170, 0, 0, -168, 8, 3, -165, -163, 10, 0, -162, 0, 0, -154, -153, 0,
+	-152, 0, -146, 0, 1, 0, -145, 0, 1, -144, 1, -143, 0, 0, -141, -139,
+	0, 0, 0, -138, -134, 1, -130, 2, -129, 0, 2, -124, 3, 0, 2, 0,
+	-122, -121, 3, 0, 0, 0, -120, -117, 2, -111, 11, 1, 0, -103, 6, -101,
+	-99, 4, 2, 0, -98, -97, 0, 3, 0, 0, 0, 12, 23, 1, 1, 6,
+	1, 10, 0, -82, 0, -79, 0, 1, -73, 6, -71, 0, -70, -68, -64, 3,
+	-61, 3, 2, -55, 0, -45, 0, -44, -42, -41, 2, -40, 0, -39, 0, -37,
+	0, 0, 0, 0, 0, 0, -34, 1, 0, -30, 1, 0, 0, 1, 1, 0,
+	-29, 0, 2, -27, 2, 0, -26, -21, 2, 0, 1, 0, -20, 0, 0, 0,
+};
+static const uint8_t s_name_slots[256] = { // 0xFF-empty
+	255, 38, 172, 201, 255, 44, 255, 82, 164, 165, 237, 140, 16, 160, 79, 91,
+	167, 81, 76, 86, 24, 244, 118, 105, 131, 37, 94, 176, 99, 153, 5, 107,
+	147, 43, 47, 156, 115, 157, 55, 178, 232, 185, 36, 7, 18, 32, 54, 62,
+	95, 142, 240, 135, 169, 13, 84, 250, 80, 127, 46, 132, 216, 150, 14, 98,
+	125, 114, 239, 70, 60, 161, 123, 225, 133, 202, 49, 217, 90, 85, 189, 9,
+	168, 200, 148, 111, 68, 209, 188, 219, 180, 3, 108, 103, 139, 213, 144, 72,
+	61, 34, 251, 195, 214, 166, 129, 233, 22, 50, 241, 11, 59, 53, 109, 162,
+	230, 159, 12, 88, 102, 65, 136, 220, 78, 83, 234, 141, 179, 119, 120, 192,
+	243, 30, 48, 20, 248, 226, 73, 110, 221, 26, 187, 227, 35, 218, 33, 128,
+	197, 193, 206, 56, 29, 8, 191, 182, 181, 208, 1, 199, 113, 252, 96, 27,
+	112, 196, 145, 205, 4, 17, 41, 52, 155, 93, 184, 116, 222, 228, 31, 6,
+	100, 104, 92, 58, 215, 25, 204, 171, 224, 245, 66, 45, 211, 101, 64, 190,
+	242, 21, 173, 246, 51, 2, 19, 117, 198, 23, 235, 236, 69, 149, 0, 75,
+	247, 87, 57, 163, 186, 212, 249, 71, 174, 10, 97, 28, 231, 143, 74, 203,
+	175, 130, 177, 146, 194, 137, 122, 134, 183, 210, 207, 238, 158, 138, 89, 15,
+	67, 223, 124, 152, 126, 154, 229, 106, 121, 77, 151, 63, 39, 170, 42, 40,
+};
+static const int16_t s_number_disp[256] = {
+	-252, 1, 0, 1, -250, -248, 0, 0, -247, -245, 0, -242, 0, -239, 1, 0,
+	3, -237, -235, 0, -234, -232, -229, -226, 0, 0, 1, 7, 0, 2, 0, 0,
+	-225, -224, 1, 0, -221, 2, -216, -215, -214, -211, -209, 0, -208, 1, -206, 1,
+	-203, 0, 2, 0, 6, -201, 1, -200, -199, 2, 2, -193, 2, 0, -188, -186,
+	0, -185, 0, 0, 0, 0, 1, 4, 0, 2, 2, -184, -180, -178, 1, 0,
+	0, 0, 0, 6, 1, -177, 0, -175, -174, 3, 0, 3, -173, -172, 0, 0,
+	-170, 0, 0, -167, 2, 2, -165, -164, 5, -163, -160, -159, 0, 2, 0, 0,
+	0, 0, 3, -157, 0, 3, 1, -155, 6, -151, -150, -149, 0, -147, 0, 1,
+	-144, 2, 0, 0, 2, -142, 0, 1, 0, -137, 0, 0, -136, -135, 0, -133,
+	-129, -125, 1, 0, 2, -123, -121, -120, 0, 1, 0, 0, 0, -119, 2, 7,
+	0, -118, 0, -117, 8, 0, -113, -111, -105, -104, 0, 1, -101, -100, 0, -98,
+	-97, -96, -95, 2, 3, 0, -93, -92, 7, 0, -90, -87, 0, 5, 4, 16,
+	0, -84, -83, 8, 0, -82, 0, 0, -79, -78, -74, 0, 0, 0, -72, -71,
+	-67, 0, 1, 0, 7, 0, 0, 4, -66, -65, 0, 0, -64, -62, -61, 7,
+	-56, -53, 34, -52, 8, -51, -48, 0, 0, -45, -43, -42, 0, 0, 6, -40,
+	0, -38, -34, -29, -27, -25, 4, -23, 0, 0, -18, -17, -16, -14, -12, 0,
+};
+static const uint8_t s_number_slots[256] = { // 0xFF-empty
+	239, 255, 255, 255, 229, 84, 139, 217, 188, 172, 189, 101, 19, 140, 238, 23,
+	58, 161, 91, 190, 233, 141, 177, 74, 124, 20, 195, 126, 3, 250, 184, 105,
+	162, 241, 1, 143, 147, 92, 25, 16, 175, 187, 33, 9, 68, 226, 49, 111,
+	231, 87, 194, 11, 44, 171, 73, 137, 109, 129, 168, 183, 199, 24, 108, 55,
+	192, 121, 27, 78, 219, 237, 46, 213, 200, 65, 210, 104, 165, 112, 224, 193,
+	88, 80, 41, 249, 176, 63, 202, 208, 158, 115, 251, 223, 8, 90, 203, 28,
+	59, 214, 215, 0, 178, 201, 169, 225, 211, 248, 98, 164, 110, 149, 181, 82,
+	93, 26, 236, 173, 50, 180, 116, 5, 45, 47, 185, 152, 60, 221, 102, 235,
+	234, 77, 132, 18, 142, 167, 179, 71, 4, 95, 151, 163, 2, 17, 83, 113,
+	227, 133, 182, 62, 196, 81, 127, 114, 48, 156, 38, 86, 34, 170, 14, 130,
+	72, 218, 186, 150, 29, 230, 146, 155, 99, 75, 174, 228, 125, 51, 252, 10,
+	148, 131, 61, 12, 197, 94, 153, 42, 76, 205, 85, 119, 22, 106, 240, 69,
+	154, 13, 242, 118, 52, 157, 145, 134, 32, 37, 128, 6, 70, 244, 166, 39,
+	97, 243, 136, 246, 100, 35, 54, 160, 216, 103, 135, 198, 191, 212, 66, 120,
+	7, 159, 247, 53, 222, 220, 89, 64, 31, 107, 123, 79, 245, 15, 40, 122,
+	57, 138, 206, 96, 36, 30, 67, 204, 144, 117, 21, 43, 209, 56, 232, 207,
 };
 
+static inline uint32_t html_entities_hash(uint32_t seed, const uint8_t* s, int n)
+{
+	int i;
+	uint32_t h;
+	h = seed ? seed : 0x811c9dc5; // FNV-1a
+	for (i = 0; i < n; i++)
+		h = (h ^ s[i]) * 0x01000193;
+	return h;
+}
+
+static inline int html_entities_slot(const int16_t disp[256], const uint8_t slots[256], const uint8_t* key, int n)
+{
+	int d;
+	d = disp[html_entities_hash(0, key, n) & 0xFF];
+	return slots[d < 0 ? -d - 1 : (int)(html_entities_hash((uint32_t)d, key, n) & 0xFF)];
+}
+
 int html_entities_count(void)
 {
 	return sizeof(s_entities)/sizeof(s_entities[0]);
@@ -53,27 +407,134 @@ void html_entities_get(int index, char name[16], wchar_t *number)
 	}
 }
 
-static int html_entities_find_by_name(const char* name)
+/// @param[in] name entity name(without '&' and ';')
+static int html_entities_find_by_name(const char* name, int len)
 {
 	int i;
-	for(i = 0; i < sizeof(s_entities)/sizeof(s_entities[0]); i++)
-	{
-		if(0==strncmp(s_entities[i].name, name, strlen(s_entities[i].name)) 
-			&& ';'==name[strlen(s_entities[i].name)])
-			return i;
-	}
+	if (len < 1 || len > HTML_ENTITIES_NAME_MAX)
+		return -1;
+
+	i = html_entities_slot(s_name_disp, s_name_slots, (const uint8_t*)name, len);
+	if (i < (int)(sizeof(s_entities) / sizeof(s_entities[0])) && 0 == memcmp(s_entities[i].name, name, len) && 0 == s_entities[i].name[len])
+		return i;
 	return -1;
 }
 
 static int html_entities_find_by_number(wchar_t number)
 {
 	int i;
-	for(i = 0; i < sizeof(s_entities)/sizeof(s_entities[0]); i++)
+	uint8_t key[3];
+
+	if (number < 0 || number > 0xFFFF)
+		return -1;
+
+	key[0] = (uint8_t)number;
+	key[1] = (uint8_t)(number >> 8);
+	key[2] = 0;
+	i = html_entities_slot(s_number_disp, s_number_slots, key, sizeof(key));
+	if (i < (int)(sizeof(s_entities) / sizeof(s_entities[0])) && s_entities[i].number == number)
+		return i;
+	return -1;
+}
+
+static inline int html_entities_ctz(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+#if defined(HTML_ENTITIES_NEON)
+static inline int html_entities_ctz64(uint64_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctzll(v);
+#endif
+}
+#endif
+
+/// @return length of the leading run that don't need decode(no '&' and '\0')
+static int html_entities_decode_span(const char* s, const char* end)
+{
+	const char* p;
+#if defined(HTML_ENTITIES_SSE2)
+	uint32_t m;
+	__m128i v;
+	for (p = s; p + 16 <= end; p += 16)
 	{
-		if(s_entities[i].number == number)
-			return i;
+		v = _mm_loadu_si128((const __m128i*)p);
+		m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('&')), _mm_cmpeq_epi8(v, _mm_setzero_si128())));
+		if (m)
+			return (int)(p - s) + html_entities_ctz(m);
 	}
-	return -1;
+#elif defined(HTML_ENTITIES_NEON)
+	uint64_t m;
+	uint8x16_t v;
+	for (p = s; p + 16 <= end; p += 16)
+	{
+		v = vld1q_u8((const uint8_t*)p);
+		v = vorrq_u8(vceqq_u8(v, vdupq_n_u8('&')), vceqq_u8(v, vdupq_n_u8(0)));
+		m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0); // 4-bits per byte
+		if (m)
+			return (int)(p - s) + html_entities_ctz64(m) / 4;
+	}
+#else
+	p = s;
+#endif
+	while (p < end && '&' != *p && *p)
+		p++;
+	return (int)(p - s);
+}
+
+/// @return length of the leading run that don't need encode(ASCII except '"', '&', '\'', '<', '>' and '\0')
+static int html_entities_encode_span(const char* s, const char* end)
+{
+	const char* p;
+#if defined(HTML_ENTITIES_SSE2)
+	uint32_t m;
+	__m128i v, x;
+	for (p = s; p + 16 <= end; p += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)p);
+		x = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('&')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+		m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(x, v)); // high bit: non-ASCII
+		if (m)
+			return (int)(p - s) + html_entities_ctz(m);
+	}
+#elif defined(HTML_ENTITIES_NEON)
+	uint64_t m;
+	uint8x16_t v, x;
+	for (p = s; p + 16 <= end; p += 16)
+	{
+		v = vld1q_u8((const uint8_t*)p);
+		x = vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('&')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8('\'')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8('<')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8('>')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8(0)));
+		x = vorrq_u8(x, vcgeq_u8(v, vdupq_n_u8(0x80)));
+		m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(x), 4)), 0); // 4-bits per byte
+		if (m)
+			return (int)(p - s) + html_entities_ctz64(m) / 4;
+	}
+#else
+	p = s;
+#endif
+	while (p < end && *p && 0 == (*p & 0x80) && NULL == strchr("\"&'<>", *p))
+		p++;
+	return (int)(p - s);
 }
 
 static int html_entities_value(char* p, wchar_t number)
@@ -143,43 +604,47 @@ static const char* html_entities_numeric(const char *p, wchar_t *number)
 
 int html_entities_decode(char* dst, const char* src, int srcLen)
 {
-	int i, j;
-	wchar_t n;
-	const char* p, *p0;
+	int i, j, n;
+	wchar_t w;
+	const char* p, *p0, *end;
 
 	j = 0;
-	for(p = src; *p && p < src + srcLen; )
+	end = src + srcLen;
+	for(p = src; p < end && *p; )
 	{
-		if('&' != p[0])
-		{
-			dst[j++] = *p++;
-			continue;
-		}
+		// copy plain text run
+		n = html_entities_decode_span(p, end);
+		memcpy(dst + j, p, n);
+		j += n;
+		p += n;
+		if (p >= end || '&' != *p)
+			break;
 
-		n = 0;
+		w = 0;
 		if('#' == p[1])
 		{
-			p0 = html_entities_numeric(p+2, &n);
+			p0 = html_entities_numeric(p+2, &w);
 			if(p0)
 			{
-				j += html_entities_value(dst+j, n);
+				j += html_entities_value(dst+j, w);
 				p = p0;
 				continue;
 			}
 		}
 		else
 		{
-			i = html_entities_find_by_name(p+1);
+			for (p0 = p + 1; p0 < end && p0 <= p + 1 + HTML_ENTITIES_NAME_MAX && ';' != *p0 && *p0; p0++)
+				;
+			i = p0 < end && ';' == *p0 ? html_entities_find_by_name(p + 1, (int)(p0 - p - 1)) : -1;
 			if(i >= 0)
 			{
-				n = s_entities[i].number;
-				p += strlen(s_entities[i].name) + 2; // with '&' and ';'
-				j += html_entities_value(dst+j, n);
+				j += html_entities_value(dst+j, s_entities[i].number);
+				p = p0 + 1; // with ';'
 				continue;
 			}
 		}
 
-		dst[j++] = *src++; // don't decode '&'
+		dst[j++] = *p++; // don't decode '&'
 	}
 
 	dst[j] = '\0';
@@ -218,21 +683,34 @@ static const unsigned char* get_next_char(const unsigned char* s, wchar_t* w)
 
 int html_entities_encode(char* dst, const char* src, int srcLen)
 {
-	int i, j;
-	wchar_t n;
+	int i, j, n;
+	wchar_t w;
+	const char* end;
 	const unsigned char* p, *p2;
 
 	j = 0;
+	end = src + srcLen;
 	p = (const unsigned char*)src;
-	while(p < (const unsigned char*)src+srcLen && *p)
+	while(p < (const unsigned char*)end && *p)
 	{
-		p2 = get_next_char(p, &n);
+		// copy plain text run
+		n = html_entities_encode_span((const char*)p, end);
+		memcpy(dst + j, p, n);
+		j += n;
+		p += n;
+		if (p >= (const unsigned char*)end || 0 == *p)
+			break;
+
+		p2 = get_next_char(p, &w);
 
-		i = html_entities_find_by_number(n);
-		if(i >= 0)
+		i = html_entities_find_by_number(w);
+		if(i >= 0 && i < HTML_ENTITIES_ENCODE)
 		{
-			sprintf(dst+j, "&%s;", s_entities[i].name);
-			j += strlen(s_entities[i].name) + 2;
+			n = (int)strlen(s_entities[i].name);
+			dst[j++] = '&';
+			memcpy(dst + j, s_entities[i].name, n);
+			j += n;
+			dst[j++] = ';';
 			p = p2;
 		}
 		else
@@ -245,3 +723,145 @@ int html_entities_encode(char* dst, const char* src, int srcLen)
 	dst[j] = 0;
 	return j;
 }
+
+#if defined(DEBUG) || defined(_DEBUG)
+#include <assert.h>
+
+static int html_entities_key(int number, int i, uint8_t key[HTML_ENTITIES_NAME_MAX])
+{
+	if (!number)
+	{
+		memcpy(key, s_entities[i].name, strlen(s_entities[i].name));
+		return (int)strlen(s_entities[i].name);
+	}
+
+	key[0] = (uint8_t)s_entities[i].number;
+	key[1] = (uint8_t)(s_entities[i].number >> 8);
+	key[2] = 0;
+	return 3;
+}
+
+/// generate perfect hash tables: multi-key buckets(largest first) search a seed for free slots,
+/// then single-key buckets take the remaining slots from the top
+/// @param[in] number 0-by name, 1-by number
+/// @return 0-ok, -1-no seed
+static int html_entities_perfect_hash(int number, int16_t disp[256], uint8_t slots[256])
+{
+	int i, j, k, n, b, size, seed;
+	int bucket[256][8];
+	int count[256];
+	uint8_t key[HTML_ENTITIES_NAME_MAX];
+	uint8_t slot[8];
+
+	memset(count, 0, sizeof(count));
+	memset(disp, 0, sizeof(disp[0]) * 256);
+	memset(slots, 0xFF, 256);
+	for (i = 0; i < html_entities_count(); i++)
+	{
+		n = html_entities_key(number, i, key);
+		b = (int)(html_entities_hash(0, key, n) & 0xFF);
+		if (count[b] >= 8)
+			return -1;
+		bucket[b][count[b]++] = i;
+	}
+
+	for (size = 8; size > 1; size--)
+	{
+		for (b = 0; b < 256; b++)
+		{
+			if (count[b] != size)
+				continue;
+
+			for (seed = 1; seed < 0x7FFF; seed++)
+			{
+				for (j = 0; j < size; j++)
+				{
+					n = html_entities_key(number, bucket[b][j], key);
+					slot[j] = (uint8_t)(html_entities_hash((uint32_t)seed, key, n) & 0xFF);
+					for (k = 0; k < j && slot[k] != slot[j]; k++)
+					{
+					}
+					if (k < j || 0xFF != slots[slot[j]])
+						break;
+				}
+				if (j == size)
+					break;
+			}
+			if (seed >= 0x7FFF)
+				return -1;
+
+			disp[b] = (int16_t)seed;
+			for (j = 0; j < size; j++)
+				slots[slot[j]] = (uint8_t)bucket[b][j];
+		}
+	}
+
+	for (k = 255, b = 0; b < 256; b++)
+	{
+		if (1 != count[b])
+			continue;
+		while (k >= 0 && 0xFF != slots[k])
+			k--;
+		if (k < 0)
+			return -1;
+		disp[b] = (int16_t)(-k - 1);
+		slots[k] = (uint8_t)bucket[b][0];
+	}
+	return 0;
+}
+
+#if defined(HTML_ENTITIES_GENERATE)
+static void html_entities_perfect_hash_print(const char* name, const int16_t disp[256], const uint8_t slots[256])
+{
+	int i;
+	printf("static const int16_t s_%s_disp[256] = {", name);
+	for (i = 0; i < 256; i++)
+		printf("%s%d,", 0 == i % 16 ? "\n\t" : " ", (int)disp[i]);
+	printf("\n};\nstatic const uint8_t s_%s_slots[256] = { // 0xFF-empty", name);
+	for (i = 0; i < 256; i++)
+		printf("%s%d,", 0 == i % 16 ? "\n\t" : " ", (int)slots[i]);
+	printf("\n};\n");
+}
+#endif
+
+void html_entities_test(void)
+{
+	int i;
+	int16_t disp[256];
+	uint8_t slots[256];
+	char name[16];
+	char buf[256];
+	wchar_t number;
+	const char* html = "&lt;p title=&quot;caf&eacute; &amp; cr&#232;me&quot;&gt;&copy;&nbsp;&alefsym;&unknown; &amp &#x4E2D;&#20013; a&b&lt;/p&gt;";
+	const char* text = "<p title=\"caf\xC3\xA9 & cr\xC3\xA8me\">\xC2\xA9\xC2\xA0\xE2\x84\xB5&unknown; &amp \xE4\xB8\xAD\xE4\xB8\xAD a&b</p>";
+
+	for (i = 0; i < html_entities_count(); i++)
+	{
+		html_entities_get(i, name, &number);
+		name[strlen(name) - 1] = 0; // ';'
+		assert(i == html_entities_find_by_name(name + 1, (int)strlen(name + 1)));
+		assert(i == html_entities_find_by_number(number));
+	}
+	assert(-1 == html_entities_find_by_name("ampx", 4) && -1 == html_entities_find_by_number(0x4E2D));
+
+	// embedded tables are up to date with s_entities
+	assert(0 == html_entities_perfect_hash(0, disp, slots));
+#if defined(HTML_ENTITIES_GENERATE)
+	html_entities_perfect_hash_print("name", disp, slots);
+#endif
+	assert(0 == memcmp(disp, s_name_disp, sizeof(disp)) && 0 == memcmp(slots, s_name_slots, sizeof(slots)));
+	assert(0 == html_entities_perfect_hash(1, disp, slots));
+#if defined(HTML_ENTITIES_GENERATE)
+	html_entities_perfect_hash_print("number", disp, slots);
+#endif
+	assert(0 == memcmp(disp, s_number_disp, sizeof(disp)) && 0 == memcmp(slots, s_number_slots, sizeof(slots)));
+
+	assert((int)strlen(text) == html_entities_decode(buf, html, (int)strlen(html)));
+	assert(0 == strcmp(buf, text));
+
+	// encode special characters only
+	html = "<a href='x?a=1&b=2'>\xC3\xA9\xC2\xA9\xE2\x82\xAC \"ok\"</a>";
+	assert(html_entities_encode(buf, html, (int)strlen(html)) > 0);
+	assert(0 == strcmp(buf, "&lt;a href=&apos;x?a=1&amp;b=2&apos;&gt;\xC3\xA9&copy;&euro; &quot;ok&quot;&lt;/a&gt;"));
+}
+#endif
@@ -1,6 +1,8 @@
 #if defined(OS_LINUX)
 #include "aio-socket.h"
 #include "sys/spinlock.h"
+#include "slab.h"
+#include "epoch.h"
 #include <sys/epoll.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -39,6 +41,7 @@
 
 static int s_epoll = -1;
 static int s_threads = 0;
+static struct slab_t* s_slab; // epoll_context cache, keep after aio_socket_clean(late release)
 
 struct epoll_context_accept
 {
@@ -197,7 +200,7 @@ static int aio_socket_release(struct epoll_context* ctx)
 #if defined(DEBUG) || defined(_DEBUG)
 		memset(ctx, 0xCC, sizeof(*ctx));
 #endif
-		free(ctx);
+		slab_free(s_slab, ctx);
 	}
 	return 0;
 }
@@ -205,6 +208,10 @@ static int aio_socket_release(struct epoll_context* ctx)
 int aio_socket_init(int threads)
 {
 	s_threads = threads;
+	if (!s_slab)
+		s_slab = slab_create(sizeof(struct epoll_context));
+	if (!s_slab)
+		return ENOMEM;
 
 	// Since Linux 2.6.8, the size argument is ignored, but must be greater than zero
 	s_epoll = epoll_create(10000/*10k*/);
@@ -220,12 +227,16 @@ int aio_socket_clean(void)
 
 int aio_socket_process(int timeout)
 {
-	int i, r;
+	int i, r, online;
 	uint32_t userevent;
 	struct epoll_context* ctx;
 	struct epoll_event events[1];
 
+	// QSBR: don't hold back epoch reclamation while blocked, callbacks run online
+	online = epoch_offline();
 	r = epoll_wait(s_epoll, events, 1, timeout);
+	if (online)
+		epoch_online();
 	for(i = 0; i < r; i++)
 	{
 		// EPOLLERR: Error condition happened on the associated file descriptor
@@ -349,7 +360,7 @@ aio_socket_t aio_socket_create(socket_t socket, int own)
 {
 //	int flags;
 	struct epoll_context* ctx;
-	ctx = (struct epoll_context*)calloc(1, sizeof(struct epoll_context));
+	ctx = s_slab ? (struct epoll_context*)slab_calloc(s_slab) : NULL; // aio_socket_init
 	if(!ctx)
 		return NULL;
 
@@ -1,5 +1,6 @@
 #if defined(OS_WINDOWS)
 #include "aio-socket.h"
+#include "epoch.h"
 #include <WS2tcpip.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -424,13 +425,23 @@ int aio_socket_clean(void)
 
 int aio_socket_process(int timeout)
 {
+	BOOL r;
+	DWORD err;
 	DWORD bytes;
 	ULONG_PTR completionKey;
 	OVERLAPPED *pOverlapped;
 	struct aio_context *ctx;
 	struct aio_context_action *aio;
+	int online;
 
-	if(GetQueuedCompletionStatus(s_iocp, &bytes, &completionKey, &pOverlapped, timeout))
+	// QSBR: don't hold back epoch reclamation while blocked, callbacks run online
+	online = epoch_offline();
+	r = GetQueuedCompletionStatus(s_iocp, &bytes, &completionKey, &pOverlapped, timeout);
+	err = r ? 0 : GetLastError();
+	if (online)
+		epoch_online();
+
+	if(r)
 	{
 		assert(completionKey && pOverlapped);
 
@@ -444,7 +455,6 @@ int aio_socket_process(int timeout)
 	}
 	else
 	{
-		DWORD err = GetLastError();
 		if(NULL == pOverlapped)
 		{
 			if(WAIT_TIMEOUT == err)
@@ -1,6 +1,7 @@
 #if defined(OS_MAC)
 #include "aio-socket.h"
 #include "sys/atomic.h"
+#include "epoch.h"
 #include <sys/types.h>
 #include <sys/event.h>
 #include <sys/time.h>
@@ -179,7 +180,7 @@ int aio_socket_clean(void)
 
 int aio_socket_process(int timeout)
 {
-	int i, r;
+	int i, r, online;
 	struct timespec ts;
 	struct kevent events[1];
 	struct kqueue_context *ctx;
@@ -187,7 +188,11 @@ int aio_socket_process(int timeout)
 	ts.tv_sec = timeout / 1000;
 	ts.tv_nsec = (timeout % 1000) * 1000000;
 
+	// QSBR: don't hold back epoch reclamation while blocked, callbacks run online
+	online = epoch_offline();
 	r = kevent(s_kqueue, NULL, 0, events, 1, &ts);
+	if (online)
+		epoch_online();
 	for(i = 0; i < r; i++)
 	{
 		assert(events[i].udata);
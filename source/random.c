@@ -1,3 +1,9 @@
+// per-thread ChaCha20 CSPRNG
+// 1. seed from OS entropy once per thread(getrandom/arc4random_buf/CryptGenRandom, /dev/urandom fallback)
+// 2. fast-key-erasure: the first 32-bytes keystream of every refill replace the key, output bytes are wiped after use
+//    https://blog.cr.yp.to/20170723-random.html
+// 3. reseed in fork child(pthread_atfork) and every RANDOM_RESEED output bytes
+
 #include <math.h>
 #include <time.h>
 #include <stdlib.h>
@@ -6,14 +12,15 @@
 
 #if defined(OS_WINDOWS) || defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
+#define THREAD_LOCAL static __declspec(thread)
 
-int read_random(void* ptr, int bytes)
+static int random_entropy(void* ptr, int bytes)
 {
     HCRYPTPROV provider;
     if (!CryptAcquireContext(&provider, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT | CRYPT_SILENT))
-        return 0;
-    
-    CryptGenRandom(provider, bytes, (PBYTE)ptr);
+        return -1;
+
+    bytes = CryptGenRandom(provider, bytes, (PBYTE)ptr) ? bytes : -1;
     CryptReleaseContext(provider, 0);
     return bytes;
 }
@@ -22,7 +29,20 @@ int read_random(void* ptr, int bytes)
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
+#if defined(OS_LINUX)
+#include <sys/syscall.h>
+#endif
+#define THREAD_LOCAL static __thread
 
+#if defined(OS_MAC)
+static int random_entropy(void* ptr, int bytes)
+{
+    arc4random_buf(ptr, bytes);
+    return bytes;
+}
+
+#else
 static int read_random_file(const char *file, void* ptr, int bytes)
 {
     int fd = open(file, O_RDONLY);
@@ -34,25 +54,34 @@ static int read_random_file(const char *file, void* ptr, int bytes)
     return err;
 }
 
-int read_random(void* ptr, int bytes)
+static int random_entropy(void* ptr, int bytes)
 {
     int r;
+#if defined(SYS_getrandom)
+    r = (int)syscall(SYS_getrandom, ptr, (size_t)bytes, 0);
+    if (r == bytes)
+        return r;
+#endif
     r = read_random_file("/dev/urandom", ptr, bytes);
     if (-1 == r)
         r = read_random_file("/dev/random", ptr, bytes);
     return r;
 }
+#endif
+
 #else
+#define THREAD_LOCAL static
 
-int read_random(void* ptr, int bytes)
+// don't have entropy source
+static int random_entropy(void* ptr, int bytes)
 {
     int i, v;
-    for(i = 0; i < bytes / sizeof(int); i++)
+    for(i = 0; i < bytes / (int)sizeof(int); i++)
     {
         v = rand();
         memcpy((char*)ptr + i * sizeof(int), &v, sizeof(int));
     }
-    
+
     if(0 != bytes % sizeof(int))
     {
         v = rand();
@@ -62,3 +91,162 @@ int read_random(void* ptr, int bytes)
 }
 
 #endif
+
+#define RANDOM_BLOCKS 8 // 512-bytes keystream per refill
+#define RANDOM_RESEED (1 << 20)
+
+#define CHACHA20_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define CHACHA20_QR(a, b, c, d)					\
+	a += b; d ^= a; d = CHACHA20_ROTL(d, 16);	\
+	c += d; b ^= c; b = CHACHA20_ROTL(b, 12);	\
+	a += b; d ^= a; d = CHACHA20_ROTL(d, 8);	\
+	c += d; b ^= c; b = CHACHA20_ROTL(b, 7)
+
+struct random_chacha20_t
+{
+	uint32_t key[8];
+	uint8_t buf[64 * RANDOM_BLOCKS];
+	int avail; // unread bytes at the end of buf
+	int32_t generation; // fork generation, 0-not seeded
+	uint32_t output; // output bytes since last seed
+};
+
+THREAD_LOCAL struct random_chacha20_t s_random;
+static volatile int32_t s_generation = 1; // increase in fork child
+
+// rfc8439 2.3. The ChaCha20 Block Function
+static void chacha20_block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], uint8_t out[64])
+{
+	int i;
+	uint32_t s[16], x[16];
+
+	s[0] = 0x61707865;
+	s[1] = 0x3320646e;
+	s[2] = 0x79622d32;
+	s[3] = 0x6b206574;
+	memcpy(s + 4, key, 32);
+	s[12] = counter;
+	s[13] = nonce[0];
+	s[14] = nonce[1];
+	s[15] = nonce[2];
+	memcpy(x, s, sizeof(x));
+
+	for (i = 0; i < 10; i++)
+	{
+		CHACHA20_QR(x[0], x[4], x[8], x[12]);
+		CHACHA20_QR(x[1], x[5], x[9], x[13]);
+		CHACHA20_QR(x[2], x[6], x[10], x[14]);
+		CHACHA20_QR(x[3], x[7], x[11], x[15]);
+		CHACHA20_QR(x[0], x[5], x[10], x[15]);
+		CHACHA20_QR(x[1], x[6], x[11], x[12]);
+		CHACHA20_QR(x[2], x[7], x[8], x[13]);
+		CHACHA20_QR(x[3], x[4], x[9], x[14]);
+	}
+
+	for (i = 0; i < 16; i++)
+	{
+		x[i] += s[i];
+		out[i * 4 + 0] = (uint8_t)(x[i]);
+		out[i * 4 + 1] = (uint8_t)(x[i] >> 8);
+		out[i * 4 + 2] = (uint8_t)(x[i] >> 16);
+		out[i * 4 + 3] = (uint8_t)(x[i] >> 24);
+	}
+}
+
+static void random_refill(struct random_chacha20_t* r)
+{
+	int i;
+	static const uint32_t nonce[3] = { 0, 0, 0 };
+
+	// key is used only once, counter can restart from 0
+	for (i = 0; i < RANDOM_BLOCKS; i++)
+		chacha20_block(r->key, (uint32_t)i, nonce, r->buf + i * 64);
+
+	memcpy(r->key, r->buf, sizeof(r->key));
+	memset(r->buf, 0, sizeof(r->key));
+	r->avail = (int)(sizeof(r->buf) - sizeof(r->key));
+}
+
+#if defined(OS_LINUX) || defined(OS_MAC)
+static pthread_once_t s_random_once = PTHREAD_ONCE_INIT;
+
+static void random_atfork_child(void)
+{
+	// child process has a copy of parent thread state, force reseed
+	++s_generation;
+}
+
+static void random_atfork(void)
+{
+	pthread_atfork(NULL, NULL, random_atfork_child);
+}
+#endif
+
+static int random_seed(struct random_chacha20_t* r)
+{
+#if defined(OS_LINUX) || defined(OS_MAC)
+	pthread_once(&s_random_once, random_atfork);
+#endif
+
+	if ((int)sizeof(r->key) != random_entropy(r->key, sizeof(r->key)))
+		return -1;
+
+	memset(r->buf, 0, sizeof(r->buf));
+	r->avail = 0;
+	r->output = 0;
+	r->generation = s_generation;
+	return 0;
+}
+
+/// Fill buffer with cryptographically secure random bytes, any size
+/// @return bytes, -1 if seed failed
+int read_random(void* ptr, int bytes)
+{
+	int n, offset, total;
+	uint8_t* p;
+	struct random_chacha20_t* r;
+
+	r = &s_random;
+	if ((r->generation != s_generation || r->output >= RANDOM_RESEED) && 0 != random_seed(r))
+		return -1;
+
+	p = (uint8_t*)ptr;
+	r->output += bytes > 0 ? (uint32_t)bytes : 0;
+	for (total = bytes; bytes > 0; bytes -= n)
+	{
+		if (0 == r->avail)
+			random_refill(r);
+
+		n = bytes < r->avail ? bytes : r->avail;
+		offset = (int)sizeof(r->buf) - r->avail;
+		memcpy(p, r->buf + offset, n);
+		memset(r->buf + offset, 0, n);
+		r->avail -= n;
+		p += n;
+	}
+	return total;
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+#include <assert.h>
+void random_test(void)
+{
+	int i;
+	uint8_t out[64];
+	uint8_t v1[600], v2[600];
+	uint32_t key[8];
+	static const uint32_t nonce[3] = { 0x09000000, 0x4a000000, 0x00000000 };
+	static const uint8_t block[16] = { 0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4 };
+
+	// rfc8439 2.3.2. Test Vector for the ChaCha20 Block Function
+	for (i = 0; i < 8; i++)
+		key[i] = (uint32_t)(i * 4) | ((uint32_t)(i * 4 + 1) << 8) | ((uint32_t)(i * 4 + 2) << 16) | ((uint32_t)(i * 4 + 3) << 24);
+	chacha20_block(key, 1, nonce, out);
+	assert(0 == memcmp(out, block, sizeof(block)));
+
+	assert((int)sizeof(v1) == read_random(v1, sizeof(v1)));
+	assert(1 == read_random(v2, 1) && 0 == read_random(v2, 0));
+	assert((int)sizeof(v2) == read_random(v2, sizeof(v2)));
+	assert(0 != memcmp(v1, v2, sizeof(v1)));
+}
+#endif
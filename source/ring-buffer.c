@@ -1,9 +1,21 @@
 #include "ring-buffer.h"
+#include "sys/atomic.h"
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#if defined(OS_WINDOWS)
+#include <Windows.h>
+#elif !defined(OS_RTOS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
 
 int ring_buffer_alloc(struct ring_buffer_t* rb, size_t capacity)
 {
@@ -126,6 +138,337 @@ int ring_buffer_resize(struct ring_buffer_t* rb, size_t capacity)
 	return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////
+/// lock-free ring
+/// positions are free-running 32-bits counters, offset = position & (capacity - 1)
+
+#define RING_RECORD_ALIGN(n)	(((n) + 7) & ~7u)
+#define RING_RECORD_COMMIT		1
+#define RING_RECORD_PADDING		2
+
+// mpsc record header, consumer zero the record memory after consume,
+// so the header of a reserved(not committed) record is always 0
+struct ring_record_t
+{
+	volatile int32_t flag; // 0-reserved, RING_RECORD_COMMIT, RING_RECORD_PADDING
+	uint32_t bytes; // payload bytes
+};
+
+static size_t ring_mirror_granularity(void)
+{
+#if defined(OS_WINDOWS)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return si.dwAllocationGranularity;
+#elif defined(OS_RTOS)
+	return 0;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// map the same memory twice: [ptr, ptr + capacity) and [ptr + capacity, ptr + 2 * capacity)
+static void* ring_mirror_alloc(size_t capacity)
+{
+#if defined(OS_WINDOWS)
+	int retry;
+	HANDLE h;
+	uint8_t* p;
+	void *v1, *v2;
+
+	h = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)capacity >> 32), (DWORD)capacity, NULL);
+	if (NULL == h)
+		return NULL;
+
+	// find a free address range, other thread may take it before MapViewOfFileEx, retry
+	for (retry = 0; retry < 16; retry++)
+	{
+		p = (uint8_t*)VirtualAlloc(NULL, capacity * 2, MEM_RESERVE, PAGE_NOACCESS);
+		if (NULL == p)
+			break;
+		VirtualFree(p, 0, MEM_RELEASE);
+
+		v1 = MapViewOfFileEx(h, FILE_MAP_ALL_ACCESS, 0, 0, capacity, p);
+		v2 = v1 ? MapViewOfFileEx(h, FILE_MAP_ALL_ACCESS, 0, 0, capacity, p + capacity) : NULL;
+		if (v1 && v2)
+		{
+			CloseHandle(h); // views hold the section
+			return p;
+		}
+
+		if (v1)
+			UnmapViewOfFile(v1);
+	}
+
+	CloseHandle(h);
+	return NULL;
+
+#elif defined(OS_RTOS)
+	(void)capacity;
+	return NULL;
+
+#else
+	int fd;
+	uint8_t* p;
+	char name[32];
+	static volatile int32_t s_seq = 0;
+
+	fd = -1;
+#if defined(__linux__) && defined(SYS_memfd_create)
+	fd = (int)syscall(SYS_memfd_create, "ring-buffer", 1 /*MFD_CLOEXEC*/);
+#endif
+	if (-1 == fd)
+	{
+		// anonymous shared memory
+		snprintf(name, sizeof(name), "/rb.%d.%d", (int)getpid(), (int)atomic_increment32(&s_seq));
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (-1 == fd)
+			return NULL;
+		shm_unlink(name);
+	}
+
+	p = MAP_FAILED;
+	if (0 == ftruncate(fd, (off_t)capacity))
+	{
+		// reserve address range, then replace with two shared mappings
+		p = (uint8_t*)mmap(NULL, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED != p
+			&& (MAP_FAILED == mmap(p, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+				|| MAP_FAILED == mmap(p + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)))
+		{
+			munmap(p, capacity * 2);
+			p = MAP_FAILED;
+		}
+	}
+
+	close(fd); // mappings hold the memory
+	return MAP_FAILED == p ? NULL : p;
+#endif
+}
+
+static void ring_mirror_free(void* ptr, size_t capacity)
+{
+#if defined(OS_WINDOWS)
+	UnmapViewOfFile(ptr);
+	UnmapViewOfFile((uint8_t*)ptr + capacity);
+#elif defined(OS_RTOS)
+	(void)ptr, (void)capacity;
+#else
+	munmap(ptr, capacity * 2);
+#endif
+}
+
+static int ring_alloc(uint8_t** ptr, uint32_t* capacity, size_t bytes, int mirror)
+{
+	size_t n, granularity;
+
+	granularity = mirror ? ring_mirror_granularity() : 1;
+	if (0 == granularity)
+		return -ENOSYS;
+
+	bytes = bytes > granularity ? bytes : granularity;
+	if (bytes > (1u << 30))
+		return -E2BIG;
+	for (n = 8; n < bytes; n *= 2)
+	{
+	}
+
+	*ptr = mirror ? (uint8_t*)ring_mirror_alloc(n) : (uint8_t*)calloc(1, n);
+	if (NULL == *ptr)
+		return -ENOMEM;
+	*capacity = (uint32_t)n;
+	return 0;
+}
+
+static void ring_free(uint8_t* ptr, uint32_t capacity, int mirror)
+{
+	if (mirror)
+		ring_mirror_free(ptr, capacity);
+	else
+		free(ptr);
+}
+
+int ring_spsc_alloc(struct ring_spsc_t* rb, size_t capacity, int mirror)
+{
+	memset(rb, 0, sizeof(*rb));
+	rb->mirror = mirror ? 1 : 0;
+	return ring_alloc(&rb->ptr, &rb->capacity, capacity, rb->mirror);
+}
+
+int ring_spsc_free(struct ring_spsc_t* rb)
+{
+	if (!rb || !rb->ptr)
+		return -EINVAL;
+
+	ring_free(rb->ptr, rb->capacity, rb->mirror);
+	rb->ptr = NULL;
+	rb->capacity = 0;
+	return 0;
+}
+
+void* ring_spsc_reserve(struct ring_spsc_t* rb, size_t* bytes)
+{
+	uint32_t head, offset, n;
+
+	head = (uint32_t)rb->head;
+	offset = head & (rb->capacity - 1);
+	n = rb->capacity - (head - rb->tail_cache);
+	n = (rb->mirror || n < rb->capacity - offset) ? n : rb->capacity - offset;
+	if (0 == n || n < *bytes)
+	{
+		// only touch the consumer cache line if cached space isn't enough
+		rb->tail_cache = (uint32_t)atomic_load_acquire32(&rb->tail);
+		n = rb->capacity - (head - rb->tail_cache);
+		n = (rb->mirror || n < rb->capacity - offset) ? n : rb->capacity - offset;
+		if (0 == n || n < *bytes)
+			return NULL;
+	}
+
+	*bytes = n;
+	return rb->ptr + offset;
+}
+
+void ring_spsc_commit(struct ring_spsc_t* rb, size_t bytes)
+{
+	assert(bytes <= rb->capacity - ((uint32_t)rb->head - rb->tail_cache));
+	atomic_store_release32(&rb->head, (int32_t)((uint32_t)rb->head + (uint32_t)bytes));
+}
+
+const void* ring_spsc_peek(struct ring_spsc_t* rb, size_t* bytes)
+{
+	uint32_t tail, offset, n;
+
+	tail = (uint32_t)rb->tail;
+	offset = tail & (rb->capacity - 1);
+	n = rb->head_cache - tail;
+	n = (rb->mirror || n < rb->capacity - offset) ? n : rb->capacity - offset;
+	if (0 == n || n < *bytes)
+	{
+		rb->head_cache = (uint32_t)atomic_load_acquire32(&rb->head);
+		n = rb->head_cache - tail;
+		n = (rb->mirror || n < rb->capacity - offset) ? n : rb->capacity - offset;
+		if (0 == n || n < *bytes)
+			return NULL;
+	}
+
+	*bytes = n;
+	return rb->ptr + offset;
+}
+
+void ring_spsc_consume(struct ring_spsc_t* rb, size_t bytes)
+{
+	assert(bytes <= rb->head_cache - (uint32_t)rb->tail);
+	atomic_store_release32(&rb->tail, (int32_t)((uint32_t)rb->tail + (uint32_t)bytes));
+}
+
+int ring_mpsc_alloc(struct ring_mpsc_t* rb, size_t capacity, int mirror)
+{
+	memset(rb, 0, sizeof(*rb));
+	rb->mirror = mirror ? 1 : 0;
+	return ring_alloc(&rb->ptr, &rb->capacity, capacity, rb->mirror);
+}
+
+int ring_mpsc_free(struct ring_mpsc_t* rb)
+{
+	if (!rb || !rb->ptr)
+		return -EINVAL;
+
+	ring_free(rb->ptr, rb->capacity, rb->mirror);
+	rb->ptr = NULL;
+	rb->capacity = 0;
+	return 0;
+}
+
+void* ring_mpsc_reserve(struct ring_mpsc_t* rb, size_t bytes)
+{
+	uint32_t head, tail, offset, need, padding;
+	struct ring_record_t* record;
+
+	if (bytes + sizeof(struct ring_record_t) > rb->capacity)
+		return NULL;
+	need = RING_RECORD_ALIGN((uint32_t)bytes + sizeof(struct ring_record_t));
+
+	for (;;)
+	{
+		// load tail before head: tail <= head
+		tail = (uint32_t)atomic_load_acquire32(&rb->tail);
+		head = (uint32_t)atomic_load_acquire32(&rb->head);
+		if (head - tail > rb->capacity)
+			continue; // stale tail, the ring has moved more than one round
+
+		// record can't cross the buffer end, fill the tail with a padding record
+		offset = head & (rb->capacity - 1);
+		padding = (!rb->mirror && offset + need > rb->capacity) ? rb->capacity - offset : 0;
+		if (padding + need > rb->capacity - (head - tail))
+			return NULL; // full
+
+		if (atomic_cas32(&rb->head, (int32_t)head, (int32_t)(head + padding + need)))
+			break;
+	}
+
+	if (padding > 0)
+	{
+		record = (struct ring_record_t*)(rb->ptr + offset);
+		record->bytes = padding - sizeof(struct ring_record_t);
+		atomic_store_release32(&record->flag, RING_RECORD_PADDING);
+		offset = 0;
+	}
+
+	record = (struct ring_record_t*)(rb->ptr + offset);
+	assert(0 == record->flag);
+	record->bytes = (uint32_t)bytes;
+	return record + 1;
+}
+
+void ring_mpsc_commit(struct ring_mpsc_t* rb, void* ptr)
+{
+	struct ring_record_t* record;
+	record = (struct ring_record_t*)ptr - 1;
+	assert((uint8_t*)record >= rb->ptr && (uint8_t*)record < rb->ptr + rb->capacity);
+	atomic_store_release32(&record->flag, RING_RECORD_COMMIT);
+	(void)rb;
+}
+
+const void* ring_mpsc_peek(struct ring_mpsc_t* rb, size_t* bytes)
+{
+	int32_t flag;
+	struct ring_record_t* record;
+
+	for (;;)
+	{
+		record = (struct ring_record_t*)(rb->ptr + ((uint32_t)rb->tail & (rb->capacity - 1)));
+		flag = atomic_load_acquire32(&record->flag);
+		if (RING_RECORD_COMMIT == flag)
+		{
+			*bytes = record->bytes;
+			return record + 1;
+		}
+		else if (RING_RECORD_PADDING == flag)
+		{
+			ring_mpsc_consume(rb);
+		}
+		else
+		{
+			return NULL; // empty or the next record is reserved but not committed
+		}
+	}
+}
+
+void ring_mpsc_consume(struct ring_mpsc_t* rb)
+{
+	uint32_t tail, n;
+	struct ring_record_t* record;
+
+	tail = (uint32_t)rb->tail;
+	record = (struct ring_record_t*)(rb->ptr + (tail & (rb->capacity - 1)));
+	assert(RING_RECORD_COMMIT == record->flag || RING_RECORD_PADDING == record->flag);
+	n = RING_RECORD_ALIGN(record->bytes + sizeof(struct ring_record_t));
+
+	// producers may place a record header at any 8-bytes aligned position
+	memset(record, 0, n);
+	atomic_store_release32(&rb->tail, (int32_t)(tail + n));
+}
+
 #if defined(DEBUG) || defined(_DEBUG)
 #include <math.h>
 #include <time.h>
@@ -136,6 +479,173 @@ int ring_buffer_resize(struct ring_buffer_t* rb, size_t capacity)
 #define N 128000
 #endif
 
+#if !defined(OS_RTOS)
+#include "sys/thread.h"
+#include "sys/system.h"
+
+#define RING_PRODUCERS 3
+
+struct ring_test_t
+{
+	struct ring_spsc_t* spsc;
+	struct ring_mpsc_t* mpsc;
+	const uint8_t* src;
+	int id;
+};
+
+static int STDCALL ring_spsc_producer(void* param)
+{
+	int i;
+	size_t n;
+	uint8_t* p;
+	struct ring_test_t* t;
+	t = (struct ring_test_t*)param;
+
+	for (i = 0; i < N; i += (int)n)
+	{
+		n = 0;
+		p = (uint8_t*)ring_spsc_reserve(t->spsc, &n);
+		if (NULL == p)
+		{
+			system_sleep(0);
+			continue;
+		}
+
+		n = (size_t)(rand() % (int)n) + 1;
+		n = n < (size_t)(N - i) ? n : (size_t)(N - i);
+		memcpy(p, t->src + i, n);
+		ring_spsc_commit(t->spsc, n);
+	}
+	return 0;
+}
+
+static void ring_spsc_test(const uint8_t* src, uint8_t* dst, int mirror)
+{
+	int i;
+	size_t n;
+	pthread_t thread;
+	const uint8_t* p;
+	struct ring_test_t t;
+	struct ring_spsc_t spsc;
+
+	t.spsc = &spsc;
+	t.src = src;
+	assert(0 == ring_spsc_alloc(&spsc, 1000, mirror));
+	assert(spsc.capacity >= 1024 && 0 == (spsc.capacity & (spsc.capacity - 1)));
+
+	// contiguous across buffer end
+	n = spsc.capacity - 8;
+	assert(ring_spsc_reserve(&spsc, &n) && n == spsc.capacity);
+	ring_spsc_commit(&spsc, spsc.capacity - 8);
+	n = 0;
+	assert(ring_spsc_peek(&spsc, &n) && n == spsc.capacity - 8);
+	ring_spsc_consume(&spsc, n);
+	n = 16;
+	assert(mirror ? !!ring_spsc_reserve(&spsc, &n) : !ring_spsc_reserve(&spsc, &n));
+	n = 0;
+	assert(ring_spsc_reserve(&spsc, &n) && n == (mirror ? spsc.capacity : 8));
+	ring_spsc_commit(&spsc, 0);
+
+	assert(0 == thread_create(&thread, ring_spsc_producer, &t));
+	for (i = 0; i < N; i += (int)n)
+	{
+		n = 0;
+		p = (const uint8_t*)ring_spsc_peek(&spsc, &n);
+		if (NULL == p)
+		{
+			system_sleep(0);
+			continue;
+		}
+
+		n = (size_t)(rand() % (int)n) + 1;
+		memcpy(dst + i, p, n);
+		ring_spsc_consume(&spsc, n);
+	}
+	thread_destroy(thread);
+
+	assert(0 == memcmp(src, dst, N));
+	ring_spsc_free(&spsc);
+}
+
+static int STDCALL ring_mpsc_producer(void* param)
+{
+	int i;
+	size_t n;
+	uint8_t* p;
+	struct ring_test_t* t;
+	t = (struct ring_test_t*)param;
+
+	for (i = 0; i < N / 100; i++)
+	{
+		// record: id + seq + payload
+		n = 8 + (size_t)(rand() % 100);
+		while (NULL == (p = (uint8_t*)ring_mpsc_reserve(t->mpsc, n)))
+			system_sleep(0);
+
+		memcpy(p, &t->id, 4);
+		memcpy(p + 4, &i, 4);
+		memcpy(p + 8, t->src + i, n - 8);
+		ring_mpsc_commit(t->mpsc, p);
+	}
+	return 0;
+}
+
+static void ring_mpsc_test(const uint8_t* src, int mirror)
+{
+	int i, id, seq, count;
+	int seqs[RING_PRODUCERS];
+	size_t n;
+	const uint8_t* p;
+	pthread_t threads[RING_PRODUCERS];
+	struct ring_test_t t[RING_PRODUCERS];
+	struct ring_mpsc_t mpsc;
+
+	assert(0 == ring_mpsc_alloc(&mpsc, 1000, mirror));
+	assert(NULL == ring_mpsc_peek(&mpsc, &n));
+	assert(NULL == ring_mpsc_reserve(&mpsc, mpsc.capacity));
+
+	// uncommitted record block the later records
+	p = (const uint8_t*)ring_mpsc_reserve(&mpsc, 3);
+	assert(p && 0 == (uintptr_t)p % 8);
+	ring_mpsc_commit(&mpsc, ring_mpsc_reserve(&mpsc, 5));
+	assert(NULL == ring_mpsc_peek(&mpsc, &n));
+	ring_mpsc_commit(&mpsc, (void*)p);
+	assert(p == ring_mpsc_peek(&mpsc, &n) && 3 == n);
+	ring_mpsc_consume(&mpsc);
+	assert(ring_mpsc_peek(&mpsc, &n) && 5 == n);
+	ring_mpsc_consume(&mpsc);
+	assert(NULL == ring_mpsc_peek(&mpsc, &n));
+
+	for (i = 0; i < RING_PRODUCERS; i++)
+	{
+		t[i].mpsc = &mpsc;
+		t[i].src = src;
+		t[i].id = i;
+		seqs[i] = 0;
+	}
+
+	for (i = 0; i < RING_PRODUCERS; i++)
+		assert(0 == thread_create(&threads[i], ring_mpsc_producer, &t[i]));
+
+	for (count = 0; count < RING_PRODUCERS * (N / 100); count++)
+	{
+		while (NULL == (p = (const uint8_t*)ring_mpsc_peek(&mpsc, &n)))
+			system_sleep(0);
+
+		memcpy(&id, p, 4);
+		memcpy(&seq, p + 4, 4);
+		assert(id >= 0 && id < RING_PRODUCERS && seq == seqs[id]++); // per-producer order
+		assert(n >= 8 && 0 == memcmp(p + 8, src + seq, n - 8));
+		ring_mpsc_consume(&mpsc);
+	}
+
+	for (i = 0; i < RING_PRODUCERS; i++)
+		thread_destroy(threads[i]);
+	assert(NULL == ring_mpsc_peek(&mpsc, &n));
+	ring_mpsc_free(&mpsc);
+}
+#endif
+
 void ring_buffer_test(void)
 {
 	int n;
@@ -190,6 +700,13 @@ void ring_buffer_test(void)
 
 	assert(0 == memcmp(src, dst, N));
 	ring_buffer_free(&rb);
+
+#if !defined(OS_RTOS)
+	ring_spsc_test(src, dst, 0);
+	ring_spsc_test(src, dst, 1);
+	ring_mpsc_test(src, 0);
+	ring_mpsc_test(src, 1);
+#endif
 	free(src);
 	free(dst);
 }
@@ -0,0 +1,441 @@
+// magazine layer: shard(loaded + previous magazine) -> depot(full/empty magazine lists) -> chunk
+// alloc: loaded not empty -> pop; previous full -> swap; depot full magazine -> exchange; carve from chunk
+// free: loaded not full -> push; previous empty -> swap; depot empty magazine(or new one) -> exchange
+//
+// shard is selected by a per-thread index(process-wide, round-robin on first use) masked to nshards
+// (<= 2 * cpu count, max SLAB_SHARDS). Indexes are not recycled on thread exit(no thread-exit hook), so
+// once more threads than nshards have taken an index, threads share shards and the shard lock may be
+// contended. The lock is held only for a few pointer moves, the depot lock only for magazine exchange.
+
+#include "slab.h"
+#include "sys/atomic.h"
+#include "sys/spinlock.h"
+#include "sys/system.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(OS_WINDOWS) || defined(_WIN32) || defined(_WIN64)
+#define THREAD_LOCAL static __declspec(thread)
+#elif defined(OS_LINUX) || defined(OS_MAC)
+#define THREAD_LOCAL static __thread
+#else
+#define THREAD_LOCAL static
+#endif
+
+#define SLAB_MAGAZINE	30 // objects per magazine
+#define SLAB_SHARDS		64
+#define SLAB_CHUNK		(64 * 1024)
+#define SLAB_ALIGN(n)	(((n) + 15) & ~(size_t)15)
+
+struct slab_magazine_t
+{
+	struct slab_magazine_t* next;
+	int n;
+	void* objects[SLAB_MAGAZINE];
+};
+
+struct slab_chunk_t
+{
+	struct slab_chunk_t* next;
+	size_t padding; // object alignment
+};
+
+struct slab_shard_t
+{
+	spinlock_t locker;
+	struct slab_magazine_t* loaded;
+	struct slab_magazine_t* previous;
+	uint64_t allocs;
+	uint64_t frees;
+	char padding[64]; // avoid false sharing
+};
+
+struct slab_t
+{
+	size_t size; // object size
+	size_t count; // objects per chunk
+
+	spinlock_t locker; // depot
+	struct slab_magazine_t* full;
+	struct slab_magazine_t* empty;
+	void* loose; // free objects without magazine(out of memory)
+	struct slab_chunk_t* chunks;
+	uint8_t* cursor; // next object in the first chunk
+	size_t remain; // objects left in the first chunk
+	size_t nchunks;
+	size_t nfull; // full magazines in depot
+
+	int nshards; // power of 2
+	struct slab_shard_t shards[1];
+};
+
+static volatile int32_t s_thread_index;
+THREAD_LOCAL int s_shard_index = -1;
+
+static struct slab_shard_t* slab_shard(struct slab_t* slab)
+{
+	if (s_shard_index < 0)
+		s_shard_index = (int)(atomic_increment32(&s_thread_index) & 0x7FFFFFFF);
+	return &slab->shards[s_shard_index & (slab->nshards - 1)];
+}
+
+struct slab_t* slab_create(size_t size)
+{
+	int i, n;
+	struct slab_t* slab;
+
+	// two threads per cpu
+	for (n = 1; n < SLAB_SHARDS && n < 2 * (int)system_getcpucount(); n *= 2)
+	{
+	}
+
+	slab = (struct slab_t*)calloc(1, sizeof(*slab) + (n - 1) * sizeof(struct slab_shard_t));
+	if (!slab)
+		return NULL;
+
+	slab->size = SLAB_ALIGN(size < sizeof(void*) ? sizeof(void*) : size);
+	slab->count = (SLAB_CHUNK - sizeof(struct slab_chunk_t)) / slab->size;
+	slab->count = slab->count < 8 ? 8 : slab->count;
+	slab->nshards = n;
+	spinlock_create(&slab->locker);
+	for (i = 0; i < n; i++)
+		spinlock_create(&slab->shards[i].locker);
+	return slab;
+}
+
+static void slab_magazine_free(struct slab_magazine_t* m)
+{
+	struct slab_magazine_t* next;
+	for (; m; m = next)
+	{
+		next = m->next;
+		free(m);
+	}
+}
+
+void slab_destroy(struct slab_t* slab)
+{
+	int i;
+	struct slab_chunk_t *chunk, *next;
+	struct slab_stats_t stats;
+
+	if (!slab)
+		return;
+
+	slab_stats(slab, &stats);
+	assert(0 == stats.inuse);
+
+	for (i = 0; i < slab->nshards; i++)
+	{
+		free(slab->shards[i].loaded);
+		free(slab->shards[i].previous);
+		spinlock_destroy(&slab->shards[i].locker);
+	}
+
+	slab_magazine_free(slab->full);
+	slab_magazine_free(slab->empty);
+	for (chunk = slab->chunks; chunk; chunk = next)
+	{
+		next = chunk->next;
+		free(chunk);
+	}
+
+	spinlock_destroy(&slab->locker);
+	free(slab);
+}
+
+/// carve an object, depot locked
+static void* slab_carve(struct slab_t* slab)
+{
+	void* ptr;
+	struct slab_chunk_t* chunk;
+
+	if (slab->loose)
+	{
+		ptr = slab->loose;
+		slab->loose = *(void**)ptr;
+		return ptr;
+	}
+
+	if (0 == slab->remain)
+	{
+		chunk = (struct slab_chunk_t*)malloc(sizeof(struct slab_chunk_t) + slab->count * slab->size);
+		if (!chunk)
+			return NULL;
+
+		chunk->next = slab->chunks;
+		slab->chunks = chunk;
+		slab->cursor = (uint8_t*)(chunk + 1);
+		slab->remain = slab->count;
+		slab->nchunks++;
+	}
+
+	ptr = slab->cursor;
+	slab->cursor += slab->size;
+	slab->remain--;
+	return ptr;
+}
+
+/// shard locked, loaded and previous magazine are empty
+static void* slab_depot_alloc(struct slab_t* slab, struct slab_shard_t* shard)
+{
+	void* ptr;
+	struct slab_magazine_t* m;
+
+	spinlock_lock(&slab->locker);
+	m = slab->full;
+	if (m)
+	{
+		slab->full = m->next;
+		slab->nfull--;
+		if (shard->previous)
+		{
+			shard->previous->next = slab->empty;
+			slab->empty = shard->previous;
+		}
+		shard->previous = shard->loaded;
+		shard->loaded = m;
+		ptr = m->objects[--m->n];
+	}
+	else
+	{
+		ptr = slab_carve(slab);
+	}
+	spinlock_unlock(&slab->locker);
+	return ptr;
+}
+
+/// shard locked, loaded and previous magazine are full(or NULL)
+static void slab_depot_free(struct slab_t* slab, struct slab_shard_t* shard, void* ptr)
+{
+	struct slab_magazine_t* m;
+
+	spinlock_lock(&slab->locker);
+	m = slab->empty;
+	if (m)
+		slab->empty = m->next;
+	spinlock_unlock(&slab->locker);
+
+	if (!m)
+	{
+		m = (struct slab_magazine_t*)malloc(sizeof(*m));
+		if (!m)
+		{
+			spinlock_lock(&slab->locker);
+			*(void**)ptr = slab->loose;
+			slab->loose = ptr;
+			spinlock_unlock(&slab->locker);
+			return;
+		}
+	}
+
+	if (shard->previous)
+	{
+		spinlock_lock(&slab->locker);
+		shard->previous->next = slab->full;
+		slab->full = shard->previous;
+		slab->nfull++;
+		spinlock_unlock(&slab->locker);
+	}
+
+	m->n = 0;
+	shard->previous = shard->loaded;
+	shard->loaded = m;
+	m->objects[m->n++] = ptr;
+}
+
+void* slab_alloc(struct slab_t* slab)
+{
+	void* ptr;
+	struct slab_magazine_t* m;
+	struct slab_shard_t* shard;
+
+	shard = slab_shard(slab);
+	spinlock_lock(&shard->locker);
+	if (shard->loaded && shard->loaded->n > 0)
+	{
+		ptr = shard->loaded->objects[--shard->loaded->n];
+	}
+	else if (shard->previous && shard->previous->n > 0)
+	{
+		m = shard->previous;
+		shard->previous = shard->loaded;
+		shard->loaded = m;
+		ptr = m->objects[--m->n];
+	}
+	else
+	{
+		ptr = slab_depot_alloc(slab, shard);
+	}
+
+	if (ptr)
+		shard->allocs++;
+	spinlock_unlock(&shard->locker);
+	return ptr;
+}
+
+void* slab_calloc(struct slab_t* slab)
+{
+	void* ptr;
+	ptr = slab_alloc(slab);
+	if (ptr)
+		memset(ptr, 0, slab->size);
+	return ptr;
+}
+
+void slab_free(struct slab_t* slab, void* ptr)
+{
+	struct slab_magazine_t* m;
+	struct slab_shard_t* shard;
+
+	if (!ptr)
+		return;
+
+	shard = slab_shard(slab);
+	spinlock_lock(&shard->locker);
+	if (shard->loaded && shard->loaded->n < SLAB_MAGAZINE)
+	{
+		shard->loaded->objects[shard->loaded->n++] = ptr;
+	}
+	else if (shard->previous && shard->previous->n < SLAB_MAGAZINE)
+	{
+		m = shard->previous;
+		shard->previous = shard->loaded;
+		shard->loaded = m;
+		m->objects[m->n++] = ptr;
+	}
+	else
+	{
+		slab_depot_free(slab, shard, ptr);
+	}
+
+	shard->frees++;
+	spinlock_unlock(&shard->locker);
+}
+
+void slab_stats(struct slab_t* slab, struct slab_stats_t* stats)
+{
+	int i;
+	void* ptr;
+	struct slab_shard_t* shard;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < slab->nshards; i++)
+	{
+		shard = &slab->shards[i];
+		spinlock_lock(&shard->locker);
+		stats->allocs += shard->allocs;
+		stats->frees += shard->frees;
+		stats->cached += (shard->loaded ? shard->loaded->n : 0) + (shard->previous ? shard->previous->n : 0);
+		spinlock_unlock(&shard->locker);
+	}
+
+	spinlock_lock(&slab->locker);
+	stats->size = slab->size;
+	stats->chunks = slab->nchunks;
+	stats->total = slab->nchunks * slab->count - slab->remain;
+	stats->cached += slab->nfull * SLAB_MAGAZINE;
+	for (ptr = slab->loose; ptr; ptr = *(void**)ptr)
+		stats->cached++;
+	spinlock_unlock(&slab->locker);
+
+	// shards are sampled one by one, inuse is approximate under concurrency
+	stats->inuse = stats->allocs > stats->frees ? (size_t)(stats->allocs - stats->frees) : 0;
+}
+
+#if defined(DEBUG) || defined(_DEBUG)
+#include "sys/thread.h"
+
+#define SLAB_TEST_OBJECTS	2000
+
+struct slab_test_object_t
+{
+	int32_t magic;
+	int32_t owner;
+	char data[40];
+};
+
+struct slab_test_t
+{
+	struct slab_t* slab;
+	struct slab_test_object_t* objects[4][SLAB_TEST_OBJECTS];
+	volatile int32_t ready;
+};
+
+static struct slab_test_t s_test;
+
+// thread i allocate objects, thread (i + 1) % 4 free them(cross-thread free)
+static int STDCALL slab_test_thread(void* param)
+{
+	int i, j, id, round;
+	struct slab_test_object_t* obj;
+
+	id = (int)(intptr_t)param;
+	for (round = 0; round < 8; round++)
+	{
+		for (i = 0; i < SLAB_TEST_OBJECTS; i++)
+		{
+			obj = (struct slab_test_object_t*)slab_calloc(s_test.slab);
+			assert(obj && 0 == obj->magic);
+			obj->magic = 0x534C4142;
+			obj->owner = id;
+			s_test.objects[id][i] = obj;
+		}
+
+		atomic_increment32(&s_test.ready);
+		while (atomic_load_acquire32(&s_test.ready) < 4 * (2 * round + 1))
+			thread_yield();
+
+		j = (id + 1) % 4;
+		for (i = 0; i < SLAB_TEST_OBJECTS; i++)
+		{
+			obj = s_test.objects[j][i];
+			assert(0x534C4142 == obj->magic && j == obj->owner);
+			obj->magic = 0;
+			slab_free(s_test.slab, obj);
+		}
+
+		atomic_increment32(&s_test.ready);
+		while (atomic_load_acquire32(&s_test.ready) < 4 * (2 * round + 2))
+			thread_yield();
+	}
+	return 0;
+}
+
+void slab_test(void)
+{
+	int i;
+	void* ptrs[100];
+	pthread_t threads[4];
+	struct slab_stats_t stats;
+
+	s_test.slab = slab_create(sizeof(struct slab_test_object_t));
+	assert(s_test.slab);
+
+	// reuse
+	for (i = 0; i < 100; i++)
+		ptrs[i] = slab_alloc(s_test.slab);
+	for (i = 0; i < 100; i++)
+		slab_free(s_test.slab, ptrs[i]);
+	slab_stats(s_test.slab, &stats);
+	assert(0 == stats.inuse && 100 == stats.total && 100 == stats.cached && 0 == stats.size % 16);
+	for (i = 0; i < 100; i++)
+		ptrs[i] = slab_alloc(s_test.slab);
+	slab_stats(s_test.slab, &stats);
+	assert(100 == stats.inuse && 100 == stats.total && 0 == stats.cached);
+	for (i = 0; i < 100; i++)
+		slab_free(s_test.slab, ptrs[i]);
+
+	s_test.ready = 0;
+	for (i = 0; i < 4; i++)
+		thread_create(&threads[i], slab_test_thread, (void*)(intptr_t)i);
+	for (i = 0; i < 4; i++)
+		thread_destroy(threads[i]);
+
+	slab_stats(s_test.slab, &stats);
+	assert(0 == stats.inuse && stats.total == stats.cached);
+	assert(stats.total <= 4 * SLAB_TEST_OBJECTS + 2 * SLAB_MAGAZINE * SLAB_SHARDS);
+	slab_destroy(s_test.slab);
+}
+#endif
@@ -5,6 +5,874 @@
 #if defined(_WIN32) || defined(_WIN64)
 #include <Windows.h>
 #endif
+#include "sys/cpu.h"
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#elif defined(CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define UNICODE_SSE2 1
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+static inline int unicode_ctz(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+// rfc3629 UTF-8 (no overlong form, no surrogate, <= U+10FFFF)
+// @return sequence length, 0-incomplete(need more data), -1-invalid
+static int utf8_sequence(const uint8_t* s, size_t n)
+{
+	uint8_t c, lo, hi;
+	c = s[0];
+	if (c < 0x80)
+		return 1;
+	if (c < 0xC2)
+		return -1; // continuation byte or overlong 2-bytes
+	if (c < 0xE0)
+		return n < 2 ? 0 : (0x80 == (s[1] & 0xC0) ? 2 : -1);
+	if (c > 0xF4)
+		return -1;
+
+	// second byte range: E0 A0..BF, ED 80..9F(surrogate), F0 90..BF, F4 80..8F(> U+10FFFF)
+	lo = 0xE0 == c ? 0xA0 : (0xF0 == c ? 0x90 : 0x80);
+	hi = 0xED == c ? 0x9F : (0xF4 == c ? 0x8F : 0xBF);
+	if (n < 2)
+		return 0;
+	if (s[1] < lo || s[1] > hi)
+		return -1;
+	if (n < 3)
+		return 0;
+	if (0x80 != (s[2] & 0xC0))
+		return -1;
+	if (c < 0xF0)
+		return 3;
+	if (n < 4)
+		return 0;
+	return 0x80 == (s[3] & 0xC0) ? 4 : -1;
+}
+
+static uint32_t utf8_codepoint(const uint8_t* s, int n)
+{
+	switch (n)
+	{
+	case 1: return s[0];
+	case 2: return ((uint32_t)(s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+	case 3: return ((uint32_t)(s[0] & 0x0F) << 12) | ((uint32_t)(s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+	default: return ((uint32_t)(s[0] & 0x07) << 18) | ((uint32_t)(s[1] & 0x3F) << 12) | ((uint32_t)(s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+	}
+}
+
+static int utf8_encode(uint32_t cp, uint8_t* p)
+{
+	if (cp < 0x80)
+	{
+		p[0] = (uint8_t)cp;
+		return 1;
+	}
+	else if (cp < 0x800)
+	{
+		p[0] = (uint8_t)(0xC0 | (cp >> 6));
+		p[1] = (uint8_t)(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	else if (cp < 0x10000)
+	{
+		p[0] = (uint8_t)(0xE0 | (cp >> 12));
+		p[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+		p[2] = (uint8_t)(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	else
+	{
+		p[0] = (uint8_t)(0xF0 | (cp >> 18));
+		p[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+		p[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+		p[3] = (uint8_t)(0x80 | (cp & 0x3F));
+		return 4;
+	}
+}
+
+// SIMD kernels, return validated bytes(stop at sequence boundary), (size_t)-1 if invalid,
+// the remaining are processed by scalar code
+// validate: John Keiser, Daniel Lemire, Validating UTF-8 In Less Than One Instruction Per Byte
+// 3 nibble lookups classify each (prev byte, byte) pair, 3/4-bytes continuation checked by saturating subtract
+#define UTF8_TOO_SHORT		(1 << 0) // lead byte followed by lead/ASCII byte
+#define UTF8_TOO_LONG		(1 << 1) // ASCII followed by continuation
+#define UTF8_OVERLONG_3		(1 << 2)
+#define UTF8_TOO_LARGE		(1 << 3)
+#define UTF8_SURROGATE		(1 << 4)
+#define UTF8_OVERLONG_2		(1 << 5)
+#define UTF8_TOO_LARGE_1000	(1 << 6)
+#define UTF8_OVERLONG_4		(1 << 6)
+#define UTF8_TWO_CONTS		(1 << 7) // two continuations, MUST be 3/4-bytes sequence
+#define UTF8_CARRY			(UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_BYTE_1_HIGH \
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+	UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, \
+	UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+	UTF8_TOO_SHORT, \
+	UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE, \
+	UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+#define UTF8_BYTE_1_LOW \
+	UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, \
+	UTF8_CARRY | UTF8_OVERLONG_2, \
+	UTF8_CARRY, \
+	UTF8_CARRY, \
+	UTF8_CARRY | UTF8_TOO_LARGE, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+#define UTF8_BYTE_2_HIGH \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+#if defined(CPU_X86) || defined(CPU_ARM64)
+static const uint8_t s_utf8_byte_1_high[16] = { UTF8_BYTE_1_HIGH };
+static const uint8_t s_utf8_byte_1_low[16] = { UTF8_BYTE_1_LOW };
+static const uint8_t s_utf8_byte_2_high[16] = { UTF8_BYTE_2_HIGH };
+
+// back to the lead byte of the incomplete sequence at block end
+static size_t utf8_simd_boundary(const uint8_t* s, size_t i, int incomplete)
+{
+	size_t k;
+	for (k = 1; incomplete && k <= 3 && k <= i; k++)
+	{
+		if (s[i - k] >= 0xC0)
+			return i - k;
+	}
+	return i;
+}
+#endif
+
+#if defined(CPU_X86)
+#if defined(_MSC_VER)
+	#define UNICODE_TARGET(x)
+#else
+	#define UNICODE_TARGET(x) __attribute__((target(x)))
+#endif
+
+static size_t UNICODE_TARGET("ssse3") utf8_validate_ssse3(const uint8_t* s, size_t n)
+{
+	size_t i;
+	__m128i input, prev, prev1, sc, must23, error, incomplete;
+	const __m128i t1 = _mm_loadu_si128((const __m128i*)s_utf8_byte_1_high);
+	const __m128i t2 = _mm_loadu_si128((const __m128i*)s_utf8_byte_1_low);
+	const __m128i t3 = _mm_loadu_si128((const __m128i*)s_utf8_byte_2_high);
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i last = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+
+	prev = _mm_setzero_si128();
+	error = _mm_setzero_si128();
+	incomplete = _mm_setzero_si128();
+	for (i = 0; i + 16 <= n; i += 16)
+	{
+		input = _mm_loadu_si128((const __m128i*)(s + i));
+		if (0 == _mm_movemask_epi8(input))
+		{
+			// ASCII block: previous block must end with a complete sequence
+			error = _mm_or_si128(error, incomplete);
+			incomplete = _mm_setzero_si128();
+		}
+		else
+		{
+			prev1 = _mm_alignr_epi8(input, prev, 15);
+			sc = _mm_shuffle_epi8(t1, _mm_and_si128(_mm_srli_epi16(prev1, 4), mask));
+			sc = _mm_and_si128(sc, _mm_shuffle_epi8(t2, _mm_and_si128(prev1, mask)));
+			sc = _mm_and_si128(sc, _mm_shuffle_epi8(t3, _mm_and_si128(_mm_srli_epi16(input, 4), mask)));
+			must23 = _mm_or_si128(_mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8((char)(0xE0 - 0x80))),
+				_mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8((char)(0xF0 - 0x80))));
+			must23 = _mm_and_si128(must23, _mm_set1_epi8((char)0x80));
+			error = _mm_or_si128(error, _mm_xor_si128(must23, sc));
+			incomplete = _mm_subs_epu8(input, last);
+		}
+		prev = input;
+
+		if ((i & 0x3F0) == 0x3F0 && 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())))
+			return (size_t)-1; // early exit every 1KB
+	}
+
+	if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())))
+		return (size_t)-1;
+	return utf8_simd_boundary(s, i, 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(incomplete, _mm_setzero_si128())));
+}
+
+static size_t UNICODE_TARGET("avx2") utf8_validate_avx2(const uint8_t* s, size_t n)
+{
+	size_t i;
+	__m256i input, prev, shift, prev1, sc, must23, error, incomplete;
+	const __m256i t1 = _mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH);
+	const __m256i t2 = _mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW);
+	const __m256i t3 = _mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH);
+	const __m256i mask = _mm256_set1_epi8(0x0F);
+	const __m256i last = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+
+	prev = _mm256_setzero_si256();
+	error = _mm256_setzero_si256();
+	incomplete = _mm256_setzero_si256();
+	for (i = 0; i + 32 <= n; i += 32)
+	{
+		input = _mm256_loadu_si256((const __m256i*)(s + i));
+		if (0 == _mm256_movemask_epi8(input))
+		{
+			error = _mm256_or_si256(error, incomplete);
+			incomplete = _mm256_setzero_si256();
+		}
+		else
+		{
+			// shift = prev high lane | input low lane, alignr per lane
+			shift = _mm256_permute2x128_si256(prev, input, 0x21);
+			prev1 = _mm256_alignr_epi8(input, shift, 15);
+			sc = _mm256_shuffle_epi8(t1, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), mask));
+			sc = _mm256_and_si256(sc, _mm256_shuffle_epi8(t2, _mm256_and_si256(prev1, mask)));
+			sc = _mm256_and_si256(sc, _mm256_shuffle_epi8(t3, _mm256_and_si256(_mm256_srli_epi16(input, 4), mask)));
+			must23 = _mm256_or_si256(_mm256_subs_epu8(_mm256_alignr_epi8(input, shift, 14), _mm256_set1_epi8((char)(0xE0 - 0x80))),
+				_mm256_subs_epu8(_mm256_alignr_epi8(input, shift, 13), _mm256_set1_epi8((char)(0xF0 - 0x80))));
+			must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+			error = _mm256_or_si256(error, _mm256_xor_si256(must23, sc));
+			incomplete = _mm256_subs_epu8(input, last);
+		}
+		prev = input;
+
+		if ((i & 0x3E0) == 0x3E0 && !_mm256_testz_si256(error, error))
+			return (size_t)-1;
+	}
+
+	if (!_mm256_testz_si256(error, error))
+		return (size_t)-1;
+	return utf8_simd_boundary(s, i, !_mm256_testz_si256(incomplete, incomplete));
+}
+
+static size_t utf8_validate_simd(const uint8_t* s, size_t n)
+{
+	if (cpu_features() & CPU_FEATURE_AVX2)
+		return utf8_validate_avx2(s, n);
+	if (cpu_features() & CPU_FEATURE_SSSE3)
+		return utf8_validate_ssse3(s, n);
+	return 0;
+}
+
+#elif defined(CPU_ARM64)
+static size_t utf8_validate_simd(const uint8_t* s, size_t n)
+{
+	size_t i;
+	uint8x16_t input, prev, prev1, sc, must23, error, incomplete;
+	const uint8x16_t t1 = vld1q_u8(s_utf8_byte_1_high);
+	const uint8x16_t t2 = vld1q_u8(s_utf8_byte_1_low);
+	const uint8x16_t t3 = vld1q_u8(s_utf8_byte_2_high);
+	static const uint8_t s_last[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1 };
+	const uint8x16_t last = vld1q_u8(s_last);
+
+	prev = vdupq_n_u8(0);
+	error = vdupq_n_u8(0);
+	incomplete = vdupq_n_u8(0);
+	for (i = 0; i + 16 <= n; i += 16)
+	{
+		input = vld1q_u8(s + i);
+		if (vmaxvq_u8(input) < 0x80)
+		{
+			error = vorrq_u8(error, incomplete);
+			incomplete = vdupq_n_u8(0);
+		}
+		else
+		{
+			prev1 = vextq_u8(prev, input, 15);
+			sc = vqtbl1q_u8(t1, vshrq_n_u8(prev1, 4));
+			sc = vandq_u8(sc, vqtbl1q_u8(t2, vandq_u8(prev1, vdupq_n_u8(0x0F))));
+			sc = vandq_u8(sc, vqtbl1q_u8(t3, vshrq_n_u8(input, 4)));
+			must23 = vorrq_u8(vqsubq_u8(vextq_u8(prev, input, 14), vdupq_n_u8(0xE0 - 0x80)),
+				vqsubq_u8(vextq_u8(prev, input, 13), vdupq_n_u8(0xF0 - 0x80)));
+			must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+			error = vorrq_u8(error, veorq_u8(must23, sc));
+			incomplete = vqsubq_u8(input, last);
+		}
+		prev = input;
+
+		if ((i & 0x3F0) == 0x3F0 && vmaxvq_u8(error))
+			return (size_t)-1;
+	}
+
+	if (vmaxvq_u8(error))
+		return (size_t)-1;
+	return utf8_simd_boundary(s, i, vmaxvq_u8(incomplete) ? 1 : 0);
+}
+#else
+#define utf8_validate_simd(s, n) 0
+#endif
+
+// ASCII runs: widen/narrow 16 characters at once
+// @return converted characters, stop at first non-ASCII character
+static size_t utf8_ascii_to_utf16(const uint8_t* s, size_t n, uint16_t* d)
+{
+	size_t i = 0;
+#if defined(UNICODE_SSE2)
+	__m128i v;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)(s + i));
+		if (_mm_movemask_epi8(v))
+			break;
+		_mm_storeu_si128((__m128i*)(d + i), _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i*)(d + i + 8), _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+	}
+#elif defined(CPU_ARM64)
+	uint8x16_t v;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = vld1q_u8(s + i);
+		if (vmaxvq_u8(v) >= 0x80)
+			break;
+		vst1q_u16(d + i, vmovl_u8(vget_low_u8(v)));
+		vst1q_u16(d + i + 8, vmovl_high_u8(v));
+	}
+#endif
+	for (; i < n && s[i] < 0x80; i++)
+		d[i] = s[i];
+	return i;
+}
+
+static size_t utf8_ascii_to_utf32(const uint8_t* s, size_t n, uint32_t* d)
+{
+	size_t i = 0;
+#if defined(UNICODE_SSE2)
+	__m128i v, lo, hi;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)(s + i));
+		if (_mm_movemask_epi8(v))
+			break;
+		lo = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+		hi = _mm_unpackhi_epi8(v, _mm_setzero_si128());
+		_mm_storeu_si128((__m128i*)(d + i), _mm_unpacklo_epi16(lo, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i*)(d + i + 4), _mm_unpackhi_epi16(lo, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i*)(d + i + 8), _mm_unpacklo_epi16(hi, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i*)(d + i + 12), _mm_unpackhi_epi16(hi, _mm_setzero_si128()));
+	}
+#elif defined(CPU_ARM64)
+	uint8x16_t v;
+	uint16x8_t lo, hi;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = vld1q_u8(s + i);
+		if (vmaxvq_u8(v) >= 0x80)
+			break;
+		lo = vmovl_u8(vget_low_u8(v));
+		hi = vmovl_high_u8(v);
+		vst1q_u32(d + i, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(d + i + 4, vmovl_high_u16(lo));
+		vst1q_u32(d + i + 8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(d + i + 12, vmovl_high_u16(hi));
+	}
+#endif
+	for (; i < n && s[i] < 0x80; i++)
+		d[i] = s[i];
+	return i;
+}
+
+static size_t utf8_ascii_from_utf16(const uint16_t* s, size_t n, uint8_t* d)
+{
+	size_t i = 0;
+#if defined(UNICODE_SSE2)
+	__m128i a, b;
+	for (; i + 16 <= n; i += 16)
+	{
+		a = _mm_loadu_si128((const __m128i*)(s + i));
+		b = _mm_loadu_si128((const __m128i*)(s + i + 8));
+		if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short)0xFF80)), _mm_setzero_si128())))
+			break;
+		_mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(a, b));
+	}
+#elif defined(CPU_ARM64)
+	uint16x8_t a, b;
+	for (; i + 16 <= n; i += 16)
+	{
+		a = vld1q_u16(s + i);
+		b = vld1q_u16(s + i + 8);
+		if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+			break;
+		vst1q_u8(d + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+	}
+#endif
+	for (; i < n && s[i] < 0x80; i++)
+		d[i] = (uint8_t)s[i];
+	return i;
+}
+
+static size_t utf8_ascii_from_utf32(const uint32_t* s, size_t n, uint8_t* d)
+{
+	size_t i = 0;
+#if defined(UNICODE_SSE2)
+	__m128i a, b, c, e;
+	for (; i + 16 <= n; i += 16)
+	{
+		a = _mm_loadu_si128((const __m128i*)(s + i));
+		b = _mm_loadu_si128((const __m128i*)(s + i + 4));
+		c = _mm_loadu_si128((const __m128i*)(s + i + 8));
+		e = _mm_loadu_si128((const __m128i*)(s + i + 12));
+		if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, e)), _mm_set1_epi32((int)0xFFFFFF80)), _mm_setzero_si128())))
+			break;
+		_mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, e)));
+	}
+#elif defined(CPU_ARM64)
+	uint32x4_t a, b, c, e;
+	for (; i + 16 <= n; i += 16)
+	{
+		a = vld1q_u32(s + i);
+		b = vld1q_u32(s + i + 4);
+		c = vld1q_u32(s + i + 8);
+		e = vld1q_u32(s + i + 12);
+		if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, e))) >= 0x80)
+			break;
+		vst1q_u8(d + i, vcombine_u8(vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))), vmovn_u16(vcombine_u16(vmovn_u32(c), vmovn_u32(e)))));
+	}
+#endif
+	for (; i < n && s[i] < 0x80; i++)
+		d[i] = (uint8_t)s[i];
+	return i;
+}
+
+// @return leading ASCII bytes
+static size_t utf8_ascii_span(const uint8_t* s, size_t n)
+{
+	size_t i = 0;
+#if defined(UNICODE_SSE2)
+	int m;
+	for (; i + 16 <= n; i += 16)
+	{
+		m = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i)));
+		if (m)
+			return i + unicode_ctz(m);
+	}
+#elif defined(CPU_ARM64)
+	for (; i + 16 <= n; i += 16)
+	{
+		if (vmaxvq_u8(vld1q_u8(s + i)) >= 0x80)
+			break;
+	}
+#endif
+	for (; i < n && s[i] < 0x80; i++)
+		;
+	return i;
+}
+
+// @param[out] valid validated bytes, exclude incomplete sequence at end
+// @return 0-ok, -1-invalid
+static int utf8_check(const uint8_t* s, size_t n, size_t* valid)
+{
+	int r;
+	size_t i;
+	uint64_t v;
+
+	i = utf8_validate_simd(s, n);
+	if ((size_t)-1 == i)
+		return -1;
+
+	while (i < n)
+	{
+		if (i + 8 <= n)
+		{
+			memcpy(&v, s + i, 8);
+			if (0 == (v & 0x8080808080808080ULL))
+			{
+				i += 8;
+				continue;
+			}
+		}
+
+		r = utf8_sequence(s + i, n - i);
+		if (r < 0)
+			return -1;
+		if (0 == r)
+			break; // incomplete
+		i += r;
+	}
+
+	*valid = i;
+	return 0;
+}
+
+int utf8_validate(const char* src, size_t bytes)
+{
+	size_t n;
+	if (0 != utf8_check((const uint8_t*)src, bytes, &n))
+		return -1;
+	return n == bytes ? 0 : -1;
+}
+
+void utf8_validator_init(struct utf8_validator_t* v)
+{
+	memset(v, 0, sizeof(*v));
+}
+
+int utf8_validator_update(struct utf8_validator_t* v, const void* data, size_t bytes)
+{
+	int r;
+	size_t n;
+	const uint8_t* p;
+
+	p = (const uint8_t*)data;
+	if (v->error)
+		return -1;
+
+	// complete the sequence split by chunk boundary
+	while (v->n > 0 && bytes > 0)
+	{
+		v->tail[v->n++] = *p++;
+		bytes--;
+		r = utf8_sequence(v->tail, v->n);
+		if (r < 0)
+			return v->error = -1;
+		if (r > 0)
+			v->n = 0;
+	}
+
+	if (0 != utf8_check(p, bytes, &n))
+		return v->error = -1;
+
+	assert(bytes - n < sizeof(v->tail));
+	memcpy(v->tail, p + n, bytes - n);
+	v->n += (int)(bytes - n);
+	return 0;
+}
+
+int utf8_validator_finish(struct utf8_validator_t* v)
+{
+	return v->error || v->n > 0 ? -1 : 0;
+}
+
+int utf8_to_utf16(const char* src, size_t bytes, uint16_t* tgt, size_t count, size_t* consumed)
+{
+	int r;
+	size_t i, j, k;
+	uint32_t cp;
+	const uint8_t* s;
+
+	s = (const uint8_t*)src;
+	for (i = j = 0; i < bytes && j < count; i += r)
+	{
+		if (s[i] < 0x80)
+		{
+			k = utf8_ascii_to_utf16(s + i, bytes - i < count - j ? bytes - i : count - j, tgt + j);
+			j += k;
+			r = (int)k;
+			continue;
+		}
+
+		r = utf8_sequence(s + i, bytes - i);
+		if (r < 0)
+			return -1;
+		if (0 == r)
+			break;
+
+		cp = utf8_codepoint(s + i, r);
+		if (cp >= 0x10000)
+		{
+			if (j + 2 > count)
+				break;
+			cp -= 0x10000;
+			tgt[j++] = (uint16_t)(0xD800 | (cp >> 10));
+			tgt[j++] = (uint16_t)(0xDC00 | (cp & 0x3FF));
+		}
+		else
+		{
+			tgt[j++] = (uint16_t)cp;
+		}
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int utf8_to_utf32(const char* src, size_t bytes, uint32_t* tgt, size_t count, size_t* consumed)
+{
+	int r;
+	size_t i, j, k;
+	const uint8_t* s;
+
+	s = (const uint8_t*)src;
+	for (i = j = 0; i < bytes && j < count; i += r)
+	{
+		if (s[i] < 0x80)
+		{
+			k = utf8_ascii_to_utf32(s + i, bytes - i < count - j ? bytes - i : count - j, tgt + j);
+			j += k;
+			r = (int)k;
+			continue;
+		}
+
+		r = utf8_sequence(s + i, bytes - i);
+		if (r < 0)
+			return -1;
+		if (0 == r)
+			break;
+		tgt[j++] = utf8_codepoint(s + i, r);
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int utf16_to_utf8(const uint16_t* src, size_t count, char* tgt, size_t bytes, size_t* consumed)
+{
+	int n;
+	size_t i, j, k;
+	uint32_t cp;
+	uint8_t* d;
+
+	d = (uint8_t*)tgt;
+	for (i = j = 0; i < count && j < bytes; i += n)
+	{
+		if (src[i] < 0x80)
+		{
+			k = utf8_ascii_from_utf16(src + i, count - i < bytes - j ? count - i : bytes - j, d + j);
+			j += k;
+			n = (int)k;
+			continue;
+		}
+
+		n = 1;
+		cp = src[i];
+		if (cp >= 0xD800 && cp <= 0xDFFF)
+		{
+			if (cp >= 0xDC00)
+				return -1; // lone low surrogate
+			if (i + 1 >= count)
+				break; // incomplete
+			if (src[i + 1] < 0xDC00 || src[i + 1] > 0xDFFF)
+				return -1;
+			cp = 0x10000 + ((cp - 0xD800) << 10) + (src[i + 1] - 0xDC00);
+			n = 2;
+		}
+
+		if (j + (cp < 0x800 ? 2 : (cp < 0x10000 ? 3 : 4)) > bytes)
+			break;
+		j += utf8_encode(cp, d + j);
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int utf32_to_utf8(const uint32_t* src, size_t count, char* tgt, size_t bytes, size_t* consumed)
+{
+	size_t i, j, k;
+	uint32_t cp;
+	uint8_t* d;
+
+	d = (uint8_t*)tgt;
+	for (i = j = 0; i < count && j < bytes; )
+	{
+		if (src[i] < 0x80)
+		{
+			k = utf8_ascii_from_utf32(src + i, count - i < bytes - j ? count - i : bytes - j, d + j);
+			i += k;
+			j += k;
+			continue;
+		}
+
+		cp = src[i];
+		if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+			return -1;
+		if (j + (cp < 0x800 ? 2 : (cp < 0x10000 ? 3 : 4)) > bytes)
+			break;
+		j += utf8_encode(cp, d + j);
+		i++;
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+#include "i18n/gb18030.c"
+
+int gb18030_to_utf32(const char* src, size_t bytes, uint32_t* tgt, size_t count, size_t* consumed)
+{
+	int r;
+	size_t i, j, k;
+	const uint8_t* s;
+
+	s = (const uint8_t*)src;
+	for (i = j = 0; i < bytes && j < count; i += r)
+	{
+		if (s[i] < 0x80)
+		{
+			k = utf8_ascii_to_utf32(s + i, MIN(bytes - i, count - j), tgt + j);
+			j += k;
+			r = (int)k;
+			continue;
+		}
+
+		if (i + 1 < bytes && s[i + 1] >= 0x40 && s[i + 1] <= 0xFE && 0x7F != s[i + 1] && s[i] >= 0x81 && s[i] <= 0xFE)
+		{
+			// 2-bytes fast path
+			tgt[j++] = s_gb18030_to_ucs[s[i] - 0x81][s[i + 1] - 0x40];
+			r = 2;
+			continue;
+		}
+
+		r = gb18030_decode(s + i, bytes - i, tgt + j);
+		if (r < 0)
+			return -1;
+		if (0 == r)
+			break;
+		j++;
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int gb18030_to_utf8(const char* src, size_t bytes, char* tgt, size_t count, size_t* consumed)
+{
+	int r;
+	size_t i, j, k;
+	uint32_t cp;
+	uint8_t utf8[4];
+	const uint8_t* s;
+
+	s = (const uint8_t*)src;
+	for (i = j = 0; i < bytes && j < count; i += r)
+	{
+		if (s[i] < 0x80)
+		{
+			k = utf8_ascii_span(s + i, MIN(bytes - i, count - j));
+			memcpy(tgt + j, s + i, k);
+			j += k;
+			r = (int)k;
+			continue;
+		}
+
+		r = gb18030_decode(s + i, bytes - i, &cp);
+		if (r < 0)
+			return -1;
+		if (0 == r || j + utf8_encode(cp, utf8) > count)
+			break;
+		j += utf8_encode(cp, (uint8_t*)tgt + j);
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int utf32_to_gb18030(const uint32_t* src, size_t count, char* tgt, size_t bytes, size_t* consumed)
+{
+	int n;
+	size_t i, j, k;
+	uint8_t code[4];
+
+	for (i = j = 0; i < count && j < bytes; )
+	{
+		if (src[i] < 0x80)
+		{
+			k = utf8_ascii_from_utf32(src + i, MIN(count - i, bytes - j), (uint8_t*)tgt + j);
+			i += k;
+			j += k;
+			continue;
+		}
+
+		n = gb18030_encode(src[i], code);
+		if (n < 0)
+			return -1;
+		if (j + n > bytes)
+			break;
+		tgt[j] = (char)code[0];
+		tgt[j + 1] = (char)code[1];
+		if (4 == n)
+		{
+			tgt[j + 2] = (char)code[2];
+			tgt[j + 3] = (char)code[3];
+		}
+		j += n;
+		i++;
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+int utf8_to_gb18030(const char* src, size_t bytes, char* tgt, size_t count, size_t* consumed)
+{
+	int r, n;
+	size_t i, j, k;
+	uint8_t code[4];
+	const uint8_t* s;
+
+	s = (const uint8_t*)src;
+	for (i = j = 0; i < bytes && j < count; i += r)
+	{
+		if (s[i] < 0x80)
+		{
+			k = utf8_ascii_span(s + i, MIN(bytes - i, count - j));
+			memcpy(tgt + j, s + i, k);
+			j += k;
+			r = (int)k;
+			continue;
+		}
+
+		r = utf8_sequence(s + i, bytes - i);
+		if (r < 0)
+			return -1;
+		if (0 == r)
+			break;
+		n = gb18030_encode(utf8_codepoint(s + i, r), code);
+		if (n < 0)
+			return -1;
+		if (j + n > count)
+			break;
+		memcpy(tgt + j, code, n);
+		j += n;
+	}
+
+	if (consumed)
+		*consumed = i;
+	return (int)j;
+}
+
+#if WCHAR_MAX <= 0xFFFF
+#define unicode_ascii_from_wchar(s, n, d) utf8_ascii_from_utf16((const uint16_t*)(s), n, (uint8_t*)(d))
+#define unicode_ascii_to_wchar(s, n, d) utf8_ascii_to_utf16((const uint8_t*)(s), n, (uint16_t*)(d))
+#else
+#define unicode_ascii_from_wchar(s, n, d) utf8_ascii_from_utf32((const uint32_t*)(s), n, (uint8_t*)(d))
+#define unicode_ascii_to_wchar(s, n, d) utf8_ascii_to_utf32((const uint8_t*)(s), n, (uint32_t*)(d))
+#endif
 
 int unicode_to_utf8(IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, IN size_t tgtBytes)
 {
@@ -13,12 +881,19 @@ int unicode_to_utf8(IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, IN s
 	return WideCharToMultiByte(CP_UTF8, 0, src, srcLen, tgt, tgtBytes, NULL, NULL);
 
 #else
-	size_t i;
+	size_t i, n;
 	char* p = tgt;
 	srcLen = 0==srcLen?wcslen(src)+1:srcLen;
 	for(i=0; i<srcLen; i++)
 	{
-		if(src[i] <= 0x7F)
+		if((unsigned long)src[i] < 0x80 && (size_t)(p-tgt) < tgtBytes)
+		{
+			// ASCII run
+			n = unicode_ascii_from_wchar(src+i, MIN(srcLen-i, tgtBytes-(size_t)(p-tgt)), p);
+			p += n;
+			i += n - 1;
+		}
+		else if(src[i] <= 0x7F)
 		{
 			assert(p-tgt < (int)tgtBytes);
 			// U+0000 to U+007F
@@ -68,12 +943,19 @@ int unicode_from_utf8(IN const char* src, IN size_t srcLen, OUT wchar_t* tgt, IN
 	return MultiByteToWideChar(CP_UTF8, 0, src, srcLen, tgt, tgtBytes/sizeof(wchar_t));
 
 #else
-	size_t i;
+	size_t i, n;
 	wchar_t* wc = tgt;
 	srcLen = 0==srcLen?strlen(src)+1:srcLen;
 	for(i=0; i<srcLen; i++)
 	{
-		if(0xF0 == (0xF0 & src[i]))
+		if((unsigned char)src[i] < 0x80 && (size_t)(wc-tgt) < tgtBytes/sizeof(wchar_t))
+		{
+			// ASCII run
+			n = unicode_ascii_to_wchar(src+i, MIN(srcLen-i, tgtBytes/sizeof(wchar_t)-(size_t)(wc-tgt)), wc);
+			wc += n;
+			i += n - 1;
+		}
+		else if(0xF0 == (0xF0 & src[i]))
 		{
 			assert(i+3 < srcLen);
 			assert(0x80 == (src[i+1]&0x80));
@@ -161,9 +1043,6 @@ int unicode_from_mbcs(IN const char* src, IN size_t srcLen, OUT wchar_t* tgt, IN
 #endif
 }
 
-extern int gb2312_mbtowc(const unsigned char *src, wchar_t *tgt, int tgtLen);
-extern int gb2312_wctomb(const wchar_t* src, unsigned char *tgt, int tgtLen);
-
 int unicode_to_gb18030(IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, IN size_t tgtBytes)
 {
 	srcLen = 0==srcLen?wcslen(src)+1:srcLen;
@@ -173,13 +1052,10 @@ int unicode_to_gb18030(IN const wchar_t* src, IN size_t srcLen, OUT char* tgt, I
 	return WideCharToMultiByte(54936, 0, src, srcLen, tgt, tgtBytes, NULL, NULL);
 
 #else
-	if(tgtBytes > 0 && tgtBytes/sizeof(wchar_t) < srcLen)
-	{
-		assert(0);
-		return -1;
-	}
-	return gb2312_wctomb(src, (unsigned char*)tgt, (int)tgtBytes);
-	//return wcstombs(tgt, src, tgtBytes);
+	int n;
+	// wchar_t is UTF-32
+	n = utf32_to_gb18030((const uint32_t*)src, srcLen, tgt, tgtBytes, NULL);
+	return n > 0 && 0 == tgt[n-1] ? n-1 : n; // exclude '\0'
 #endif
 }
 
@@ -192,16 +1068,8 @@ int unicode_from_gb18030(IN const char* src, IN size_t srcLen, OUT wchar_t* tgt,
 	return MultiByteToWideChar(54936, 0, src, srcLen, tgt, tgtBytes/sizeof(wchar_t));
 
 #else
-	if(tgtBytes > 0 && tgtBytes/sizeof(wchar_t) < srcLen)
-	{
-		assert(0);
-		return -1;
-	}
-	return gb2312_mbtowc((unsigned char*)src, tgt, (int)tgtBytes);
-	//return mbstowcs(tgt, src, tgtBytes);
+	int n;
+	n = gb18030_to_utf32(src, srcLen, (uint32_t*)tgt, tgtBytes/sizeof(wchar_t), NULL);
+	return n > 0 && 0 == tgt[n-1] ? n-1 : n; // exclude '\0'
 #endif
 }
-
-#if defined(OS_LINUX)
-#include "i18n/nls_cp936.c"
-#endif
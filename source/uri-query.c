@@ -6,83 +6,76 @@
 
 #define N 64
 
+int uri_query_next(const char** query, const char* end, struct uri_query_t* item)
+{
+	const char* p;
+
+	for (p = *query; p < end && '&' == *p; p++)
+		; // skip k1=v1&&k2=v2
+
+	if (p >= end)
+	{
+		*query = end;
+		return 0;
+	}
+	else if ('=' == *p)
+	{
+		return -1; // no-name k1=v1&=v2
+	}
+
+	item->name = p;
+	while (p < end && '&' != *p && '=' != *p)
+		p++;
+	item->n_name = (int)(p - item->name);
+
+	if (p < end && '=' == *p)
+	{
+		item->value = ++p;
+		while (p < end && '&' != *p)
+			p++;
+		item->n_value = (int)(p - item->value); // empty-value
+	}
+	else
+	{
+		item->value = NULL;
+		item->n_value = 0; // no-value
+	}
+
+	*query = p < end ? p + 1 : end;
+	return 1;
+}
+
 int uri_query(const char* query, const char* end, struct uri_query_t** items)
 {
-	int count;
-	int capacity;
-	const char *p;
-	struct uri_query_t items0[N], *pp;
+	int r, count, capacity;
+	struct uri_query_t item, *pp;
 
 	assert(items);
 	*items = NULL;
 	capacity = count = 0;
 
-	for (p = query; p && p < end; query = p + 1)
+	for (r = 0; query && 1 == (r = uri_query_next(&query, end, &item)); )
 	{
-		p = strpbrk(query, "&=");
-		assert(!p || *p);
-		if (!p || p > end)
-			break;
-
-		if (p == query)
+		if (count >= capacity)
 		{
-			if ('&' == *p)
-			{
-				continue; // skip k1=v1&&k2=v2
-			}
-			else
+			capacity = count + N;
+			pp = (struct uri_query_t*)realloc(*items, capacity * sizeof(struct uri_query_t));
+			if (!pp)
 			{
 				uri_query_free(items);
-				return -1;  // no-name k1=v1&=v2
+				return -ENOMEM;
 			}
+			*items = pp;
 		}
 
-		if (count < N)
-		{
-			pp = &items0[count++];
-		}
-		else
-		{
-			if (count >= capacity)
-			{
-				capacity = count + 64;
-				pp = (struct uri_query_t*)realloc(*items, capacity * sizeof(struct uri_query_t));
-				if (!pp) return -ENOMEM;
-				*items = pp;
-			}
-
-			pp = &(*items)[count++];
-		}
-
-		pp->name = query;
-		pp->n_name = (int)(p - query);
-
-		if ('=' == *p)
-		{
-			pp->value = p + 1;
-			p = strchr(pp->value, '&');
-			if (NULL == p) p = end;
-			pp->n_value = (int)(p - pp->value); // empty-value
-		}
-		else
-		{
-			assert('&' == *p);
-			pp->value = NULL;
-			pp->n_value = 0; // no-value
-		}
+		memcpy(&(*items)[count++], &item, sizeof(item));
 	}
 
-	if (count <= N && count > 0)
+	if (r < 0)
 	{
-		*items = (struct uri_query_t*)malloc(count * sizeof(struct uri_query_t));
-		if (!*items) return -ENOMEM;
-		memcpy(*items, items0, count * sizeof(struct uri_query_t));
+		uri_query_free(items);
+		return -1;
 	}
-	else if(count > N)
-	{
-		memcpy(*items, items0, N * sizeof(struct uri_query_t));
-	}
-
 	return count;
 }
 
@@ -103,6 +96,9 @@ void uri_query_test(void)
 	const char* s3 = "name=value&&a=b&";
 	const char* s4 = "name=value&&=b&";
 	const char* s5 = "name=value&k1=v1&k2=v2&k3=v3&k4&k5&k6=v6";
+	const char* s6 = "a=&b=1&c#d=2";
+	const char* p;
+	struct uri_query_t item;
 
 	struct uri_query_t* items;
 	assert(0 == uri_query(s1, s1 + strlen(s1), &items));
@@ -130,5 +126,12 @@ void uri_query_test(void)
 	assert(0 == strncmp("k5", items[5].name, items[5].n_name) && 0 == items[5].n_value && NULL == items[5].value);
 	assert(0 == strncmp("k6", items[6].name, items[6].n_name) && 0 == strncmp("v6", items[6].value, items[6].n_value));
 	uri_query_free(&items);
+
+	// no allocation, stop at end
+	p = s6;
+	assert(1 == uri_query_next(&p, s6 + strlen(s6) - 4, &item) && 1 == item.n_name && 0 == strncmp("a", item.name, 1) && 0 == item.n_value && item.value);
+	assert(1 == uri_query_next(&p, s6 + strlen(s6) - 4, &item) && 0 == strncmp("b", item.name, 1) && 0 == strncmp("1", item.value, item.n_value));
+	assert(1 == uri_query_next(&p, s6 + strlen(s6) - 4, &item) && 0 == strncmp("c", item.name, 1) && NULL == item.value);
+	assert(0 == uri_query_next(&p, s6 + strlen(s6) - 4, &item));
 }
 #endif
@@ -1,8 +1,25 @@
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include "urlcodec.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define URLCODEC_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define URLCODEC_NEON 1
+	#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
 static char s_encode[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
 #define char_isnum(c)	('0'<=(c) && '9'>=(c))
@@ -15,6 +32,108 @@ static inline char HEX(char c)
 	return char_isnum(c) ? c-'0' : (char)tolower(c)-'a'+10;
 }
 
+#if defined(URLCODEC_SSE2)
+static inline int url_ctz(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+// lo <= c <= hi, signed compare: non-ASCII(>=0x80) always out of range
+#define url_inrange(v, lo, hi) _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((lo) - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8((hi) + 1)))
+
+#elif defined(URLCODEC_NEON)
+static inline int url_ctz64(uint64_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctzll(v);
+#endif
+}
+
+#define url_inrange(v, lo, hi) vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)))
+#endif
+
+/// @return length of the leading unreserved run(ALPHA / DIGIT / "-" / "." / "_" / "~")
+static int url_encode_span(const char* s, int n)
+{
+	int i = 0;
+#if defined(URLCODEC_SSE2)
+	uint32_t m;
+	__m128i v, x;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)(s + i));
+		x = _mm_or_si128(url_inrange(v, '-', '.'), url_inrange(v, '0', '9'));
+		x = _mm_or_si128(x, url_inrange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z')); // A-Z -> a-z
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_set1_epi8('~')));
+		m = (uint32_t)_mm_movemask_epi8(x) ^ 0xFFFF;
+		if (m)
+			return i + url_ctz(m);
+	}
+#elif defined(URLCODEC_NEON)
+	uint64_t m;
+	uint8x16_t v, x;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = vld1q_u8((const uint8_t*)(s + i));
+		x = vorrq_u8(url_inrange(v, '-', '.'), url_inrange(v, '0', '9'));
+		x = vorrq_u8(x, url_inrange(vorrq_u8(v, vdupq_n_u8(0x20)), 'a', 'z'));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8('_')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8('~')));
+		m = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(x), 4)), 0); // 4-bits per byte
+		if (m)
+			return i + url_ctz64(m) / 4;
+	}
+#endif
+	while (i < n && (char_isalnum(s[i]) || '-' == s[i] || '_' == s[i] || '.' == s[i] || '~' == s[i]))
+		i++;
+	return i;
+}
+
+/// @return length of the leading run that don't need decode(no '+', '%' and '\0')
+static int url_decode_span(const char* s, int n)
+{
+	int i = 0;
+#if defined(URLCODEC_SSE2)
+	uint32_t m;
+	__m128i v, x;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = _mm_loadu_si128((const __m128i*)(s + i));
+		x = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('+')), _mm_cmpeq_epi8(v, _mm_set1_epi8('%')));
+		x = _mm_or_si128(x, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+		m = (uint32_t)_mm_movemask_epi8(x);
+		if (m)
+			return i + url_ctz(m);
+	}
+#elif defined(URLCODEC_NEON)
+	uint64_t m;
+	uint8x16_t v, x;
+	for (; i + 16 <= n; i += 16)
+	{
+		v = vld1q_u8((const uint8_t*)(s + i));
+		x = vorrq_u8(vceqq_u8(v, vdupq_n_u8('+')), vceqq_u8(v, vdupq_n_u8('%')));
+		x = vorrq_u8(x, vceqq_u8(v, vdupq_n_u8(0)));
+		m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(x), 4)), 0);
+		if (m)
+			return i + url_ctz64(m) / 4;
+	}
+#endif
+	while (i < n && '+' != s[i] && '%' != s[i] && s[i])
+		i++;
+	return i;
+}
+
 // RFC3986
 // 2.2 Reserved Characters
 // reserved    = gen-delims / sub-delims
@@ -24,19 +143,25 @@ static inline char HEX(char c)
 // unreserved  = ALPHA / DIGIT / "-" / "." / "_" / "~"
 int url_encode(const char* source, int srcBytes, char* target, int tgtBytes)
 {
-	int i, r;
-	const char* p = source;
+	int i, n, r;
+	const char* p;
+	const char* end;
 
 	r = 0;
-	for(i=0; *p && (-1==srcBytes || p<source+srcBytes) && i<tgtBytes; ++p,++i)
+	end = source + (-1 == srcBytes ? (int)strlen(source) : srcBytes);
+	for(i=0, p=source; p<end && i<tgtBytes; ++p)
 	{
-		if(char_isalnum(*p) || '-'==*p || '_'==*p || '.'==*p || '~'==*p)
-		{
-			target[i] = *p;
-		}
-		else if(' ' == *p)
+		// copy unreserved run in bulk
+		n = url_encode_span(p, MIN((int)(end-p), tgtBytes-i));
+		memcpy(target+i, p, n);
+		p += n;
+		i += n;
+		if(p >= end || i >= tgtBytes || 0 == *p)
+			break;
+
+		if(' ' == *p)
 		{
-			target[i] = '+';
+			target[i++] = '+';
 		}
 		else
 		{
@@ -46,9 +171,9 @@ int url_encode(const char* source, int srcBytes, char* target, int tgtBytes)
 				break;
 			}
 
-			target[i] = '%';
-			target[++i] = s_encode[(*p>>4) & 0xF];
-			target[++i] = s_encode[*p & 0xF];
+			target[i++] = '%';
+			target[i++] = s_encode[(*p>>4) & 0xF];
+			target[i++] = s_encode[*p & 0xF];
 		}
 	}
 
@@ -59,43 +184,48 @@ int url_encode(const char* source, int srcBytes, char* target, int tgtBytes)
 
 int url_decode(const char* source, int srcBytes, char* target, int tgtBytes)
 {
-	int i, r;
-	const char* p = source;
+	int i, n, r;
+	const char* p;
+	const char* end;
 
 	r = 0;
-	for(i=0; *p && (-1==srcBytes || p<source+srcBytes) && i<tgtBytes; ++p,++i)
+	end = source + (-1 == srcBytes ? (int)strlen(source) : srcBytes);
+	for(i=0, p=source; p<end && i<tgtBytes; )
 	{
+		// copy plain run in bulk
+		n = url_decode_span(p, MIN((int)(end-p), tgtBytes-i));
+		memcpy(target+i, p, n);
+		p += n;
+		i += n;
+		if(p >= end || i >= tgtBytes || 0 == *p)
+			break;
+
 		if('+' == *p)
 		{
-            // query '+' -> ' '
-            // other '+' -> '+'
-			target[i] = ' ';
+			// query '+' -> ' '
+			// other '+' -> '+'
+			target[i++] = ' ';
+			p += 1;
 		}
-		else if('%' == *p)
+		else if(p + 1 < end && '%' == p[1])
 		{
-			if ((-1==srcBytes || p + 1 < source + srcBytes) && '%' == p[1])
-			{
-				target[i] = '%';
-				p += 1;
-				continue;
-			}
-
-            // https://tools.ietf.org/html/rfc3986#page-21
-            // in the host component %-encoding can only be used for non-ASCII bytes.
-            // https://tools.ietf.org/html/rfc6874#section-2
-            // introduces %25 being allowed to escape a percent sign in IPv6 scoped-address literals
-			if(!char_ishex(p[1]) || !char_ishex(p[2]) || (-1!=srcBytes && p+2>=source+srcBytes))
-			{
-				r = -1;
-				break;
-			}
-			
-			target[i] = (char)(HEX(p[1])<<4) | HEX(p[2]);
+			target[i++] = '%';
 			p += 2;
 		}
 		else
 		{
-			target[i] = *p;
+			// https://tools.ietf.org/html/rfc3986#page-21
+			// in the host component %-encoding can only be used for non-ASCII bytes.
+			// https://tools.ietf.org/html/rfc6874#section-2
+			// introduces %25 being allowed to escape a percent sign in IPv6 scoped-address literals
+			if(p+2 >= end || !char_ishex(p[1]) || !char_ishex(p[2]))
+			{
+				r = -1;
+				break;
+			}
+
+			target[i++] = (char)(HEX(p[1])<<4) | HEX(p[2]);
+			p += 3;
 		}
 	}
 
@@ -4,10 +4,6 @@
 #include <stdint.h>
 #include <time.h>
 
-#if !defined(OS_WINDOWS)
-#include <unistd.h> // access
-#endif
-
 // https://en.wikipedia.org/wiki/Universally_unique_identifier
 struct uuid_t
 {
@@ -20,54 +16,23 @@ struct uuid_t
 
 static void uuid_string(struct uuid_t* uuid, char s[37])
 {
-	snprintf(s, 37, "%08lx-%04x-%04x-%04x-%02x%02x%02x%02x%02x%02x",
-		uuid->time_low, uuid->time_mid, uuid->time_hi_and_version, uuid->clock_seq,
+	snprintf(s, 37, "%08x-%04x-%04x-%04x-%02x%02x%02x%02x%02x%02x",
+		(unsigned int)uuid->time_low, (unsigned int)uuid->time_mid, (unsigned int)uuid->time_hi_and_version, (unsigned int)uuid->clock_seq,
 		(unsigned int)uuid->node[0], (unsigned int)uuid->node[1], (unsigned int)uuid->node[2],
 		(unsigned int)uuid->node[3], (unsigned int)uuid->node[4], (unsigned int)uuid->node[5]);
 }
 
-#if !defined(OS_WINDOWS)
-static int uuid_have_random_source()
-{
-	return 0 == access("/dev/random", R_OK)
-		|| 0 == access("/dev/urandom", R_OK);
-}
+int read_random(void* ptr, int bytes);
 
-static int read_random_bytes(void* buf, int len)
+static int uuid_generate_random(struct uuid_t* uuid)
 {
-	int n, r;
-	FILE* fp;
-	
-	fp = fopen("/dev/urandom", "rb");
-	if (NULL == fp)
-	{
-		fp = fopen("/dev/random", "rb");
-		if (NULL == fp)
-			return -1;
-	}
-
-	for (r = n = 0; n < len; n += r)
-	{
-		r = (int)fread((uint8_t*)buf + n, 1, len - n, fp);
-		if (r <= 0)
-			break;
-	}
-
-	fclose(fp);
-	return r <= 0 ? -1 : 0;
-}
-
-static void uuid_generate_random(struct uuid_t* uuid)
-{
-	//random_get_bytes(uuid, sizeof(uuid));
-	//getrandom(uuid, sizeof(uuid), GRND_RANDOM|GRND_NONBLOCK);
-	read_random_bytes(uuid, sizeof(*uuid));
+	if ((int)sizeof(*uuid) != read_random(uuid, sizeof(*uuid)))
+		return -1;
 	uuid->clock_seq = (uuid->clock_seq & 0x3FFF) | 0x8000;
 	uuid->time_hi_and_version = (uuid->time_hi_and_version & 0x0FFF) | 0x4000;
+	return 0;
 }
 
-#endif
-
 static void uuid_generate_time(struct uuid_t* uuid)
 {
 	srand((unsigned int)time(NULL));
@@ -90,11 +55,7 @@ static void uuid_generate_time(struct uuid_t* uuid)
 void uuid_generate_simple(char s[37])
 {
 	struct uuid_t uuid;
-#if !defined(OS_WINDOWS)
-	if (uuid_have_random_source())
-		uuid_generate_random(&uuid);
-	else
-#endif
+	if (0 != uuid_generate_random(&uuid))
 		uuid_generate_time(&uuid);
 
 	uuid_string(&uuid, s);
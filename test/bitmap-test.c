@@ -6,6 +6,90 @@
 
 #define N 1001
 
+static void bitmap_next_test(const uint8_t* bitmap)
+{
+	unsigned int i, j, n;
+	size_t bit;
+
+	// next set/zero vs bit-by-bit
+	for (i = 0; i <= N; i++)
+	{
+		for (j = i; j < N && !bitmap_test_bit(bitmap, j); j++);
+		assert(j == bitmap_next_set(bitmap, N, i));
+		for (j = i; j < N && bitmap_test_bit(bitmap, j); j++);
+		assert(j == bitmap_next_zero(bitmap, N, i));
+	}
+
+	n = 0;
+	bitmap_for_each_set(bit, bitmap, N)
+	{
+		assert(bitmap_test_bit(bitmap, bit));
+		n++;
+	}
+	assert(n == bitmap_weight(bitmap, N));
+
+	n = 0;
+	bitmap_for_each_zero(bit, bitmap, N)
+	{
+		assert(!bitmap_test_bit(bitmap, bit));
+		n++;
+	}
+	assert(n + bitmap_weight(bitmap, N) == N);
+}
+
+static void bitmap_op_test(const uint8_t* src1)
+{
+	unsigned int i;
+	uint8_t src2[(N + 7) / 8], r[(N + 7) / 8];
+	for (i = 0; i < sizeof(src2); i++)
+		src2[i] = (uint8_t)rand();
+
+	bitmap_or(r, src1, src2, N);
+	for (i = 0; i < sizeof(r); i++) assert(r[i] == (src1[i] | src2[i]));
+	bitmap_and(r, src1, src2, N);
+	for (i = 0; i < sizeof(r); i++) assert(r[i] == (src1[i] & src2[i]));
+	bitmap_xor(r, src1, src2, N);
+	for (i = 0; i < sizeof(r); i++) assert(r[i] == (src1[i] ^ src2[i]));
+}
+
+static void hbitmap_test(void)
+{
+	static const size_t s_nbits[] = { 1, 63, 64, 65, 4095, 4096, 4097, 300000 };
+	struct hbitmap_t* hb;
+	size_t i, j, k, n;
+
+	for (k = 0; k < sizeof(s_nbits) / sizeof(s_nbits[0]); k++)
+	{
+		n = s_nbits[k];
+		hb = hbitmap_create(n);
+		assert(0 == hbitmap_find_first_zero(hb));
+
+		// fill in order
+		for (i = 0; i < n; i++)
+		{
+			assert(i == hbitmap_acquire(hb, 0));
+			assert(hbitmap_test_bit(hb, i));
+		}
+		assert(n == hbitmap_acquire(hb, 0));
+		assert(n == hbitmap_find_first_zero(hb));
+
+		// random release, next zero vs linear scan
+		for (i = 0; i < 64; i++)
+			hbitmap_clear(hb, rand() % n);
+		for (i = 0; i < n; i += 1 + rand() % 97)
+		{
+			for (j = i; j < n && hbitmap_test_bit(hb, j); j++);
+			assert(j == hbitmap_find_next_zero(hb, i));
+		}
+
+		while (hbitmap_find_first_zero(hb) < n)
+			hbitmap_set(hb, hbitmap_find_first_zero(hb));
+		hbitmap_clear(hb, n - 1);
+		assert(n - 1 == hbitmap_acquire(hb, n / 2));
+		hbitmap_destroy(hb);
+	}
+}
+
 void bitmap_test(void)
 {
 	unsigned int i, j, n;
@@ -70,5 +154,8 @@ void bitmap_test(void)
 		assert(!bitmap_test_bit(bitmap, i));
 	}
 
+	bitmap_next_test(bitmap);
+	bitmap_op_test(bitmap);
+	hbitmap_test();
 	printf("bitmap test ok\n");
 }
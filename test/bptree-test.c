@@ -0,0 +1,302 @@
+#include "bptree.h"
+#include "rbtree.h"
+#include "sys/system.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(OS_RTOS)
+#define N 1000
+#else
+#define N 100000
+#endif
+
+static uint64_t bptree_test_rand(void)
+{
+	return ((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 16) ^ (uint64_t)rand();
+}
+
+static int bptree_test_onscan(void* param, uint64_t key, void* value)
+{
+	uint64_t* last = (uint64_t*)param;
+	assert(key > last[0] || 0 == last[1]);
+	assert((uintptr_t)value == (uintptr_t)key);
+	last[0] = key;
+	last[1]++;
+	return 0;
+}
+
+// check order and size, all values are key
+static void bptree_check(struct bptree_t* tree, const uint8_t* exist, size_t n)
+{
+	size_t i, size;
+	uint64_t key;
+	struct bptree_iter_t it;
+
+	size = 0;
+	for (i = 0; i < n; i++)
+		size += exist[i] ? 1 : 0;
+	assert(size == bptree_size(tree));
+
+	i = 0;
+	for (bptree_first(tree, &it); it.leaf; bptree_next(&it))
+	{
+		key = bptree_iter_key(&it);
+		assert(key < n && exist[key] && (i == 0 || key >= i));
+		assert((uintptr_t)bptree_iter_value(&it) == (uintptr_t)key);
+		i = (size_t)key + 1;
+		size--;
+	}
+	assert(0 == size);
+}
+
+static void bptree_random_test(void)
+{
+	size_t i, j;
+	uint64_t key, last[2];
+	void* value;
+	uint8_t* exist;
+	struct bptree_t* tree;
+	struct bptree_iter_t it;
+
+	exist = (uint8_t*)calloc(N, 1);
+	tree = bptree_create();
+
+	for (i = 0; i < N * 2; i++)
+	{
+		key = bptree_test_rand() % N;
+		if (exist[key])
+		{
+			assert(-EEXIST == bptree_insert(tree, key, (void*)(uintptr_t)key));
+			if (rand() % 3)
+			{
+				assert(0 == bptree_delete(tree, key, &value) && (uintptr_t)value == key);
+				exist[key] = 0;
+			}
+		}
+		else
+		{
+			assert(-ENOENT == bptree_delete(tree, key, NULL));
+			assert(0 == bptree_insert(tree, key, (void*)(uintptr_t)key));
+			exist[key] = 1;
+		}
+	}
+	bptree_check(tree, exist, N);
+
+	for (i = 0; i < N; i++)
+		assert(exist[i] ? (0 == bptree_find(tree, i, &value) && (uintptr_t)value == i) : -ENOENT == bptree_find(tree, i, NULL));
+
+	// lower bound/range
+	for (i = 0; i < 1000; i++)
+	{
+		key = bptree_test_rand() % N;
+		if (0 == bptree_lower_bound(tree, key, &it))
+		{
+			assert(bptree_iter_key(&it) >= key && exist[bptree_iter_key(&it)]);
+			for (; key < bptree_iter_key(&it); key++)
+				assert(!exist[key]);
+		}
+
+		key = bptree_test_rand() % N;
+		last[0] = last[1] = 0;
+		assert(0 == bptree_range(tree, key, key + 100, bptree_test_onscan, last));
+		for (j = key; j < N && j < key + 100; j++)
+			last[1] -= exist[j] ? 1 : 0;
+		assert(0 == last[1]);
+	}
+
+	// reverse iteration
+	key = N;
+	for (bptree_last(tree, &it); it.leaf; bptree_prev(&it))
+	{
+		assert(bptree_iter_key(&it) < key);
+		key = bptree_iter_key(&it);
+	}
+
+	// delete all
+	for (i = 0; i < N; i++)
+	{
+		if (exist[i])
+			assert(0 == bptree_delete(tree, i, NULL));
+		exist[i] = 0;
+	}
+	assert(0 == bptree_size(tree) && -ENOENT == bptree_first(tree, &it));
+	bptree_destroy(tree);
+	free(exist);
+}
+
+static void bptree_bulk_test(void)
+{
+	size_t i, j, n;
+	uint64_t* keys;
+	void** values;
+	uint8_t* exist;
+	struct bptree_t* tree;
+
+	keys = (uint64_t*)malloc(sizeof(uint64_t) * N);
+	values = (void**)malloc(sizeof(void*) * N);
+	exist = (uint8_t*)calloc(N, 1);
+
+	for (n = 1; n <= N; n = n * 7 + 3)
+	{
+		for (i = j = 0; i < N && j < n; i++)
+		{
+			if (rand() % 2 && N - i > n - j)
+				continue;
+			keys[j] = i;
+			values[j++] = (void*)(uintptr_t)i;
+		}
+
+		tree = bptree_create();
+		assert(0 == bptree_bulk_load(tree, keys, values, n));
+		assert(-EINVAL == bptree_bulk_load(tree, keys, values, n));
+		memset(exist, 0, N);
+		for (i = 0; i < n; i++)
+			exist[keys[i]] = 1;
+		bptree_check(tree, exist, N);
+
+		// modify after bulk load
+		for (i = 0; i < n; i += 2)
+		{
+			assert(0 == bptree_delete(tree, keys[i], NULL));
+			exist[keys[i]] = 0;
+		}
+		for (i = 0; i < N; i += 3)
+		{
+			if (!exist[i])
+			{
+				assert(0 == bptree_insert(tree, i, (void*)(uintptr_t)i));
+				exist[i] = 1;
+			}
+		}
+		bptree_check(tree, exist, N);
+		bptree_destroy(tree);
+	}
+
+	tree = bptree_create();
+	keys[0] = 2; keys[1] = 1;
+	assert(-EINVAL == bptree_bulk_load(tree, keys, NULL, 2));
+	bptree_destroy(tree);
+
+	// append(time index)
+	tree = bptree_create();
+	memset(exist, 0, N);
+	for (i = 0; i < N; i++)
+	{
+		assert(0 == bptree_insert(tree, i, (void*)(uintptr_t)i));
+		exist[i] = 1;
+	}
+	for (i = 0; i < N / 2; i++)
+	{
+		assert(0 == bptree_delete(tree, i, NULL));
+		exist[i] = 0;
+	}
+	bptree_check(tree, exist, N);
+	bptree_destroy(tree);
+
+	free(exist);
+	free(values);
+	free(keys);
+}
+
+#if defined(BPTREE_BENCHMARK)
+struct bptree_rbtree_value_t
+{
+	struct rbtree_node_t node;
+	uint64_t key;
+};
+
+static void bptree_benchmark(size_t n)
+{
+	size_t i;
+	uint64_t t0, t1, t2, t3, sum;
+	uint64_t* keys;
+	void* value;
+	struct bptree_t* tree;
+	struct bptree_iter_t it;
+	struct rbtree_root_t root;
+	struct rbtree_node_t** link;
+	struct rbtree_node_t* parent;
+	const struct rbtree_node_t* node;
+	struct bptree_rbtree_value_t* items;
+	struct bptree_rbtree_value_t* v;
+
+	keys = (uint64_t*)malloc(sizeof(uint64_t) * n);
+	items = (struct bptree_rbtree_value_t*)malloc(sizeof(*items) * n);
+	for (i = 0; i < n; i++)
+		keys[i] = bptree_test_rand();
+
+	// rbtree
+	root.node = NULL;
+	t0 = system_clock();
+	for (i = 0; i < n; i++)
+	{
+		parent = NULL;
+		link = &root.node;
+		while (*link)
+		{
+			parent = *link;
+			v = rbtree_entry(parent, struct bptree_rbtree_value_t, node);
+			link = v->key > keys[i] ? &parent->left : &parent->right;
+		}
+		items[i].key = keys[i];
+		rbtree_insert(&root, parent, link, &items[i].node);
+	}
+	t1 = system_clock();
+	for (sum = i = 0; i < n; i++)
+	{
+		parent = root.node;
+		while (parent)
+		{
+			v = rbtree_entry(parent, struct bptree_rbtree_value_t, node);
+			if (v->key == keys[i])
+				break;
+			parent = v->key > keys[i] ? parent->left : parent->right;
+		}
+		sum += parent ? 1 : 0;
+	}
+	t2 = system_clock();
+	for (node = rbtree_first(&root); node; node = rbtree_next(node))
+	{
+		v = rbtree_entry(node, struct bptree_rbtree_value_t, node);
+		sum += v->key;
+	}
+	t3 = system_clock();
+	printf("rbtree %u: insert %ums, find %ums, scan %ums\n", (unsigned int)n, (unsigned int)(t1 - t0), (unsigned int)(t2 - t1), (unsigned int)(t3 - t2));
+
+	// b+tree
+	tree = bptree_create();
+	t0 = system_clock();
+	for (i = 0; i < n; i++)
+		bptree_insert(tree, keys[i], &items[i]);
+	t1 = system_clock();
+	for (i = 0; i < n; i++)
+		sum += 0 == bptree_find(tree, keys[i], &value) ? 1 : 0;
+	t2 = system_clock();
+	for (bptree_first(tree, &it); it.leaf; bptree_next(&it))
+		sum += bptree_iter_key(&it);
+	t3 = system_clock();
+	printf("bptree %u: insert %ums, find %ums, scan %ums (%u)\n", (unsigned int)n, (unsigned int)(t1 - t0), (unsigned int)(t2 - t1), (unsigned int)(t3 - t2), (unsigned int)sum);
+	bptree_destroy(tree);
+
+	free(items);
+	free(keys);
+}
+#endif
+
+void bptree_test(void)
+{
+	srand((unsigned int)time(NULL));
+	bptree_random_test();
+	bptree_bulk_test();
+
+#if defined(BPTREE_BENCHMARK)
+	bptree_benchmark(1000000);
+	bptree_benchmark(10000000);
+#endif
+	printf("b+tree test ok\n");
+}
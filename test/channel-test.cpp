@@ -2,6 +2,7 @@
 #include "sys/atomic.h"
 #include "sys/thread.h"
 #include "sys/system.h"
+#include "sys/sema.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -40,6 +41,55 @@ static int STDCALL channel_writer(void* param)
     return 0;
 }
 
+static int STDCALL channel_batch_writer(void* param)
+{
+    int i, n, v[16];
+    struct channel_t* q = (struct channel_t*)param;
+    for(i = 0; i < COUNTER; i += n)
+    {
+        for(n = 0; n < 16; n++)
+            v[n] = i + n;
+        n = channel_push_batch(q, v, COUNTER - i < 16 ? COUNTER - i : 16, -1);
+        assert(n > 0);
+    }
+    return 0;
+}
+
+static void channel_batch_select_test(void)
+{
+    int i, j, n, v[16], sum[2];
+    pthread_t writers[2];
+    struct channel_t* c[2];
+
+    c[0] = channel_create(CAPACITY, sizeof(int));
+    c[1] = channel_create(3, sizeof(int));
+    assert(0 == channel_count(c[1]));
+    assert(WAIT_TIMEOUT == channel_pop_timeout(c[1], v, 0));
+    assert(-WAIT_TIMEOUT == channel_select(c, 2, v, 10));
+
+    // capacity round up to 4
+    assert(4 == channel_push_batch(c[1], v, 16, 0));
+    assert(0 == channel_push_batch(c[1], v, 1, 0) && 4 == channel_count(c[1]));
+    assert(4 == channel_pop_batch(c[1], v, 16, 0));
+
+    thread_create(&writers[0], channel_batch_writer, c[0]);
+    thread_create(&writers[1], channel_batch_writer, c[1]);
+    sum[0] = sum[1] = 0;
+    for(i = 0; i < 2 * COUNTER; i++)
+    {
+        j = channel_select(c, 2, &n, -1);
+        assert(0 == j || 1 == j);
+        assert(n == sum[j]++); // per-channel order
+    }
+    thread_destroy(writers[0]);
+    thread_destroy(writers[1]);
+    assert(COUNTER == sum[0] && COUNTER == sum[1]);
+    assert(0 == channel_count(c[0]) && 0 == channel_count(c[1]));
+
+    channel_destroy(&c[0]);
+    channel_destroy(&c[1]);
+}
+
 extern "C" void channel_test(void)
 {
     struct channel_t* c;
@@ -66,5 +116,7 @@ extern "C" void channel_test(void)
     
     assert(s_counter == THREADS * COUNTER);
     channel_destroy(&c);
+
+    channel_batch_select_test();
     printf("channel test ok\n");
 }
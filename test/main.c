@@ -17,6 +17,7 @@ void string_test(void);
 
 void heap_test(void);
 void rbtree_test(void);
+void bptree_test(void);
 void timer_test(void);
 
 void socket_test(void);
@@ -36,10 +37,21 @@ void base64_test(void);
 void bitmap_test(void);
 void hweight_test(void);
 void ring_buffer_test(void);
+void random_test(void);
+void epoch_test(void);
+void memsearch_test(void);
+void aho_corasick_test(void);
 void channel_test(void);
+void chashmap_test(void);
+void app_log_test(void);
+void slab_test(void);
 
 void unicode_test(void);
+void html_entities_test(void);
+void utf8_validate_test(void);
+void gb18030_test(void);
 void uri_parse_test(void);
+void uri_query_test(void);
 void utf8codec_test(void);
 void thread_pool_test(void);
 void task_queue_test(void);
@@ -62,6 +74,10 @@ void http_test(void);
 void sdp_test(void);
 #endif
 
+#if defined(TURN_RELAY_BENCHMARK)
+void turn_relay_benchmark(void);
+#endif
+
 int main(int argc, char* argv[])
 {
 #if defined(OS_LINUX)
@@ -75,7 +91,9 @@ int main(int argc, char* argv[])
 
 	heap_test();
 	rbtree_test();
+	bptree_test();
 	channel_test();
+	chashmap_test();
 	timer_test();
 
 	socket_test();
@@ -102,13 +120,27 @@ int main(int argc, char* argv[])
 	bitmap_test();
 	hweight_test();
 	ring_buffer_test();
-
+	random_test();
+	epoch_test();
+	memsearch_test();
+	aho_corasick_test();
+	app_log_test();
+	slab_test();
+
+	utf8_validate_test();
+	html_entities_test();
+	gb18030_test();
 	uri_parse_test();
+	uri_query_test();
 
 #if defined(HTTP_TEST)
 	http_test();
 #endif
 
+#if defined(TURN_RELAY_BENCHMARK)
+	turn_relay_benchmark();
+#endif
+
 	thread_pool_test();
 	task_queue_test();
 
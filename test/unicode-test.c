@@ -2,11 +2,71 @@
 #include <assert.h>
 #include <string.h>
 
+void utf8_validate_test(void)
+{
+	size_t i, n;
+	char out[64];
+	uint16_t u16[64];
+	uint32_t u32[64];
+	const char* utf8 = "1中a华人民cc共和xxxx国\xF0\x9F\x98\x80"; // U+1F600
+	struct utf8_validator_t v;
+
+	assert(0 == utf8_validate(utf8, strlen(utf8)));
+	assert(-1 == utf8_validate("\xC0\xAF", 2)); // overlong '/'
+	assert(-1 == utf8_validate("\xED\xA0\x80", 3)); // surrogate
+	assert(-1 == utf8_validate("\xF4\x90\x80\x80", 4)); // > U+10FFFF
+	assert(-1 == utf8_validate(utf8, strlen(utf8) - 1)); // incomplete
+
+	// sequence split by chunk boundary
+	for (i = 0; i <= strlen(utf8); i++)
+	{
+		utf8_validator_init(&v);
+		assert(0 == utf8_validator_update(&v, utf8, i));
+		assert(0 == utf8_validator_update(&v, utf8 + i, strlen(utf8) - i));
+		assert(0 == utf8_validator_finish(&v));
+	}
+	utf8_validator_init(&v);
+	assert(0 == utf8_validator_update(&v, "\xE4\xB8", 2));
+	assert(-1 == utf8_validator_finish(&v));
+	assert(-1 == utf8_validator_update(&v, "a", 1));
+
+	assert(17 == utf8_to_utf16(utf8, strlen(utf8), u16, 64, &n) && n == strlen(utf8));
+	assert(0x4E2D == u16[1] && 0xD83D == u16[15] && 0xDE00 == u16[16]);
+	assert((int)strlen(utf8) == utf16_to_utf8(u16, 17, out, sizeof(out), &n) && 17 == n && 0 == memcmp(out, utf8, strlen(utf8)));
+	assert(15 == utf8_to_utf16(utf8, strlen(utf8) - 1, u16, 64, &n) && n == strlen(utf8) - 4); // keep incomplete tail
+	assert(16 == utf8_to_utf32(utf8, strlen(utf8), u32, 64, &n) && 0x1F600 == u32[15]);
+	assert((int)strlen(utf8) == utf32_to_utf8(u32, 16, out, sizeof(out), &n) && 16 == n && 0 == memcmp(out, utf8, strlen(utf8)));
+	assert(-1 == utf16_to_utf8(u16 + 16, 1, out, sizeof(out), &n)); // lone low surrogate
+}
+
+void gb18030_test(void)
+{
+	size_t i, n;
+	char out[64];
+	uint32_t u32[64];
+	const char* gb = "a\xD6\xD0\x95\x32\x82\x36\xA2\xE3\x81\x30\x81\x30"; // a中U+20000€U+0080
+	const char* utf8 = "a中\xF0\xA0\x80\x80€\xC2\x80";
+
+	assert(5 == gb18030_to_utf32(gb, strlen(gb), u32, 64, &n) && n == strlen(gb));
+	assert('a' == u32[0] && 0x4E2D == u32[1] && 0x20000 == u32[2] && 0x20AC == u32[3] && 0x80 == u32[4]);
+	assert((int)strlen(gb) == utf32_to_gb18030(u32, 5, out, sizeof(out), &n) && 5 == n && 0 == memcmp(out, gb, strlen(gb)));
+	assert((int)strlen(utf8) == gb18030_to_utf8(gb, strlen(gb), out, sizeof(out), &n) && 0 == memcmp(out, utf8, strlen(utf8)));
+	assert((int)strlen(gb) == utf8_to_gb18030(utf8, strlen(utf8), out, sizeof(out), &n) && 0 == memcmp(out, gb, strlen(gb)));
+	assert(-1 == utf32_to_gb18030((const uint32_t*)"\x00\xD8\x00\x00", 1, out, sizeof(out), &n)); // surrogate
+
+	// sequence split by chunk boundary: keep remain bytes
+	for (i = 1; i < 7; i++)
+	{
+		assert((int)(i < 3 ? 1 : 2) == gb18030_to_utf32(gb, i, u32, 64, &n));
+		assert(n == (i < 3 ? 1 : 3));
+	}
+}
+
 void unicode_test(void)
 {
 	char pc[256] = {0};
 	wchar_t pw[256] = {0};
-	char cc[] = "1中a华人民cc共和xxxx国";
+	char cc[] = "1\xD6\xD0" "a\xBB\xAA\xC8\xCB\xC3\xF1" "cc\xB9\xB2\xBA\xCDxxxx\xB9\xFA"; // GB18030: 1中a华人民cc共和xxxx国
 	wchar_t wc[] = L"1中a华人民cc共和xxxx国";
 	unicode_to_gb18030(wc, 0, pc, sizeof(pc));
 	assert(0 == strcmp(pc, cc));